@@ -0,0 +1,58 @@
+
+# generate the avx2 variant of an x86 layer
+# the copy lives in the nested namespace ncnn::avx2 so that its classes, kernel helpers
+# and layer creator never collide with the baseline build of the same source
+#
+# the copy is compiled with the baseline flags, avx2 fma and f16c are enabled by a target pragma
+# placed after the shared headers, so inline functions and templates from mat.h, layer.h and the
+# standard library keep their baseline code and the linker can pick any copy of them
+# the x86 layer header and kernel headers come after the pragma and see the avx macros
+
+# input: NAME SRC DST HDR_SRC HDR_DST
+
+string(TOUPPER ${NAME} NAME_UPPER)
+
+file(READ ${SRC} source_data)
+string(REPLACE "#include \"${NAME}_x86.h\"" "#include \"${NAME}_x86_avx2.h\"" source_data "${source_data}")
+string(REPLACE "namespace ncnn {" "namespace ncnn {\nnamespace avx2 {" source_data "${source_data}")
+string(REPLACE "} // namespace ncnn" "} // namespace avx2\n} // namespace ncnn" source_data "${source_data}")
+
+set(preamble "// generated from ${NAME}_x86.cpp, do not edit
+
+// shared headers first, compiled for the baseline isa
+#include \"${NAME}.h\"
+#include \"layer_type.h\"
+#include \"platform.h\"
+#include \"cpu.h\"
+#include \"benchmark.h\"
+#include \"autotune.h\"
+#include <algorithm>
+#include <vector>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target(\"avx2,fma,f16c\")
+// g++ does not update the isa macros on a target pragma, the layer code tests them
+#define __AVX__ 1
+#define __AVX2__ 1
+#define __FMA__ 1
+#define __F16C__ 1
+
+")
+file(WRITE ${DST} "${preamble}${source_data}\n#pragma GCC pop_options\n")
+
+file(READ ${HDR_SRC} header_data)
+string(REPLACE "LAYER_${NAME_UPPER}_X86_H" "LAYER_${NAME_UPPER}_X86_AVX2_H" header_data "${header_data}")
+string(REPLACE "namespace ncnn {" "namespace ncnn {\nnamespace avx2 {" header_data "${header_data}")
+string(REPLACE "} // namespace ncnn" "} // namespace avx2\n} // namespace ncnn" header_data "${header_data}")
+file(WRITE ${HDR_DST} "${header_data}")
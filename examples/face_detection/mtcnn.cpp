@@ -326,11 +326,16 @@ void mtcnn::CFaceDetection::PNet(){
         minl *= factor;
         m = m*factor;
     }
+    vector<int> sizes;
     for (size_t i = 0; i < scales_.size(); i++) {
-        int hs = (int)ceil(img_h*scales_[i]);
-        int ws = (int)ceil(img_w*scales_[i]);
-        ncnn::Mat in;
-        resize_bilinear(img, in, ws, hs);
+        sizes.push_back((int)ceil(img_w*scales_[i]));
+        sizes.push_back((int)ceil(img_h*scales_[i]));
+    }
+    vector<ncnn::Mat> pyramid(scales_.size());
+    if (!scales_.empty())
+        resize_pyramid(img, pyramid.data(), sizes.data(), (int)scales_.size());
+    for (size_t i = 0; i < scales_.size(); i++) {
+        ncnn::Mat& in = pyramid[i];
         ncnn::Extractor ex = Pnet->create_extractor();
         ex.set_num_threads(num_threads);
         ex.set_light_mode(true);
@@ -348,11 +353,16 @@ void mtcnn::CFaceDetection::PNet(){
 void mtcnn::CFaceDetection::RNet(){
     secondBbox_.clear();
     int count = 0;
+    vector<int> rois;
+    for(vector<Bbox>::iterator it=firstBbox_.begin(); it!=firstBbox_.end();it++){
+        int roi[4] = { (*it).x1, (*it).y1, (*it).x2-(*it).x1, (*it).y2-(*it).y1 };
+        rois.insert(rois.end(), roi, roi+4);
+    }
+    ncnn::Mat crops;
+    if(!rois.empty())
+        crop_resize_rois(img, rois.data(), (int)firstBbox_.size(), crops, 24, 24);
     for(vector<Bbox>::iterator it=firstBbox_.begin(); it!=firstBbox_.end();it++){
-        ncnn::Mat tempIm;
-        copy_cut_border(img, tempIm, (*it).y1, img_h-(*it).y2, (*it).x1, img_w-(*it).x2);
-        ncnn::Mat in;
-        resize_bilinear(tempIm, in, 24, 24);
+        ncnn::Mat in = crops.channel_range((int)(it-firstBbox_.begin())*img.c, img.c);
         ncnn::Extractor ex = Rnet->create_extractor();
         ex.set_num_threads(num_threads);
         ex.set_light_mode(true);
@@ -372,11 +382,16 @@ void mtcnn::CFaceDetection::RNet(){
 }
 void mtcnn::CFaceDetection::ONet(){
     thirdBbox_.clear();
+    vector<int> rois;
+    for(vector<Bbox>::iterator it=secondBbox_.begin(); it!=secondBbox_.end();it++){
+        int roi[4] = { (*it).x1, (*it).y1, (*it).x2-(*it).x1, (*it).y2-(*it).y1 };
+        rois.insert(rois.end(), roi, roi+4);
+    }
+    ncnn::Mat crops;
+    if(!rois.empty())
+        crop_resize_rois(img, rois.data(), (int)secondBbox_.size(), crops, 48, 48);
     for(vector<Bbox>::iterator it=secondBbox_.begin(); it!=secondBbox_.end();it++){
-        ncnn::Mat tempIm;
-        copy_cut_border(img, tempIm, (*it).y1, img_h-(*it).y2, (*it).x1, img_w-(*it).x2);
-        ncnn::Mat in;
-        resize_bilinear(tempIm, in, 48, 48);
+        ncnn::Mat in = crops.channel_range((int)(it-secondBbox_.begin())*img.c, img.c);
         ncnn::Extractor ex = Onet->create_extractor();
         ex.set_num_threads(num_threads);
         ex.set_light_mode(true);
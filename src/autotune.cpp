@@ -0,0 +1,129 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "autotune.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace ncnn {
+
+AutotuneCache::AutotuneCache()
+{
+}
+
+AutotuneCache::~AutotuneCache()
+{
+}
+
+#if NCNN_STDIO
+int AutotuneCache::load(const char* path)
+{
+    MutexLockGuard guard(lock);
+
+    cachepath = path;
+    recorded.clear();
+
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        // first run, the file is created on the first decision
+        return 0;
+    }
+
+    // one decision per line
+    // choice key
+    char line[256];
+    while (fgets(line, sizeof(line), fp))
+    {
+        int choice = -1;
+        int nconsumed = 0;
+        if (sscanf(line, "%d %n", &choice, &nconsumed) != 1 || choice < 0)
+            continue;
+
+        char* key = line + nconsumed;
+        key[strcspn(key, "\r\n")] = '\0';
+        if (key[0] == '\0')
+            continue;
+
+        decisions[key] = choice;
+        recorded[key] = choice;
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+#endif // NCNN_STDIO
+
+int AutotuneCache::find(const char* key) const
+{
+    MutexLockGuard guard(lock);
+
+    std::map<std::string, int>::const_iterator it = decisions.find(key);
+    if (it == decisions.end())
+        return -1;
+
+    return it->second;
+}
+
+void AutotuneCache::insert(const char* key, int choice)
+{
+    MutexLockGuard guard(lock);
+
+    decisions[key] = choice;
+
+#if NCNN_STDIO
+    if (cachepath.empty())
+        return;
+
+    std::map<std::string, int>::iterator it = recorded.find(key);
+    if (it != recorded.end() && it->second == choice)
+        return;
+
+    // a new key is appended, a changed decision rewrites the file so that no key appears twice
+    bool rewrite = it != recorded.end();
+    recorded[key] = choice;
+
+    FILE* fp = fopen(cachepath.c_str(), rewrite ? "wb" : "ab");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", cachepath.c_str());
+        return;
+    }
+
+    if (rewrite)
+    {
+        for (it = recorded.begin(); it != recorded.end(); it++)
+        {
+            fprintf(fp, "%d %s\n", it->second, it->first.c_str());
+        }
+    }
+    else
+    {
+        fprintf(fp, "%d %s\n", choice, key);
+    }
+
+    fclose(fp);
+#endif // NCNN_STDIO
+}
+
+void AutotuneCache::clear()
+{
+    MutexLockGuard guard(lock);
+
+    decisions.clear();
+}
+
+} // namespace ncnn
@@ -0,0 +1,59 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef NCNN_AUTOTUNE_H
+#define NCNN_AUTOTUNE_H
+
+#include <map>
+#include <string>
+#include "platform.h"
+
+namespace ncnn {
+
+// implementation choices made by timing at runtime
+// keyed by layer parameters, input shape and thread count
+// shared by all extractors of a net
+class AutotuneCache
+{
+public:
+    AutotuneCache();
+    ~AutotuneCache();
+
+#if NCNN_STDIO
+    // read the decisions recorded in path by earlier runs
+    // and record every new decision in it, one line per key
+    // return 0 if success
+    int load(const char* path);
+#endif // NCNN_STDIO
+
+    // the recorded choice for key, -1 if key has not been tuned yet
+    int find(const char* key) const;
+
+    // record the choice for key
+    void insert(const char* key, int choice);
+
+    // forget all decisions, the cache file is left untouched
+    void clear();
+
+private:
+    mutable Mutex lock;
+    std::map<std::string, int> decisions;
+    std::string cachepath;
+    // the decisions as written in cachepath
+    std::map<std::string, int> recorded;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_AUTOTUNE_H
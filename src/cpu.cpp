@@ -28,6 +28,14 @@
 #include <stdint.h>
 #endif
 
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#define __X86_CPU__ 1
+#elif defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>
+#define __X86_CPU__ 1
+#endif
+
 #if __APPLE__
 #include "TargetConditionals.h"
 #if TARGET_OS_IPHONE
@@ -191,6 +199,196 @@ int cpu_support_arm_asimdhp()
 #endif
 }
 
+#if __X86_CPU__
+static void x86_cpuid(int level, int subleaf, unsigned int out[4])
+{
+#if defined(_MSC_VER)
+    __cpuidex((int*)out, level, subleaf);
+#else
+    __cpuid_count(level, subleaf, out[0], out[1], out[2], out[3]);
+#endif
+}
+
+// the os saved register state, xcr0
+static unsigned int x86_get_xcr0()
+{
+#if defined(_MSC_VER)
+    return (unsigned int)_xgetbv(0);
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return eax;
+#endif
+}
+
+static int x86_max_cpuid_level()
+{
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(0, 0, cpu_info);
+    return cpu_info[0];
+}
+
+// os has enabled the xmm and ymm state
+static int x86_os_support_ymm()
+{
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(1, 0, cpu_info);
+
+    // osxsave
+    if (!(cpu_info[2] & (1u << 27)))
+        return 0;
+
+    return (x86_get_xcr0() & 6) == 6;
+}
+
+// os has enabled the opmask and zmm state
+static int x86_os_support_zmm()
+{
+    if (!x86_os_support_ymm())
+        return 0;
+
+    return (x86_get_xcr0() & 0xe6) == 0xe6;
+}
+
+static int get_x86_avx()
+{
+    if (!x86_os_support_ymm())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(1, 0, cpu_info);
+
+    return (cpu_info[2] >> 28) & 1;
+}
+
+static int get_x86_avx2()
+{
+    if (x86_max_cpuid_level() < 7 || !x86_os_support_ymm())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(7, 0, cpu_info);
+
+    return (cpu_info[1] >> 5) & 1;
+}
+
+static int get_x86_fma()
+{
+    if (!x86_os_support_ymm())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(1, 0, cpu_info);
+
+    return (cpu_info[2] >> 12) & 1;
+}
+
+static int get_x86_f16c()
+{
+    if (!x86_os_support_ymm())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(1, 0, cpu_info);
+
+    return (cpu_info[2] >> 29) & 1;
+}
+
+static int get_x86_avx_vnni()
+{
+    if (x86_max_cpuid_level() < 7 || !x86_os_support_ymm())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(7, 0, cpu_info);
+
+    // avx2
+    if (!(cpu_info[1] & (1u << 5)))
+        return 0;
+
+    x86_cpuid(7, 1, cpu_info);
+
+    return (cpu_info[0] >> 4) & 1;
+}
+
+static int get_x86_avx512_vnni()
+{
+    if (x86_max_cpuid_level() < 7 || !x86_os_support_zmm())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(7, 0, cpu_info);
+
+    // avx512f and avx512vl
+    if (!(cpu_info[1] & (1u << 16)) || !(cpu_info[1] & (1u << 31)))
+        return 0;
+
+    return (cpu_info[2] >> 11) & 1;
+}
+
+static int g_x86_avx = get_x86_avx();
+static int g_x86_avx2 = get_x86_avx2();
+static int g_x86_fma = get_x86_fma();
+static int g_x86_f16c = get_x86_f16c();
+static int g_x86_avx_vnni = get_x86_avx_vnni();
+static int g_x86_avx512_vnni = get_x86_avx512_vnni();
+#endif // __X86_CPU__
+
+int cpu_support_x86_avx()
+{
+#if __X86_CPU__
+    return g_x86_avx;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_avx2()
+{
+#if __X86_CPU__
+    return g_x86_avx2;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_fma()
+{
+#if __X86_CPU__
+    return g_x86_fma;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_f16c()
+{
+#if __X86_CPU__
+    return g_x86_f16c;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_avx_vnni()
+{
+#if __X86_CPU__
+    return g_x86_avx_vnni;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_avx512_vnni()
+{
+#if __X86_CPU__
+    return g_x86_avx512_vnni;
+#else
+    return 0;
+#endif
+}
+
 static int get_cpucount()
 {
 #ifdef __ANDROID__
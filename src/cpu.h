@@ -24,6 +24,18 @@ int cpu_support_arm_neon();
 int cpu_support_arm_vfpv4();
 // asimdhp = aarch64 asimd half precision
 int cpu_support_arm_asimdhp();
+// avx = x86 avx with os ymm state support
+int cpu_support_x86_avx();
+// avx2 = x86 avx2 integer and permute extensions
+int cpu_support_x86_avx2();
+// fma = x86 fused multiply add
+int cpu_support_x86_fma();
+// f16c = x86 fp16 <-> fp32 conversion
+int cpu_support_x86_f16c();
+// avx_vnni = x86 avx2 + vex encoded int8 dot product
+int cpu_support_x86_avx_vnni();
+// avx512_vnni = x86 avx512f + avx512vl + int8 dot product
+int cpu_support_x86_avx512_vnni();
 
 // cpu info
 int get_cpu_count();
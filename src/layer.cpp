@@ -161,6 +161,21 @@ static const layer_registry_entry layer_registry[] =
 
 static const int layer_registry_entry_count = sizeof(layer_registry) / sizeof(layer_registry_entry);
 
+#if NCNN_RUNTIME_CPU
+// same layer order, x86 implementations built for avx2 + fma + f16c
+static const layer_registry_entry layer_registry_avx2[] =
+{
+#include "layer_registry_avx2.h"
+};
+
+// queried on first use, the cpu feature flags are initialized statically in another translation unit
+static bool layer_registry_use_avx2()
+{
+    static const bool use_avx2 = cpu_support_x86_avx2() && cpu_support_x86_fma() && cpu_support_x86_f16c();
+    return use_avx2;
+}
+#endif // NCNN_RUNTIME_CPU
+
 #if NCNN_STRING
 int layer_to_index(const char* type)
 {
@@ -188,7 +203,11 @@ Layer* create_layer(int index)
     if (index < 0 || index >= layer_registry_entry_count)
         return 0;
 
+#if NCNN_RUNTIME_CPU
+    layer_creator_func layer_creator = layer_registry_use_avx2() ? layer_registry_avx2[index].creator : layer_registry[index].creator;
+#else
     layer_creator_func layer_creator = layer_registry[index].creator;
+#endif // NCNN_RUNTIME_CPU
     if (!layer_creator)
         return 0;
 
@@ -15,6 +15,7 @@
 #include "innerproduct.h"
 #include <algorithm>
 #include "layer_type.h"
+#include "quantize.h"
 
 namespace ncnn {
 
@@ -26,6 +27,8 @@ InnerProduct::InnerProduct()
     support_inplace = false;
 
     quantize = 0;
+
+    use_int8_requantize = false;
 }
 
 int InnerProduct::load_param(const ParamDict& pd)
@@ -181,6 +184,34 @@ int InnerProduct::destroy_pipeline(const Option& opt)
     return 0;
 }
 
+static inline float activation_ss(float v, int activation_type, const Mat& activation_params)
+{
+    if (activation_type == 1)
+    {
+        v = std::max(v, 0.f);
+    }
+    else if (activation_type == 2)
+    {
+        float slope = activation_params[0];
+        v = v > 0.f ? v : v * slope;
+    }
+    else if (activation_type == 3)
+    {
+        float min = activation_params[0];
+        float max = activation_params[1];
+        if (v < min)
+            v = min;
+        if (v > max)
+            v = max;
+    }
+    else if (activation_type == 4)
+    {
+        v = 1.f / (1.f + exp(-v));
+    }
+
+    return v;
+}
+
 int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
     int w = bottom_blob.w;
@@ -189,12 +220,17 @@ int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
     size_t elemsize = bottom_blob.elemsize;
     int size = w * h;
 
-    top_blob.create(num_output, elemsize, opt.blob_allocator);
-    if (top_blob.empty())
-        return -100;
-
     if (use_int8_inference)
     {
+        Mat top_blob_tm;
+        top_blob_tm.create(num_output, (size_t)4u, opt.workspace_allocator);
+        if (top_blob_tm.empty())
+            return -100;
+
+        top_blob.create(num_output, use_int8_requantize ? (size_t)1u : (size_t)4u, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
         Mat bottom_blob_tm = bottom_blob;
         if (elemsize != 1)
         {
@@ -219,7 +255,7 @@ int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
         for (int p=0; p<num_output; p++)
         {
             int sum = 0;
-            int* out = top_blob;
+            int* out = top_blob_tm;
 
             // channels
             for (int q=0; q<channels; q++)
@@ -239,28 +275,75 @@ int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
         #pragma omp parallel for num_threads(opt.num_threads)
         for (int p=0; p<num_output; p++)
         {
-            int* out_s32 = top_blob;
-            float* out_f32 = top_blob;
+            const int* out_s32 = top_blob_tm;
             float top_rescale = 1.f;
             if (weight_data_int8_scales[p] == 0)
                 top_rescale = 0;
             else
                 top_rescale = 1.f / (bottom_blob_int8_scale * weight_data_int8_scales[p]);
 
+            float sum = out_s32[p] * top_rescale;
+
             if (bias_term)
-                out_f32[p] = out_s32[p] * top_rescale + bias_data[p];
+                sum += bias_data[p];
+
+            sum = activation_ss(sum, activation_type, activation_params);
+
+            if (use_int8_requantize)
+            {
+                signed char* out_s8 = top_blob;
+                out_s8[p] = float2int8(sum * top_blob_int8_scale);
+            }
             else
-                out_f32[p] = out_s32[p] * top_rescale;
+            {
+                float* out_f32 = top_blob;
+                out_f32[p] = sum;
+            }
+        }
 
-            if (activation_type == 1)
+        return 0;
+    }
+
+    int num_input = weight_data_size / num_output;
+
+    if (bottom_blob.dims == 2 && w == num_input && h > 1)
+    {
+        // batched, one input vector per row
+        top_blob.create(num_output, h, elemsize, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int j=0; j<h; j++)
+        {
+            const float* m = bottom_blob.row(j);
+            float* outptr = top_blob.row(j);
+
+            for (int p=0; p<num_output; p++)
             {
-                out_f32[p] = std::max(out_f32[p], 0.f);
-            }                
+                const float* kptr = (const float*)weight_data + num_input * p;
+
+                float sum = 0.f;
+
+                if (bias_term)
+                    sum = bias_data[p];
+
+                for (int i = 0; i < num_input; i++)
+                {
+                    sum += m[i] * kptr[i];
+                }
+
+                outptr[p] = activation_ss(sum, activation_type, activation_params);
+            }
         }
 
         return 0;
     }
 
+    top_blob.create(num_output, elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
     // num_output
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int p=0; p<num_output; p++)
@@ -282,28 +365,7 @@ int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
             }
         }
 
-        if (activation_type == 1)
-        {
-            sum = std::max(sum, 0.f);
-        }
-        else if (activation_type == 2)
-        {
-            float slope = activation_params[0];
-            sum = sum > 0.f ? sum : sum * slope;
-        }
-        else if (activation_type == 3)
-        {
-            float min = activation_params[0];
-            float max = activation_params[1];
-            if (sum < min)
-                sum = min;
-            if (sum > max)
-                sum = max;
-        }
-        else if (activation_type == 4)
-        {
-            sum = 1.f / (1.f + exp(-sum));
-        }
+        sum = activation_ss(sum, activation_type, activation_params);
 
         top_blob[p] = sum;
     }
@@ -54,6 +54,10 @@ public:
     float bottom_blob_int8_scale;
 
     bool use_int8_inference;
+    bool use_int8_requantize;
+
+    // merge requantize op into innerproduct op
+    float top_blob_int8_scale;
 
     ncnn::Layer* quantize;
     std::vector<ncnn::Layer*> dequantize_ops;
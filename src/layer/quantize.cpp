@@ -33,14 +33,6 @@ int Quantize::load_param(const ParamDict& pd)
     return 0;
 }
 
-static inline signed char float2int8(float v)
-{
-    int int32 = round(v);
-    if (int32 > 127) return 127;
-    if (int32 < -128) return -128;
-    return (signed char)int32;
-}
-
 int Quantize::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
     int dims = bottom_blob.dims;
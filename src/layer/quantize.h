@@ -15,6 +15,7 @@
 #ifndef LAYER_QUANTIZE_H
 #define LAYER_QUANTIZE_H
 
+#include <math.h>
 #include "layer.h"
 
 namespace ncnn {
@@ -32,6 +33,17 @@ public:
     float scale;
 };
 
+// round to nearest and saturate, the one int8 conversion every quantizing layer uses
+// weights quantized with 127 / absmax stay within [-127, 127], the x86 int8 kernels
+// rely on that and clamp packed weights to -127 because their sign trick cannot negate -128
+static inline signed char float2int8(float v)
+{
+    int int32 = round(v);
+    if (int32 > 127) return 127;
+    if (int32 < -128) return -128;
+    return (signed char)int32;
+}
+
 } // namespace ncnn
 
 #endif // LAYER_QUANTIZE_H
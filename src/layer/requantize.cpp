@@ -13,6 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "requantize.h"
+#include "quantize.h"
 
 #include <math.h>
 
@@ -27,14 +28,6 @@ Requantize::Requantize()
     fusion_relu = false;
 }
 
-static inline signed char float2int8(float v)
-{
-    int int32 = round(v);
-    if (int32 > 127) return 127;
-    if (int32 < -128) return -128;
-    return (signed char)int32;
-}
-
 int Requantize::load_param(const ParamDict& pd)
 {
     scale_in = pd.get(0, 1.f);	// bottom_blob_scale * weight_scale
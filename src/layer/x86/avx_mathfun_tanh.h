@@ -0,0 +1,61 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// tanh avx vector version
+// refer the scalar version from Cephes Math Library
+
+#define c_cephes_HALFMAXLOGF 44.014845935754205f
+#define c_cephes_tanh_C1 0.625f
+
+#define c_cephes_tanh_p0 - 5.70498872745E-3
+#define c_cephes_tanh_p1 + 2.06390887954E-2
+#define c_cephes_tanh_p2 - 5.37397155531E-2
+#define c_cephes_tanh_p3 + 1.33314422036E-1
+#define c_cephes_tanh_p4 - 3.33332819422E-1
+
+/* Single precision hyperbolic tangent computed for 8 simultaneous float */
+static inline v8sf tanh256_ps(v8sf x)
+{
+    v8sf sign = _mm256_and_ps(x, _mm256_set1_ps(-0.f));
+    v8sf x2 = _mm256_andnot_ps(_mm256_set1_ps(-0.f), x);
+
+    v8sf mask_l = _mm256_cmp_ps(x2, _mm256_set1_ps(c_cephes_tanh_C1), _CMP_GE_OQ);
+    v8sf mask_l2 = _mm256_cmp_ps(x2, _mm256_set1_ps(c_cephes_HALFMAXLOGF), _CMP_GT_OQ);
+
+    // abs(x) >= 0.625
+    // tanh(x) = (exp(2x) - 1) / (exp(2x) + 1)
+    v8sf one = _mm256_set1_ps(1.f);
+    v8sf exp_x_x = exp256_ps(_mm256_add_ps(x, x));
+    v8sf y0 = _mm256_div_ps(_mm256_sub_ps(exp_x_x, one), _mm256_add_ps(exp_x_x, one));
+
+    // abs(x) < 0.625
+    v8sf z = _mm256_mul_ps(x, x);
+
+    v8sf y = _mm256_set1_ps(c_cephes_tanh_p0);
+    y = _mm256_fmadd_ps(y, z, _mm256_set1_ps(c_cephes_tanh_p1));
+    y = _mm256_fmadd_ps(y, z, _mm256_set1_ps(c_cephes_tanh_p2));
+    y = _mm256_fmadd_ps(y, z, _mm256_set1_ps(c_cephes_tanh_p3));
+    y = _mm256_fmadd_ps(y, z, _mm256_set1_ps(c_cephes_tanh_p4));
+
+    y = _mm256_mul_ps(y, z);
+    y = _mm256_fmadd_ps(y, x, x);
+
+    // abs(x) > HALFMAXLOGF
+    // return 1.0 or -1.0
+    v8sf y1 = _mm256_or_ps(one, sign);
+
+    y = _mm256_blendv_ps(y, y0, mask_l);
+    y = _mm256_blendv_ps(y, y1, mask_l2);
+    return y;
+}
@@ -0,0 +1,593 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "binaryop_x86.h"
+#include <algorithm>
+
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(BinaryOp_x86)
+
+BinaryOp_x86::BinaryOp_x86()
+{
+}
+
+int BinaryOp_x86::create_pipeline(const Option& opt)
+{
+    // write the result over the first input, the gpu path has no multi-blob inplace forward
+    if (with_scalar == 0 && !(opt.use_vulkan_compute && support_vulkan))
+    {
+        support_inplace = true;
+    }
+
+    return 0;
+}
+
+struct binary_op_simd_add
+{
+    float operator()(const float& x, const float& y) const { return x + y; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_add_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_add_ps(x, y); }
+#endif // __AVX__
+};
+
+struct binary_op_simd_sub
+{
+    float operator()(const float& x, const float& y) const { return x - y; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_sub_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_sub_ps(x, y); }
+#endif // __AVX__
+};
+
+struct binary_op_simd_mul
+{
+    float operator()(const float& x, const float& y) const { return x * y; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_mul_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_mul_ps(x, y); }
+#endif // __AVX__
+};
+
+struct binary_op_simd_div
+{
+    float operator()(const float& x, const float& y) const { return x / y; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_div_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_div_ps(x, y); }
+#endif // __AVX__
+};
+
+struct binary_op_simd_max
+{
+    float operator()(const float& x, const float& y) const { return std::max(x, y); }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_max_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_max_ps(x, y); }
+#endif // __AVX__
+};
+
+struct binary_op_simd_min
+{
+    float operator()(const float& x, const float& y) const { return std::min(x, y); }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_min_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_min_ps(x, y); }
+#endif // __AVX__
+};
+
+struct binary_op_simd_rsub
+{
+    float operator()(const float& x, const float& y) const { return y - x; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_sub_ps(y, x); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_sub_ps(y, x); }
+#endif // __AVX__
+};
+
+struct binary_op_simd_rdiv
+{
+    float operator()(const float& x, const float& y) const { return y / x; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_div_ps(y, x); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_div_ps(y, x); }
+#endif // __AVX__
+};
+
+// outptr may alias ptr or ptr1, every element is read before it is written
+
+// vector op vector
+template<typename Op>
+static void binary_op_vv(const float* ptr, const float* ptr1, float* outptr, int size, const Op& op)
+{
+    int i=0;
+#if __AVX__
+    for (; i+7<size; i+=8)
+    {
+        _mm256_storeu_ps(outptr + i, op(_mm256_loadu_ps(ptr + i), _mm256_loadu_ps(ptr1 + i)));
+    }
+#endif // __AVX__
+#if __SSE2__
+    for (; i+3<size; i+=4)
+    {
+        _mm_storeu_ps(outptr + i, op(_mm_loadu_ps(ptr + i), _mm_loadu_ps(ptr1 + i)));
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        outptr[i] = op(ptr[i], ptr1[i]);
+    }
+}
+
+// vector op scalar
+template<typename Op>
+static void binary_op_vs(const float* ptr, float b0, float* outptr, int size, const Op& op)
+{
+    int i=0;
+#if __AVX__
+    __m256 _b0_avx = _mm256_set1_ps(b0);
+    for (; i+7<size; i+=8)
+    {
+        _mm256_storeu_ps(outptr + i, op(_mm256_loadu_ps(ptr + i), _b0_avx));
+    }
+#endif // __AVX__
+#if __SSE2__
+    __m128 _b0 = _mm_set1_ps(b0);
+    for (; i+3<size; i+=4)
+    {
+        _mm_storeu_ps(outptr + i, op(_mm_loadu_ps(ptr + i), _b0));
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        outptr[i] = op(ptr[i], b0);
+    }
+}
+
+// scalar op vector
+template<typename Op>
+static void binary_op_sv(float a0, const float* ptr1, float* outptr, int size, const Op& op)
+{
+    int i=0;
+#if __AVX__
+    __m256 _a0_avx = _mm256_set1_ps(a0);
+    for (; i+7<size; i+=8)
+    {
+        _mm256_storeu_ps(outptr + i, op(_a0_avx, _mm256_loadu_ps(ptr1 + i)));
+    }
+#endif // __AVX__
+#if __SSE2__
+    __m128 _a0 = _mm_set1_ps(a0);
+    for (; i+3<size; i+=4)
+    {
+        _mm_storeu_ps(outptr + i, op(_a0, _mm_loadu_ps(ptr1 + i)));
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        outptr[i] = op(a0, ptr1[i]);
+    }
+}
+
+// broadcasting rule
+// https://github.com/Tencent/ncnn/wiki/binaryop-broadcasting
+
+template<typename Op>
+static int binary_op(const Mat& a, const Mat& b, Mat& c, const Option& opt)
+{
+    Op op;
+
+    int w = a.w;
+    int h = a.h;
+    int channels = a.c;
+    int size = w * h;
+    size_t elemsize = a.elemsize;
+
+    int w1 = b.w;
+    int h1 = b.h;
+    int channels1 = b.c;
+    int size1 = w1 * h1;
+
+    if (a.dims == 3)
+    {
+        c.create(w, h, channels, elemsize, opt.blob_allocator);
+        if (c.empty())
+            return -100;
+
+        if (b.dims == 3)
+        {
+            if (b.w == 1 && b.h == 1)
+            {
+                // special type 1
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q=0; q<channels; q++)
+                {
+                    const float* ptr = a.channel(q);
+                    const float* b0 = b.channel(q);
+                    float* outptr = c.channel(q);
+
+                    binary_op_vs(ptr, b0[0], outptr, size, op);
+                }
+
+                return 0;
+            }
+
+            // type 19
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                const float* ptr = a.channel(q);
+                const float* ptr1 = b.channel(q);
+                float* outptr = c.channel(q);
+
+                binary_op_vv(ptr, ptr1, outptr, size, op);
+            }
+
+            return 0;
+        }
+
+        if (b.dims == 2)
+        {
+            // type 18
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                const float* ptr = a.channel(q);
+                const float* ptr1 = b.row(q);
+                float* outptr = c.channel(q);
+
+                for (int y=0; y<h; y++)
+                {
+                    binary_op_vs(ptr, ptr1[y], outptr, w, op);
+
+                    ptr += w;
+                    outptr += w;
+                }
+            }
+
+            return 0;
+        }
+
+        if (b.dims == 1)
+        {
+            if (b.w == 1)
+            {
+                // type 16
+                const float b0 = b[0];
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q=0; q<channels; q++)
+                {
+                    const float* ptr = a.channel(q);
+                    float* outptr = c.channel(q);
+
+                    binary_op_vs(ptr, b0, outptr, size, op);
+                }
+
+                return 0;
+            }
+
+            // type 17
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                const float* ptr = a.channel(q);
+                float* outptr = c.channel(q);
+
+                binary_op_vs(ptr, b[q], outptr, size, op);
+            }
+
+            return 0;
+        }
+    }
+    else if (a.dims == 2)
+    {
+        if (b.dims == 3)
+        {
+            // type 14
+            c.create(w1, h1, channels1, elemsize, opt.blob_allocator);
+            if (c.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels1; q++)
+            {
+                const float* ptr = a.row(q);
+                const float* ptr1 = b.channel(q);
+                float* outptr = c.channel(q);
+
+                for (int y=0; y<h1; y++)
+                {
+                    binary_op_sv(ptr[y], ptr1, outptr, w1, op);
+
+                    ptr1 += w1;
+                    outptr += w1;
+                }
+            }
+
+            return 0;
+        }
+
+        c.create(w, h, elemsize, opt.blob_allocator);
+        if (c.empty())
+            return -100;
+
+        if (b.dims == 2)
+        {
+            // type 13
+            binary_op_vv(a, b, c, size, op);
+
+            return 0;
+        }
+
+        if (b.dims == 1)
+        {
+            if (b.w == 1)
+            {
+                // type 11
+                binary_op_vs(a, b[0], c, size, op);
+
+                return 0;
+            }
+
+            // type 12
+            const float* ptr = a;
+            float* outptr = c;
+
+            for (int y=0; y<h; y++)
+            {
+                binary_op_vs(ptr, b[y], outptr, w, op);
+
+                ptr += w;
+                outptr += w;
+            }
+
+            return 0;
+        }
+    }
+    else if (a.dims == 1)
+    {
+        if (a.w == 1)
+        {
+            if (b.dims == 3)
+            {
+                // type 4
+                c.create(w1, h1, channels1, elemsize, opt.blob_allocator);
+                if (c.empty())
+                    return -100;
+
+                const float a0 = a[0];
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q=0; q<channels1; q++)
+                {
+                    const float* ptr1 = b.channel(q);
+                    float* outptr = c.channel(q);
+
+                    binary_op_sv(a0, ptr1, outptr, size1, op);
+                }
+
+                return 0;
+            }
+
+            if (b.dims == 2)
+            {
+                // type 3
+                c.create(w1, h1, elemsize, opt.blob_allocator);
+                if (c.empty())
+                    return -100;
+
+                binary_op_sv(a[0], b, c, size1, op);
+
+                return 0;
+            }
+
+            if (b.dims == 1)
+            {
+                // type 2
+                c.create(w1, elemsize, opt.blob_allocator);
+                if (c.empty())
+                    return -100;
+
+                binary_op_sv(a[0], b, c, w1, op);
+
+                return 0;
+            }
+        }
+
+        if (b.dims == 3)
+        {
+            // type 9
+            c.create(w1, h1, channels1, elemsize, opt.blob_allocator);
+            if (c.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels1; q++)
+            {
+                const float* ptr1 = b.channel(q);
+                float* outptr = c.channel(q);
+
+                binary_op_sv(a[q], ptr1, outptr, size1, op);
+            }
+
+            return 0;
+        }
+
+        if (b.dims == 2)
+        {
+            // type 8
+            c.create(w1, h1, elemsize, opt.blob_allocator);
+            if (c.empty())
+                return -100;
+
+            const float* ptr1 = b;
+            float* outptr = c;
+
+            for (int y=0; y<h1; y++)
+            {
+                binary_op_sv(a[y], ptr1, outptr, w1, op);
+
+                ptr1 += w1;
+                outptr += w1;
+            }
+
+            return 0;
+        }
+
+        if (b.dims == 1)
+        {
+            c.create(w, elemsize, opt.blob_allocator);
+            if (c.empty())
+                return -100;
+
+            if (b.w == 1)
+            {
+                // type 6
+                binary_op_vs(a, b[0], c, w, op);
+
+                return 0;
+            }
+
+            // type 7
+            binary_op_vv(a, b, c, w, op);
+        }
+    }
+
+    return 0;
+}
+
+template<typename Op>
+static int binary_op_scalar_inplace(Mat& a, float b, const Option& opt)
+{
+    Op op;
+
+    int w = a.w;
+    int h = a.h;
+    int channels = a.c;
+    int size = w * h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<channels; q++)
+    {
+        float* ptr = a.channel(q);
+
+        binary_op_vs(ptr, b, ptr, size, op);
+    }
+
+    return 0;
+}
+
+int BinaryOp_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+    const Mat& bottom_blob1 = bottom_blobs[1];
+
+    Mat& top_blob = top_blobs[0];
+
+    if (op_type == Operation_ADD)
+        return binary_op<binary_op_simd_add>(bottom_blob, bottom_blob1, top_blob, opt);
+
+    if (op_type == Operation_SUB)
+        return binary_op<binary_op_simd_sub>(bottom_blob, bottom_blob1, top_blob, opt);
+
+    if (op_type == Operation_MUL)
+        return binary_op<binary_op_simd_mul>(bottom_blob, bottom_blob1, top_blob, opt);
+
+    if (op_type == Operation_DIV)
+        return binary_op<binary_op_simd_div>(bottom_blob, bottom_blob1, top_blob, opt);
+
+    if (op_type == Operation_MAX)
+        return binary_op<binary_op_simd_max>(bottom_blob, bottom_blob1, top_blob, opt);
+
+    if (op_type == Operation_MIN)
+        return binary_op<binary_op_simd_min>(bottom_blob, bottom_blob1, top_blob, opt);
+
+    if (op_type == Operation_RSUB)
+        return binary_op<binary_op_simd_rsub>(bottom_blob, bottom_blob1, top_blob, opt);
+
+    if (op_type == Operation_RDIV)
+        return binary_op<binary_op_simd_rdiv>(bottom_blob, bottom_blob1, top_blob, opt);
+
+    // pow has no exact vector form
+    return BinaryOp::forward(bottom_blobs, top_blobs, opt);
+}
+
+int BinaryOp_x86::forward_inplace(std::vector<Mat>& bottom_top_blobs, const Option& opt) const
+{
+    // the result lands in the first blob when the shapes allow, a new blob otherwise
+    std::vector<Mat> top_blobs(1);
+    top_blobs[0] = bottom_top_blobs[0];
+
+    int ret = forward(bottom_top_blobs, top_blobs, opt);
+    if (ret != 0)
+        return ret;
+
+    bottom_top_blobs[0] = top_blobs[0];
+
+    return 0;
+}
+
+int BinaryOp_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    if (op_type == Operation_ADD)
+        return binary_op_scalar_inplace<binary_op_simd_add>(bottom_top_blob, b, opt);
+
+    if (op_type == Operation_SUB)
+        return binary_op_scalar_inplace<binary_op_simd_sub>(bottom_top_blob, b, opt);
+
+    if (op_type == Operation_MUL)
+        return binary_op_scalar_inplace<binary_op_simd_mul>(bottom_top_blob, b, opt);
+
+    if (op_type == Operation_DIV)
+        return binary_op_scalar_inplace<binary_op_simd_div>(bottom_top_blob, b, opt);
+
+    if (op_type == Operation_MAX)
+        return binary_op_scalar_inplace<binary_op_simd_max>(bottom_top_blob, b, opt);
+
+    if (op_type == Operation_MIN)
+        return binary_op_scalar_inplace<binary_op_simd_min>(bottom_top_blob, b, opt);
+
+    if (op_type == Operation_RSUB)
+        return binary_op_scalar_inplace<binary_op_simd_rsub>(bottom_top_blob, b, opt);
+
+    if (op_type == Operation_RDIV)
+        return binary_op_scalar_inplace<binary_op_simd_rdiv>(bottom_top_blob, b, opt);
+
+    return BinaryOp::forward_inplace(bottom_top_blob, opt);
+}
+
+} // namespace ncnn
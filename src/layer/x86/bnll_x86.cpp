@@ -0,0 +1,97 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "bnll_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#endif // __AVX__
+
+#include <math.h>
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(BNLL_x86)
+
+BNLL_x86::BNLL_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int BNLL_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    int w = bottom_top_blob.w;
+    int h = bottom_top_blob.h;
+    int channels = bottom_top_blob.c;
+    int elempack = bottom_top_blob.elempack;
+    int size = w * h * elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<channels; q++)
+    {
+        float* ptr = bottom_top_blob.channel(q);
+
+        int i=0;
+#if __AVX__
+        __m256 _zero8 = _mm256_setzero_ps();
+        __m256 _one8 = _mm256_set1_ps(1.f);
+        __m256 _sign8 = _mm256_set1_ps(-0.f);
+        for (; i+7<size; i+=8)
+        {
+            __m256 _p = _mm256_loadu_ps(ptr);
+            // max(x, 0) + log(1 + exp(-abs(x)))
+            __m256 _nabs = _mm256_or_ps(_p, _sign8);
+            _p = _mm256_add_ps(_mm256_max_ps(_p, _zero8), log256_ps(_mm256_add_ps(_one8, exp256_ps(_nabs))));
+            _mm256_storeu_ps(ptr, _p);
+
+            ptr += 8;
+        }
+#endif // __AVX__
+#if __SSE2__
+        __m128 _zero = _mm_setzero_ps();
+        __m128 _one = _mm_set1_ps(1.f);
+        __m128 _sign = _mm_set1_ps(-0.f);
+        for (; i+3<size; i+=4)
+        {
+            __m128 _p = _mm_loadu_ps(ptr);
+            // max(x, 0) + log(1 + exp(-abs(x)))
+            __m128 _nabs = _mm_or_ps(_p, _sign);
+            _p = _mm_add_ps(_mm_max_ps(_p, _zero), log_ps(_mm_add_ps(_one, exp_ps(_nabs))));
+            _mm_storeu_ps(ptr, _p);
+
+            ptr += 4;
+        }
+#endif // __SSE2__
+        for (; i<size; i++)
+        {
+            if (*ptr > 0)
+                *ptr = *ptr + log(1.f + exp(-*ptr));
+            else
+                *ptr = log(1.f + exp(*ptr));
+
+            ptr++;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -140,7 +140,7 @@ static void conv3x3s1_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _ker
 
 }
 
-static void conv3x3s1_winograd23_transform_kernel_sse(const Mat& kernel, Mat& kernel_tm, int inch, int outch)
+static void conv3x3s1_winograd23_transform_kernel_sse(const Mat& kernel, Mat& kernel_tm, int inch, int outch, const Option& opt)
 {
     kernel_tm.create(4*4, inch, outch);
 
@@ -152,7 +152,7 @@ static void conv3x3s1_winograd23_transform_kernel_sse(const Mat& kernel, Mat& ke
         {   0.0f,     0.0f,     1.0f}
     };
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opt.num_threads)
     for (int p = 0; p<outch; p++)
     {
         for (int q = 0; q<inch; q++)
@@ -188,7 +188,7 @@ static void conv3x3s1_winograd23_transform_kernel_sse(const Mat& kernel, Mat& ke
     }
 }
 
-static void conv3x3s1_winograd23_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_tm, const Mat& _bias, const Option& opt)
+static void conv3x3s1_winograd23_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_tm, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
 {
     int w = bottom_blob.w;
     int h = bottom_blob.h;
@@ -198,7 +198,7 @@ static void conv3x3s1_winograd23_sse(const Mat& bottom_blob, Mat& top_blob, cons
     int outh = top_blob.h;
     int outch = top_blob.c;
 
-    // pad to 2n+2, winograd F(2,3)
+    // pad to 2n+2, winograd F(2,3), the convolution padding is applied in the same copy
     Mat bottom_blob_bordered = bottom_blob;
 
     outw = (outw + 1) / 2 * 2;
@@ -208,7 +208,7 @@ static void conv3x3s1_winograd23_sse(const Mat& bottom_blob, Mat& top_blob, cons
     h = outh + 2;
     Option opt_b = opt;
     opt_b.blob_allocator = opt.workspace_allocator;
-    copy_make_border(bottom_blob, bottom_blob_bordered, 0, h - bottom_blob.h, 0, w - bottom_blob.w, 0, 0.f, opt_b);
+    copy_make_border(bottom_blob, bottom_blob_bordered, pad_top, h - bottom_blob.h - pad_top, pad_left, w - bottom_blob.w - pad_left, 0, 0.f, opt_b);
 
     const float* bias = _bias;
 
@@ -739,7 +739,7 @@ static void conv3x3s1_winograd23_sse(const Mat& bottom_blob, Mat& top_blob, cons
     copy_cut_border(top_blob_bordered, top_blob, 0, top_blob_bordered.h - top_blob.h, 0, top_blob_bordered.w - top_blob.w, opt);
 }
 
-static void conv3x3s1_winograd43_transform_kernel_sse(const Mat& kernel, std::vector<Mat> &kernel_tm2, int inch, int outch)
+static void conv3x3s1_winograd43_transform_kernel_sse(const Mat& kernel, std::vector<Mat> &kernel_tm2, int inch, int outch, const Option& opt)
 {
     Mat kernel_tm(6*6, inch, outch);
 
@@ -753,7 +753,7 @@ static void conv3x3s1_winograd43_transform_kernel_sse(const Mat& kernel, std::ve
         {    0.0f,     0.0f,    1.0f}
     };
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opt.num_threads)
     for (int p = 0; p<outch; p++)
     {
         for (int q = 0; q<inch; q++)
@@ -920,7 +920,7 @@ static void conv3x3s1_winograd43_transform_kernel_sse(const Mat& kernel, std::ve
     }    
 }
 
-static void conv3x3s1_winograd43_sse(const Mat& bottom_blob, Mat& top_blob, const std::vector<Mat> &kernel_tm_test, const Mat& _bias, const Option& opt)
+static void conv3x3s1_winograd43_sse(const Mat& bottom_blob, Mat& top_blob, const std::vector<Mat> &kernel_tm_test, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
 {
     int w = bottom_blob.w;
     int h = bottom_blob.h;
@@ -933,7 +933,7 @@ static void conv3x3s1_winograd43_sse(const Mat& bottom_blob, Mat& top_blob, cons
     size_t elemsize = bottom_blob.elemsize;
     const float* bias = _bias;    
 
-    // pad to 4n+2, winograd F(4,3)
+    // pad to 4n+2, winograd F(4,3), the convolution padding is applied in the same copy
     Mat bottom_blob_bordered = bottom_blob;
 
     outw = (outw + 3) / 4 * 4;
@@ -944,7 +944,7 @@ static void conv3x3s1_winograd43_sse(const Mat& bottom_blob, Mat& top_blob, cons
 
     Option opt_b = opt;
     opt_b.blob_allocator = opt.workspace_allocator;
-    copy_make_border(bottom_blob, bottom_blob_bordered, 0, h - bottom_blob.h, 0, w - bottom_blob.w, 0, 0.f, opt_b);
+    copy_make_border(bottom_blob, bottom_blob_bordered, pad_top, h - bottom_blob.h - pad_top, pad_left, w - bottom_blob.w - pad_left, 0, 0.f, opt_b);
 
     // BEGIN transform input
     Mat bottom_blob_tm;
@@ -1606,7 +1606,7 @@ static void conv3x3s1_winograd43_sse(const Mat& bottom_blob, Mat& top_blob, cons
 #else
                         _sum0 = _mm_add_ps(_sum0, _mm_mul_ps(_r0, _k0));
 #endif
-                        kptr += 16;
+                        kptr += 4;
                         r0 += 4;
                     }
                     _mm_storeu_ps(output0_tm, _sum0);
@@ -1617,9 +1617,9 @@ static void conv3x3s1_winograd43_sse(const Mat& bottom_blob, Mat& top_blob, cons
                     {
                         for (int n=0; n<4; n++)
                         {
-                            sum0[n] += (int)r0[n] * kptr[n];
+                            sum0[n] += r0[n] * kptr[n];
                         }
-                        kptr += 4; 
+                        kptr += 4;
                         r0 += 4;
                     }
 
@@ -1776,6 +1776,542 @@ static void conv3x3s1_winograd43_sse(const Mat& bottom_blob, Mat& top_blob, cons
     copy_cut_border(top_blob_bordered, top_blob, 0, top_blob_bordered.h - top_blob.h, 0, top_blob_bordered.w - top_blob.w, opt);
 }
 
+// winograd F(6,3), U = G g GT, V = BT d B, Y = AT M A
+// input and output transforms run with one tile per simd lane,
+// the 64 transform-domain products are each one sgemm over all tiles
+#if __AVX__
+static const int winograd63_lanes = 8;
+#elif __SSE2__
+static const int winograd63_lanes = 4;
+#else
+static const int winograd63_lanes = 1;
+#endif
+
+#if __AVX__
+static inline void winograd63_transpose8_avx(__m256* r)
+{
+    __m256 _t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    __m256 _t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 _t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    __m256 _t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 _t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    __m256 _t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 _t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    __m256 _t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+    __m256 _s0 = _mm256_shuffle_ps(_t0, _t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _s1 = _mm256_shuffle_ps(_t0, _t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _s2 = _mm256_shuffle_ps(_t1, _t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _s3 = _mm256_shuffle_ps(_t1, _t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _s4 = _mm256_shuffle_ps(_t4, _t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _s5 = _mm256_shuffle_ps(_t4, _t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _s6 = _mm256_shuffle_ps(_t5, _t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _s7 = _mm256_shuffle_ps(_t5, _t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    r[0] = _mm256_permute2f128_ps(_s0, _s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(_s1, _s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(_s2, _s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(_s3, _s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(_s0, _s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(_s1, _s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(_s2, _s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(_s3, _s7, 0x31);
+}
+
+// w = BT d, 8 -> 8
+static inline void winograd63_itrans_avx(const __m256* d, __m256* w, int wstep)
+{
+    const __m256 _v5_25 = _mm256_set1_ps(5.25f);
+    const __m256 _vm4_25 = _mm256_set1_ps(-4.25f);
+    const __m256 _vm1_25 = _mm256_set1_ps(-1.25f);
+    const __m256 _v0_25 = _mm256_set1_ps(0.25f);
+    const __m256 _vm2_5 = _mm256_set1_ps(-2.5f);
+    const __m256 _v0_5 = _mm256_set1_ps(0.5f);
+    const __m256 _v2 = _mm256_set1_ps(2.f);
+    const __m256 _v4 = _mm256_set1_ps(4.f);
+
+    w[0] = _mm256_fmadd_ps(_mm256_sub_ps(d[4], d[2]), _v5_25, _mm256_sub_ps(d[0], d[6]));
+    w[wstep * 7] = _mm256_fmadd_ps(_mm256_sub_ps(d[3], d[5]), _v5_25, _mm256_sub_ps(d[7], d[1]));
+
+    __m256 _t1 = _mm256_fmadd_ps(d[4], _vm4_25, _mm256_add_ps(d[2], d[6]));
+    __m256 _t2 = _mm256_fmadd_ps(d[3], _vm4_25, _mm256_add_ps(d[1], d[5]));
+    w[wstep] = _mm256_add_ps(_t1, _t2);
+    w[wstep * 2] = _mm256_sub_ps(_t1, _t2);
+
+    __m256 _t3 = _mm256_fmadd_ps(d[4], _vm1_25, _mm256_fmadd_ps(d[2], _v0_25, d[6]));
+    __m256 _t4 = _mm256_fmadd_ps(d[5], _v2, _mm256_fmadd_ps(d[3], _vm2_5, _mm256_mul_ps(d[1], _v0_5)));
+    w[wstep * 3] = _mm256_add_ps(_t3, _t4);
+    w[wstep * 4] = _mm256_sub_ps(_t3, _t4);
+
+    __m256 _t5 = _mm256_fmadd_ps(_mm256_fmadd_ps(d[4], _vm1_25, d[2]), _v4, d[6]);
+    __m256 _t6 = _mm256_fmadd_ps(d[5], _v0_5, _mm256_fmadd_ps(d[3], _vm2_5, _mm256_mul_ps(d[1], _v2)));
+    w[wstep * 5] = _mm256_add_ps(_t5, _t6);
+    w[wstep * 6] = _mm256_sub_ps(_t5, _t6);
+}
+
+// y = AT m, 8 -> 6
+static inline void winograd63_otrans_avx(const __m256* m, int mstep, __m256* y)
+{
+    const __m256 _v2 = _mm256_set1_ps(2.f);
+    const __m256 _v4 = _mm256_set1_ps(4.f);
+    const __m256 _v8 = _mm256_set1_ps(8.f);
+    const __m256 _v16 = _mm256_set1_ps(16.f);
+    const __m256 _v32 = _mm256_set1_ps(32.f);
+
+    __m256 _a1 = _mm256_add_ps(m[mstep], m[mstep * 2]);
+    __m256 _b1 = _mm256_sub_ps(m[mstep], m[mstep * 2]);
+    __m256 _a2 = _mm256_add_ps(m[mstep * 3], m[mstep * 4]);
+    __m256 _b2 = _mm256_sub_ps(m[mstep * 3], m[mstep * 4]);
+    __m256 _a3 = _mm256_add_ps(m[mstep * 5], m[mstep * 6]);
+    __m256 _b3 = _mm256_sub_ps(m[mstep * 5], m[mstep * 6]);
+
+    y[0] = _mm256_fmadd_ps(_a3, _v32, _mm256_add_ps(_mm256_add_ps(m[0], _a1), _a2));
+    y[1] = _mm256_fmadd_ps(_b3, _v16, _mm256_fmadd_ps(_b2, _v2, _b1));
+    y[2] = _mm256_fmadd_ps(_a3, _v8, _mm256_fmadd_ps(_a2, _v4, _a1));
+    y[3] = _mm256_fmadd_ps(_b3, _v4, _mm256_fmadd_ps(_b2, _v8, _b1));
+    y[4] = _mm256_fmadd_ps(_a3, _v2, _mm256_fmadd_ps(_a2, _v16, _a1));
+    y[5] = _mm256_add_ps(_mm256_fmadd_ps(_b2, _v32, _mm256_add_ps(m[mstep * 7], _b1)), _b3);
+}
+#elif __SSE2__
+static inline void winograd63_itrans_sse(const __m128* d, __m128* w, int wstep)
+{
+    const __m128 _v5_25 = _mm_set1_ps(5.25f);
+    const __m128 _v4_25 = _mm_set1_ps(4.25f);
+    const __m128 _v1_25 = _mm_set1_ps(1.25f);
+    const __m128 _v0_25 = _mm_set1_ps(0.25f);
+    const __m128 _v2_5 = _mm_set1_ps(2.5f);
+    const __m128 _v0_5 = _mm_set1_ps(0.5f);
+    const __m128 _v2 = _mm_set1_ps(2.f);
+    const __m128 _v4 = _mm_set1_ps(4.f);
+
+    w[0] = _mm_add_ps(_mm_sub_ps(d[0], d[6]), _mm_mul_ps(_mm_sub_ps(d[4], d[2]), _v5_25));
+    w[wstep * 7] = _mm_add_ps(_mm_sub_ps(d[7], d[1]), _mm_mul_ps(_mm_sub_ps(d[3], d[5]), _v5_25));
+
+    __m128 _t1 = _mm_sub_ps(_mm_add_ps(d[2], d[6]), _mm_mul_ps(d[4], _v4_25));
+    __m128 _t2 = _mm_sub_ps(_mm_add_ps(d[1], d[5]), _mm_mul_ps(d[3], _v4_25));
+    w[wstep] = _mm_add_ps(_t1, _t2);
+    w[wstep * 2] = _mm_sub_ps(_t1, _t2);
+
+    __m128 _t3 = _mm_sub_ps(_mm_add_ps(d[6], _mm_mul_ps(d[2], _v0_25)), _mm_mul_ps(d[4], _v1_25));
+    __m128 _t4 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(d[1], _v0_5), _mm_mul_ps(d[3], _v2_5)), _mm_mul_ps(d[5], _v2));
+    w[wstep * 3] = _mm_add_ps(_t3, _t4);
+    w[wstep * 4] = _mm_sub_ps(_t3, _t4);
+
+    __m128 _t5 = _mm_add_ps(d[6], _mm_mul_ps(_mm_sub_ps(d[2], _mm_mul_ps(d[4], _v1_25)), _v4));
+    __m128 _t6 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(d[1], _v2), _mm_mul_ps(d[3], _v2_5)), _mm_mul_ps(d[5], _v0_5));
+    w[wstep * 5] = _mm_add_ps(_t5, _t6);
+    w[wstep * 6] = _mm_sub_ps(_t5, _t6);
+}
+
+static inline void winograd63_otrans_sse(const __m128* m, int mstep, __m128* y)
+{
+    const __m128 _v2 = _mm_set1_ps(2.f);
+    const __m128 _v4 = _mm_set1_ps(4.f);
+    const __m128 _v8 = _mm_set1_ps(8.f);
+    const __m128 _v16 = _mm_set1_ps(16.f);
+    const __m128 _v32 = _mm_set1_ps(32.f);
+
+    __m128 _a1 = _mm_add_ps(m[mstep], m[mstep * 2]);
+    __m128 _b1 = _mm_sub_ps(m[mstep], m[mstep * 2]);
+    __m128 _a2 = _mm_add_ps(m[mstep * 3], m[mstep * 4]);
+    __m128 _b2 = _mm_sub_ps(m[mstep * 3], m[mstep * 4]);
+    __m128 _a3 = _mm_add_ps(m[mstep * 5], m[mstep * 6]);
+    __m128 _b3 = _mm_sub_ps(m[mstep * 5], m[mstep * 6]);
+
+    y[0] = _mm_add_ps(_mm_add_ps(_mm_add_ps(m[0], _a1), _a2), _mm_mul_ps(_a3, _v32));
+    y[1] = _mm_add_ps(_mm_add_ps(_b1, _mm_mul_ps(_b2, _v2)), _mm_mul_ps(_b3, _v16));
+    y[2] = _mm_add_ps(_mm_add_ps(_a1, _mm_mul_ps(_a2, _v4)), _mm_mul_ps(_a3, _v8));
+    y[3] = _mm_add_ps(_mm_add_ps(_b1, _mm_mul_ps(_b2, _v8)), _mm_mul_ps(_b3, _v4));
+    y[4] = _mm_add_ps(_mm_add_ps(_a1, _mm_mul_ps(_a2, _v16)), _mm_mul_ps(_a3, _v2));
+    y[5] = _mm_add_ps(_mm_add_ps(_mm_add_ps(m[mstep * 7], _b1), _mm_mul_ps(_b2, _v32)), _b3);
+}
+#else
+static inline void winograd63_itrans(const float* d, float* w, int wstep)
+{
+    w[0] = d[0] - d[6] + (d[4] - d[2]) * 5.25f;
+    w[wstep * 7] = d[7] - d[1] + (d[3] - d[5]) * 5.25f;
+
+    float t1 = d[2] + d[6] - d[4] * 4.25f;
+    float t2 = d[1] + d[5] - d[3] * 4.25f;
+    w[wstep] = t1 + t2;
+    w[wstep * 2] = t1 - t2;
+
+    float t3 = d[6] + d[2] * 0.25f - d[4] * 1.25f;
+    float t4 = d[1] * 0.5f - d[3] * 2.5f + d[5] * 2.f;
+    w[wstep * 3] = t3 + t4;
+    w[wstep * 4] = t3 - t4;
+
+    float t5 = d[6] + (d[2] - d[4] * 1.25f) * 4.f;
+    float t6 = d[1] * 2.f - d[3] * 2.5f + d[5] * 0.5f;
+    w[wstep * 5] = t5 + t6;
+    w[wstep * 6] = t5 - t6;
+}
+
+static inline void winograd63_otrans(const float* m, int mstep, float* y)
+{
+    float a1 = m[mstep] + m[mstep * 2];
+    float b1 = m[mstep] - m[mstep * 2];
+    float a2 = m[mstep * 3] + m[mstep * 4];
+    float b2 = m[mstep * 3] - m[mstep * 4];
+    float a3 = m[mstep * 5] + m[mstep * 6];
+    float b3 = m[mstep * 5] - m[mstep * 6];
+
+    y[0] = m[0] + a1 + a2 + a3 * 32;
+    y[1] = b1 + b2 * 2 + b3 * 16;
+    y[2] = a1 + a2 * 4 + a3 * 8;
+    y[3] = b1 + b2 * 8 + b3 * 4;
+    y[4] = a1 + a2 * 16 + a3 * 2;
+    y[5] = m[mstep * 7] + b1 + b2 * 32 + b3;
+}
+#endif // __AVX__
+
+static void conv3x3s1_winograd63_transform_kernel_sse(const Mat& kernel, std::vector<Mat>& kernel_tm2, int inch, int outch, const Option& opt)
+{
+    Mat kernel_tm(8*8, inch, outch);
+
+    // G
+    const float ktm[8][3] = {
+        {    1.0f,     0.0f,     0.0f},
+        {-2.0f/9,  -2.0f/9,  -2.0f/9},
+        {-2.0f/9,   2.0f/9,  -2.0f/9},
+        {1.0f/90,  1.0f/45,  2.0f/45},
+        {1.0f/90, -1.0f/45,  2.0f/45},
+        {1.0f/45,  1.0f/90, 1.0f/180},
+        {1.0f/45, -1.0f/90, 1.0f/180},
+        {    0.0f,     0.0f,     1.0f}
+    };
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p<outch; p++)
+    {
+        for (int q = 0; q<inch; q++)
+        {
+            const float* kernel0 = (const float*)kernel + p*inch * 9 + q * 9;
+            float* kernel_tm0 = kernel_tm.channel(p).row(q);
+
+            // G g
+            float tmp[8][3];
+            for (int i=0; i<8; i++)
+            {
+                for (int j=0; j<3; j++)
+                {
+                    tmp[i][j] = ktm[i][0] * kernel0[j] + ktm[i][1] * kernel0[3 + j] + ktm[i][2] * kernel0[6 + j];
+                }
+            }
+
+            // U = G g GT
+            for (int i=0; i<8; i++)
+            {
+                for (int j=0; j<8; j++)
+                {
+                    kernel_tm0[i*8 + j] = tmp[i][0] * ktm[j][0] + tmp[i][1] * ktm[j][1] + tmp[i][2] * ktm[j][2];
+                }
+            }
+        }
+    }
+
+    // one outch x inch sgemm A matrix per transform position
+    kernel_tm2.resize(64);
+    for (int r=0; r<64; r++)
+    {
+        sgemm_pack_a((const float*)kernel_tm + r, (int)kernel_tm.cstep, 64, outch, inch, kernel_tm2[r], 0);
+    }
+}
+
+static void conv3x3s1_winograd63_sse(const Mat& bottom_blob, Mat& top_blob, const std::vector<Mat>& kernel_tm, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const float* bias = _bias;
+
+    // pad to 6n+2, winograd F(6,3), the convolution padding is applied in the same copy
+    Mat bottom_blob_bordered = bottom_blob;
+
+    outw = (outw + 5) / 6 * 6;
+    outh = (outh + 5) / 6 * 6;
+
+    w = outw + 2;
+    h = outh + 2;
+
+    Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+    copy_make_border(bottom_blob, bottom_blob_bordered, pad_top, h - bottom_blob.h - pad_top, pad_left, w - bottom_blob.w - pad_left, 0, 0.f, opt_b);
+
+    const int nRowBlocks = outw / 6;
+    const int nColBlocks = outh / 6;
+    const int tiles = nColBlocks * nRowBlocks;
+
+    // walk the tiles in blocks small enough for the transform-domain data to stay in cache,
+    // tiles are the sgemm N dimension so a block is a whole number of B panels
+    int tile_block = (512 * 1024) / (64 * 4 * std::max(inch, outch));
+    tile_block = std::max(tile_block / sgemm_nr, 2) * sgemm_nr;
+    tile_block = std::min(tile_block, (tiles + sgemm_nr - 1) / sgemm_nr * sgemm_nr);
+
+    Mat bottom_blob_tm(sgemm_nr * inch, tile_block / sgemm_nr, 64, (size_t)4u, opt.workspace_allocator);
+    Mat top_blob_tm(tile_block, outch, 64, (size_t)4u, opt.workspace_allocator);
+
+    Mat top_blob_bordered;
+    if (outw == top_blob.w && outh == top_blob.h)
+    {
+        top_blob_bordered = top_blob;
+    }
+    else
+    {
+        top_blob_bordered.create(outw, outh, outch, (size_t)4u, opt.workspace_allocator);
+    }
+
+    for (int tb=0; tb<tiles; tb+=tile_block)
+    {
+        const int nt = std::min(tile_block, tiles - tb);
+        const int ngroups = (nt + winograd63_lanes - 1) / winograd63_lanes;
+
+        // BEGIN transform input
+        {
+            const int tm_cstep = (int)bottom_blob_tm.cstep;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int gq=0; gq<ngroups * inch; gq++)
+            {
+                const int n0 = gq / inch * winograd63_lanes;
+                const int q = gq % inch;
+
+                const float* img = bottom_blob_bordered.channel(q);
+
+                // the tail group repeats the last tile into the padded panel columns
+                const float* r0[winograd63_lanes];
+                for (int t=0; t<winograd63_lanes; t++)
+                {
+                    const int n = tb + std::min(n0 + t, nt - 1);
+                    r0[t] = img + n / nRowBlocks * 6 * w + n % nRowBlocks * 6;
+                }
+
+                float* outptr = (float*)bottom_blob_tm.channel(0).row(n0 / sgemm_nr) + q * sgemm_nr + n0 % sgemm_nr;
+
+#if __AVX__
+                __m256 _tmp[8][8];
+                for (int i=0; i<8; i++)
+                {
+                    __m256 _d[8];
+                    for (int t=0; t<8; t++)
+                    {
+                        _d[t] = _mm256_loadu_ps(r0[t] + i * w);
+                    }
+
+                    winograd63_transpose8_avx(_d);
+
+                    winograd63_itrans_avx(_d, &_tmp[0][i], 8);
+                }
+
+                for (int j=0; j<8; j++)
+                {
+                    __m256 _v[8];
+                    winograd63_itrans_avx(_tmp[j], _v, 1);
+
+                    for (int i=0; i<8; i++)
+                    {
+                        _mm256_storeu_ps(outptr + (i * 8 + j) * tm_cstep, _v[i]);
+                    }
+                }
+#elif __SSE2__
+                __m128 _tmp[8][8];
+                for (int i=0; i<8; i++)
+                {
+                    __m128 _d[8];
+                    for (int t=0; t<4; t++)
+                    {
+                        _d[t] = _mm_loadu_ps(r0[t] + i * w);
+                        _d[t + 4] = _mm_loadu_ps(r0[t] + i * w + 4);
+                    }
+
+                    _MM_TRANSPOSE4_PS(_d[0], _d[1], _d[2], _d[3]);
+                    _MM_TRANSPOSE4_PS(_d[4], _d[5], _d[6], _d[7]);
+
+                    winograd63_itrans_sse(_d, &_tmp[0][i], 8);
+                }
+
+                for (int j=0; j<8; j++)
+                {
+                    __m128 _v[8];
+                    winograd63_itrans_sse(_tmp[j], _v, 1);
+
+                    for (int i=0; i<8; i++)
+                    {
+                        _mm_storeu_ps(outptr + (i * 8 + j) * tm_cstep, _v[i]);
+                    }
+                }
+#else
+                float tmp[8][8];
+                for (int i=0; i<8; i++)
+                {
+                    winograd63_itrans(r0[0] + i * w, &tmp[0][i], 8);
+                }
+
+                for (int j=0; j<8; j++)
+                {
+                    float v[8];
+                    winograd63_itrans(tmp[j], v, 1);
+
+                    for (int i=0; i<8; i++)
+                    {
+                        outptr[(i * 8 + j) * tm_cstep] = v[i];
+                    }
+                }
+#endif // __AVX__
+            }
+        }
+        // END transform input
+
+        // BEGIN dot
+        // the 64 products are independent, one single threaded sgemm each
+        {
+            Option opt_g = opt;
+            opt_g.num_threads = 1;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int r=0; r<64; r++)
+            {
+                sgemm(outch, nt, inch, kernel_tm[r], bottom_blob_tm.channel(r), 0, top_blob_tm.channel(r), top_blob_tm.w, 1, opt_g);
+            }
+        }
+        // END dot
+
+        // BEGIN transform output
+        {
+            const int tm_cstep = (int)top_blob_tm.cstep;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int gp=0; gp<ngroups * outch; gp++)
+            {
+                const int n0 = gp / outch * winograd63_lanes;
+                const int p = gp % outch;
+
+                const float bias0 = bias ? bias[p] : 0.f;
+
+                const float* inptr = (const float*)top_blob_tm.channel(0).row(p) + n0;
+
+                float* out = top_blob_bordered.channel(p);
+
+                float y[6][6][winograd63_lanes];
+
+#if __AVX__
+                __m256 _m[8][8];
+                for (int r=0; r<64; r++)
+                {
+                    _m[r / 8][r % 8] = _mm256_loadu_ps(inptr + r * tm_cstep);
+                }
+
+                __m256 _tmp[6][8];
+                for (int i=0; i<8; i++)
+                {
+                    __m256 _t[6];
+                    winograd63_otrans_avx(_m[i], 1, _t);
+
+                    for (int j=0; j<6; j++)
+                    {
+                        _tmp[j][i] = _t[j];
+                    }
+                }
+
+                const __m256 _bias0 = _mm256_set1_ps(bias0);
+                for (int j=0; j<6; j++)
+                {
+                    __m256 _y[6];
+                    winograd63_otrans_avx(_tmp[j], 1, _y);
+
+                    for (int i=0; i<6; i++)
+                    {
+                        _mm256_storeu_ps(y[i][j], _mm256_add_ps(_y[i], _bias0));
+                    }
+                }
+#elif __SSE2__
+                __m128 _m[8][8];
+                for (int r=0; r<64; r++)
+                {
+                    _m[r / 8][r % 8] = _mm_loadu_ps(inptr + r * tm_cstep);
+                }
+
+                __m128 _tmp[6][8];
+                for (int i=0; i<8; i++)
+                {
+                    __m128 _t[6];
+                    winograd63_otrans_sse(_m[i], 1, _t);
+
+                    for (int j=0; j<6; j++)
+                    {
+                        _tmp[j][i] = _t[j];
+                    }
+                }
+
+                const __m128 _bias0 = _mm_set1_ps(bias0);
+                for (int j=0; j<6; j++)
+                {
+                    __m128 _y[6];
+                    winograd63_otrans_sse(_tmp[j], 1, _y);
+
+                    for (int i=0; i<6; i++)
+                    {
+                        _mm_storeu_ps(y[i][j], _mm_add_ps(_y[i], _bias0));
+                    }
+                }
+#else
+                float tmp[6][8];
+                for (int i=0; i<8; i++)
+                {
+                    float t[6];
+                    winograd63_otrans(inptr + i * 8 * tm_cstep, tm_cstep, t);
+
+                    for (int j=0; j<6; j++)
+                    {
+                        tmp[j][i] = t[j];
+                    }
+                }
+
+                for (int j=0; j<6; j++)
+                {
+                    float yj[6];
+                    winograd63_otrans(tmp[j], 1, yj);
+
+                    for (int i=0; i<6; i++)
+                    {
+                        y[i][j][0] = yj[i] + bias0;
+                    }
+                }
+#endif // __AVX__
+
+                const int nlanes = std::min(winograd63_lanes, nt - n0);
+                for (int t=0; t<nlanes; t++)
+                {
+                    const int n = tb + n0 + t;
+                    float* outptr = out + n / nRowBlocks * 6 * outw + n % nRowBlocks * 6;
+
+                    for (int i=0; i<6; i++)
+                    {
+                        for (int j=0; j<6; j++)
+                        {
+                            outptr[j] = y[i][j][t];
+                        }
+
+                        outptr += outw;
+                    }
+                }
+            }
+        }
+        // END transform output
+    }
+
+    // cut result pad
+    if (top_blob_bordered.data != top_blob.data)
+    {
+        copy_cut_border(top_blob_bordered, top_blob, 0, top_blob_bordered.h - top_blob.h, 0, top_blob_bordered.w - top_blob.w, opt);
+    }
+}
+
 static void conv3x3s2_sse(const Mat &bottom_blob, Mat &top_blob, const Mat &_kernel, const Mat& _bias, const Option& opt)
 {
     int w = bottom_blob.w;
@@ -0,0 +1,757 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// weight layout of the pack8 kernels, one channel per output block, one row per input block
+// pack8to8  outch/8 - inch/8 - maxk - 8 input lanes - 8 output lanes
+// pack1to8  outch/8 - inch   - maxk - 8 output lanes
+// pack8to1  outch   - inch/8 - maxk - 8 input lanes
+static void conv_transform_kernel_pack8_avx(const Mat& _kernel, Mat& kernel_tm, int inch, int outch, int maxk, int elempack, int out_elempack)
+{
+    const float* kernel = _kernel;
+
+    kernel_tm.create(maxk * elempack * out_elempack, inch / elempack, outch / out_elempack);
+
+    for (int q=0; q<outch / out_elempack; q++)
+    {
+        float* g0 = kernel_tm.channel(q);
+
+        for (int p=0; p<inch / elempack; p++)
+        {
+            for (int k=0; k<maxk; k++)
+            {
+                for (int i=0; i<elempack; i++)
+                {
+                    for (int o=0; o<out_elempack; o++)
+                    {
+                        *g0++ = kernel[((q * out_elempack + o) * inch + p * elempack + i) * maxk + k];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// kernel offsets in floats for an input of width w and elempack lanes
+static void conv_space_ofs_pack8(int* space_ofs, int w, int elempack, int kernel_w, int kernel_h, int dilation_w, int dilation_h)
+{
+    int p1 = 0;
+    for (int y=0; y<kernel_h; y++)
+    {
+        for (int x=0; x<kernel_w; x++)
+        {
+            space_ofs[p1++] = (y * dilation_h * w + x * dilation_w) * elempack;
+        }
+    }
+}
+
+// output pixel whose window is partially outside the input, padding contributes zero
+// kptr points at the weights of one output block
+static __m256 conv_window_pack8_avx(const Mat& bottom_blob, int sx, int sy, const float* kptr, int kernel_w, int kernel_h, int dilation_w, int dilation_h, __m256 _sum)
+{
+    const int maxk = kernel_w * kernel_h;
+
+    for (int p=0; p<bottom_blob.c; p++)
+    {
+        const Mat m = bottom_blob.channel(p);
+
+        for (int y=0; y<kernel_h; y++)
+        {
+            int sy1 = sy + y * dilation_h;
+            if (sy1 < 0 || sy1 >= m.h)
+                continue;
+
+            for (int x=0; x<kernel_w; x++)
+            {
+                int sx1 = sx + x * dilation_w;
+                if (sx1 < 0 || sx1 >= m.w)
+                    continue;
+
+                const float* s = m.row(sy1) + sx1 * 8;
+                const float* k0 = kptr + (p * maxk + y * kernel_w + x) * 64;
+
+                for (int l=0; l<8; l++)
+                {
+                    _sum = _mm256_fmadd_ps(_mm256_broadcast_ss(s + l), _mm256_loadu_ps(k0 + l * 8), _sum);
+                }
+            }
+        }
+    }
+
+    return _sum;
+}
+
+static __m256 conv_window_pack1to8_avx(const Mat& bottom_blob, int sx, int sy, const float* kptr, int kernel_w, int kernel_h, int dilation_w, int dilation_h, __m256 _sum)
+{
+    const int maxk = kernel_w * kernel_h;
+
+    for (int p=0; p<bottom_blob.c; p++)
+    {
+        const Mat m = bottom_blob.channel(p);
+
+        for (int y=0; y<kernel_h; y++)
+        {
+            int sy1 = sy + y * dilation_h;
+            if (sy1 < 0 || sy1 >= m.h)
+                continue;
+
+            for (int x=0; x<kernel_w; x++)
+            {
+                int sx1 = sx + x * dilation_w;
+                if (sx1 < 0 || sx1 >= m.w)
+                    continue;
+
+                _sum = _mm256_fmadd_ps(_mm256_broadcast_ss(m.row(sy1) + sx1), _mm256_loadu_ps(kptr + (p * maxk + y * kernel_w + x) * 8), _sum);
+            }
+        }
+    }
+
+    return _sum;
+}
+
+static float conv_window_pack8to1_avx(const Mat& bottom_blob, int sx, int sy, const float* kptr, int kernel_w, int kernel_h, int dilation_w, int dilation_h, float sum)
+{
+    const int maxk = kernel_w * kernel_h;
+
+    __m256 _sum = _mm256_setzero_ps();
+
+    for (int p=0; p<bottom_blob.c; p++)
+    {
+        const Mat m = bottom_blob.channel(p);
+
+        for (int y=0; y<kernel_h; y++)
+        {
+            int sy1 = sy + y * dilation_h;
+            if (sy1 < 0 || sy1 >= m.h)
+                continue;
+
+            for (int x=0; x<kernel_w; x++)
+            {
+                int sx1 = sx + x * dilation_w;
+                if (sx1 < 0 || sx1 >= m.w)
+                    continue;
+
+                _sum = _mm256_fmadd_ps(_mm256_loadu_ps(m.row(sy1) + sx1 * 8), _mm256_loadu_ps(kptr + (p * maxk + y * kernel_w + x) * 8), _sum);
+            }
+        }
+    }
+
+    __m128 _ss = _mm_add_ps(_mm256_castps256_ps128(_sum), _mm256_extractf128_ps(_sum, 1));
+    _ss = _mm_add_ps(_ss, _mm_movehl_ps(_ss, _ss));
+    _ss = _mm_add_ss(_ss, _mm_shuffle_ps(_ss, _ss, 1));
+
+    return sum + _mm_cvtss_f32(_ss);
+}
+
+static void conv_pack8_avx(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_tm, const Mat& _bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int pad_left, int pad_top, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const float* bias = _bias;
+
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    conv_space_ofs_pack8(space_ofs, w, 8, kernel_w, kernel_h, dilation_w, dilation_h);
+
+    const float* bottom = bottom_blob;
+    const size_t bottom_cstep = bottom_blob.cstep * 8;
+    const int step = stride_w * 8;
+
+    // output columns whose window lies inside the input
+    int jstart = std::min(std::max((pad_left + stride_w - 1) / stride_w, 0), outw);
+    int jend = w - kernel_extent_w + pad_left < 0 ? 0 : std::min((w - kernel_extent_w + pad_left) / stride_w + 1, outw);
+    jend = std::max(jend, jstart);
+
+    // two output blocks share every broadcast input lane
+    int nn_outch = outch >> 1;
+    int remain_outch_start = nn_outch << 1;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp=0; pp<nn_outch; pp++)
+    {
+        int q = pp * 2;
+
+        float* outptr0 = top_blob.channel(q);
+        float* outptr1 = top_blob.channel(q + 1);
+
+        const __m256 _bias0 = bias ? _mm256_loadu_ps(bias + q * 8) : _mm256_setzero_ps();
+        const __m256 _bias1 = bias ? _mm256_loadu_ps(bias + q * 8 + 8) : _mm256_setzero_ps();
+
+        const float* kernel0 = kernel_tm.channel(q);
+        const float* kernel1 = kernel_tm.channel(q + 1);
+
+        for (int i=0; i<outh; i++)
+        {
+            int sy = i * stride_h - pad_top;
+
+            // border rows run every column through the clipped window
+            const bool inside = sy >= 0 && sy + kernel_extent_h <= h;
+            const int j0 = inside ? jstart : outw;
+            const int j1 = inside ? jend : outw;
+
+            for (int j=0; j<j0; j++)
+            {
+                _mm256_storeu_ps(outptr0, conv_window_pack8_avx(bottom_blob, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, _bias0));
+                _mm256_storeu_ps(outptr1, conv_window_pack8_avx(bottom_blob, j * stride_w - pad_left, sy, kernel1, kernel_w, kernel_h, dilation_w, dilation_h, _bias1));
+
+                outptr0 += 8;
+                outptr1 += 8;
+            }
+
+            const int row_ofs = sy * w * 8;
+
+            int j = j0;
+            for (; j+5<j1; j+=6)
+            {
+                __m256 _sum00 = _bias0;
+                __m256 _sum01 = _bias0;
+                __m256 _sum02 = _bias0;
+                __m256 _sum03 = _bias0;
+                __m256 _sum04 = _bias0;
+                __m256 _sum05 = _bias0;
+                __m256 _sum10 = _bias1;
+                __m256 _sum11 = _bias1;
+                __m256 _sum12 = _bias1;
+                __m256 _sum13 = _bias1;
+                __m256 _sum14 = _bias1;
+                __m256 _sum15 = _bias1;
+
+                const float* k0 = kernel0;
+                const float* k1 = kernel1;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + (j * stride_w - pad_left) * 8;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        const float* s = sptr + space_ofs[k];
+
+                        for (int l=0; l<8; l++)
+                        {
+                            __m256 _w0 = _mm256_loadu_ps(k0 + l * 8);
+                            __m256 _w1 = _mm256_loadu_ps(k1 + l * 8);
+
+                            __m256 _v = _mm256_broadcast_ss(s + l);
+                            _sum00 = _mm256_fmadd_ps(_v, _w0, _sum00);
+                            _sum10 = _mm256_fmadd_ps(_v, _w1, _sum10);
+                            _v = _mm256_broadcast_ss(s + step + l);
+                            _sum01 = _mm256_fmadd_ps(_v, _w0, _sum01);
+                            _sum11 = _mm256_fmadd_ps(_v, _w1, _sum11);
+                            _v = _mm256_broadcast_ss(s + step * 2 + l);
+                            _sum02 = _mm256_fmadd_ps(_v, _w0, _sum02);
+                            _sum12 = _mm256_fmadd_ps(_v, _w1, _sum12);
+                            _v = _mm256_broadcast_ss(s + step * 3 + l);
+                            _sum03 = _mm256_fmadd_ps(_v, _w0, _sum03);
+                            _sum13 = _mm256_fmadd_ps(_v, _w1, _sum13);
+                            _v = _mm256_broadcast_ss(s + step * 4 + l);
+                            _sum04 = _mm256_fmadd_ps(_v, _w0, _sum04);
+                            _sum14 = _mm256_fmadd_ps(_v, _w1, _sum14);
+                            _v = _mm256_broadcast_ss(s + step * 5 + l);
+                            _sum05 = _mm256_fmadd_ps(_v, _w0, _sum05);
+                            _sum15 = _mm256_fmadd_ps(_v, _w1, _sum15);
+                        }
+
+                        k0 += 64;
+                        k1 += 64;
+                    }
+                }
+
+                _mm256_storeu_ps(outptr0, _sum00);
+                _mm256_storeu_ps(outptr0 + 8, _sum01);
+                _mm256_storeu_ps(outptr0 + 16, _sum02);
+                _mm256_storeu_ps(outptr0 + 24, _sum03);
+                _mm256_storeu_ps(outptr0 + 32, _sum04);
+                _mm256_storeu_ps(outptr0 + 40, _sum05);
+                _mm256_storeu_ps(outptr1, _sum10);
+                _mm256_storeu_ps(outptr1 + 8, _sum11);
+                _mm256_storeu_ps(outptr1 + 16, _sum12);
+                _mm256_storeu_ps(outptr1 + 24, _sum13);
+                _mm256_storeu_ps(outptr1 + 32, _sum14);
+                _mm256_storeu_ps(outptr1 + 40, _sum15);
+
+                outptr0 += 48;
+                outptr1 += 48;
+            }
+            for (; j+3<j1; j+=4)
+            {
+                __m256 _sum00 = _bias0;
+                __m256 _sum01 = _bias0;
+                __m256 _sum02 = _bias0;
+                __m256 _sum03 = _bias0;
+                __m256 _sum10 = _bias1;
+                __m256 _sum11 = _bias1;
+                __m256 _sum12 = _bias1;
+                __m256 _sum13 = _bias1;
+
+                const float* k0 = kernel0;
+                const float* k1 = kernel1;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + (j * stride_w - pad_left) * 8;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        const float* s = sptr + space_ofs[k];
+
+                        for (int l=0; l<8; l++)
+                        {
+                            __m256 _w0 = _mm256_loadu_ps(k0 + l * 8);
+                            __m256 _w1 = _mm256_loadu_ps(k1 + l * 8);
+
+                            __m256 _v0 = _mm256_broadcast_ss(s + l);
+                            __m256 _v1 = _mm256_broadcast_ss(s + step + l);
+                            __m256 _v2 = _mm256_broadcast_ss(s + step * 2 + l);
+                            __m256 _v3 = _mm256_broadcast_ss(s + step * 3 + l);
+
+                            _sum00 = _mm256_fmadd_ps(_v0, _w0, _sum00);
+                            _sum01 = _mm256_fmadd_ps(_v1, _w0, _sum01);
+                            _sum02 = _mm256_fmadd_ps(_v2, _w0, _sum02);
+                            _sum03 = _mm256_fmadd_ps(_v3, _w0, _sum03);
+                            _sum10 = _mm256_fmadd_ps(_v0, _w1, _sum10);
+                            _sum11 = _mm256_fmadd_ps(_v1, _w1, _sum11);
+                            _sum12 = _mm256_fmadd_ps(_v2, _w1, _sum12);
+                            _sum13 = _mm256_fmadd_ps(_v3, _w1, _sum13);
+                        }
+
+                        k0 += 64;
+                        k1 += 64;
+                    }
+                }
+
+                _mm256_storeu_ps(outptr0, _sum00);
+                _mm256_storeu_ps(outptr0 + 8, _sum01);
+                _mm256_storeu_ps(outptr0 + 16, _sum02);
+                _mm256_storeu_ps(outptr0 + 24, _sum03);
+                _mm256_storeu_ps(outptr1, _sum10);
+                _mm256_storeu_ps(outptr1 + 8, _sum11);
+                _mm256_storeu_ps(outptr1 + 16, _sum12);
+                _mm256_storeu_ps(outptr1 + 24, _sum13);
+
+                outptr0 += 32;
+                outptr1 += 32;
+            }
+            for (; j<j1; j++)
+            {
+                __m256 _sum0 = _bias0;
+                __m256 _sum1 = _bias1;
+
+                const float* k0 = kernel0;
+                const float* k1 = kernel1;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + (j * stride_w - pad_left) * 8;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        const float* s = sptr + space_ofs[k];
+
+                        for (int l=0; l<8; l++)
+                        {
+                            __m256 _v = _mm256_broadcast_ss(s + l);
+
+                            _sum0 = _mm256_fmadd_ps(_v, _mm256_loadu_ps(k0 + l * 8), _sum0);
+                            _sum1 = _mm256_fmadd_ps(_v, _mm256_loadu_ps(k1 + l * 8), _sum1);
+                        }
+
+                        k0 += 64;
+                        k1 += 64;
+                    }
+                }
+
+                _mm256_storeu_ps(outptr0, _sum0);
+                _mm256_storeu_ps(outptr1, _sum1);
+
+                outptr0 += 8;
+                outptr1 += 8;
+            }
+            for (; j<outw; j++)
+            {
+                _mm256_storeu_ps(outptr0, conv_window_pack8_avx(bottom_blob, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, _bias0));
+                _mm256_storeu_ps(outptr1, conv_window_pack8_avx(bottom_blob, j * stride_w - pad_left, sy, kernel1, kernel_w, kernel_h, dilation_w, dilation_h, _bias1));
+
+                outptr0 += 8;
+                outptr1 += 8;
+            }
+        }
+    }
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=remain_outch_start; q<outch; q++)
+    {
+        float* outptr0 = top_blob.channel(q);
+
+        const __m256 _bias0 = bias ? _mm256_loadu_ps(bias + q * 8) : _mm256_setzero_ps();
+
+        const float* kernel0 = kernel_tm.channel(q);
+
+        for (int i=0; i<outh; i++)
+        {
+            int sy = i * stride_h - pad_top;
+
+            // border rows run every column through the clipped window
+            const bool inside = sy >= 0 && sy + kernel_extent_h <= h;
+            const int j0 = inside ? jstart : outw;
+            const int j1 = inside ? jend : outw;
+
+            for (int j=0; j<j0; j++)
+            {
+                _mm256_storeu_ps(outptr0, conv_window_pack8_avx(bottom_blob, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, _bias0));
+
+                outptr0 += 8;
+            }
+
+            const int row_ofs = sy * w * 8;
+
+            int j = j0;
+            for (; j+3<j1; j+=4)
+            {
+                __m256 _sum0 = _bias0;
+                __m256 _sum1 = _bias0;
+                __m256 _sum2 = _bias0;
+                __m256 _sum3 = _bias0;
+
+                const float* k0 = kernel0;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + (j * stride_w - pad_left) * 8;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        const float* s = sptr + space_ofs[k];
+
+                        for (int l=0; l<8; l++)
+                        {
+                            __m256 _w0 = _mm256_loadu_ps(k0 + l * 8);
+
+                            _sum0 = _mm256_fmadd_ps(_mm256_broadcast_ss(s + l), _w0, _sum0);
+                            _sum1 = _mm256_fmadd_ps(_mm256_broadcast_ss(s + step + l), _w0, _sum1);
+                            _sum2 = _mm256_fmadd_ps(_mm256_broadcast_ss(s + step * 2 + l), _w0, _sum2);
+                            _sum3 = _mm256_fmadd_ps(_mm256_broadcast_ss(s + step * 3 + l), _w0, _sum3);
+                        }
+
+                        k0 += 64;
+                    }
+                }
+
+                _mm256_storeu_ps(outptr0, _sum0);
+                _mm256_storeu_ps(outptr0 + 8, _sum1);
+                _mm256_storeu_ps(outptr0 + 16, _sum2);
+                _mm256_storeu_ps(outptr0 + 24, _sum3);
+
+                outptr0 += 32;
+            }
+            for (; j<j1; j++)
+            {
+                __m256 _sum = _bias0;
+
+                const float* k0 = kernel0;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + (j * stride_w - pad_left) * 8;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        const float* s = sptr + space_ofs[k];
+
+                        for (int l=0; l<8; l++)
+                        {
+                            _sum = _mm256_fmadd_ps(_mm256_broadcast_ss(s + l), _mm256_loadu_ps(k0 + l * 8), _sum);
+                        }
+
+                        k0 += 64;
+                    }
+                }
+
+                _mm256_storeu_ps(outptr0, _sum);
+
+                outptr0 += 8;
+            }
+            for (; j<outw; j++)
+            {
+                _mm256_storeu_ps(outptr0, conv_window_pack8_avx(bottom_blob, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, _bias0));
+
+                outptr0 += 8;
+            }
+        }
+    }
+}
+
+static void conv_pack1to8_avx(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_tm, const Mat& _bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int pad_left, int pad_top, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const float* bias = _bias;
+
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    conv_space_ofs_pack8(space_ofs, w, 1, kernel_w, kernel_h, dilation_w, dilation_h);
+
+    const float* bottom = bottom_blob;
+    const size_t bottom_cstep = bottom_blob.cstep;
+
+    // output columns whose window lies inside the input
+    int jstart = std::min(std::max((pad_left + stride_w - 1) / stride_w, 0), outw);
+    int jend = w - kernel_extent_w + pad_left < 0 ? 0 : std::min((w - kernel_extent_w + pad_left) / stride_w + 1, outw);
+    jend = std::max(jend, jstart);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<outch; q++)
+    {
+        float* outptr0 = top_blob.channel(q);
+
+        const __m256 _bias0 = bias ? _mm256_loadu_ps(bias + q * 8) : _mm256_setzero_ps();
+
+        const float* kernel0 = kernel_tm.channel(q);
+
+        for (int i=0; i<outh; i++)
+        {
+            int sy = i * stride_h - pad_top;
+
+            // border rows run every column through the clipped window
+            const bool inside = sy >= 0 && sy + kernel_extent_h <= h;
+            const int j0 = inside ? jstart : outw;
+            const int j1 = inside ? jend : outw;
+
+            for (int j=0; j<j0; j++)
+            {
+                _mm256_storeu_ps(outptr0, conv_window_pack1to8_avx(bottom_blob, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, _bias0));
+
+                outptr0 += 8;
+            }
+
+            const int row_ofs = sy * w;
+
+            int j = j0;
+            for (; j+3<j1; j+=4)
+            {
+                __m256 _sum0 = _bias0;
+                __m256 _sum1 = _bias0;
+                __m256 _sum2 = _bias0;
+                __m256 _sum3 = _bias0;
+
+                const float* k0 = kernel0;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + j * stride_w - pad_left;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        const float* s = sptr + space_ofs[k];
+
+                        __m256 _w0 = _mm256_loadu_ps(k0);
+
+                        _sum0 = _mm256_fmadd_ps(_mm256_broadcast_ss(s), _w0, _sum0);
+                        _sum1 = _mm256_fmadd_ps(_mm256_broadcast_ss(s + stride_w), _w0, _sum1);
+                        _sum2 = _mm256_fmadd_ps(_mm256_broadcast_ss(s + stride_w * 2), _w0, _sum2);
+                        _sum3 = _mm256_fmadd_ps(_mm256_broadcast_ss(s + stride_w * 3), _w0, _sum3);
+
+                        k0 += 8;
+                    }
+                }
+
+                _mm256_storeu_ps(outptr0, _sum0);
+                _mm256_storeu_ps(outptr0 + 8, _sum1);
+                _mm256_storeu_ps(outptr0 + 16, _sum2);
+                _mm256_storeu_ps(outptr0 + 24, _sum3);
+
+                outptr0 += 32;
+            }
+            for (; j<j1; j++)
+            {
+                __m256 _sum = _bias0;
+
+                const float* k0 = kernel0;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + j * stride_w - pad_left;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        _sum = _mm256_fmadd_ps(_mm256_broadcast_ss(sptr + space_ofs[k]), _mm256_loadu_ps(k0), _sum);
+
+                        k0 += 8;
+                    }
+                }
+
+                _mm256_storeu_ps(outptr0, _sum);
+
+                outptr0 += 8;
+            }
+            for (; j<outw; j++)
+            {
+                _mm256_storeu_ps(outptr0, conv_window_pack1to8_avx(bottom_blob, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, _bias0));
+
+                outptr0 += 8;
+            }
+        }
+    }
+}
+
+static void conv_pack8to1_avx(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_tm, const Mat& _bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int pad_left, int pad_top, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const float* bias = _bias;
+
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    conv_space_ofs_pack8(space_ofs, w, 8, kernel_w, kernel_h, dilation_w, dilation_h);
+
+    const float* bottom = bottom_blob;
+    const size_t bottom_cstep = bottom_blob.cstep * 8;
+    const int step = stride_w * 8;
+
+    // output columns whose window lies inside the input
+    int jstart = std::min(std::max((pad_left + stride_w - 1) / stride_w, 0), outw);
+    int jend = w - kernel_extent_w + pad_left < 0 ? 0 : std::min((w - kernel_extent_w + pad_left) / stride_w + 1, outw);
+    jend = std::max(jend, jstart);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<outch; q++)
+    {
+        float* outptr0 = top_blob.channel(q);
+
+        const float bias0 = bias ? bias[q] : 0.f;
+
+        const float* kernel0 = kernel_tm.channel(q);
+
+        for (int i=0; i<outh; i++)
+        {
+            int sy = i * stride_h - pad_top;
+
+            // border rows run every column through the clipped window
+            const bool inside = sy >= 0 && sy + kernel_extent_h <= h;
+            const int j0 = inside ? jstart : outw;
+            const int j1 = inside ? jend : outw;
+
+            for (int j=0; j<j0; j++)
+            {
+                *outptr0++ = conv_window_pack8to1_avx(bottom_blob, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, bias0);
+            }
+
+            const int row_ofs = sy * w * 8;
+
+            int j = j0;
+            for (; j+3<j1; j+=4)
+            {
+                // lane-wise partial sums, reduced once per pixel
+                __m256 _sum0 = _mm256_setzero_ps();
+                __m256 _sum1 = _mm256_setzero_ps();
+                __m256 _sum2 = _mm256_setzero_ps();
+                __m256 _sum3 = _mm256_setzero_ps();
+
+                const float* k0 = kernel0;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + (j * stride_w - pad_left) * 8;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        const float* s = sptr + space_ofs[k];
+
+                        __m256 _w0 = _mm256_loadu_ps(k0);
+
+                        _sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(s), _w0, _sum0);
+                        _sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(s + step), _w0, _sum1);
+                        _sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(s + step * 2), _w0, _sum2);
+                        _sum3 = _mm256_fmadd_ps(_mm256_loadu_ps(s + step * 3), _w0, _sum3);
+
+                        k0 += 8;
+                    }
+                }
+
+                // transpose-add the four sums into one vector of four pixels
+                __m256 _s01 = _mm256_hadd_ps(_sum0, _sum1);
+                __m256 _s23 = _mm256_hadd_ps(_sum2, _sum3);
+                __m256 _s0123 = _mm256_hadd_ps(_s01, _s23);
+                __m128 _ss = _mm_add_ps(_mm256_castps256_ps128(_s0123), _mm256_extractf128_ps(_s0123, 1));
+
+                _mm_storeu_ps(outptr0, _mm_add_ps(_ss, _mm_set1_ps(bias0)));
+
+                outptr0 += 4;
+            }
+            for (; j<j1; j++)
+            {
+                __m256 _sum = _mm256_setzero_ps();
+
+                const float* k0 = kernel0;
+
+                for (int p=0; p<inch; p++)
+                {
+                    const float* sptr = bottom + p * bottom_cstep + row_ofs + (j * stride_w - pad_left) * 8;
+
+                    for (int k=0; k<maxk; k++)
+                    {
+                        _sum = _mm256_fmadd_ps(_mm256_loadu_ps(sptr + space_ofs[k]), _mm256_loadu_ps(k0), _sum);
+
+                        k0 += 8;
+                    }
+                }
+
+                __m128 _ss = _mm_add_ps(_mm256_castps256_ps128(_sum), _mm256_extractf128_ps(_sum, 1));
+                _ss = _mm_add_ps(_ss, _mm_movehl_ps(_ss, _ss));
+                _ss = _mm_add_ss(_ss, _mm_shuffle_ps(_ss, _ss, 1));
+
+                *outptr0++ = bias0 + _mm_cvtss_f32(_ss);
+            }
+            for (; j<outw; j++)
+            {
+                *outptr0++ = conv_window_pack8to1_avx(bottom_blob, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, bias0);
+            }
+        }
+    }
+}
@@ -24,14 +24,20 @@
 
 #include "layer_type.h"
 #include "benchmark.h"
+#include "autotune.h"
+#include "quantize.h"
 
 namespace ncnn {
 
+#include "sgemm.h"
 #include "convolution_sgemm.h"
 #include "convolution_1x1.h"
 #include "convolution_3x3.h"
 #include "convolution_5x5.h"
 #include "convolution_7x7.h"
+#if __AVX__
+#include "convolution_pack8.h"
+#endif // __AVX__
 #include "convolution_sgemm_int8.h"
 #include "convolution_1x1_int8.h"
 #include "convolution_3x3_int8.h"
@@ -40,8 +46,165 @@ namespace ncnn {
 
 DEFINE_LAYER_CREATOR(Convolution_x86)
 
+// implementations, also the choices recorded by the autotuner
+static const int conv_impl_direct = 0;
+static const int conv_impl_sgemm = 1;
+static const int conv_impl_winograd23 = 2;
+static const int conv_impl_winograd43 = 3;
+static const int conv_impl_winograd63 = 4;
+static const int conv_impl_count = 5;
+
+typedef void (*conv_func)(const Mat&, Mat&, const Mat&, const Mat&, const Option&);
+
+// kernel_size x stride
+static const conv_func conv_func_table[7][4] =
+{
+    {
+        conv1x1s1_sse,
+        conv1x1s2_sse,
+        0,
+        0
+    }, // kernel_size = 1
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 2
+    {
+        conv3x3s1_sse,
+        conv3x3s2_sse,
+        0,
+        0
+    }, // kernel_size = 3
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 4
+    {
+        conv5x5s1_sse,
+        conv5x5s2_sse,
+        0,
+        0
+    }, // kernel_size = 5
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 6
+    {
+        conv7x7s1_sse,          
+        conv7x7s2_sse,          
+        0,
+        0
+    }  // kernel_size = 7        
+};
+
+typedef void (*conv_int8_dequant_func)(const Mat&, Mat&, const Mat&, const Mat&, std::vector<float>, const Option&);
+typedef void (*conv_int8_requant_func)(const Mat&, Mat&, const Mat&, const Mat&, std::vector<float>, const Option&);
+
+// kernel_size x stride
+static const conv_int8_dequant_func conv_int8_dequant_func_table[7][4] =
+{
+    {
+        conv1x1s1_int8_dequant_sse,
+        conv1x1s2_int8_dequant_sse,
+        0,
+        0
+    }, // kernel_size = 1
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 2
+    {
+        conv3x3s1_int8_dequant_sse,
+        conv3x3s2_int8_dequant_sse,
+        0,
+        0,
+    }, // kernel_size = 3
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 4
+    {        
+        conv5x5s1_int8_dequant_sse,
+        conv5x5s2_int8_dequant_sse,    
+        0,
+        0
+    }, // kernel_size = 5
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 6
+    {
+        conv7x7s1_int8_dequant_sse,          
+        conv7x7s2_int8_dequant_sse, 
+        0,
+        0
+    }  // kernel_size = 7
+};
+
+static const conv_int8_requant_func conv_int8_requant_func_table[7][4] =
+{
+    {
+        conv1x1s1_int8_requant_sse,
+        conv1x1s2_int8_requant_sse,
+        0,
+        0
+    }, // kernel_size = 1
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 2
+    {
+        conv3x3s1_int8_requant_sse,
+        conv3x3s2_int8_requant_sse,
+        0,
+        0,
+    }, // kernel_size = 3
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 4
+    {        
+        conv5x5s1_int8_requant_sse,
+        conv5x5s2_int8_requant_sse,    
+        0,
+        0
+    }, // kernel_size = 5
+    {
+        0,
+        0,
+        0,
+        0
+    }, // kernel_size = 6
+    {
+        conv7x7s1_int8_requant_sse,          
+        conv7x7s2_int8_requant_sse, 
+        0,
+        0
+    }  // kernel_size = 7
+};
+
 Convolution_x86::Convolution_x86()
 {
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+
     activation = 0;
 }
 
@@ -88,6 +251,7 @@ int Convolution_x86::create_pipeline(const Option& opt)
     }
 
     use_winograd3x3 = false;
+    winograd3x3_tile = 4;
 
     if (opt.use_winograd_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
     {
@@ -95,7 +259,18 @@ int Convolution_x86::create_pipeline(const Option& opt)
         // winograd is slow on small channel count
         if(num_input >= 16 && num_output >= 16)
             use_winograd3x3 = true;
-    }           
+
+#if __AVX__
+        // the avx F(2,3) kernel beats F(4,3) on narrow layers at every map size
+        if (num_input < 32 || num_output < 32)
+            winograd3x3_tile = 2;
+        else
+#endif // __AVX__
+        // F(6,3) saves the most multiplies but its transforms and 64 transformed kernels
+        // only pay off with enough channels, maps below 24x24 run F(4,3) instead
+        if (num_input >= 64 && num_output >= 64)
+            winograd3x3_tile = 6;
+    }
 
     if (use_winograd3x3)
     {
@@ -104,9 +279,23 @@ int Convolution_x86::create_pipeline(const Option& opt)
         if (use_int8_inference)
             // conv3x3s1_winograd23_transform_kernel_int8_sse(weight_data, weight_3x3_winograd23_data, num_input, num_output);
             conv3x3s1_winograd43_transform_kernel_int8_sse(weight_data, weight_3x3_winograd23_data, num_input, num_output);
+        else if (opt.autotune_cache)
+        {
+            // every variant is a candidate for the autotuner
+            conv3x3s1_winograd23_transform_kernel_sse(weight_data, weight_3x3_winograd23_data, num_input, num_output, opt);
+            conv3x3s1_winograd43_transform_kernel_sse(weight_data, weight_3x3_winograd43_data, num_input, num_output, opt);
+            conv3x3s1_winograd63_transform_kernel_sse(weight_data, weight_3x3_winograd63_data, num_input, num_output, opt);
+        }
         else
-            // conv3x3s1_winograd23_transform_kernel_sse(weight_data, weight_3x3_winograd23_data, num_input, num_output);
-            conv3x3s1_winograd43_transform_kernel_sse(weight_data, weight_3x3_winograd43_data, num_input, num_output);
+        {
+            if (winograd3x3_tile == 2)
+                conv3x3s1_winograd23_transform_kernel_sse(weight_data, weight_3x3_winograd23_data, num_input, num_output, opt);
+            else
+                conv3x3s1_winograd43_transform_kernel_sse(weight_data, weight_3x3_winograd43_data, num_input, num_output, opt);
+
+            if (winograd3x3_tile == 6)
+                conv3x3s1_winograd63_transform_kernel_sse(weight_data, weight_3x3_winograd63_data, num_input, num_output, opt);
+        }
     }
 
     if (use_int8_inference == false)
@@ -114,6 +303,25 @@ int Convolution_x86::create_pipeline(const Option& opt)
         int kernel_size = kernel_w * kernel_h;
         int num_input = weight_data_size / kernel_size / num_output;
 
+#if __AVX__
+        if (opt.use_packing_layout)
+        {
+
+        int elempack = num_input % 8 == 0 ? 8 : 1;
+        int out_elempack = num_output % 8 == 0 ? 8 : 1;
+
+        if (elempack == 8 || out_elempack == 8)
+        {
+            conv_transform_kernel_pack8_avx(weight_data, weight_data_pack8, num_input, num_output, kernel_size, elempack, out_elempack);
+
+            // winograd layers still fall back to sgemm on small maps
+            if (!use_winograd3x3)
+                return 0;
+        }
+
+        } // opt.use_packing_layout
+#endif // __AVX__
+
         conv_im2col_sgemm_transform_kernel_sse(weight_data, weight_sgemm_data, num_input, num_output, kernel_size);
     }       
 
@@ -135,142 +343,36 @@ int Convolution_x86::destroy_pipeline(const Option& opt)
     return 0;
 }
 
-int Convolution_x86::forwardDilation(const Mat& bottom_blob, Mat& top_blob, conv_func conv, const Option& opt) const
+int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
-    int w = bottom_blob.w;
-    int h = bottom_blob.h;
-    size_t elemsize = bottom_blob.elemsize;
-
-    const int kernel_size = kernel_w;
-    const int stride = stride_w;
-    const int dilation = dilation_w;
-    const int kernel_extent = dilation * (kernel_size - 1) + 1;
-
-    Mat bottom_blob_bordered = bottom_blob;
-    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0)
-    {
-        Option opt_b = opt;
-        opt_b.blob_allocator = opt.workspace_allocator;
-        copy_make_border(bottom_blob, bottom_blob_bordered, pad_top, pad_bottom, pad_left, pad_right, BORDER_CONSTANT, 0.f, opt_b);
-        if (bottom_blob_bordered.empty())
-            return -100;
+    // convolv with NxN kernel
+    // value = value + bias
 
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
-    }
-    else if (pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
+#if __AVX__
+    if (opt.use_packing_layout)
     {
-        int wpad = kernel_extent + (w - 1) / stride * stride - w;
-        int hpad = kernel_extent + (h - 1) / stride * stride - h;
-        if (wpad > 0 || hpad > 0)
-        {
-            Option opt_b = opt;
-            opt_b.blob_allocator = opt.workspace_allocator;
-            copy_make_border(bottom_blob, bottom_blob_bordered, hpad / 2, hpad - hpad / 2, wpad / 2, wpad - wpad / 2, BORDER_CONSTANT, 0.f, opt_b);
-            if (bottom_blob_bordered.empty())
-                return -100;
-        }
 
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
-    }
-    else if (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234)
+    if (!weight_data_pack8.empty() && bottom_blob.dims == 3)
     {
-        int wpad = kernel_extent + (w - 1) / stride * stride - w;
-        int hpad = kernel_extent + (h - 1) / stride * stride - h;
-        if (wpad > 0 || hpad > 0)
-        {
-            Option opt_b = opt;
-            opt_b.blob_allocator = opt.workspace_allocator;
-            copy_make_border(bottom_blob, bottom_blob_bordered, hpad - hpad / 2, hpad / 2, wpad - wpad / 2, wpad / 2, BORDER_CONSTANT, 0.f, opt_b);
-            if (bottom_blob_bordered.empty())
-                return -100;
-        }
-
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
+        return forward_pack8(bottom_blob, top_blob, opt);
     }
 
-    int outw = (w - kernel_extent) / stride + 1;
-    int outh = (h - kernel_extent) / stride + 1;
-
-    top_blob.create(outw, outh, num_output, elemsize, opt.blob_allocator);
-    if (top_blob.empty())
-        return -100;
-
-    // Make (dilation * dilation) batches
-    Mat inner_bottom_blob;
-    Mat inner_top_blob;
-    for (int x = 0; x < dilation; x ++)
+    if (bottom_blob.elempack != 1)
     {
-        for (int y = 0; y < dilation; y ++)
-        {
-            int inner_w = (w - y + dilation - 1) / dilation;
-            int inner_h = (h - x + dilation - 1) / dilation;
-
-            int inner_outw = (inner_w - kernel_size) / stride + 1;
-            int inner_outh = (inner_h - kernel_size) / stride + 1;
-
-            inner_bottom_blob.create(inner_w, inner_h, bottom_blob.c, elemsize, opt.workspace_allocator);
-            if (inner_bottom_blob.empty())
-                return -100;
-
-            inner_top_blob.create(inner_outw, inner_outh, num_output, elemsize, opt.workspace_allocator);
-            if (inner_top_blob.empty())
-                return -100;
+        // the remaining paths run on pack1
+        Option opt_pack = opt;
+        opt_pack.blob_allocator = opt.workspace_allocator;
 
-            #pragma omp parallel for num_threads(opt.num_threads)
-            for (int c = 0; c < bottom_blob.c; c ++)
-            {
-                float *outptr = inner_bottom_blob.channel(c);
-
-                for (int i = 0; i < inner_h; i ++)
-                {
-                    const float* ptr = (const float *)bottom_blob_bordered.channel(c) + dilation * i * w + x * w + y;
-                    for (int j = 0; j < inner_w; j ++)
-                    {
-                        outptr[j] = ptr[j*dilation];
-                    }
-                    outptr += inner_w;
-                }
-            }
-
-            ncnn::Option opt_g = opt;
-            opt_g.blob_allocator = inner_top_blob.allocator;
-            if (kernel_size == 7)
-            {
-            // FIXME conv7x7s1_sse use sgemm
-            conv(inner_bottom_blob, inner_top_blob, weight_sgemm_data, bias_data, opt_g);
-            }
-            else
-            {
-            conv(inner_bottom_blob, inner_top_blob, weight_data, bias_data, opt_g);
-            }
+        Mat bottom_blob_unpacked;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack);
+        if (bottom_blob_unpacked.empty())
+            return -100;
 
-            #pragma omp parallel for num_threads(opt.num_threads)
-            for (int c = 0; c < num_output; c ++)
-            {
-                float *outptr = (float *)top_blob.channel(c) + x * outw + y;
-                for (int i = 0; i < inner_outh; i ++)
-                {
-                    const float* ptr = (const float *)inner_top_blob.channel(c) + i * inner_outw;
-                    for (int j = 0; j < inner_outw; j ++)
-                    {
-                        outptr[j*dilation] = ptr[j];
-                    }
-                    outptr += dilation * outw;
-                }
-            }
-        }
+        return forward(bottom_blob_unpacked, top_blob, opt);
     }
 
-    return 0;
-}
-
-int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
-{
-    // convolv with NxN kernel
-    // value = value + bias
+    } // opt.use_packing_layout
+#endif // __AVX__
 
     if (bottom_blob.dims != 3)
     {
@@ -285,156 +387,11 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     const int kernel_size = kernel_w;
     const int stride = stride_w;  
 
-    if (kernel_size > 7 || stride > 7 || dilation_w != dilation_h)
+    if (kernel_size > 7 || stride > 7)
     {
         return Convolution::forward(bottom_blob, top_blob, opt);
     }
 
-    typedef void (*conv_func)(const Mat&, Mat&, const Mat&, const Mat&, const Option&);
-
-    // kernel_size x stride
-    conv_func conv_func_table[7][4] =
-    {
-        {
-            conv1x1s1_sse,
-            conv1x1s2_sse,
-            0,
-            0
-        }, // kernel_size = 1
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 2
-        {
-            conv3x3s1_sse,
-            conv3x3s2_sse,
-            0,
-            0
-        }, // kernel_size = 3
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 4
-        {
-            conv5x5s1_sse,
-            conv5x5s2_sse,
-            0,
-            0
-        }, // kernel_size = 5
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 6
-        {
-            conv7x7s1_sse,          
-            conv7x7s2_sse,          
-            0,
-            0
-        }  // kernel_size = 7        
-    };
-
-    typedef void (*conv_int8_dequant_func)(const Mat&, Mat&, const Mat&, const Mat&, std::vector<float>, const Option&);
-    typedef void (*conv_int8_requant_func)(const Mat&, Mat&, const Mat&, const Mat&, std::vector<float>, const Option&);
-
-    // kernel_size x stride
-    conv_int8_dequant_func conv_int8_dequant_func_table[7][4] =
-    {
-        {
-            conv1x1s1_int8_dequant_sse,
-            conv1x1s2_int8_dequant_sse,
-            0,
-            0
-        }, // kernel_size = 1
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 2
-        {
-            conv3x3s1_int8_dequant_sse,
-            conv3x3s2_int8_dequant_sse,
-            0,
-            0,
-        }, // kernel_size = 3
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 4
-        {        
-            conv5x5s1_int8_dequant_sse,
-            conv5x5s2_int8_dequant_sse,    
-            0,
-            0
-        }, // kernel_size = 5
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 6
-        {
-            conv7x7s1_int8_dequant_sse,          
-            conv7x7s2_int8_dequant_sse, 
-            0,
-            0
-        }  // kernel_size = 7
-    };
-
-    conv_int8_requant_func conv_int8_requant_func_table[7][4] =
-    {
-        {
-            conv1x1s1_int8_requant_sse,
-            conv1x1s2_int8_requant_sse,
-            0,
-            0
-        }, // kernel_size = 1
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 2
-        {
-            conv3x3s1_int8_requant_sse,
-            conv3x3s2_int8_requant_sse,
-            0,
-            0,
-        }, // kernel_size = 3
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 4
-        {        
-            conv5x5s1_int8_requant_sse,
-            conv5x5s2_int8_requant_sse,    
-            0,
-            0
-        }, // kernel_size = 5
-        {
-            0,
-            0,
-            0,
-            0
-        }, // kernel_size = 6
-        {
-            conv7x7s1_int8_requant_sse,          
-            conv7x7s2_int8_requant_sse, 
-            0,
-            0
-        }  // kernel_size = 7
-    };
-
     conv_func conv = 0;
     conv_int8_dequant_func conv_int8_dequant = 0;
     conv_int8_requant_func conv_int8_requant = 0;
@@ -449,6 +406,11 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         {
             return Convolution::forward(bottom_blob, top_blob, opt);
         }
+
+        if (dilation_w != 1 || dilation_h != 1)
+        {
+            return Convolution::forward(bottom_blob, top_blob, opt);
+        }
     }
     else
     {
@@ -457,16 +419,11 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         {
             return Convolution::forward(bottom_blob, top_blob, opt);
         }
-
-        if (dilation_w != 1)
-        {
-            if (stride != 1)
-                return Convolution::forward(bottom_blob, top_blob, opt);
-
-            return forwardDilation(bottom_blob, top_blob, conv, opt);
-        }
     }
 
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     int channels = bottom_blob.c;
@@ -491,57 +448,149 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         bottom_blob_unbordered = bottom_blob_int8;
     }
 
-    Mat bottom_blob_bordered = bottom_blob_unbordered;
-    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0)
-    {
-        Option opt_b = opt;
-        opt_b.blob_allocator = opt.workspace_allocator;
-        copy_make_border(bottom_blob_unbordered, bottom_blob_bordered, pad_top, pad_bottom, pad_left, pad_right, BORDER_CONSTANT, 0.f, opt_b);
-        if (bottom_blob_bordered.empty())
-            return -100;
+    // resolve the padding, the float kernels read the border on the fly
+    int pad_t = pad_top;
+    int pad_b = pad_bottom;
+    int pad_l = pad_left;
+    int pad_r = pad_right;
 
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
-    }
-    else if (pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
+    if ((pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
+        || (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234))
     {
-        int wpad = kernel_size + (w - 1) / stride * stride - w;
-        int hpad = kernel_size + (h - 1) / stride * stride - h;
+        int wpad = kernel_extent_w + (w - 1) / stride * stride - w;
+        int hpad = kernel_extent_h + (h - 1) / stride * stride - h;
+
+        pad_t = 0;
+        pad_b = 0;
+        pad_l = 0;
+        pad_r = 0;
+
         if (wpad > 0 || hpad > 0)
         {
-            Option opt_b = opt;
-            opt_b.blob_allocator = opt.workspace_allocator;
-            copy_make_border(bottom_blob_unbordered, bottom_blob_bordered, hpad / 2, hpad - hpad / 2, wpad / 2, wpad - wpad / 2, BORDER_CONSTANT, 0.f, opt_b);
-            if (bottom_blob_bordered.empty())
-                return -100;
+            pad_t = pad_left == -233 ? hpad / 2 : hpad - hpad / 2;
+            pad_b = hpad - pad_t;
+            pad_l = pad_left == -233 ? wpad / 2 : wpad - wpad / 2;
+            pad_r = wpad - pad_l;
         }
+    }
 
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
+    if (pad_t <= 0 && pad_b <= 0 && pad_l <= 0 && pad_r <= 0)
+    {
+        pad_t = 0;
+        pad_b = 0;
+        pad_l = 0;
+        pad_r = 0;
     }
-    else if (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234)
+
+    w += pad_l + pad_r;
+    h += pad_t + pad_b;
+
+    int outw = (w - kernel_extent_w) / stride + 1;
+    int outh = (h - kernel_extent_h) / stride + 1;
+
+    int impl;
+
+    if (use_int8_inference)
     {
-        int wpad = kernel_size + (w - 1) / stride * stride - w;
-        int hpad = kernel_size + (h - 1) / stride * stride - h;
-        if (wpad > 0 || hpad > 0)
+        // int8 keeps a fixed dispatch, the direct kernels and F(4,3) round differently
+        // and the output must not depend on which one wins the timing
+        impl = use_winograd3x3 ? conv_impl_winograd43 : conv_impl_direct;
+    }
+    else
+    {
+        impl = conv_impl_sgemm;
+
+        // winograd beats sgemm from 4x4 up, F(6,3) pads smaller maps than 24x24 to a few mostly empty tiles
+        if (use_winograd3x3 && outw >= 4 && outh >= 4)
         {
-            Option opt_b = opt;
-            opt_b.blob_allocator = opt.workspace_allocator;
-            copy_make_border(bottom_blob_unbordered, bottom_blob_bordered, hpad - hpad / 2, hpad / 2, wpad - wpad / 2, wpad / 2, BORDER_CONSTANT, 0.f, opt_b);
-            if (bottom_blob_bordered.empty())
-                return -100;
+            if (winograd3x3_tile == 2)
+                impl = conv_impl_winograd23;
+            else if (winograd3x3_tile == 6 && outw >= 24 && outh >= 24)
+                impl = conv_impl_winograd63;
+            else
+                impl = conv_impl_winograd43;
         }
+    }
+
+    if (opt.autotune_cache && !use_int8_inference)
+    {
+        // the direct kernels take no dilation, the 7x7 entries are im2col sgemm already
+        bool available[conv_impl_count];
+        available[conv_impl_direct] = dilation_w == 1 && dilation_h == 1 && kernel_size != 7;
+        available[conv_impl_sgemm] = true;
+        available[conv_impl_winograd23] = !weight_3x3_winograd23_data.empty() && outw >= 4 && outh >= 4;
+        available[conv_impl_winograd43] = !weight_3x3_winograd43_data.empty() && outw >= 4 && outh >= 4;
+        available[conv_impl_winograd63] = !weight_3x3_winograd63_data.empty() && outw >= 4 && outh >= 4;
+
+        char key[256];
+        sprintf(key, "Convolution_x86 k%dx%d d%dx%d s%dx%d p%d,%d,%d,%d %dx%dx%d-%d t%d", kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_l, pad_r, pad_t, pad_b, w, h, channels, num_output, opt.num_threads);
+
+        int choice = opt.autotune_cache->find(key);
+        if (choice < 0 || choice >= conv_impl_count || !available[choice])
+        {
+            // time every candidate on this input, the first run of each warms caches and allocators
+            // and a second run is only spent on candidates within reach of the best so far
+            double best = 0;
+            choice = impl;
+
+            for (int i=0; i<conv_impl_count; i++)
+            {
+                if (!available[i])
+                    continue;
+
+                Mat top_blob_tuned;
+
+                double start = get_current_time();
+                int ret = forward_impl(i, bottom_blob_unbordered, pad_t, pad_b, pad_l, pad_r, top_blob_tuned, opt);
+                double cost = get_current_time() - start;
+                if (ret != 0)
+                    continue;
+
+                if (best == 0 || cost < best * 2)
+                {
+                    start = get_current_time();
+                    forward_impl(i, bottom_blob_unbordered, pad_t, pad_b, pad_l, pad_r, top_blob_tuned, opt);
+                    cost = std::min(cost, get_current_time() - start);
+                }
+
+                if (best == 0 || cost < best)
+                {
+                    best = cost;
+                    choice = i;
+                }
+            }
 
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
+            opt.autotune_cache->insert(key, choice);
+        }
+
+        impl = choice;
     }
 
-    int outw = (w - kernel_size) / stride + 1;
-    int outh = (h - kernel_size) / stride + 1;
+    return forward_impl(impl, bottom_blob_unbordered, pad_t, pad_b, pad_l, pad_r, top_blob, opt);
+}
+
+int Convolution_x86::forward_impl(int impl, const Mat& bottom_blob, int pad_t, int pad_b, int pad_l, int pad_r, Mat& top_blob, const Option& opt) const
+{
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    int outw = (bottom_blob.w + pad_l + pad_r - kernel_extent_w) / stride_w + 1;
+    int outh = (bottom_blob.h + pad_t + pad_b - kernel_extent_h) / stride_h + 1;
+
+    // the int8 kernels and the direct float kernels read a bordered copy
+    Mat bottom_blob_bordered = bottom_blob;
+    if ((use_int8_inference || impl == conv_impl_direct) && (pad_t > 0 || pad_b > 0 || pad_l > 0 || pad_r > 0))
+    {
+        Option opt_b = opt;
+        opt_b.blob_allocator = opt.workspace_allocator;
+        copy_make_border(bottom_blob, bottom_blob_bordered, pad_t, pad_b, pad_l, pad_r, BORDER_CONSTANT, 0.f, opt_b);
+        if (bottom_blob_bordered.empty())
+            return -100;
+    }
 
     // int8
     if (use_int8_inference)
-    {         
+    {
         if (use_int8_requantize == true)
         {
             Mat top_blob_tm;
@@ -553,7 +602,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
             if (top_blob.empty())
                 return -100; 
 
-            if (use_winograd3x3)
+            if (impl == conv_impl_winograd43)
             {
                 // conv3x3s1_winograd23_int8_sse(bottom_blob_bordered, top_blob_tm, weight_3x3_winograd23_data, opt);
                 conv3x3s1_winograd43_int8_sse(bottom_blob_bordered, top_blob_tm, weight_3x3_winograd23_data, opt);
@@ -572,7 +621,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
                 }
             }
             else
-                conv_int8_requant(bottom_blob_bordered, top_blob, weight_data, bias_data, requantize_scales, opt);
+                conv_int8_requant_func_table[kernel_w-1][stride_w-1](bottom_blob_bordered, top_blob, weight_data, bias_data, requantize_scales, opt);
         }
         else
         {
@@ -580,7 +629,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
             if (top_blob.empty())
                 return -100;
 
-            if (use_winograd3x3)
+            if (impl == conv_impl_winograd43)
             {
                 // conv3x3s1_winograd23_int8_sse(bottom_blob_bordered, top_blob, weight_3x3_winograd23_data, opt);
                 conv3x3s1_winograd43_int8_sse(bottom_blob_bordered, top_blob, weight_3x3_winograd23_data, opt);
@@ -598,7 +647,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
                 }
             }
             else
-                conv_int8_dequant(bottom_blob_bordered, top_blob, weight_data, bias_data, dequantize_scales, opt);     
+                conv_int8_dequant_func_table[kernel_w-1][stride_w-1](bottom_blob_bordered, top_blob, weight_data, bias_data, dequantize_scales, opt);     
         }
 
         if (activation)
@@ -610,18 +659,127 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     }
 
     // float32
-    top_blob.create(outw, outh, num_output, elemsize, opt.blob_allocator);
+    top_blob.create(outw, outh, num_output, bottom_blob.elemsize, opt.blob_allocator);
     if (top_blob.empty())
-        return -100;    
+        return -100;
+
+    if (impl == conv_impl_direct)
+        conv_func_table[kernel_w-1][stride_w-1](bottom_blob_bordered, top_blob, weight_data, bias_data, opt);
+    else if (impl == conv_impl_winograd23)
+        conv3x3s1_winograd23_sse(bottom_blob, top_blob, weight_3x3_winograd23_data, bias_data, pad_l, pad_t, opt);
+    else if (impl == conv_impl_winograd43)
+        conv3x3s1_winograd43_sse(bottom_blob, top_blob, weight_3x3_winograd43_data, bias_data, pad_l, pad_t, opt);
+    else if (impl == conv_impl_winograd63)
+        conv3x3s1_winograd63_sse(bottom_blob, top_blob, weight_3x3_winograd63_data, bias_data, pad_l, pad_t, opt);
+    else
+        conv_im2col_sgemm_sse(bottom_blob, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_l, pad_t, opt);
+
+    if (activation)
+    {
+        activation->forward_inplace(top_blob, opt);
+    }
+
+    return 0;
+}
+
+#if __AVX__
+int Convolution_x86::forward_pack8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int maxk = kernel_w * kernel_h;
+    const int num_input = weight_data_size / maxk / num_output;
+
+    int elempack = num_input % 8 == 0 ? 8 : 1;
+    int out_elempack = num_output % 8 == 0 ? 8 : 1;
 
-    if (use_winograd3x3 && outw >= 8 && outh >=8)
+    Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+
+    Mat bottom_blob_packed = bottom_blob;
+    if (bottom_blob.elempack != elempack)
+    {
+        convert_packing(bottom_blob, bottom_blob_packed, elempack, opt_b);
+        if (bottom_blob_packed.empty())
+            return -100;
+    }
+
+    int w = bottom_blob_packed.w;
+    int h = bottom_blob_packed.h;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    // resolve the padding, the pack8 kernels read the border in place
+    int pad_t = pad_top;
+    int pad_b = pad_bottom;
+    int pad_l = pad_left;
+    int pad_r = pad_right;
+
+    if ((pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
+        || (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234))
+    {
+        int wpad = kernel_extent_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_extent_h + (h - 1) / stride_h * stride_h - h;
+
+        pad_t = 0;
+        pad_b = 0;
+        pad_l = 0;
+        pad_r = 0;
+
+        if (wpad > 0 || hpad > 0)
+        {
+            // -233 pads the extra pixel after, -234 before
+            pad_t = pad_left == -233 ? hpad / 2 : hpad - hpad / 2;
+            pad_b = hpad - pad_t;
+            pad_l = pad_left == -233 ? wpad / 2 : wpad - wpad / 2;
+            pad_r = wpad - pad_l;
+        }
+    }
+
+    if (pad_t <= 0 && pad_b <= 0 && pad_l <= 0 && pad_r <= 0)
     {
-        // conv3x3s1_winograd23_sse(bottom_blob_bordered, top_blob, weight_3x3_winograd23_data, bias_data, opt);
-        conv3x3s1_winograd43_sse(bottom_blob_bordered, top_blob, weight_3x3_winograd43_data, bias_data, opt);
+        pad_t = 0;
+        pad_b = 0;
+        pad_l = 0;
+        pad_r = 0;
     }
+
+    int outw = (w + pad_l + pad_r - kernel_extent_w) / stride_w + 1;
+    int outh = (h + pad_t + pad_b - kernel_extent_h) / stride_h + 1;
+
+    if (use_winograd3x3 && outw >= 8 && outh >= 8)
+    {
+        // winograd saves more multiplications than the pack8 layout gains, run it on pack1
+        Option opt_pack1 = opt;
+        opt_pack1.use_packing_layout = false;
+        opt_pack1.blob_allocator = opt.workspace_allocator;
+
+        Mat bottom_blob_unpacked;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_b);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+
+        Mat top_blob_unpacked;
+        int ret = forward(bottom_blob_unpacked, top_blob_unpacked, opt_pack1);
+        if (ret != 0)
+            return ret;
+
+        convert_packing(top_blob_unpacked, top_blob, out_elempack, opt);
+        if (top_blob.empty())
+            return -100;
+
+        return 0;
+    }
+
+    top_blob.create(outw, outh, num_output / out_elempack, (size_t)4u * out_elempack, out_elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    if (elempack == 8 && out_elempack == 8)
+        conv_pack8_avx(bottom_blob_packed, top_blob, weight_data_pack8, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_l, pad_t, opt);
+    else if (elempack == 1 && out_elempack == 8)
+        conv_pack1to8_avx(bottom_blob_packed, top_blob, weight_data_pack8, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_l, pad_t, opt);
     else
-        //conv(bottom_blob_bordered, top_blob, weight_data, bias_data, opt);
-        conv_im2col_sgemm_sse(bottom_blob_bordered, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, stride_w, stride_h, opt);
+        conv_pack8to1_avx(bottom_blob_packed, top_blob, weight_data_pack8, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_l, pad_t, opt);
 
     if (activation)
     {
@@ -630,5 +788,6 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
 
     return 0;
 }
+#endif // __AVX__
 
 } // namespace ncnn
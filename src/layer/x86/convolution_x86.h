@@ -19,8 +19,6 @@
 
 namespace ncnn {
 
-typedef void (*conv_func)(const Mat&, Mat&, const Mat&, const Mat&, const Option&);
-
 class Convolution_x86 : virtual public Convolution
 {
 public:
@@ -30,14 +28,28 @@ public:
     virtual int destroy_pipeline(const Option& opt);
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
-    virtual int forwardDilation(const Mat& bottom_blob, Mat &top_blob, conv_func conv, const Option& opt) const;
+
+protected:
+    // run implementation impl, bottom_blob is padded by pad_t pad_b pad_l pad_r zeros
+    // the float winograd and sgemm kernels read the border on the fly, the others copy it
+    int forward_impl(int impl, const Mat& bottom_blob, int pad_t, int pad_b, int pad_l, int pad_r, Mat& top_blob, const Option& opt) const;
+
+#if __AVX__
+    int forward_pack8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+#endif // __AVX__
 
 public:
     Layer* activation;
     bool use_winograd3x3;
+    // output tile size of the float winograd path, 2 4 or 6, tile 6 keeps F(4,3) kernels for small maps
+    int winograd3x3_tile;
     Mat weight_3x3_winograd23_data;
     Mat weight_sgemm_data;
     std::vector<Mat> weight_3x3_winograd43_data;
+    std::vector<Mat> weight_3x3_winograd63_data;
+
+    // pack8
+    Mat weight_data_pack8;
 };
 
 } // namespace ncnn
@@ -12,9 +12,34 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
-static void convdw3x3s1_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, const Option& opt)
+
+#if __AVX__
+static inline __m256 convdw3_avx(const float* r, const float* k, int stride, __m256 _sum)
+{
+    _sum = _mm256_fmadd_ps(convdw_load8_avx(r, stride), _mm256_broadcast_ss(k), _sum);
+    _sum = _mm256_fmadd_ps(convdw_load8_avx(r + 1, stride), _mm256_broadcast_ss(k + 1), _sum);
+    _sum = _mm256_fmadd_ps(convdw_load8_avx(r + 2, stride), _mm256_broadcast_ss(k + 2), _sum);
+
+    return _sum;
+}
+#endif // __AVX__
+
+#if __SSE2__
+static inline __m128 convdw3_sse(const float* r, const float* k, int stride, __m128 _sum)
+{
+    _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(r, stride), _mm_set1_ps(k[0])));
+    _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(r + 1, stride), _mm_set1_ps(k[1])));
+    _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(r + 2, stride), _mm_set1_ps(k[2])));
+
+    return _sum;
+}
+#endif // __SSE2__
+
+template<int stride>
+static void convdw3x3_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
 {
     int w = bottom_blob.w;
+    int h = bottom_blob.h;
 
     int outw = top_blob.w;
     int outh = top_blob.h;
@@ -24,178 +49,149 @@ static void convdw3x3s1_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _k
     const float* kernel = _kernel;
     const float* bias = _bias;
 
+    // output columns whose window lies inside the input
+    int jstart = std::min(std::max((pad_left + stride - 1) / stride, 0), outw);
+    int jend = w - 3 + pad_left < 0 ? 0 : std::min((w - 3 + pad_left) / stride + 1, outw);
+    jend = std::max(jend, jstart);
+
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int g=0; g<group; g++)
     {
-        Mat out = top_blob.channel(g);
+        float* outptr = top_blob.channel(g);
 
         const float bias0 = bias ? bias[g] : 0.f;
 
-        const float* kernel0 = kernel + g*9;
-
-        float* outptr = out;
-        float* outptr2 = outptr + outw;
-
-        const float* img0 = bottom_blob.channel(g);
-
-        const float* r0 = img0;
-        const float* r1 = img0 + w;
-        const float* r2 = img0 + w*2;
-        const float* r3 = img0 + w*3;
-
-        const float* k0 = kernel0;
-        const float* k1 = kernel0 + 3;
-        const float* k2 = kernel0 + 6;
+        const float* k0 = kernel + g*9;
 
-        int i = 0;
+        const Mat m = bottom_blob.channel(g);
 
-        for (; i+1 < outh; i+=2)
+        for (int i=0; i<outh; i++)
         {
+            int sy = i * stride - pad_top;
 
-            int remain = outw;
+            // kernel rows inside the input, the rest read zero padding
+            int y0, y1;
+            convdw_clip(sy, h, 3, 1, y0, y1);
 
-            for (; remain>0; remain--)
+            for (int j=0; j<jstart; j++)
             {
-                float sum = bias0;
-                sum += r0[0] * k0[0];
-                sum += r0[1] * k0[1];
-                sum += r0[2] * k0[2];
-                sum += r1[0] * k1[0];
-                sum += r1[1] * k1[1];
-                sum += r1[2] * k1[2];
-                sum += r2[0] * k2[0];
-                sum += r2[1] * k2[1];
-                sum += r2[2] * k2[2];
-
-                float sum2 = bias0;
-                sum2 += r1[0] * k0[0];
-                sum2 += r1[1] * k0[1];
-                sum2 += r1[2] * k0[2];
-                sum2 += r2[0] * k1[0];
-                sum2 += r2[1] * k1[1];
-                sum2 += r2[2] * k1[2];
-                sum2 += r3[0] * k2[0];
-                sum2 += r3[1] * k2[1];
-                sum2 += r3[2] * k2[2];
-
-                *outptr = sum;
-                *outptr2 = sum2;
-
-                r0++;
-                r1++;
-                r2++;
-                r3++;
-                outptr++;
-                outptr2++;
+                outptr[j] = convdw_window(m, j * stride - pad_left, sy, k0, 3, 3, 1, 1, bias0);
             }
 
-            r0 += 2 + w;
-            r1 += 2 + w;
-            r2 += 2 + w;
-            r3 += 2 + w;
+            int j = jstart;
 
-            outptr += outw;
-            outptr2 += outw;
-        }
-
-        for (; i < outh; i++)
-        {
-            int remain = outw;
+            if (y0 == 0 && y1 == 3)
+            {
+                const float* r0 = m.row(sy);
+                const float* r1 = r0 + w;
+                const float* r2 = r1 + w;
+
+#if __AVX__
+                for (; j<jend && jend-jstart>=8; j+=8)
+                {
+                    // the last block overlaps the one before rather than leave a scalar tail
+                    j = std::min(j, jend - 8);
+
+                    const int sx = j * stride - pad_left;
+
+                    __m256 _sum = _mm256_set1_ps(bias0);
+                    _sum = convdw3_avx(r0 + sx, k0, stride, _sum);
+                    _sum = convdw3_avx(r1 + sx, k0 + 3, stride, _sum);
+                    _sum = convdw3_avx(r2 + sx, k0 + 6, stride, _sum);
+
+                    _mm256_storeu_ps(outptr + j, _sum);
+                }
+#endif // __AVX__
+#if __SSE2__
+                for (; j<jend && jend-jstart>=4; j+=4)
+                {
+                    j = std::min(j, jend - 4);
+
+                    const int sx = j * stride - pad_left;
+
+                    __m128 _sum = _mm_set1_ps(bias0);
+                    _sum = convdw3_sse(r0 + sx, k0, stride, _sum);
+                    _sum = convdw3_sse(r1 + sx, k0 + 3, stride, _sum);
+                    _sum = convdw3_sse(r2 + sx, k0 + 6, stride, _sum);
+
+                    _mm_storeu_ps(outptr + j, _sum);
+                }
+#endif // __SSE2__
+                for (; j<jend; j++)
+                {
+                    const int sx = j * stride - pad_left;
+
+                    float sum = bias0;
+                    sum += r0[sx] * k0[0];
+                    sum += r0[sx + 1] * k0[1];
+                    sum += r0[sx + 2] * k0[2];
+                    sum += r1[sx] * k0[3];
+                    sum += r1[sx + 1] * k0[4];
+                    sum += r1[sx + 2] * k0[5];
+                    sum += r2[sx] * k0[6];
+                    sum += r2[sx + 1] * k0[7];
+                    sum += r2[sx + 2] * k0[8];
+
+                    outptr[j] = sum;
+                }
+            }
+            else
+            {
+                // top and bottom rows, only the kernel rows inside the input
+#if __AVX__
+                for (; j<jend && jend-jstart>=8; j+=8)
+                {
+                    j = std::min(j, jend - 8);
+
+                    const int sx = j * stride - pad_left;
+
+                    __m256 _sum = _mm256_set1_ps(bias0);
+                    for (int y=y0; y<y1; y++)
+                    {
+                        _sum = convdw3_avx(m.row(sy + y) + sx, k0 + y*3, stride, _sum);
+                    }
+
+                    _mm256_storeu_ps(outptr + j, _sum);
+                }
+#endif // __AVX__
+#if __SSE2__
+                for (; j<jend && jend-jstart>=4; j+=4)
+                {
+                    j = std::min(j, jend - 4);
+
+                    const int sx = j * stride - pad_left;
+
+                    __m128 _sum = _mm_set1_ps(bias0);
+                    for (int y=y0; y<y1; y++)
+                    {
+                        _sum = convdw3_sse(m.row(sy + y) + sx, k0 + y*3, stride, _sum);
+                    }
+
+                    _mm_storeu_ps(outptr + j, _sum);
+                }
+#endif // __SSE2__
+                for (; j<jend; j++)
+                {
+                    outptr[j] = convdw_window(m, j * stride - pad_left, sy, k0, 3, 3, 1, 1, bias0);
+                }
+            }
 
-            for (; remain>0; remain--)
+            for (j=jend; j<outw; j++)
             {
-                float sum = bias0;
-                sum += r0[0] * k0[0];
-                sum += r0[1] * k0[1];
-                sum += r0[2] * k0[2];
-                sum += r1[0] * k1[0];
-                sum += r1[1] * k1[1];
-                sum += r1[2] * k1[2];
-                sum += r2[0] * k2[0];
-                sum += r2[1] * k2[1];
-                sum += r2[2] * k2[2];
-
-                *outptr = sum;
-
-                r0++;
-                r1++;
-                r2++;
-                outptr++;
+                outptr[j] = convdw_window(m, j * stride - pad_left, sy, k0, 3, 3, 1, 1, bias0);
             }
 
-            r0 += 2;
-            r1 += 2;
-            r2 += 2;
+            outptr += outw;
         }
     }
 }
 
-static void convdw3x3s2_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, const Option& opt)
+static void convdw3x3s1_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
 {
-    int w = bottom_blob.w;
-
-    int outw = top_blob.w;
-    int outh = top_blob.h;
-
-    const int group = bottom_blob.c;
-
-    const int tailstep = w - 2*outw + w;
-
-    const float* kernel = _kernel;
-    const float* bias = _bias;
-
-    #pragma omp parallel for num_threads(opt.num_threads)
-    for (int g=0; g<group; g++)
-    {
-        Mat out = top_blob.channel(g);
-
-        const float bias0 = bias ? bias[g] : 0.f;
-
-        const float* kernel0 = kernel + g*9;
-
-        float* outptr = out;
-
-        const float* img0 = bottom_blob.channel(g);
-
-        const float* r0 = img0;
-        const float* r1 = img0 + w;
-        const float* r2 = img0 + w*2;
-
-        const float* k0 = kernel0;
-        const float* k1 = kernel0 + 3;
-        const float* k2 = kernel0 + 6;
-
-        int i = 0;
-
-        for (; i < outh; i++)
-        {
-            int remain = outw;
-
-            for (; remain>0; remain--)
-            {
-                float sum = bias0;
-                sum += r0[0] * k0[0];
-                sum += r0[1] * k0[1];
-                sum += r0[2] * k0[2];
-                sum += r1[0] * k1[0];
-                sum += r1[1] * k1[1];
-                sum += r1[2] * k1[2];
-                sum += r2[0] * k2[0];
-                sum += r2[1] * k2[1];
-                sum += r2[2] * k2[2];
-
-                *outptr = sum;
-
-                r0 += 2;
-                r1 += 2;
-                r2 += 2;
-                outptr++;
-            }
-
-            r0 += tailstep;
-            r1 += tailstep;
-            r2 += tailstep;
-        }
+    convdw3x3_sse<1>(bottom_blob, top_blob, _kernel, _bias, pad_left, pad_top, opt);
+}
 
-    }
+static void convdw3x3s2_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
+{
+    convdw3x3_sse<2>(bottom_blob, top_blob, _kernel, _bias, pad_left, pad_top, opt);
 }
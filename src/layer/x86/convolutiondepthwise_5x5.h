@@ -0,0 +1,263 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#if __AVX__
+static inline __m256 convdw5_avx(const float* r, const float* k, int stride, __m256 _sum)
+{
+    _sum = _mm256_fmadd_ps(convdw_load8_avx(r, stride), _mm256_broadcast_ss(k), _sum);
+    _sum = _mm256_fmadd_ps(convdw_load8_avx(r + 1, stride), _mm256_broadcast_ss(k + 1), _sum);
+    _sum = _mm256_fmadd_ps(convdw_load8_avx(r + 2, stride), _mm256_broadcast_ss(k + 2), _sum);
+    _sum = _mm256_fmadd_ps(convdw_load8_avx(r + 3, stride), _mm256_broadcast_ss(k + 3), _sum);
+    _sum = _mm256_fmadd_ps(convdw_load8_avx(r + 4, stride), _mm256_broadcast_ss(k + 4), _sum);
+
+    return _sum;
+}
+#endif // __AVX__
+
+#if __SSE2__
+static inline __m128 convdw5_sse(const float* r, const float* k, int stride, __m128 _sum)
+{
+    _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(r, stride), _mm_set1_ps(k[0])));
+    _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(r + 1, stride), _mm_set1_ps(k[1])));
+    _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(r + 2, stride), _mm_set1_ps(k[2])));
+    _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(r + 3, stride), _mm_set1_ps(k[3])));
+    _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(r + 4, stride), _mm_set1_ps(k[4])));
+
+    return _sum;
+}
+#endif // __SSE2__
+
+static inline float convdw5(const float* r, const float* k)
+{
+    return r[0] * k[0] + r[1] * k[1] + r[2] * k[2] + r[3] * k[3] + r[4] * k[4];
+}
+
+// one output row, kernel rows outside the input and the border columns read zero padding
+template<int stride>
+static void convdw5x5_row_sse(const Mat& m, float* outptr, int sy, const float* k0, float bias0, int pad_left, int jstart, int jend, int outw)
+{
+    int y0, y1;
+    convdw_clip(sy, m.h, 5, 1, y0, y1);
+
+    for (int j=0; j<jstart; j++)
+    {
+        outptr[j] = convdw_window(m, j * stride - pad_left, sy, k0, 5, 5, 1, 1, bias0);
+    }
+
+    int j = jstart;
+#if __AVX__
+    for (; j<jend && jend-jstart>=8; j+=8)
+    {
+        // the last block overlaps the one before rather than leave a scalar tail
+        j = std::min(j, jend - 8);
+
+        __m256 _sum = _mm256_set1_ps(bias0);
+
+        for (int y=y0; y<y1; y++)
+        {
+            _sum = convdw5_avx(m.row(sy + y) + j * stride - pad_left, k0 + y*5, stride, _sum);
+        }
+
+        _mm256_storeu_ps(outptr + j, _sum);
+    }
+#endif // __AVX__
+#if __SSE2__
+    for (; j<jend && jend-jstart>=4; j+=4)
+    {
+        j = std::min(j, jend - 4);
+
+        __m128 _sum = _mm_set1_ps(bias0);
+
+        for (int y=y0; y<y1; y++)
+        {
+            _sum = convdw5_sse(m.row(sy + y) + j * stride - pad_left, k0 + y*5, stride, _sum);
+        }
+
+        _mm_storeu_ps(outptr + j, _sum);
+    }
+#endif // __SSE2__
+    for (; j<jend; j++)
+    {
+        float sum = bias0;
+
+        for (int y=y0; y<y1; y++)
+        {
+            sum += convdw5(m.row(sy + y) + j * stride - pad_left, k0 + y*5);
+        }
+
+        outptr[j] = sum;
+    }
+
+    for (j=jend; j<outw; j++)
+    {
+        outptr[j] = convdw_window(m, j * stride - pad_left, sy, k0, 5, 5, 1, 1, bias0);
+    }
+}
+
+// two output rows per pass share the overlapping input rows
+template<int stride>
+static void convdw5x5_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+
+    const int group = bottom_blob.c;
+
+    const float* kernel = _kernel;
+    const float* bias = _bias;
+
+    // output rows and columns whose window lies inside the input
+    int istart = std::min(std::max((pad_top + stride - 1) / stride, 0), outh);
+    int iend = h - 5 + pad_top < 0 ? 0 : std::min((h - 5 + pad_top) / stride + 1, outh);
+    iend = std::max(iend, istart);
+
+    int jstart = std::min(std::max((pad_left + stride - 1) / stride, 0), outw);
+    int jend = w - 5 + pad_left < 0 ? 0 : std::min((w - 5 + pad_left) / stride + 1, outw);
+    jend = std::max(jend, jstart);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g=0; g<group; g++)
+    {
+        float* outptr = top_blob.channel(g);
+        float* outptr2 = outptr + outw;
+
+        const float bias0 = bias ? bias[g] : 0.f;
+
+        const float* k0 = kernel + g*25;
+
+        const Mat m = bottom_blob.channel(g);
+
+        int i = 0;
+
+        for (; i < istart; i++)
+        {
+            convdw5x5_row_sse<stride>(m, outptr, i * stride - pad_top, k0, bias0, pad_left, jstart, jend, outw);
+
+            outptr += outw;
+            outptr2 += outw;
+        }
+
+        for (; i+1 < iend; i+=2)
+        {
+            const int sy = i * stride - pad_top;
+
+            for (int j=0; j<jstart; j++)
+            {
+                outptr[j] = convdw_window(m, j * stride - pad_left, sy, k0, 5, 5, 1, 1, bias0);
+                outptr2[j] = convdw_window(m, j * stride - pad_left, sy + stride, k0, 5, 5, 1, 1, bias0);
+            }
+
+            const float* r0 = m.row(sy);
+
+            int j = jstart;
+#if __AVX__
+            for (; j<jend && jend-jstart>=8; j+=8)
+            {
+                j = std::min(j, jend - 8);
+
+                __m256 _sum = _mm256_set1_ps(bias0);
+                __m256 _sum2 = _sum;
+
+                const float* r = r0 + j * stride - pad_left;
+
+                for (int y=0; y<5+stride; y++)
+                {
+                    if (y < 5)
+                        _sum = convdw5_avx(r, k0 + y*5, stride, _sum);
+                    if (y >= stride && y - stride < 5)
+                        _sum2 = convdw5_avx(r, k0 + (y - stride)*5, stride, _sum2);
+
+                    r += w;
+                }
+
+                _mm256_storeu_ps(outptr + j, _sum);
+                _mm256_storeu_ps(outptr2 + j, _sum2);
+            }
+#endif // __AVX__
+#if __SSE2__
+            for (; j<jend && jend-jstart>=4; j+=4)
+            {
+                j = std::min(j, jend - 4);
+
+                __m128 _sum = _mm_set1_ps(bias0);
+                __m128 _sum2 = _sum;
+
+                const float* r = r0 + j * stride - pad_left;
+
+                for (int y=0; y<5+stride; y++)
+                {
+                    if (y < 5)
+                        _sum = convdw5_sse(r, k0 + y*5, stride, _sum);
+                    if (y >= stride && y - stride < 5)
+                        _sum2 = convdw5_sse(r, k0 + (y - stride)*5, stride, _sum2);
+
+                    r += w;
+                }
+
+                _mm_storeu_ps(outptr + j, _sum);
+                _mm_storeu_ps(outptr2 + j, _sum2);
+            }
+#endif // __SSE2__
+            for (; j<jend; j++)
+            {
+                float sum = bias0;
+                float sum2 = bias0;
+
+                const float* r = r0 + j * stride - pad_left;
+
+                for (int y=0; y<5+stride; y++)
+                {
+                    if (y < 5)
+                        sum += convdw5(r, k0 + y*5);
+                    if (y >= stride && y - stride < 5)
+                        sum2 += convdw5(r, k0 + (y - stride)*5);
+
+                    r += w;
+                }
+
+                outptr[j] = sum;
+                outptr2[j] = sum2;
+            }
+
+            for (j=jend; j<outw; j++)
+            {
+                outptr[j] = convdw_window(m, j * stride - pad_left, sy, k0, 5, 5, 1, 1, bias0);
+                outptr2[j] = convdw_window(m, j * stride - pad_left, sy + stride, k0, 5, 5, 1, 1, bias0);
+            }
+
+            outptr += outw * 2;
+            outptr2 += outw * 2;
+        }
+
+        for (; i < outh; i++)
+        {
+            convdw5x5_row_sse<stride>(m, outptr, i * stride - pad_top, k0, bias0, pad_left, jstart, jend, outw);
+
+            outptr += outw;
+        }
+    }
+}
+
+static void convdw5x5s1_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
+{
+    convdw5x5_sse<1>(bottom_blob, top_blob, _kernel, _bias, pad_left, pad_top, opt);
+}
+
+static void convdw5x5s2_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, int pad_left, int pad_top, const Option& opt)
+{
+    convdw5x5_sse<2>(bottom_blob, top_blob, _kernel, _bias, pad_left, pad_top, opt);
+}
@@ -0,0 +1,175 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+static void convdw_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int pad_left, int pad_top, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+
+    const int group = bottom_blob.c;
+    const int maxk = kernel_w * kernel_h;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+
+    const float* kernel = _kernel;
+    const float* bias = _bias;
+
+    // output columns whose window lies inside the input
+    int jstart = std::min(std::max((pad_left + stride_w - 1) / stride_w, 0), outw);
+    int jend = w - kernel_extent_w + pad_left < 0 ? 0 : std::min((w - kernel_extent_w + pad_left) / stride_w + 1, outw);
+    jend = std::max(jend, jstart);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g=0; g<group; g++)
+    {
+        float* outptr = top_blob.channel(g);
+
+        const float bias0 = bias ? bias[g] : 0.f;
+
+        const float* kernel0 = kernel + maxk * g;
+
+        const Mat m = bottom_blob.channel(g);
+
+        for (int i=0; i<outh; i++)
+        {
+            int sy = i * stride_h - pad_top;
+
+            // kernel rows inside the input, the rest read zero padding
+            int y0, y1;
+            convdw_clip(sy, h, kernel_h, dilation_h, y0, y1);
+
+            for (int j=0; j<jstart; j++)
+            {
+                outptr[j] = convdw_window(m, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, bias0);
+            }
+
+            int j = jstart;
+#if __AVX__
+            for (; j+15<jend; j+=16)
+            {
+                __m256 _sum0 = _mm256_set1_ps(bias0);
+                __m256 _sum1 = _sum0;
+
+                for (int y=y0; y<y1; y++)
+                {
+                    const float* sptr = m.row(sy + y * dilation_h) + j * stride_w - pad_left;
+                    const float* k0 = kernel0 + y * kernel_w;
+
+                    for (int x=0; x<kernel_w; x++)
+                    {
+                        __m256 _k = _mm256_broadcast_ss(k0 + x);
+
+                        _sum0 = _mm256_fmadd_ps(convdw_load8_avx(sptr + x * dilation_w, stride_w), _k, _sum0);
+                        _sum1 = _mm256_fmadd_ps(convdw_load8_avx(sptr + x * dilation_w + 8 * stride_w, stride_w), _k, _sum1);
+                    }
+                }
+
+                _mm256_storeu_ps(outptr + j, _sum0);
+                _mm256_storeu_ps(outptr + j + 8, _sum1);
+            }
+            for (; j<jend && jend-jstart>=8; j+=8)
+            {
+                // the last block overlaps the one before rather than leave a scalar tail
+                j = std::min(j, jend - 8);
+
+                __m256 _sum = _mm256_set1_ps(bias0);
+
+                for (int y=y0; y<y1; y++)
+                {
+                    const float* sptr = m.row(sy + y * dilation_h) + j * stride_w - pad_left;
+                    const float* k0 = kernel0 + y * kernel_w;
+
+                    for (int x=0; x<kernel_w; x++)
+                    {
+                        _sum = _mm256_fmadd_ps(convdw_load8_avx(sptr + x * dilation_w, stride_w), _mm256_broadcast_ss(k0 + x), _sum);
+                    }
+                }
+
+                _mm256_storeu_ps(outptr + j, _sum);
+            }
+#endif // __AVX__
+#if __SSE2__
+            for (; j+7<jend; j+=8)
+            {
+                __m128 _sum0 = _mm_set1_ps(bias0);
+                __m128 _sum1 = _sum0;
+
+                for (int y=y0; y<y1; y++)
+                {
+                    const float* sptr = m.row(sy + y * dilation_h) + j * stride_w - pad_left;
+                    const float* k0 = kernel0 + y * kernel_w;
+
+                    for (int x=0; x<kernel_w; x++)
+                    {
+                        __m128 _k = _mm_set1_ps(k0[x]);
+
+                        _sum0 = _mm_add_ps(_sum0, _mm_mul_ps(convdw_load4_sse(sptr + x * dilation_w, stride_w), _k));
+                        _sum1 = _mm_add_ps(_sum1, _mm_mul_ps(convdw_load4_sse(sptr + x * dilation_w + 4 * stride_w, stride_w), _k));
+                    }
+                }
+
+                _mm_storeu_ps(outptr + j, _sum0);
+                _mm_storeu_ps(outptr + j + 4, _sum1);
+            }
+            for (; j<jend && jend-jstart>=4; j+=4)
+            {
+                j = std::min(j, jend - 4);
+
+                __m128 _sum = _mm_set1_ps(bias0);
+
+                for (int y=y0; y<y1; y++)
+                {
+                    const float* sptr = m.row(sy + y * dilation_h) + j * stride_w - pad_left;
+                    const float* k0 = kernel0 + y * kernel_w;
+
+                    for (int x=0; x<kernel_w; x++)
+                    {
+                        _sum = _mm_add_ps(_sum, _mm_mul_ps(convdw_load4_sse(sptr + x * dilation_w, stride_w), _mm_set1_ps(k0[x])));
+                    }
+                }
+
+                _mm_storeu_ps(outptr + j, _sum);
+            }
+#endif // __SSE2__
+            for (; j<jend; j++)
+            {
+                float sum = bias0;
+
+                for (int y=y0; y<y1; y++)
+                {
+                    const float* sptr = m.row(sy + y * dilation_h) + j * stride_w - pad_left;
+                    const float* k0 = kernel0 + y * kernel_w;
+
+                    for (int x=0; x<kernel_w; x++)
+                    {
+                        sum += sptr[x * dilation_w] * k0[x];
+                    }
+                }
+
+                outptr[j] = sum;
+            }
+
+            for (j=jend; j<outw; j++)
+            {
+                outptr[j] = convdw_window(m, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, bias0);
+            }
+
+            outptr += outw;
+        }
+    }
+}
@@ -0,0 +1,397 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#if __SSE2__
+// p[0] p[stride] ... p[stride*7] sign extended to int16, never reads beyond the last element
+static inline __m128i convdw_load8_int8_sse(const signed char* p, int stride)
+{
+    if (stride == 1)
+    {
+        __m128i _v = _mm_loadl_epi64((const __m128i*)p);
+        return _mm_srai_epi16(_mm_unpacklo_epi8(_v, _v), 8);
+    }
+
+    if (stride == 2)
+    {
+        // even bytes of p[0..7] and odd bytes of p[7..14]
+        __m128i _v0 = _mm_loadl_epi64((const __m128i*)p);
+        __m128i _v1 = _mm_loadl_epi64((const __m128i*)(p + 7));
+        _v0 = _mm_srai_epi16(_mm_slli_epi16(_v0, 8), 8);
+        _v1 = _mm_srai_epi16(_v1, 8);
+        return _mm_unpacklo_epi64(_v0, _v1);
+    }
+
+    return _mm_setr_epi16(p[0], p[stride], p[stride*2], p[stride*3], p[stride*4], p[stride*5], p[stride*6], p[stride*7]);
+}
+
+// int32 sums of 8 neighbouring outputs, two taps per madd
+static inline void convdw_int8_sum8_sse(const signed char* sptr, const signed char* kptr, const int* space_ofs, int maxk, int stride, __m128i& _sum0, __m128i& _sum1)
+{
+    _sum0 = _mm_setzero_si128();
+    _sum1 = _mm_setzero_si128();
+
+    int k=0;
+    for (; k+1<maxk; k+=2)
+    {
+        __m128i _val0 = convdw_load8_int8_sse(sptr + space_ofs[k], stride);
+        __m128i _val1 = convdw_load8_int8_sse(sptr + space_ofs[k+1], stride);
+
+        __m128i _k = _mm_set1_epi32((int)(unsigned short)(short)kptr[k] | ((int)kptr[k+1] << 16));
+
+        _sum0 = _mm_add_epi32(_sum0, _mm_madd_epi16(_mm_unpacklo_epi16(_val0, _val1), _k));
+        _sum1 = _mm_add_epi32(_sum1, _mm_madd_epi16(_mm_unpackhi_epi16(_val0, _val1), _k));
+    }
+    for (; k<maxk; k++)
+    {
+        __m128i _val = convdw_load8_int8_sse(sptr + space_ofs[k], stride);
+
+        __m128i _k = _mm_set1_epi32((int)(unsigned short)(short)kptr[k]);
+
+        _sum0 = _mm_add_epi32(_sum0, _mm_madd_epi16(_mm_unpacklo_epi16(_val, _mm_setzero_si128()), _k));
+        _sum1 = _mm_add_epi32(_sum1, _mm_madd_epi16(_mm_unpackhi_epi16(_val, _mm_setzero_si128()), _k));
+    }
+}
+#endif // __SSE2__
+
+static inline int convdw_int8_sum(const signed char* sptr, const signed char* kptr, const int* space_ofs, int maxk)
+{
+    int sum = 0;
+
+    for (int k=0; k<maxk; k++)
+    {
+        sum += (int)sptr[space_ofs[k]] * (int)kptr[k];
+    }
+
+    return sum;
+}
+
+static void convdw_int8_space_ofs(std::vector<int>& _space_ofs, int w, int kernel_w, int kernel_h, int dilation_w, int dilation_h)
+{
+    _space_ofs.resize(kernel_w * kernel_h);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = w * dilation_h - kernel_w * dilation_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2;
+                p1++;
+                p2 += dilation_w;
+            }
+            p2 += gap;
+        }
+    }
+}
+
+static void convdw_int8_dequant_sse(const Mat &bottom_blob, Mat &top_blob, const Mat &_kernel, const Mat &_bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, std::vector<float> scales_dequant, const Option& opt)
+{
+    int w = bottom_blob.w;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+
+    const signed char *kernel = _kernel;
+    const float* bias = _bias;
+
+    std::vector<int> _space_ofs;
+    convdw_int8_space_ofs(_space_ofs, w, kernel_w, kernel_h, dilation_w, dilation_h);
+    const int* space_ofs = &_space_ofs[0];
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < outch; p++)
+    {
+        float *outptr = top_blob.channel(p);
+
+        const float bias0 = bias ? bias[p] : 0.f;
+        const float scale_dequant = scales_dequant[p];
+
+        const signed char *kernel0 = (const signed char *)kernel + p * maxk;
+
+        const signed char *img0 = bottom_blob.channel(p);
+
+        for (int i = 0; i < outh; i++)
+        {
+            const signed char *r0 = img0 + w * i * stride_h;
+
+            int j = 0;
+#if __SSE2__
+            __m128 _scale = _mm_set1_ps(scale_dequant);
+            __m128 _bias0 = _mm_set1_ps(bias0);
+
+            for (; j+7 < outw; j+=8)
+            {
+                __m128i _sum0;
+                __m128i _sum1;
+                convdw_int8_sum8_sse(r0 + j * stride_w, kernel0, space_ofs, maxk, stride_w, _sum0, _sum1);
+
+                _mm_storeu_ps(outptr + j, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_sum0), _scale), _bias0));
+                _mm_storeu_ps(outptr + j + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_sum1), _scale), _bias0));
+            }
+#endif // __SSE2__
+            for (; j < outw; j++)
+            {
+                int sum = convdw_int8_sum(r0 + j * stride_w, kernel0, space_ofs, maxk);
+
+                outptr[j] = (float)sum * scale_dequant + bias0;
+            }
+
+            outptr += outw;
+        }
+    }
+}
+
+static void convdw_int8_requant_sse(const Mat &bottom_blob, Mat &top_blob, const Mat &_kernel, const Mat &_bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, std::vector<float> scales_requant, const Option& opt)
+{
+    int w = bottom_blob.w;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+
+    const signed char *kernel = _kernel;
+    const float* bias = _bias;
+
+    std::vector<int> _space_ofs;
+    convdw_int8_space_ofs(_space_ofs, w, kernel_w, kernel_h, dilation_w, dilation_h);
+    const int* space_ofs = &_space_ofs[0];
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < outch; p++)
+    {
+        signed char *outptr = top_blob.channel(p);
+
+        const float bias0 = bias ? bias[p] : 0.f;
+        const float scale_requant_in = scales_requant[2*p];
+        const float scale_requant_out = scales_requant[2*p+1];
+
+        const signed char *kernel0 = (const signed char *)kernel + p * maxk;
+
+        const signed char *img0 = bottom_blob.channel(p);
+
+        for (int i = 0; i < outh; i++)
+        {
+            const signed char *r0 = img0 + w * i * stride_h;
+
+            int j = 0;
+#if __SSE2__
+            for (; j+7 < outw; j+=8)
+            {
+                __m128i _sum0;
+                __m128i _sum1;
+                convdw_int8_sum8_sse(r0 + j * stride_w, kernel0, space_ofs, maxk, stride_w, _sum0, _sum1);
+
+                int sum[8];
+                _mm_storeu_si128((__m128i*)sum, _sum0);
+                _mm_storeu_si128((__m128i*)(sum + 4), _sum1);
+
+                for (int n = 0; n < 8; n++)
+                {
+                    outptr[j + n] = float2int8(((float)sum[n] * scale_requant_in + bias0) * scale_requant_out);
+                }
+            }
+#endif // __SSE2__
+            for (; j < outw; j++)
+            {
+                int sum = convdw_int8_sum(r0 + j * stride_w, kernel0, space_ofs, maxk);
+
+                outptr[j] = float2int8(((float)sum * scale_requant_in + bias0) * scale_requant_out);
+            }
+
+            outptr += outw;
+        }
+    }
+}
+
+// grouped, output channel p sums the inch / group input channels of its group
+static void convgroup_int8_dequant_sse(const Mat &bottom_blob, Mat &top_blob, const Mat &_kernel, const Mat &_bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int group, std::vector<float> scales_dequant, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const int inch_g = inch / group;
+    const int outch_g = outch / group;
+    const int maxk = kernel_w * kernel_h;
+
+    const signed char *kernel = _kernel;
+    const float* bias = _bias;
+
+    std::vector<int> _space_ofs;
+    convdw_int8_space_ofs(_space_ofs, w, kernel_w, kernel_h, dilation_w, dilation_h);
+    const int* space_ofs = &_space_ofs[0];
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < outch; p++)
+    {
+        const int g = p / outch_g;
+
+        float *outptr = top_blob.channel(p);
+
+        const float bias0 = bias ? bias[p] : 0.f;
+        const float scale_dequant = scales_dequant[g];
+
+        const signed char *kernel0 = (const signed char *)kernel + p * inch_g * maxk;
+
+        const Mat bottom_blob_g = bottom_blob.channel_range(inch_g * g, inch_g);
+
+        for (int i = 0; i < outh; i++)
+        {
+            const int rofs = w * i * stride_h;
+
+            int j = 0;
+#if __SSE2__
+            __m128 _scale = _mm_set1_ps(scale_dequant);
+            __m128 _bias0 = _mm_set1_ps(bias0);
+
+            for (; j+7 < outw; j+=8)
+            {
+                __m128i _sum0 = _mm_setzero_si128();
+                __m128i _sum1 = _mm_setzero_si128();
+
+                for (int q = 0; q < inch_g; q++)
+                {
+                    const signed char *r0 = (const signed char *)bottom_blob_g.channel(q) + rofs;
+
+                    __m128i _s0;
+                    __m128i _s1;
+                    convdw_int8_sum8_sse(r0 + j * stride_w, kernel0 + q * maxk, space_ofs, maxk, stride_w, _s0, _s1);
+
+                    _sum0 = _mm_add_epi32(_sum0, _s0);
+                    _sum1 = _mm_add_epi32(_sum1, _s1);
+                }
+
+                _mm_storeu_ps(outptr + j, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_sum0), _scale), _bias0));
+                _mm_storeu_ps(outptr + j + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_sum1), _scale), _bias0));
+            }
+#endif // __SSE2__
+            for (; j < outw; j++)
+            {
+                int sum = 0;
+
+                for (int q = 0; q < inch_g; q++)
+                {
+                    const signed char *r0 = (const signed char *)bottom_blob_g.channel(q) + rofs;
+
+                    sum += convdw_int8_sum(r0 + j * stride_w, kernel0 + q * maxk, space_ofs, maxk);
+                }
+
+                outptr[j] = (float)sum * scale_dequant + bias0;
+            }
+
+            outptr += outw;
+        }
+    }
+}
+
+static void convgroup_int8_requant_sse(const Mat &bottom_blob, Mat &top_blob, const Mat &_kernel, const Mat &_bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int group, std::vector<float> scales_requant, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const int inch_g = inch / group;
+    const int outch_g = outch / group;
+    const int maxk = kernel_w * kernel_h;
+
+    const signed char *kernel = _kernel;
+    const float* bias = _bias;
+
+    std::vector<int> _space_ofs;
+    convdw_int8_space_ofs(_space_ofs, w, kernel_w, kernel_h, dilation_w, dilation_h);
+    const int* space_ofs = &_space_ofs[0];
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < outch; p++)
+    {
+        const int g = p / outch_g;
+
+        signed char *outptr = top_blob.channel(p);
+
+        const float bias0 = bias ? bias[p] : 0.f;
+        const float scale_requant_in = scales_requant[2*g];
+        const float scale_requant_out = scales_requant[2*g+1];
+
+        const signed char *kernel0 = (const signed char *)kernel + p * inch_g * maxk;
+
+        const Mat bottom_blob_g = bottom_blob.channel_range(inch_g * g, inch_g);
+
+        for (int i = 0; i < outh; i++)
+        {
+            const int rofs = w * i * stride_h;
+
+            int j = 0;
+#if __SSE2__
+            for (; j+7 < outw; j+=8)
+            {
+                __m128i _sum0 = _mm_setzero_si128();
+                __m128i _sum1 = _mm_setzero_si128();
+
+                for (int q = 0; q < inch_g; q++)
+                {
+                    const signed char *r0 = (const signed char *)bottom_blob_g.channel(q) + rofs;
+
+                    __m128i _s0;
+                    __m128i _s1;
+                    convdw_int8_sum8_sse(r0 + j * stride_w, kernel0 + q * maxk, space_ofs, maxk, stride_w, _s0, _s1);
+
+                    _sum0 = _mm_add_epi32(_sum0, _s0);
+                    _sum1 = _mm_add_epi32(_sum1, _s1);
+                }
+
+                int sum[8];
+                _mm_storeu_si128((__m128i*)sum, _sum0);
+                _mm_storeu_si128((__m128i*)(sum + 4), _sum1);
+
+                for (int n = 0; n < 8; n++)
+                {
+                    outptr[j + n] = float2int8(((float)sum[n] * scale_requant_in + bias0) * scale_requant_out);
+                }
+            }
+#endif // __SSE2__
+            for (; j < outw; j++)
+            {
+                int sum = 0;
+
+                for (int q = 0; q < inch_g; q++)
+                {
+                    const signed char *r0 = (const signed char *)bottom_blob_g.channel(q) + rofs;
+
+                    sum += convdw_int8_sum(r0 + j * stride_w, kernel0 + q * maxk, space_ofs, maxk);
+                }
+
+                outptr[j] = float2int8(((float)sum * scale_requant_in + bias0) * scale_requant_out);
+            }
+
+            outptr += outw;
+        }
+    }
+}
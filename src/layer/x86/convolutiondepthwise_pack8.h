@@ -0,0 +1,149 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+static void convdw_transform_kernel_pack8_avx(const Mat& _kernel, Mat& kernel_pack8, int group, int maxk)
+{
+    // maxk-group to pack8 rows of maxk, lane l holds the weight of channel g*8+l
+    Mat weight_data_r2 = _kernel.reshape(maxk, group);
+    convert_packing(weight_data_r2, kernel_pack8, 8);
+}
+
+// pack8 window partially outside the input, padding contributes zero
+static inline __m256 convdw_window_pack8(const Mat& m, int sx, int sy, const float* kptr, int kernel_w, int kernel_h, int dilation_w, int dilation_h, __m256 _sum)
+{
+    int x0, x1, y0, y1;
+    convdw_clip(sx, m.w, kernel_w, dilation_w, x0, x1);
+    convdw_clip(sy, m.h, kernel_h, dilation_h, y0, y1);
+
+    for (int y=y0; y<y1; y++)
+    {
+        const float* ptr = m.row(sy + y * dilation_h);
+        const float* k0 = kptr + y * kernel_w * 8;
+
+        for (int x=x0; x<x1; x++)
+        {
+            _sum = _mm256_fmadd_ps(_mm256_loadu_ps(ptr + (sx + x * dilation_w) * 8), _mm256_loadu_ps(k0 + x * 8), _sum);
+        }
+    }
+
+    return _sum;
+}
+
+static void convdw_pack8_avx(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_pack8, const Mat& _bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int pad_left, int pad_top, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+
+    const int group = bottom_blob.c;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+
+    const float* bias = _bias;
+
+    const int step = stride_w * 8;
+    const int dstep = dilation_w * 8;
+
+    // output columns whose window lies inside the input
+    int jstart = std::min(std::max((pad_left + stride_w - 1) / stride_w, 0), outw);
+    int jend = w - kernel_extent_w + pad_left < 0 ? 0 : std::min((w - kernel_extent_w + pad_left) / stride_w + 1, outw);
+    jend = std::max(jend, jstart);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g=0; g<group; g++)
+    {
+        float* outptr = top_blob.channel(g);
+
+        const __m256 _bias0 = bias ? _mm256_loadu_ps(bias + g * 8) : _mm256_setzero_ps();
+
+        const float* kernel0 = kernel_pack8.row(g);
+
+        const Mat m = bottom_blob.channel(g);
+
+        for (int i=0; i<outh; i++)
+        {
+            int sy = i * stride_h - pad_top;
+
+            // kernel rows inside the input, the rest read zero padding
+            int y0, y1;
+            convdw_clip(sy, h, kernel_h, dilation_h, y0, y1);
+
+            for (int j=0; j<jstart; j++)
+            {
+                _mm256_storeu_ps(outptr + j * 8, convdw_window_pack8(m, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, _bias0));
+            }
+
+            int j = jstart;
+            for (; j<jend && jend-jstart>=4; j+=4)
+            {
+                // the last block overlaps the one before rather than leave a scalar tail
+                j = std::min(j, jend - 4);
+
+                __m256 _sum0 = _bias0;
+                __m256 _sum1 = _bias0;
+                __m256 _sum2 = _bias0;
+                __m256 _sum3 = _bias0;
+
+                for (int y=y0; y<y1; y++)
+                {
+                    const float* sptr = m.row(sy + y * dilation_h) + (j * stride_w - pad_left) * 8;
+                    const float* k0 = kernel0 + y * kernel_w * 8;
+
+                    for (int x=0; x<kernel_w; x++)
+                    {
+                        __m256 _k = _mm256_loadu_ps(k0 + x * 8);
+                        const float* s = sptr + x * dstep;
+
+                        _sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(s), _k, _sum0);
+                        _sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(s + step), _k, _sum1);
+                        _sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(s + step * 2), _k, _sum2);
+                        _sum3 = _mm256_fmadd_ps(_mm256_loadu_ps(s + step * 3), _k, _sum3);
+                    }
+                }
+
+                _mm256_storeu_ps(outptr + j * 8, _sum0);
+                _mm256_storeu_ps(outptr + j * 8 + 8, _sum1);
+                _mm256_storeu_ps(outptr + j * 8 + 16, _sum2);
+                _mm256_storeu_ps(outptr + j * 8 + 24, _sum3);
+            }
+            for (; j<jend; j++)
+            {
+                __m256 _sum = _bias0;
+
+                for (int y=y0; y<y1; y++)
+                {
+                    const float* sptr = m.row(sy + y * dilation_h) + (j * stride_w - pad_left) * 8;
+                    const float* k0 = kernel0 + y * kernel_w * 8;
+
+                    for (int x=0; x<kernel_w; x++)
+                    {
+                        _sum = _mm256_fmadd_ps(_mm256_loadu_ps(sptr + x * dstep), _mm256_loadu_ps(k0 + x * 8), _sum);
+                    }
+                }
+
+                _mm256_storeu_ps(outptr + j * 8, _sum);
+            }
+
+            for (j=jend; j<outw; j++)
+            {
+                _mm256_storeu_ps(outptr + j * 8, convdw_window_pack8(m, j * stride_w - pad_left, sy, kernel0, kernel_w, kernel_h, dilation_w, dilation_h, _bias0));
+            }
+
+            outptr += outw * 8;
+        }
+    }
+}
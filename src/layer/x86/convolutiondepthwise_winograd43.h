@@ -0,0 +1,412 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#if __SSE2__
+// BT of one 6 point line, four tiles per lane
+static inline void convgroup_winograd43_bt_sse(const __m128* d, __m128* o)
+{
+    __m128 _2 = _mm_set1_ps(2.f);
+    __m128 _4 = _mm_set1_ps(4.f);
+    __m128 _5 = _mm_set1_ps(5.f);
+
+    __m128 _d12 = _mm_add_ps(d[1], d[2]);
+    __m128 _d12n = _mm_sub_ps(d[1], d[2]);
+    __m128 _d42 = _mm_sub_ps(d[4], d[2]);
+    __m128 _d13 = _mm_mul_ps(_mm_sub_ps(d[1], d[3]), _2);
+
+    o[0] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(d[0], _4), _mm_mul_ps(d[2], _5)), d[4]);
+    o[1] = _mm_sub_ps(_mm_add_ps(d[3], d[4]), _mm_mul_ps(_d12, _4));
+    o[2] = _mm_add_ps(_mm_sub_ps(d[4], d[3]), _mm_mul_ps(_d12n, _4));
+    o[3] = _mm_sub_ps(_d42, _d13);
+    o[4] = _mm_add_ps(_d42, _d13);
+    o[5] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(d[1], _4), _mm_mul_ps(d[3], _5)), d[5]);
+}
+
+// AT of one 6 point line, four tiles per lane
+static inline void convgroup_winograd43_at_sse(const __m128* m, __m128* o)
+{
+    __m128 _m12 = _mm_add_ps(m[1], m[2]);
+    __m128 _m12n = _mm_sub_ps(m[1], m[2]);
+    __m128 _m34 = _mm_add_ps(m[3], m[4]);
+    __m128 _m34n = _mm_sub_ps(m[3], m[4]);
+
+    o[0] = _mm_add_ps(_mm_add_ps(m[0], _m12), _m34);
+    o[1] = _mm_add_ps(_m12n, _mm_mul_ps(_m34n, _mm_set1_ps(2.f)));
+    o[2] = _mm_add_ps(_m12, _mm_mul_ps(_m34, _mm_set1_ps(4.f)));
+    o[3] = _mm_add_ps(_mm_add_ps(m[5], _m12n), _mm_mul_ps(_m34n, _mm_set1_ps(8.f)));
+}
+#endif // __SSE2__
+
+static void convgroup3x3s1_winograd43_transform_kernel_sse(const Mat& kernel, std::vector<Mat>& kernel_tm, int inch_g, int outch_g, int group)
+{
+    // U = G g GT, packed as sgemm A for each group and each of the 36 positions
+    kernel_tm.resize(group * 36);
+
+    // G
+    const float ktm[6][3] = {
+        {  1.0f/4,     0.0f,    0.0f},
+        { -1.0f/6,  -1.0f/6, -1.0f/6},
+        { -1.0f/6,   1.0f/6, -1.0f/6},
+        { 1.0f/24,  1.0f/12,  1.0f/6},
+        { 1.0f/24, -1.0f/12,  1.0f/6},
+        {    0.0f,     0.0f,    1.0f}
+    };
+
+    #pragma omp parallel for
+    for (int g=0; g<group; g++)
+    {
+        // outch_g x inch_g per position
+        Mat U(inch_g * outch_g, 36);
+
+        for (int p=0; p<outch_g; p++)
+        {
+            for (int q=0; q<inch_g; q++)
+            {
+                const float* k = (const float*)kernel + ((g * outch_g + p) * inch_g + q) * 9;
+
+                // h
+                float tmp[6][3];
+                for (int a=0; a<6; a++)
+                {
+                    for (int v=0; v<3; v++)
+                    {
+                        tmp[a][v] = ktm[a][0] * k[v] + ktm[a][1] * k[3 + v] + ktm[a][2] * k[6 + v];
+                    }
+                }
+
+                // U
+                for (int a=0; a<6; a++)
+                {
+                    for (int b=0; b<6; b++)
+                    {
+                        U.row(a * 6 + b)[p * inch_g + q] = tmp[a][0] * ktm[b][0] + tmp[a][1] * ktm[b][1] + tmp[a][2] * ktm[b][2];
+                    }
+                }
+            }
+        }
+
+        for (int r=0; r<36; r++)
+        {
+            sgemm_pack_a(U.row(r), inch_g, 1, outch_g, inch_g, kernel_tm[g * 36 + r], 0);
+        }
+    }
+}
+
+static void convgroup3x3s1_winograd43_sse(const Mat& bottom_blob, Mat& top_blob, const std::vector<Mat>& kernel_tm, const Mat& _bias, int group, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    size_t elemsize = bottom_blob.elemsize;
+    const float* bias = _bias;
+
+    const int inch_g = inch / group;
+    const int outch_g = outch / group;
+
+    // pad to 4n+2, winograd F(4,3)
+    Mat bottom_blob_bordered = bottom_blob;
+
+    int outw_tm = (outw + 3) / 4 * 4;
+    int outh_tm = (outh + 3) / 4 * 4;
+
+    w = outw_tm + 2;
+    h = outh_tm + 2;
+
+    if (w != bottom_blob.w || h != bottom_blob.h)
+    {
+        Option opt_b = opt;
+        opt_b.blob_allocator = opt.workspace_allocator;
+        copy_make_border(bottom_blob, bottom_blob_bordered, 0, h - bottom_blob.h, 0, w - bottom_blob.w, BORDER_CONSTANT, 0.f, opt_b);
+    }
+
+    const int nColBlocks = outh_tm / 4;
+    const int nRowBlocks = outw_tm / 4;
+    const int tiles = nColBlocks * nRowBlocks;
+
+    // V of each group and position is written straight into sgemm B panels of sgemm_nr tiles
+    const int nn_tiles = (tiles + sgemm_nr - 1) / sgemm_nr;
+    const int vstep = sgemm_nr * inch_g;
+
+    Mat bottom_blob_tm(vstep, nn_tiles, group * 36, elemsize, opt.workspace_allocator);
+    Mat top_blob_tm(tiles, 36, outch, elemsize, opt.workspace_allocator);
+
+    // BT d B, one job per group and panel so that every panel is written front to back
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int gp=0; gp<group * nn_tiles; gp++)
+    {
+        const int g = gp / nn_tiles;
+        const int pp = gp % nn_tiles;
+
+        const int t0 = pp * sgemm_nr;
+        const int t1 = std::min(t0 + sgemm_nr, tiles);
+
+        for (int k=0; k<inch_g; k++)
+        {
+            const float* img = bottom_blob_bordered.channel(g * inch_g + k);
+
+            // row k of panel pp of every position
+            float* vptr[36];
+            for (int r=0; r<36; r++)
+            {
+                vptr[r] = bottom_blob_tm.channel(g * 36 + r).row(pp) + k * sgemm_nr - t0;
+            }
+
+            int t = t0;
+#if __SSE2__
+            for (; t+3<t1; t+=4)
+            {
+                const float* r0[4];
+                for (int n=0; n<4; n++)
+                {
+                    r0[n] = img + w * ((t + n) / nRowBlocks) * 4 + (t + n) % nRowBlocks * 4;
+                }
+
+                // d of four tiles, [column][row]
+                __m128 _d[6][6];
+                for (int u=0; u<6; u++)
+                {
+                    __m128 _c0 = _mm_loadu_ps(r0[0] + w * u);
+                    __m128 _c1 = _mm_loadu_ps(r0[1] + w * u);
+                    __m128 _c2 = _mm_loadu_ps(r0[2] + w * u);
+                    __m128 _c3 = _mm_loadu_ps(r0[3] + w * u);
+                    _MM_TRANSPOSE4_PS(_c0, _c1, _c2, _c3);
+
+                    // columns 2 to 5
+                    __m128 _e0 = _mm_loadu_ps(r0[0] + w * u + 2);
+                    __m128 _e1 = _mm_loadu_ps(r0[1] + w * u + 2);
+                    __m128 _e2 = _mm_loadu_ps(r0[2] + w * u + 2);
+                    __m128 _e3 = _mm_loadu_ps(r0[3] + w * u + 2);
+                    _MM_TRANSPOSE4_PS(_e0, _e1, _e2, _e3);
+
+                    _d[0][u] = _c0;
+                    _d[1][u] = _c1;
+                    _d[2][u] = _c2;
+                    _d[3][u] = _c3;
+                    _d[4][u] = _e2;
+                    _d[5][u] = _e3;
+                }
+
+                __m128 _tmp[6][6];
+                for (int v=0; v<6; v++)
+                {
+                    __m128 _o[6];
+                    convgroup_winograd43_bt_sse(_d[v], _o);
+
+                    for (int a=0; a<6; a++)
+                        _tmp[a][v] = _o[a];
+                }
+
+                for (int a=0; a<6; a++)
+                {
+                    __m128 _o[6];
+                    convgroup_winograd43_bt_sse(_tmp[a], _o);
+
+                    for (int b=0; b<6; b++)
+                        _mm_storeu_ps(vptr[a*6 + b] + t, _o[b]);
+                }
+            }
+#endif // __SSE2__
+            for (; t<t1; t++)
+            {
+                const float* r0 = img + w * (t / nRowBlocks) * 4 + t % nRowBlocks * 4;
+
+                float tmp[6][6];
+
+                // 0 =  4 * r00 - 5 * r02 + r04
+                // 1 = -4 * (r01 + r02) + r03 + r04
+                // 2 =  4 * (r01 - r02) - r03 + r04
+                // 3 = -2 * r01 - r02 + 2 * r03 + r04
+                // 4 =  2 * r01 - r02 - 2 * r03 + r04
+                // 5 =  4 * r01 - 5 * r03 + r05
+                for (int v=0; v<6; v++)
+                {
+                    const float d0 = r0[v];
+                    const float d1 = r0[w + v];
+                    const float d2 = r0[w*2 + v];
+                    const float d3 = r0[w*3 + v];
+                    const float d4 = r0[w*4 + v];
+                    const float d5 = r0[w*5 + v];
+
+                    tmp[0][v] = 4 * d0 - 5 * d2 + d4;
+                    tmp[1][v] = -4 * (d1 + d2) + d3 + d4;
+                    tmp[2][v] = 4 * (d1 - d2) - d3 + d4;
+                    tmp[3][v] = -2 * d1 - d2 + 2 * d3 + d4;
+                    tmp[4][v] = 2 * d1 - d2 - 2 * d3 + d4;
+                    tmp[5][v] = 4 * d1 - 5 * d3 + d5;
+                }
+
+                for (int a=0; a<6; a++)
+                {
+                    const float* tmp0 = tmp[a];
+
+                    vptr[a*6 + 0][t] = 4 * tmp0[0] - 5 * tmp0[2] + tmp0[4];
+                    vptr[a*6 + 1][t] = -4 * (tmp0[1] + tmp0[2]) + tmp0[3] + tmp0[4];
+                    vptr[a*6 + 2][t] = 4 * (tmp0[1] - tmp0[2]) - tmp0[3] + tmp0[4];
+                    vptr[a*6 + 3][t] = -2 * tmp0[1] - tmp0[2] + 2 * tmp0[3] + tmp0[4];
+                    vptr[a*6 + 4][t] = 2 * tmp0[1] - tmp0[2] - 2 * tmp0[3] + tmp0[4];
+                    vptr[a*6 + 5][t] = 4 * tmp0[1] - 5 * tmp0[3] + tmp0[5];
+                }
+            }
+
+            // the last panel is zero padded past the last tile
+            for (; t<t0 + sgemm_nr; t++)
+            {
+                for (int r=0; r<36; r++)
+                    vptr[r][t] = 0.f;
+            }
+        }
+    }
+
+    // U V per group and position, the 36 * group products are spread over the threads
+    Option opt_g = opt;
+    opt_g.num_threads = 1;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int gr=0; gr<group * 36; gr++)
+    {
+        const int g = gr / 36;
+        const int r = gr % 36;
+
+        float* outptr = top_blob_tm.channel(g * outch_g).row(r);
+
+        sgemm(outch_g, tiles, inch_g, kernel_tm[gr], bottom_blob_tm.channel(gr), 0, outptr, (int)top_blob_tm.cstep, 1, opt_g);
+    }
+
+    // AT m A
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p=0; p<outch; p++)
+    {
+        const Mat out_tm = top_blob_tm.channel(p);
+        float* outptr = top_blob.channel(p);
+
+        const float bias0 = bias ? bias[p] : 0.f;
+
+        for (int j=0; j<nColBlocks; j++)
+        {
+            int i=0;
+#if __SSE2__
+            for (; i+3<nRowBlocks; i+=4)
+            {
+                const int t = j * nRowBlocks + i;
+
+                __m128 _tmp[4][6];
+                for (int b=0; b<6; b++)
+                {
+                    __m128 _m[6];
+                    for (int a=0; a<6; a++)
+                        _m[a] = _mm_loadu_ps(out_tm.row(a*6 + b) + t);
+
+                    __m128 _o[4];
+                    convgroup_winograd43_at_sse(_m, _o);
+
+                    for (int a=0; a<4; a++)
+                        _tmp[a][b] = _o[a];
+                }
+
+                for (int a=0; a<4; a++)
+                {
+                    const int y = j * 4 + a;
+                    if (y >= outh)
+                        break;
+
+                    __m128 _o[4];
+                    convgroup_winograd43_at_sse(_tmp[a], _o);
+
+                    __m128 _bias0 = _mm_set1_ps(bias0);
+                    __m128 _o0 = _mm_add_ps(_o[0], _bias0);
+                    __m128 _o1 = _mm_add_ps(_o[1], _bias0);
+                    __m128 _o2 = _mm_add_ps(_o[2], _bias0);
+                    __m128 _o3 = _mm_add_ps(_o[3], _bias0);
+
+                    // back to four columns per tile
+                    _MM_TRANSPOSE4_PS(_o0, _o1, _o2, _o3);
+
+                    float* out0 = outptr + y * outw + i * 4;
+
+                    if (i * 4 + 15 < outw)
+                    {
+                        _mm_storeu_ps(out0, _o0);
+                        _mm_storeu_ps(out0 + 4, _o1);
+                        _mm_storeu_ps(out0 + 8, _o2);
+                        _mm_storeu_ps(out0 + 12, _o3);
+                    }
+                    else
+                    {
+                        float o[16];
+                        _mm_storeu_ps(o, _o0);
+                        _mm_storeu_ps(o + 4, _o1);
+                        _mm_storeu_ps(o + 8, _o2);
+                        _mm_storeu_ps(o + 12, _o3);
+
+                        for (int b=0; b<16 && i * 4 + b < outw; b++)
+                        {
+                            out0[b] = o[b];
+                        }
+                    }
+                }
+            }
+#endif // __SSE2__
+            for (; i<nRowBlocks; i++)
+            {
+                const int t = j * nRowBlocks + i;
+
+                // 0 = r00 + (r01 + r02) + (r03 + r04)
+                // 1 =       (r01 - r02) + (r03 - r04) * 2
+                // 2 =       (r01 + r02) + (r03 + r04) * 4
+                // 3 = r05 + (r01 - r02) + (r03 - r04) * 8
+                float tmp[4][6];
+                for (int b=0; b<6; b++)
+                {
+                    const float m0 = out_tm.row(b)[t];
+                    const float m1 = out_tm.row(6 + b)[t];
+                    const float m2 = out_tm.row(12 + b)[t];
+                    const float m3 = out_tm.row(18 + b)[t];
+                    const float m4 = out_tm.row(24 + b)[t];
+                    const float m5 = out_tm.row(30 + b)[t];
+
+                    tmp[0][b] = m0 + (m1 + m2) + (m3 + m4);
+                    tmp[1][b] = (m1 - m2) + (m3 - m4) * 2;
+                    tmp[2][b] = (m1 + m2) + (m3 + m4) * 4;
+                    tmp[3][b] = m5 + (m1 - m2) + (m3 - m4) * 8;
+                }
+
+                for (int a=0; a<4; a++)
+                {
+                    const int y = j * 4 + a;
+                    if (y >= outh)
+                        break;
+
+                    const float* tmp0 = tmp[a];
+
+                    float o[4];
+                    o[0] = bias0 + tmp0[0] + (tmp0[1] + tmp0[2]) + (tmp0[3] + tmp0[4]);
+                    o[1] = bias0 + (tmp0[1] - tmp0[2]) + (tmp0[3] - tmp0[4]) * 2;
+                    o[2] = bias0 + (tmp0[1] + tmp0[2]) + (tmp0[3] + tmp0[4]) * 4;
+                    o[3] = bias0 + tmp0[5] + (tmp0[1] - tmp0[2]) + (tmp0[3] - tmp0[4]) * 8;
+
+                    float* out0 = outptr + y * outw + i * 4;
+                    for (int b=0; b<4 && i * 4 + b < outw; b++)
+                    {
+                        out0[b] = o[b];
+                    }
+                }
+            }
+        }
+    }
+}
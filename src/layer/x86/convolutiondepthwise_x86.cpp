@@ -14,23 +14,143 @@
 
 #include "convolutiondepthwise_x86.h"
 
+#include <algorithm>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#if __SSE2__
+#include <emmintrin.h>
+#endif
+#if __AVX__
+#include <immintrin.h>
+#endif
+
 #include "layer_type.h"
+#include "quantize.h"
 
 namespace ncnn {
 
+#if __SSE2__
+// p[0] p[stride] p[stride*2] p[stride*3], never reads beyond the last element
+static inline __m128 convdw_load4_sse(const float* p, int stride)
+{
+    if (stride == 1)
+        return _mm_loadu_ps(p);
+
+    if (stride == 2)
+        return _mm_shuffle_ps(_mm_loadu_ps(p), _mm_loadu_ps(p + 3), _MM_SHUFFLE(3, 1, 2, 0));
+
+    return _mm_setr_ps(p[0], p[stride], p[stride*2], p[stride*3]);
+}
+#endif // __SSE2__
+
+#if __AVX__
+// p[0] p[stride] ... p[stride*7], never reads beyond the last element
+static inline __m256 convdw_load8_avx(const float* p, int stride)
+{
+    if (stride == 1)
+        return _mm256_loadu_ps(p);
+
+    if (stride == 2)
+    {
+        // a0 a1 a2 a3 a4 a5 a6 a7
+        // b1 b0 b3 b2 b5 b4 b7 b6  where b0 = p[7]
+        __m256 _a = _mm256_loadu_ps(p);
+        __m256 _b = _mm256_permute_ps(_mm256_loadu_ps(p + 7), _MM_SHUFFLE(2, 3, 0, 1));
+
+        __m256 _lo = _mm256_permute2f128_ps(_a, _b, 0x20);
+        __m256 _hi = _mm256_permute2f128_ps(_a, _b, 0x31);
+
+        return _mm256_shuffle_ps(_lo, _hi, _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    return _mm256_setr_ps(p[0], p[stride], p[stride*2], p[stride*3], p[stride*4], p[stride*5], p[stride*6], p[stride*7]);
+}
+#endif // __AVX__
+
+// kernel taps [t0, t1) of a window starting at s land inside [0, size)
+static inline void convdw_clip(int s, int size, int kernel, int dilation, int& t0, int& t1)
+{
+    t0 = s < 0 ? (-s + dilation - 1) / dilation : 0;
+    t1 = std::min(kernel, (size - s + dilation - 1) / dilation);
+    t1 = std::max(t1, t0);
+}
+
+// window partially outside the input, padding contributes zero
+static inline float convdw_window(const Mat& m, int sx, int sy, const float* kptr, int kernel_w, int kernel_h, int dilation_w, int dilation_h, float sum)
+{
+    int x0, x1, y0, y1;
+    convdw_clip(sx, m.w, kernel_w, dilation_w, x0, x1);
+    convdw_clip(sy, m.h, kernel_h, dilation_h, y0, y1);
+
+#if __AVX__
+    if (dilation_w == 1 && x1 - x0 <= 8)
+    {
+        // the taps of a kernel row are contiguous, masked lanes are never read
+        static const int mask_table[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+        const __m256i _mask = _mm256_loadu_si256((const __m256i*)(mask_table + 8 - (x1 - x0)));
+
+        __m256 _sum = _mm256_setzero_ps();
+
+        for (int y=y0; y<y1; y++)
+        {
+            const float* ptr = m.row(sy + y * dilation_h) + sx + x0;
+            const float* k0 = kptr + y * kernel_w + x0;
+
+            _sum = _mm256_fmadd_ps(_mm256_maskload_ps(ptr, _mask), _mm256_maskload_ps(k0, _mask), _sum);
+        }
+
+        __m128 _ss = _mm_add_ps(_mm256_castps256_ps128(_sum), _mm256_extractf128_ps(_sum, 1));
+        _ss = _mm_add_ps(_ss, _mm_movehl_ps(_ss, _ss));
+        _ss = _mm_add_ss(_ss, _mm_shuffle_ps(_ss, _ss, 1));
+
+        return sum + _mm_cvtss_f32(_ss);
+    }
+#endif // __AVX__
+
+    // one partial sum per kernel row keeps the adds independent
+    for (int y=y0; y<y1; y++)
+    {
+        const float* ptr = m.row(sy + y * dilation_h);
+        const float* k0 = kptr + y * kernel_w;
+
+        float sum_y = 0.f;
+        for (int x=x0; x<x1; x++)
+        {
+            sum_y += ptr[sx + x * dilation_w] * k0[x];
+        }
+
+        sum += sum_y;
+    }
+
+    return sum;
+}
+
 #include "convolutiondepthwise_3x3.h"
+#include "convolutiondepthwise_kxk.h"
+#include "convolutiondepthwise_5x5.h"
+#include "sgemm.h"
+#include "convolution_sgemm.h"
+#include "convolutiondepthwise_winograd43.h"
+#if __AVX__
+#include "convolutiondepthwise_pack8.h"
+#endif // __AVX__
 
 #include "convolutiondepthwise_3x3_int8.h"
+#include "convolutiondepthwise_kxk_int8.h"
 
 DEFINE_LAYER_CREATOR(ConvolutionDepthWise_x86)
 
 ConvolutionDepthWise_x86::ConvolutionDepthWise_x86()
 {
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+
     activation = 0;
+    use_winograd3x3 = false;
 }
 
 int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
@@ -75,91 +195,58 @@ int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
         activation->create_pipeline(opt_cpu);
     }
 
-    // create Convolution op for each group
     const int maxk = kernel_w * kernel_h;
     int channels = (weight_data_size / group) / maxk / (num_output / group) * group;
 
-    for (int i=0; i<(int)group_ops.size(); i++)
-        delete group_ops[i];
-
-    group_ops.clear();      
+    use_winograd3x3 = false;
 
     if (channels == group && group == num_output)
     {
-        // depth-wise specific
-        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1)
+#if __AVX__
+        if (opt.use_packing_layout)
         {
-            if ((stride_w == 1 && stride_h == 1) || (stride_w == 2 && stride_h == 2))
-            {
-                return 0;
-            }
-        }
-    }    
-
-    const int channels_g = channels / group;
-    const int num_output_g = num_output / group;
-
-    group_ops.resize(group);     
 
-    for (int g=0; g<group; g++)
-    {  
-        Mat weight_data_g = weight_data.range(maxk * channels_g * num_output_g * g, maxk * channels_g * num_output_g);
-        Mat bias_data_g;
-        if (bias_term)
-            bias_data_g = bias_data.range(num_output_g * g, num_output_g);
+        // depth-wise
+        if (channels % 8 == 0 && !use_int8_inference)
+        {
+            convdw_transform_kernel_pack8_avx(weight_data, weight_data_pack8, group, maxk);
+        }
 
-        ncnn::Layer* op = ncnn::create_layer(ncnn::LayerType::Convolution);
+        } // opt.use_packing_layout
+#endif // __AVX__
 
-        // set param
-        ncnn::ParamDict pd;
-        pd.set(0, num_output_g);// num_output
-        pd.set(1, kernel_w);
-        pd.set(11, kernel_h);
-        pd.set(2, dilation_w);
-        pd.set(12, dilation_h);
-        pd.set(3, stride_w);
-        pd.set(13, stride_h);
-        pd.set(4, 0);// pad_w
-        pd.set(14, 0);// pad_h
-        pd.set(5, bias_term);
-        pd.set(6, maxk * channels_g * num_output_g);// weight_data_size
-        pd.set(8, int8_scale_term);
-
-        op->load_param(pd);
-
-        // set weights
-        if (bias_term)
-        {
-            ncnn::Mat weights[4];
-            weights[0] = weight_data_g;
-            weights[1] = bias_data_g;
+        // depth-wise kernels read weight_data directly
+        return 0;
+    }
 
-            if (int8_scale_term)
-            {
-                weights[2] = weight_data_int8_scales.range(g, 1);
-                weights[3] = bottom_blob_int8_scales.range(g, 1);     
-            }
+    // the int8 grouped kernels read the quantized weight_data directly
+    if (use_int8_inference)
+        return 0;
 
-            op->load_model(ModelBinFromMatArray(weights));
-        }
-        else
-        {
-            ncnn::Mat weights[3];
-            weights[0] = weight_data_g;
+    const int channels_g = channels / group;
+    const int num_output_g = num_output / group;
 
-            if (int8_scale_term)
-            {
-                weights[1] = weight_data_int8_scales.range(g, 1);
-                weights[2] = bottom_blob_int8_scales.range(g, 1);
-            }
+    // pack the weights of every group for the native grouped kernels
+    if (opt.use_winograd_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+    {
+        // winograd is slow on small channel count
+        if (channels_g >= 16 && num_output_g >= 16)
+            use_winograd3x3 = true;
+    }
 
-            op->load_model(ModelBinFromMatArray(weights));
-        }
+    if (use_winograd3x3)
+    {
+        convgroup3x3s1_winograd43_transform_kernel_sse(weight_data, weight_3x3_winograd43_data, channels_g, num_output_g, group);
+    }
 
-        op->create_pipeline(opt_cpu);
+    // kernel memory packed as sgemm A panels, one set per group
+    weight_sgemm_data.resize(group);
+    for (int g=0; g<group; g++)
+    {
+        const float* kernel = (const float*)weight_data + maxk * channels_g * num_output_g * g;
 
-        group_ops[g] = op;
-    }      
+        sgemm_pack_a(kernel, maxk * channels_g, 1, num_output_g, maxk * channels_g, weight_sgemm_data[g], 0);
+    }
 
     return 0;
 }
@@ -176,13 +263,6 @@ int ConvolutionDepthWise_x86::destroy_pipeline(const Option& opt)
         activation = 0;
     }
 
-    for (int i=0; i<(int)group_ops.size(); i++)
-    {
-        group_ops[i]->destroy_pipeline(opt_cpu);
-        delete group_ops[i];
-    }
-    group_ops.clear();
-
     return 0;
 }
 
@@ -191,6 +271,30 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
     // convolv with NxN kernel
     // value = value + bias
 
+#if __AVX__
+    if (opt.use_packing_layout)
+    {
+
+    if (bottom_blob.elempack == 8)
+    {
+        if (!weight_data_pack8.empty() && bottom_blob.dims == 3)
+            return forward_pack8(bottom_blob, top_blob, opt);
+
+        // group convolution and int8 run on pack1
+        Option opt_pack = opt;
+        opt_pack.blob_allocator = opt.workspace_allocator;
+
+        Mat bottom_blob_unpacked;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+
+        return forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
+    } // opt.use_packing_layout
+#endif // __AVX__
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     int channels = bottom_blob.c;
@@ -205,6 +309,44 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
     const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
     const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
 
+    // resolve the padding, the float depth-wise and grouped sgemm kernels read the border in place
+    int pad_t = pad_top;
+    int pad_b = pad_bottom;
+    int pad_l = pad_left;
+    int pad_r = pad_right;
+
+    if ((pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
+        || (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234))
+    {
+        int wpad = kernel_extent_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_extent_h + (h - 1) / stride_h * stride_h - h;
+
+        pad_t = 0;
+        pad_b = 0;
+        pad_l = 0;
+        pad_r = 0;
+
+        if (wpad > 0 || hpad > 0)
+        {
+            // -233 pads the extra pixel after, -234 before
+            pad_t = pad_left == -233 ? hpad / 2 : hpad - hpad / 2;
+            pad_b = hpad - pad_t;
+            pad_l = pad_left == -233 ? wpad / 2 : wpad - wpad / 2;
+            pad_r = wpad - pad_l;
+        }
+    }
+
+    if (pad_t <= 0 && pad_b <= 0 && pad_l <= 0 && pad_r <= 0)
+    {
+        pad_t = 0;
+        pad_b = 0;
+        pad_l = 0;
+        pad_r = 0;
+    }
+
+    int outw = (w + pad_l + pad_r - kernel_extent_w) / stride_w + 1;
+    int outh = (h + pad_t + pad_b - kernel_extent_h) / stride_h + 1;
+
     Mat bottom_blob_unbordered = bottom_blob;
     if (use_int8_inference && elemsize != 1)
     {
@@ -231,64 +373,24 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
         bottom_blob_unbordered = bottom_blob_int8;       
     }     
 
+    const bool use_winograd3x3_g = !use_int8_inference && use_winograd3x3 && outw >= 8 && outh >= 8;
+
+    // int8 and grouped winograd read a bordered copy
     Mat bottom_blob_bordered = bottom_blob_unbordered;
-    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0)
+    if ((use_int8_inference || use_winograd3x3_g) && (pad_t > 0 || pad_b > 0 || pad_l > 0 || pad_r > 0))
     {
         Option opt_b = opt;
         opt_b.blob_allocator = opt.workspace_allocator;
-        copy_make_border(bottom_blob_unbordered, bottom_blob_bordered, pad_top, pad_bottom, pad_left, pad_right, BORDER_CONSTANT, 0.f, opt_b);
+        copy_make_border(bottom_blob_unbordered, bottom_blob_bordered, pad_t, pad_b, pad_l, pad_r, BORDER_CONSTANT, 0.f, opt_b);
         if (bottom_blob_bordered.empty())
             return -100;
-
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
     }
-    else if (pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
-    {
-        int wpad = kernel_extent_w + (w - 1) / stride_w * stride_w - w;
-        int hpad = kernel_extent_h + (h - 1) / stride_h * stride_h - h;
-        if (wpad > 0 || hpad > 0)
-        {
-            Option opt_b = opt;
-            opt_b.blob_allocator = opt.workspace_allocator;
-            copy_make_border(bottom_blob_unbordered, bottom_blob_bordered, hpad / 2, hpad - hpad / 2, wpad / 2, wpad - wpad / 2, BORDER_CONSTANT, 0.f, opt_b);
-            if (bottom_blob_bordered.empty())
-                return -100;
-        }
-
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
-    }
-    else if (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234)
-    {
-        int wpad = kernel_extent_w + (w - 1) / stride_w * stride_w - w;
-        int hpad = kernel_extent_h + (h - 1) / stride_h * stride_h - h;
-        if (wpad > 0 || hpad > 0)
-        {
-            Option opt_b = opt;
-            opt_b.blob_allocator = opt.workspace_allocator;
-            copy_make_border(bottom_blob_unbordered, bottom_blob_bordered, hpad - hpad / 2, hpad / 2, wpad - wpad / 2, wpad / 2, BORDER_CONSTANT, 0.f, opt_b);
-            if (bottom_blob_bordered.empty())
-                return -100;
-        }
-
-        w = bottom_blob_bordered.w;
-        h = bottom_blob_bordered.h;
-    }
-
-    int outw = (w - kernel_extent_w) / stride_w + 1;
-    int outh = (h - kernel_extent_h) / stride_h + 1;
 
     // int8
     if (use_int8_inference)
     {
         if (use_int8_requantize)
         {
-            Mat top_blob_tm;
-            top_blob_tm.create(outw, outh, num_output, (size_t)4u, opt.workspace_allocator);
-            if (top_blob_tm.empty())
-                return -100;
-            
             top_blob.create(outw, outh, num_output, (size_t)1u, opt.blob_allocator);
             if (top_blob.empty())
                 return -100;
@@ -318,21 +420,7 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
                     }
                 }
 
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g=0; g<group; g++)
-                {
-                    const Mat bottom_blob_bordered_g = bottom_blob_bordered.channel_range(g, 1);
-                    Mat top_blob_tm_g = top_blob_tm.channel_range(g, 1);
-
-                    const ncnn::Layer* op = group_ops[g];
-
-                    ncnn::Option opt_g = opt;
-                    opt_g.num_threads = 1;
-                    opt_g.blob_allocator = top_blob.allocator;
-
-                    // forward
-                    op->forward(bottom_blob_bordered_g, top_blob_tm_g, opt_g);
-                }
+                convdw_int8_requant_sse(bottom_blob_bordered, top_blob, weight_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, requantize_scales, opt);
 
                 if (activation)
                 {
@@ -342,23 +430,7 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
                 return 0;
             }
 
-            const int channels_g = channels / group;
-            const int num_output_g = num_output / group;
-
-            #pragma omp parallel for num_threads(opt.num_threads)
-            for (int g=0; g<group; g++)
-            {
-                const Mat bottom_blob_bordered_g = bottom_blob_bordered.channel_range(channels_g * g, channels_g);
-                Mat top_blob_tm_g = top_blob_tm.channel_range(num_output_g * g, num_output_g);
-
-                const ncnn::Layer* op = group_ops[g];
-
-                ncnn::Option opt_g = opt;
-                opt_g.blob_allocator = top_blob.allocator;
-
-                // forward
-                op->forward(bottom_blob_bordered_g, top_blob_tm_g, opt_g);
-            }                 
+            convgroup_int8_requant_sse(bottom_blob_bordered, top_blob, weight_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, group, requantize_scales, opt);
         }
         else
         {
@@ -391,21 +463,7 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
                     }
                 }
 
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g=0; g<group; g++)
-                {
-                    const Mat bottom_blob_bordered_g = bottom_blob_bordered.channel_range(g, 1);
-                    Mat top_blob_g = top_blob.channel_range(g, 1);
-
-                    const ncnn::Layer* op = group_ops[g];
-
-                    ncnn::Option opt_g = opt;
-                    opt_g.num_threads = 1;
-                    opt_g.blob_allocator = top_blob.allocator;
-
-                    // forward
-                    op->forward(bottom_blob_bordered_g, top_blob_g, opt_g);
-                }
+                convdw_int8_dequant_sse(bottom_blob_bordered, top_blob, weight_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, dequantize_scales, opt);
 
                 if (activation)
                 {
@@ -415,23 +473,7 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
                 return 0;
             }
 
-            const int channels_g = channels / group;
-            const int num_output_g = num_output / group;
-
-            #pragma omp parallel for num_threads(opt.num_threads)
-            for (int g=0; g<group; g++)
-            {
-                const Mat bottom_blob_bordered_g = bottom_blob_bordered.channel_range(channels_g * g, channels_g);
-                Mat top_blob_g = top_blob.channel_range(num_output_g * g, num_output_g);
-
-                const ncnn::Layer* op = group_ops[g];
-
-                ncnn::Option opt_g = opt;
-                opt_g.blob_allocator = top_blob.allocator;
-
-                // forward
-                op->forward(bottom_blob_bordered_g, top_blob_g, opt_g);
-            }                       
+            convgroup_int8_dequant_sse(bottom_blob_bordered, top_blob, weight_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, group, dequantize_scales, opt);
         }
 
         if (activation)
@@ -454,35 +496,28 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
         {
             if (stride_w == 1 && stride_h == 1)
             {
-                convdw3x3s1_sse(bottom_blob_bordered, top_blob, weight_data, bias_data, opt);
+                convdw3x3s1_sse(bottom_blob, top_blob, weight_data, bias_data, pad_l, pad_t, opt);
             }
             else if (stride_w == 2 && stride_h == 2)
             {
-                convdw3x3s2_sse(bottom_blob_bordered, top_blob, weight_data, bias_data, opt);
+                convdw3x3s2_sse(bottom_blob, top_blob, weight_data, bias_data, pad_l, pad_t, opt);
             }
-
-            if (activation)
+            else
             {
-                activation->forward_inplace(top_blob, opt);
+                convdw_sse(bottom_blob, top_blob, weight_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_l, pad_t, opt);
             }
-
-            return 0;
         }
-
-        #pragma omp parallel for num_threads(opt.num_threads)
-        for (int g=0; g<group; g++)
+        else if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
-            const Mat bottom_blob_bordered_g = bottom_blob_bordered.channel_range(g, 1);
-            Mat top_blob_g = top_blob.channel_range(g, 1);
-
-            const ncnn::Layer* op = group_ops[g];
-
-            ncnn::Option opt_g = opt;
-            opt_g.num_threads = 1;
-            opt_g.blob_allocator = top_blob.allocator;
-
-         // forward
-            op->forward(bottom_blob_bordered_g, top_blob_g, opt_g);
+            convdw5x5s1_sse(bottom_blob, top_blob, weight_data, bias_data, pad_l, pad_t, opt);
+        }
+        else if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+        {
+            convdw5x5s2_sse(bottom_blob, top_blob, weight_data, bias_data, pad_l, pad_t, opt);
+        }
+        else
+        {
+            convdw_sse(bottom_blob, top_blob, weight_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_l, pad_t, opt);
         }
 
         if (activation)
@@ -493,23 +528,111 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
         return 0;
     }
 
-    const int channels_g = channels / group;
-    const int num_output_g = num_output / group;
+    if (use_winograd3x3_g)
+    {
+        convgroup3x3s1_winograd43_sse(bottom_blob_bordered, top_blob, weight_3x3_winograd43_data, bias_data, group, opt);
+    }
+    else
+    {
+        const int channels_g = channels / group;
+        const int num_output_g = num_output / group;
 
-    for (int g=0; g<group; g++)
+        // with enough groups every group runs on one thread, otherwise each sgemm is threaded
+        const bool parallel_group = group >= opt.num_threads;
+
+        Option opt_g = opt;
+        if (parallel_group)
+            opt_g.num_threads = 1;
+
+        #pragma omp parallel for num_threads(parallel_group ? opt.num_threads : 1)
+        for (int g=0; g<group; g++)
+        {
+            const Mat bottom_blob_g = bottom_blob.channel_range(channels_g * g, channels_g);
+            Mat top_blob_g = top_blob.channel_range(num_output_g * g, num_output_g);
+
+            const float* bias_g = bias_term ? (const float*)bias_data + num_output_g * g : 0;
+
+            // im2col packed on the fly, taps outside the input read zero padding
+            conv_im2col_pack_b pack_b;
+            pack_b.bottom_blob = &bottom_blob_g;
+            pack_b.outw = outw;
+            pack_b.kernel_w = kernel_w;
+            pack_b.kernel_h = kernel_h;
+            pack_b.dilation_w = dilation_w;
+            pack_b.dilation_h = dilation_h;
+            pack_b.stride_w = stride_w;
+            pack_b.stride_h = stride_h;
+            pack_b.pad_left = pad_l;
+            pack_b.pad_top = pad_t;
+
+            sgemm_implicit(num_output_g, outw * outh, kernel_w * kernel_h * channels_g, weight_sgemm_data[g], pack_b, bias_g, top_blob_g, (int)top_blob_g.cstep, 1, opt_g);
+        }
+    }
+
+    if (activation)
+    {
+        activation->forward_inplace(top_blob, opt);
+    }
+
+    return 0;
+}
+
+#if __AVX__
+int ConvolutionDepthWise_x86::forward_pack8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+    int elempack = bottom_blob.elempack;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    // resolve the padding, the kernel reads the border in place
+    int pad_t = pad_top;
+    int pad_b = pad_bottom;
+    int pad_l = pad_left;
+    int pad_r = pad_right;
+
+    if ((pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
+        || (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234))
     {
-        const Mat bottom_blob_bordered_g = bottom_blob_bordered.channel_range(channels_g * g, channels_g);
-        Mat top_blob_g = top_blob.channel_range(num_output_g * g, num_output_g);
+        int wpad = kernel_extent_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_extent_h + (h - 1) / stride_h * stride_h - h;
 
-        const ncnn::Layer* op = group_ops[g];
+        pad_t = 0;
+        pad_b = 0;
+        pad_l = 0;
+        pad_r = 0;
 
-        ncnn::Option opt_g = opt;
-        opt_g.blob_allocator = top_blob.allocator;
+        if (wpad > 0 || hpad > 0)
+        {
+            // -233 pads the extra pixel after, -234 before
+            pad_t = pad_left == -233 ? hpad / 2 : hpad - hpad / 2;
+            pad_b = hpad - pad_t;
+            pad_l = pad_left == -233 ? wpad / 2 : wpad - wpad / 2;
+            pad_r = wpad - pad_l;
+        }
+    }
 
-        // forward
-        op->forward(bottom_blob_bordered_g, top_blob_g, opt_g);
+    if (pad_t <= 0 && pad_b <= 0 && pad_l <= 0 && pad_r <= 0)
+    {
+        pad_t = 0;
+        pad_b = 0;
+        pad_l = 0;
+        pad_r = 0;
     }
 
+    int outw = (w + pad_l + pad_r - kernel_extent_w) / stride_w + 1;
+    int outh = (h + pad_t + pad_b - kernel_extent_h) / stride_h + 1;
+
+    top_blob.create(outw, outh, channels, elemsize, elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    convdw_pack8_avx(bottom_blob, top_blob, weight_data_pack8, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_l, pad_t, opt);
+
     if (activation)
     {
         activation->forward_inplace(top_blob, opt);
@@ -517,5 +640,6 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
 
     return 0;
 }
+#endif // __AVX__
 
 } // namespace ncnn
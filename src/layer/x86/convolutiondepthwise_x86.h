@@ -29,9 +29,20 @@ public:
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
+#if __AVX__
+protected:
+    int forward_pack8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+#endif // __AVX__
+
 public:
     Layer* activation;
-    std::vector<ncnn::Layer*> group_ops;
+
+    bool use_winograd3x3;
+    std::vector<Mat> weight_sgemm_data;
+    std::vector<Mat> weight_3x3_winograd43_data;
+
+    // pack8
+    Mat weight_data_pack8;
 };
 
 } // namespace ncnn
@@ -0,0 +1,105 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// out[j * stride] += src[j] * scale
+static void deconv_scatter_sse(const float* src, float* out, int n, int stride, float scale)
+{
+    int j=0;
+
+    if (stride == 1)
+    {
+#if __AVX__
+        __m256 _scale8 = _mm256_set1_ps(scale);
+        for (; j+7<n; j+=8)
+        {
+            _mm256_storeu_ps(out + j, _mm256_fmadd_ps(_mm256_loadu_ps(src + j), _scale8, _mm256_loadu_ps(out + j)));
+        }
+#endif // __AVX__
+#if __SSE2__
+        __m128 _scale = _mm_set1_ps(scale);
+        for (; j+3<n; j+=4)
+        {
+            _mm_storeu_ps(out + j, _mm_add_ps(_mm_loadu_ps(out + j), _mm_mul_ps(_mm_loadu_ps(src + j), _scale)));
+        }
+#endif // __SSE2__
+    }
+
+    for (; j<n; j++)
+    {
+        out[j * stride] += src[j] * scale;
+    }
+}
+
+// out[2j] += src0[j] * scale0 and out[2j+1] += src1[j] * scale1,
+// two neighbouring taps of a stride 2 kernel interleave into one contiguous run
+static void deconv_scatter_s2_pair_sse(const float* src0, const float* src1, float* out, int n, float scale0, float scale1)
+{
+    int j=0;
+#if __AVX__
+    __m256 _scale08 = _mm256_set1_ps(scale0);
+    __m256 _scale18 = _mm256_set1_ps(scale1);
+    for (; j+7<n; j+=8)
+    {
+        __m256 _a = _mm256_mul_ps(_mm256_loadu_ps(src0 + j), _scale08);
+        __m256 _b = _mm256_mul_ps(_mm256_loadu_ps(src1 + j), _scale18);
+
+        // a0 b0 a1 b1 a4 b4 a5 b5 / a2 b2 a3 b3 a6 b6 a7 b7
+        __m256 _lo = _mm256_unpacklo_ps(_a, _b);
+        __m256 _hi = _mm256_unpackhi_ps(_a, _b);
+
+        float* outptr = out + j * 2;
+        _mm256_storeu_ps(outptr, _mm256_add_ps(_mm256_loadu_ps(outptr), _mm256_permute2f128_ps(_lo, _hi, 0x20)));
+        _mm256_storeu_ps(outptr + 8, _mm256_add_ps(_mm256_loadu_ps(outptr + 8), _mm256_permute2f128_ps(_lo, _hi, 0x31)));
+    }
+#endif // __AVX__
+#if __SSE2__
+    __m128 _scale0 = _mm_set1_ps(scale0);
+    __m128 _scale1 = _mm_set1_ps(scale1);
+    for (; j+3<n; j+=4)
+    {
+        __m128 _a = _mm_mul_ps(_mm_loadu_ps(src0 + j), _scale0);
+        __m128 _b = _mm_mul_ps(_mm_loadu_ps(src1 + j), _scale1);
+
+        float* outptr = out + j * 2;
+        _mm_storeu_ps(outptr, _mm_add_ps(_mm_loadu_ps(outptr), _mm_unpacklo_ps(_a, _b)));
+        _mm_storeu_ps(outptr + 4, _mm_add_ps(_mm_loadu_ps(outptr + 4), _mm_unpackhi_ps(_a, _b)));
+    }
+#endif // __SSE2__
+    for (; j<n; j++)
+    {
+        out[j * 2] += src0[j] * scale0;
+        out[j * 2 + 1] += src1[j] * scale1;
+    }
+}
+
+// scatter one input row through one kernel row
+// out[j * stride_w + v * dilation_w] += src[v * src_vstep + j] * scale[v], scale may be null for all ones
+// stride 2 kernels without dilation (2x2s2, 4x4s2 ...) take the taps pairwise
+static void deconv_scatter_row_sse(const float* src, int src_vstep, const float* scale, float* out, int n, int kernel_w, int dilation_w, int stride_w)
+{
+    int v=0;
+
+    if (stride_w == 2 && dilation_w == 1)
+    {
+        for (; v+1<kernel_w; v+=2)
+        {
+            deconv_scatter_s2_pair_sse(src + v * src_vstep, src + (v + 1) * src_vstep, out + v, n, scale ? scale[v] : 1.f, scale ? scale[v + 1] : 1.f);
+        }
+    }
+
+    for (; v<kernel_w; v++)
+    {
+        deconv_scatter_sse(src + v * src_vstep, out + v * dilation_w, n, stride_w, scale ? scale[v] : 1.f);
+    }
+}
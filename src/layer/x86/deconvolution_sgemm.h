@@ -0,0 +1,102 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+static void deconv_transform_kernel_sgemm_sse(const Mat& _kernel, Mat& kernel_tm, int inch, int outch, int maxk)
+{
+    // A(p * maxk + k, q) = kernel[p][q][k], one row of the column matrix per output tap
+    Mat kernel_t(inch, outch * maxk);
+
+    for (int p=0; p<outch; p++)
+    {
+        const float* kernel = (const float*)_kernel + p * inch * maxk;
+
+        for (int k=0; k<maxk; k++)
+        {
+            float* ptr = kernel_t.row(p * maxk + k);
+
+            for (int q=0; q<inch; q++)
+            {
+                ptr[q] = kernel[q * maxk + k];
+            }
+        }
+    }
+
+    sgemm_pack_a(kernel_t, inch, 1, outch * maxk, inch, kernel_tm, 0);
+}
+
+// column matrix blocks above this size are split along the input rows
+static const size_t deconv_col2im_workspace_max = 4 * 1024 * 1024;
+
+// top = bias + col2im(A * bottom), top_blob is the unpadded output
+static int deconv_sgemm_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_tm, const Mat& _bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int inch = bottom_blob.c;
+
+    int outch = top_blob.c;
+
+    const float* bias = _bias;
+
+    const int maxk = kernel_w * kernel_h;
+    const int M = outch * maxk;
+    const int K = inch;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p=0; p<outch; p++)
+    {
+        top_blob.channel(p).fill(bias ? bias[p] : 0.f);
+    }
+
+    int nh = (int)std::min((size_t)h, std::max((size_t)1, deconv_col2im_workspace_max / ((size_t)M * w * sizeof(float))));
+
+    Mat col(w * nh, M, (size_t)4u, opt.workspace_allocator);
+    if (col.empty())
+        return -100;
+
+    for (int i0=0; i0<h; i0+=nh)
+    {
+        const int rows = std::min(nh, h - i0);
+        const int N = rows * w;
+
+        Mat b_packed;
+        sgemm_pack_b((const float*)bottom_blob + i0 * w, (int)bottom_blob.cstep, 1, K, N, b_packed, opt.workspace_allocator, opt);
+        if (b_packed.empty())
+            return -100;
+
+        sgemm(M, N, K, kernel_tm, b_packed, 0, col, N, 1, opt);
+
+        // col2im, every output channel scatters its own taps
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p=0; p<outch; p++)
+        {
+            Mat out = top_blob.channel(p);
+
+            for (int u=0; u<kernel_h; u++)
+            {
+                const float* colptr = (const float*)col + (size_t)(p * maxk + u * kernel_w) * N;
+
+                for (int i=0; i<rows; i++)
+                {
+                    float* outptr = out.row((i0 + i) * stride_h + u * dilation_h);
+
+                    deconv_scatter_row_sse(colptr + i * w, N, 0, outptr, w, kernel_w, dilation_w, stride_w);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+static void deconvdw_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, \
+            int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+
+    const int group = bottom_blob.c;
+    const int maxk = kernel_w * kernel_h;
+
+    const float* kernel = _kernel;
+    const float* bias = _bias;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g=0; g<group; g++)
+    {
+        Mat out = top_blob.channel(g);
+
+        out.fill(bias ? bias[g] : 0.f);
+
+        const float* kernel0 = kernel + maxk * g;
+
+        const float* img0 = bottom_blob.channel(g);
+
+        for (int u=0; u<kernel_h; u++)
+        {
+            for (int i=0; i<h; i++)
+            {
+                float* outptr = out.row(i * stride_h + u * dilation_h);
+
+                deconv_scatter_row_sse(img0 + i * w, 0, kernel0 + u * kernel_w, outptr, w, kernel_w, dilation_w, stride_w);
+            }
+        }
+    }
+}
@@ -0,0 +1,240 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "eltwise_x86.h"
+#include <algorithm>
+
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Eltwise_x86)
+
+Eltwise_x86::Eltwise_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int Eltwise_x86::create_pipeline(const Option& opt)
+{
+    // write the result over the first input, the gpu path has no multi-blob inplace forward
+    if (!(opt.use_vulkan_compute && support_vulkan))
+    {
+        support_inplace = true;
+    }
+
+    return 0;
+}
+
+struct eltwise_op_prod
+{
+    float operator()(const float& x, const float& y) const { return x * y; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_mul_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_mul_ps(x, y); }
+#endif // __AVX__
+};
+
+struct eltwise_op_sum
+{
+    float operator()(const float& x, const float& y) const { return x + y; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_add_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_add_ps(x, y); }
+#endif // __AVX__
+};
+
+struct eltwise_op_max
+{
+    float operator()(const float& x, const float& y) const { return std::max(x, y); }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_max_ps(x, y); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_max_ps(x, y); }
+#endif // __AVX__
+};
+
+// outptr may alias ptr
+template<typename Op>
+static void eltwise_op(const float* ptr, const float* ptr1, float* outptr, int size, const Op& op)
+{
+    int i=0;
+#if __AVX__
+    for (; i+7<size; i+=8)
+    {
+        _mm256_storeu_ps(outptr + i, op(_mm256_loadu_ps(ptr + i), _mm256_loadu_ps(ptr1 + i)));
+    }
+#endif // __AVX__
+#if __SSE2__
+    for (; i+3<size; i+=4)
+    {
+        _mm_storeu_ps(outptr + i, op(_mm_loadu_ps(ptr + i), _mm_loadu_ps(ptr1 + i)));
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        outptr[i] = op(ptr[i], ptr1[i]);
+    }
+}
+
+// outptr = ptr * coeff + ptr1 * coeff1, outptr may alias ptr
+static void eltwise_sum_coeff(const float* ptr, float coeff, const float* ptr1, float coeff1, float* outptr, int size)
+{
+    int i=0;
+#if __AVX__
+    __m256 _coeff_avx = _mm256_set1_ps(coeff);
+    __m256 _coeff1_avx = _mm256_set1_ps(coeff1);
+    for (; i+7<size; i+=8)
+    {
+        __m256 _p = _mm256_mul_ps(_mm256_loadu_ps(ptr + i), _coeff_avx);
+        _p = _mm256_fmadd_ps(_mm256_loadu_ps(ptr1 + i), _coeff1_avx, _p);
+        _mm256_storeu_ps(outptr + i, _p);
+    }
+#endif // __AVX__
+#if __SSE2__
+    __m128 _coeff = _mm_set1_ps(coeff);
+    __m128 _coeff1 = _mm_set1_ps(coeff1);
+    for (; i+3<size; i+=4)
+    {
+        __m128 _p = _mm_mul_ps(_mm_loadu_ps(ptr + i), _coeff);
+        _p = _mm_add_ps(_p, _mm_mul_ps(_mm_loadu_ps(ptr1 + i), _coeff1));
+        _mm_storeu_ps(outptr + i, _p);
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        outptr[i] = ptr[i] * coeff + ptr1[i] * coeff1;
+    }
+}
+
+// reduce all inputs tile by tile, the partial result stays in cache
+// so every input is read once and the output written once
+template<typename Op>
+static void eltwise_reduce(const std::vector<Mat>& bottom_blobs, Mat& top_blob, const Op& op, const Option& opt)
+{
+    const int tile = 1024;
+
+    int channels = top_blob.c;
+    int size = top_blob.w * top_blob.h * top_blob.elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<channels; q++)
+    {
+        float* outptr = top_blob.channel(q);
+
+        for (int i=0; i<size; i+=tile)
+        {
+            int n = std::min(tile, size - i);
+
+            const float* ptr = bottom_blobs[0].channel(q);
+            const float* ptr1 = bottom_blobs[1].channel(q);
+            eltwise_op(ptr + i, ptr1 + i, outptr + i, n, op);
+
+            for (size_t b=2; b<bottom_blobs.size(); b++)
+            {
+                const float* ptr2 = bottom_blobs[b].channel(q);
+                eltwise_op(outptr + i, ptr2 + i, outptr + i, n, op);
+            }
+        }
+    }
+}
+
+static void eltwise_reduce_sum_coeff(const std::vector<Mat>& bottom_blobs, Mat& top_blob, const Mat& coeffs, const Option& opt)
+{
+    const int tile = 1024;
+
+    int channels = top_blob.c;
+    int size = top_blob.w * top_blob.h * top_blob.elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<channels; q++)
+    {
+        float* outptr = top_blob.channel(q);
+
+        for (int i=0; i<size; i+=tile)
+        {
+            int n = std::min(tile, size - i);
+
+            const float* ptr = bottom_blobs[0].channel(q);
+            const float* ptr1 = bottom_blobs[1].channel(q);
+            eltwise_sum_coeff(ptr + i, coeffs[0], ptr1 + i, coeffs[1], outptr + i, n);
+
+            for (size_t b=2; b<bottom_blobs.size(); b++)
+            {
+                const float* ptr2 = bottom_blobs[b].channel(q);
+                eltwise_sum_coeff(outptr + i, 1.f, ptr2 + i, coeffs[b], outptr + i, n);
+            }
+        }
+    }
+}
+
+int Eltwise_x86::forward_reduce(const std::vector<Mat>& bottom_blobs, Mat& top_blob, const Option& opt) const
+{
+    if (op_type == Operation_PROD)
+    {
+        eltwise_reduce(bottom_blobs, top_blob, eltwise_op_prod(), opt);
+    }
+    else if (op_type == Operation_SUM)
+    {
+        if (coeffs.w == 0)
+            eltwise_reduce(bottom_blobs, top_blob, eltwise_op_sum(), opt);
+        else
+            eltwise_reduce_sum_coeff(bottom_blobs, top_blob, coeffs, opt);
+    }
+    else if (op_type == Operation_MAX)
+    {
+        eltwise_reduce(bottom_blobs, top_blob, eltwise_op_max(), opt);
+    }
+
+    return 0;
+}
+
+int Eltwise_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+    int elempack = bottom_blob.elempack;
+
+    Mat& top_blob = top_blobs[0];
+    top_blob.create(w, h, channels, elemsize, elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    return forward_reduce(bottom_blobs, top_blob, opt);
+}
+
+int Eltwise_x86::forward_inplace(std::vector<Mat>& bottom_top_blobs, const Option& opt) const
+{
+    // the first input is consumed before its tile is written
+    Mat& bottom_top_blob = bottom_top_blobs[0];
+
+    return forward_reduce(bottom_top_blobs, bottom_top_blob, opt);
+}
+
+} // namespace ncnn
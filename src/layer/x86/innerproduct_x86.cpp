@@ -0,0 +1,786 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "innerproduct_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#endif // __AVX__
+
+#include "cpu.h"
+#include "quantize.h"
+
+// int8 dot product instructions selected at runtime
+#if __AVX2__ && defined(__GNUC__)
+#if (defined(__clang__) && __clang_major__ >= 12) || (!defined(__clang__) && __GNUC__ >= 11)
+#define NCNN_X86_AVX_VNNI 1
+#endif
+#if (defined(__clang__) && __clang_major__ >= 6) || (!defined(__clang__) && __GNUC__ >= 8)
+#define NCNN_X86_AVX512_VNNI 1
+#endif
+#endif // __AVX2__ && defined(__GNUC__)
+
+namespace ncnn {
+
+#include "sgemm.h"
+
+DEFINE_LAYER_CREATOR(InnerProduct_x86)
+
+InnerProduct_x86::InnerProduct_x86()
+{
+}
+
+#if __AVX__
+static inline __m256 activation_avx(__m256 _v, int activation_type, const Mat& activation_params)
+{
+    if (activation_type == 1)
+    {
+        _v = _mm256_max_ps(_v, _mm256_setzero_ps());
+    }
+    else if (activation_type == 2)
+    {
+        __m256 _slope = _mm256_set1_ps(activation_params[0]);
+        __m256 _neg = _mm256_mul_ps(_mm256_min_ps(_v, _mm256_setzero_ps()), _slope);
+        _v = _mm256_add_ps(_mm256_max_ps(_v, _mm256_setzero_ps()), _neg);
+    }
+    else if (activation_type == 3)
+    {
+        _v = _mm256_max_ps(_v, _mm256_set1_ps(activation_params[0]));
+        _v = _mm256_min_ps(_v, _mm256_set1_ps(activation_params[1]));
+    }
+    else if (activation_type == 4)
+    {
+        __m256 _one = _mm256_set1_ps(1.f);
+        _v = exp256_ps(_mm256_sub_ps(_mm256_setzero_ps(), _v));
+        _v = _mm256_div_ps(_one, _mm256_add_ps(_one, _v));
+    }
+
+    return _v;
+}
+#endif // __AVX__
+
+#if __SSE2__
+static inline __m128 activation_sse(__m128 _v, int activation_type, const Mat& activation_params)
+{
+    if (activation_type == 1)
+    {
+        _v = _mm_max_ps(_v, _mm_setzero_ps());
+    }
+    else if (activation_type == 2)
+    {
+        __m128 _slope = _mm_set1_ps(activation_params[0]);
+        __m128 _neg = _mm_mul_ps(_mm_min_ps(_v, _mm_setzero_ps()), _slope);
+        _v = _mm_add_ps(_mm_max_ps(_v, _mm_setzero_ps()), _neg);
+    }
+    else if (activation_type == 3)
+    {
+        _v = _mm_max_ps(_v, _mm_set1_ps(activation_params[0]));
+        _v = _mm_min_ps(_v, _mm_set1_ps(activation_params[1]));
+    }
+    else if (activation_type == 4)
+    {
+        __m128 _one = _mm_set1_ps(1.f);
+        _v = exp_ps(_mm_sub_ps(_mm_setzero_ps(), _v));
+        _v = _mm_div_ps(_one, _mm_add_ps(_one, _v));
+    }
+
+    return _v;
+}
+#endif // __SSE2__
+
+static inline float activation_ss(float v, int activation_type, const Mat& activation_params)
+{
+    if (activation_type == 1)
+    {
+        v = std::max(v, 0.f);
+    }
+    else if (activation_type == 2)
+    {
+        float slope = activation_params[0];
+        v = v > 0.f ? v : v * slope;
+    }
+    else if (activation_type == 3)
+    {
+        float min = activation_params[0];
+        float max = activation_params[1];
+        if (v < min)
+            v = min;
+        if (v > max)
+            v = max;
+    }
+    else if (activation_type == 4)
+    {
+        v = 1.f / (1.f + exp(-v));
+    }
+
+    return v;
+}
+
+#if __AVX2__
+// 8 outputs, packed as 4 inputs per output per 32 bytes
+// maddubs wants unsigned x signed, so multiply |x| by w carrying the sign of x
+static inline __m256i innerproduct_int8_block_avx2(const signed char* kptr, const int* xptr, int nn)
+{
+    __m256i _one = _mm256_set1_epi16(1);
+    __m256i _sum0 = _mm256_setzero_si256();
+    __m256i _sum1 = _mm256_setzero_si256();
+
+    int i=0;
+    for (; i+1<nn; i+=2)
+    {
+        __m256i _x0 = _mm256_set1_epi32(xptr[0]);
+        __m256i _x1 = _mm256_set1_epi32(xptr[1]);
+
+        __m256i _w0 = _mm256_loadu_si256((const __m256i*)kptr);
+        __m256i _w1 = _mm256_loadu_si256((const __m256i*)(kptr + 32));
+
+        __m256i _s0 = _mm256_maddubs_epi16(_mm256_abs_epi8(_x0), _mm256_sign_epi8(_w0, _x0));
+        __m256i _s1 = _mm256_maddubs_epi16(_mm256_abs_epi8(_x1), _mm256_sign_epi8(_w1, _x1));
+
+        _sum0 = _mm256_add_epi32(_sum0, _mm256_madd_epi16(_s0, _one));
+        _sum1 = _mm256_add_epi32(_sum1, _mm256_madd_epi16(_s1, _one));
+
+        xptr += 2;
+        kptr += 64;
+    }
+    for (; i<nn; i++)
+    {
+        __m256i _x = _mm256_set1_epi32(xptr[0]);
+        __m256i _w = _mm256_loadu_si256((const __m256i*)kptr);
+
+        __m256i _s = _mm256_maddubs_epi16(_mm256_abs_epi8(_x), _mm256_sign_epi8(_w, _x));
+        _sum0 = _mm256_add_epi32(_sum0, _mm256_madd_epi16(_s, _one));
+
+        xptr += 1;
+        kptr += 32;
+    }
+
+    return _mm256_add_epi32(_sum0, _sum1);
+}
+#endif // __AVX2__
+
+#if NCNN_X86_AVX_VNNI
+// xuptr holds x + 128 as unsigned, caller subtracts 128 * sum(w)
+__attribute__((target("avx2,fma,avxvnni")))
+static __m256i innerproduct_int8_block_avxvnni(const signed char* kptr, const int* xuptr, int nn)
+{
+    __m256i _sum0 = _mm256_setzero_si256();
+    __m256i _sum1 = _mm256_setzero_si256();
+
+    int i=0;
+    for (; i+1<nn; i+=2)
+    {
+        _sum0 = _mm256_dpbusd_avx_epi32(_sum0, _mm256_set1_epi32(xuptr[0]), _mm256_loadu_si256((const __m256i*)kptr));
+        _sum1 = _mm256_dpbusd_avx_epi32(_sum1, _mm256_set1_epi32(xuptr[1]), _mm256_loadu_si256((const __m256i*)(kptr + 32)));
+
+        xuptr += 2;
+        kptr += 64;
+    }
+    for (; i<nn; i++)
+    {
+        _sum0 = _mm256_dpbusd_avx_epi32(_sum0, _mm256_set1_epi32(xuptr[0]), _mm256_loadu_si256((const __m256i*)kptr));
+
+        xuptr += 1;
+        kptr += 32;
+    }
+
+    return _mm256_add_epi32(_sum0, _sum1);
+}
+#endif // NCNN_X86_AVX_VNNI
+
+#if NCNN_X86_AVX512_VNNI
+// xuptr holds x + 128 as unsigned, caller subtracts 128 * sum(w)
+__attribute__((target("avx2,fma,avx512f,avx512vl,avx512vnni")))
+static __m256i innerproduct_int8_block_avx512vnni(const signed char* kptr, const int* xuptr, int nn)
+{
+    __m256i _sum0 = _mm256_setzero_si256();
+    __m256i _sum1 = _mm256_setzero_si256();
+
+    int i=0;
+    for (; i+1<nn; i+=2)
+    {
+        _sum0 = _mm256_dpbusd_epi32(_sum0, _mm256_set1_epi32(xuptr[0]), _mm256_loadu_si256((const __m256i*)kptr));
+        _sum1 = _mm256_dpbusd_epi32(_sum1, _mm256_set1_epi32(xuptr[1]), _mm256_loadu_si256((const __m256i*)(kptr + 32)));
+
+        xuptr += 2;
+        kptr += 64;
+    }
+    for (; i<nn; i++)
+    {
+        _sum0 = _mm256_dpbusd_epi32(_sum0, _mm256_set1_epi32(xuptr[0]), _mm256_loadu_si256((const __m256i*)kptr));
+
+        xuptr += 1;
+        kptr += 32;
+    }
+
+    return _mm256_add_epi32(_sum0, _sum1);
+}
+#endif // NCNN_X86_AVX512_VNNI
+
+#if __SSE2__
+// 8 outputs, packed as 4 inputs per output per 32 bytes
+// sign extend to int16 and reduce input pairs with madd
+static inline void innerproduct_int8_block_sse2(const signed char* kptr, const int* xptr, int nn, __m128i& _sum0123, __m128i& _sum4567)
+{
+    __m128i _sum01 = _mm_setzero_si128();
+    __m128i _sum23 = _mm_setzero_si128();
+    __m128i _sum45 = _mm_setzero_si128();
+    __m128i _sum67 = _mm_setzero_si128();
+
+    for (int i=0; i<nn; i++)
+    {
+        // x0 x1 x2 x3 x0 x1 x2 x3
+        __m128i _x = _mm_set1_epi32(xptr[0]);
+        _x = _mm_srai_epi16(_mm_unpacklo_epi8(_x, _x), 8);
+
+        __m128i _w0123 = _mm_loadu_si128((const __m128i*)kptr);
+        __m128i _w4567 = _mm_loadu_si128((const __m128i*)(kptr + 16));
+
+        __m128i _w01 = _mm_srai_epi16(_mm_unpacklo_epi8(_w0123, _w0123), 8);
+        __m128i _w23 = _mm_srai_epi16(_mm_unpackhi_epi8(_w0123, _w0123), 8);
+        __m128i _w45 = _mm_srai_epi16(_mm_unpacklo_epi8(_w4567, _w4567), 8);
+        __m128i _w67 = _mm_srai_epi16(_mm_unpackhi_epi8(_w4567, _w4567), 8);
+
+        _sum01 = _mm_add_epi32(_sum01, _mm_madd_epi16(_w01, _x));
+        _sum23 = _mm_add_epi32(_sum23, _mm_madd_epi16(_w23, _x));
+        _sum45 = _mm_add_epi32(_sum45, _mm_madd_epi16(_w45, _x));
+        _sum67 = _mm_add_epi32(_sum67, _mm_madd_epi16(_w67, _x));
+
+        xptr += 1;
+        kptr += 32;
+    }
+
+    // each output holds two partial sums side by side
+    __m128 _t0 = _mm_shuffle_ps(_mm_castsi128_ps(_sum01), _mm_castsi128_ps(_sum23), _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 _t1 = _mm_shuffle_ps(_mm_castsi128_ps(_sum01), _mm_castsi128_ps(_sum23), _MM_SHUFFLE(3, 1, 3, 1));
+    __m128 _t2 = _mm_shuffle_ps(_mm_castsi128_ps(_sum45), _mm_castsi128_ps(_sum67), _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 _t3 = _mm_shuffle_ps(_mm_castsi128_ps(_sum45), _mm_castsi128_ps(_sum67), _MM_SHUFFLE(3, 1, 3, 1));
+
+    _sum0123 = _mm_add_epi32(_mm_castps_si128(_t0), _mm_castps_si128(_t1));
+    _sum4567 = _mm_add_epi32(_mm_castps_si128(_t2), _mm_castps_si128(_t3));
+}
+#endif // __SSE2__
+
+int InnerProduct_x86::create_pipeline(const Option& opt)
+{
+    int num_input = weight_data_size / num_output;
+
+    if (use_int8_inference)
+    {
+        // src = inch-outch
+        // dst = 4a-8b-inch/4a-outch/8b, zero padded
+        int num_input_4 = (num_input + 3) / 4 * 4;
+        int nn_num_output = (num_output + 7) / 8;
+
+        weight_data_int8_packed.create(num_input_4 * 8, nn_num_output, (size_t)1u);
+        weight_data_int8_sums.create(nn_num_output * 8, (size_t)4u);
+        dequantize_scales_data.create(nn_num_output * 8);
+        dequantize_bias_data.create(nn_num_output * 8);
+        if (weight_data_int8_packed.empty() || weight_data_int8_sums.empty() || dequantize_scales_data.empty() || dequantize_bias_data.empty())
+            return -100;
+
+        const signed char* weight_data_ptr = weight_data;
+        int* sums = weight_data_int8_sums;
+
+        for (int pp=0; pp<nn_num_output; pp++)
+        {
+            signed char* g00 = weight_data_int8_packed.row<signed char>(pp);
+
+            for (int k=0; k<8; k++)
+            {
+                sums[pp * 8 + k] = 0;
+            }
+
+            for (int i=0; i<num_input_4; i+=4)
+            {
+                for (int k=0; k<8; k++)
+                {
+                    int p = pp * 8 + k;
+
+                    for (int j=0; j<4; j++)
+                    {
+                        signed char w = 0;
+                        if (p < num_output && i + j < num_input)
+                            w = weight_data_ptr[num_input * p + i + j];
+
+                        // the sign trick cannot negate -128, see float2int8 in quantize.h
+                        if (w < -127)
+                            w = -127;
+
+                        g00[j] = w;
+                        sums[p] += w * 128;
+                    }
+
+                    g00 += 4;
+                }
+            }
+        }
+
+        for (int p=0; p<nn_num_output * 8; p++)
+        {
+            float scale_in = 0.f;
+            float bias = 0.f;
+
+            if (p < num_output)
+            {
+                if (weight_data_int8_scales[p] != 0)
+                    scale_in = 1.f / (bottom_blob_int8_scale * weight_data_int8_scales[p]);
+
+                if (bias_term)
+                    bias = bias_data[p];
+            }
+
+            dequantize_scales_data[p] = scale_in;
+            dequantize_bias_data[p] = bias;
+        }
+
+        return 0;
+    }
+
+    // src = inch-outch
+    // dst = sgemm_nr-inch-outch/sgemm_nr, zero padded, shared by gemv and the batched sgemm
+    sgemm_pack_b(weight_data, 1, num_input, num_input, num_output, weight_data_packed, 0, opt);
+    if (weight_data_packed.empty())
+        return -100;
+
+    // every float path reads the packed panels from here on, vulkan still uploads the original
+    if (opt.lightmode && !opt.use_vulkan_compute)
+    {
+        weight_data.release();
+    }
+
+    return 0;
+}
+
+int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    if (use_int8_inference)
+    {
+        return forward_int8(bottom_blob, top_blob, opt);
+    }
+
+    size_t elemsize = bottom_blob.elemsize;
+    int num_input = weight_data_size / num_output;
+
+    if (bottom_blob.dims == 2 && bottom_blob.w == num_input && bottom_blob.h > 1)
+    {
+        return forward_batch(bottom_blob, top_blob, opt);
+    }
+
+    if (bottom_blob.w * bottom_blob.h * bottom_blob.c != num_input)
+    {
+        return -1;
+    }
+
+    // flatten to a continuous vector, skipping channel gaps
+    Mat bottom_blob_flattened = bottom_blob;
+    if (bottom_blob.dims != 1)
+    {
+        bottom_blob_flattened = bottom_blob.reshape(num_input, opt.workspace_allocator);
+        if (bottom_blob_flattened.empty())
+            return -100;
+    }
+
+    top_blob.create(num_output, elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const float* m0 = bottom_blob_flattened;
+    const float* bias_data_ptr = bias_term ? (const float*)bias_data : 0;
+    float* outptr = top_blob;
+
+    int nn_num_output = (num_output + sgemm_nr - 1) / sgemm_nr;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp=0; pp<nn_num_output; pp++)
+    {
+        int p = pp * sgemm_nr;
+
+        const float* kptr = weight_data_packed.row(pp);
+        const float* m = m0;
+
+        const float* biasptr = bias_data_ptr ? bias_data_ptr + p : 0;
+        float* outptr0 = outptr + p;
+
+        // the zero padded tail panel goes through local bias and output buffers
+        float bias_tail[sgemm_nr];
+        float out_tail[sgemm_nr];
+        const int valid = std::min(sgemm_nr, num_output - p);
+        if (valid < sgemm_nr)
+        {
+            if (biasptr)
+            {
+                for (int k=0; k<sgemm_nr; k++)
+                {
+                    bias_tail[k] = k < valid ? biasptr[k] : 0.f;
+                }
+                biasptr = bias_tail;
+            }
+
+            outptr0 = out_tail;
+        }
+
+#if __AVX__
+        __m256 _sum0 = biasptr ? _mm256_loadu_ps(biasptr) : _mm256_setzero_ps();
+        __m256 _sum1 = biasptr ? _mm256_loadu_ps(biasptr + 8) : _mm256_setzero_ps();
+        __m256 _sum2 = biasptr ? _mm256_loadu_ps(biasptr + 16) : _mm256_setzero_ps();
+        __m256 _sum3 = _mm256_setzero_ps();
+        __m256 _sum4 = _mm256_setzero_ps();
+        __m256 _sum5 = _mm256_setzero_ps();
+
+        int i=0;
+        for (; i+1<num_input; i+=2)
+        {
+            __m256 _val0 = _mm256_broadcast_ss(m);
+            __m256 _val1 = _mm256_broadcast_ss(m+1);
+
+            _sum0 = _mm256_fmadd_ps(_val0, _mm256_loadu_ps(kptr), _sum0);
+            _sum1 = _mm256_fmadd_ps(_val0, _mm256_loadu_ps(kptr+8), _sum1);
+            _sum2 = _mm256_fmadd_ps(_val0, _mm256_loadu_ps(kptr+16), _sum2);
+            _sum3 = _mm256_fmadd_ps(_val1, _mm256_loadu_ps(kptr+24), _sum3);
+            _sum4 = _mm256_fmadd_ps(_val1, _mm256_loadu_ps(kptr+32), _sum4);
+            _sum5 = _mm256_fmadd_ps(_val1, _mm256_loadu_ps(kptr+40), _sum5);
+
+            m += 2;
+            kptr += 48;
+        }
+        for (; i<num_input; i++)
+        {
+            __m256 _val = _mm256_broadcast_ss(m);
+
+            _sum0 = _mm256_fmadd_ps(_val, _mm256_loadu_ps(kptr), _sum0);
+            _sum1 = _mm256_fmadd_ps(_val, _mm256_loadu_ps(kptr+8), _sum1);
+            _sum2 = _mm256_fmadd_ps(_val, _mm256_loadu_ps(kptr+16), _sum2);
+
+            m += 1;
+            kptr += 24;
+        }
+
+        _sum0 = activation_avx(_mm256_add_ps(_sum0, _sum3), activation_type, activation_params);
+        _sum1 = activation_avx(_mm256_add_ps(_sum1, _sum4), activation_type, activation_params);
+        _sum2 = activation_avx(_mm256_add_ps(_sum2, _sum5), activation_type, activation_params);
+
+        _mm256_storeu_ps(outptr0, _sum0);
+        _mm256_storeu_ps(outptr0 + 8, _sum1);
+        _mm256_storeu_ps(outptr0 + 16, _sum2);
+#elif __SSE2__
+        __m128 _sum0 = biasptr ? _mm_loadu_ps(biasptr) : _mm_setzero_ps();
+        __m128 _sum1 = biasptr ? _mm_loadu_ps(biasptr + 4) : _mm_setzero_ps();
+        __m128 _sum2 = biasptr ? _mm_loadu_ps(biasptr + 8) : _mm_setzero_ps();
+        __m128 _sum3 = _mm_setzero_ps();
+        __m128 _sum4 = _mm_setzero_ps();
+        __m128 _sum5 = _mm_setzero_ps();
+
+        int i=0;
+        for (; i+1<num_input; i+=2)
+        {
+            __m128 _val0 = _mm_load1_ps(m);
+            __m128 _val1 = _mm_load1_ps(m+1);
+
+            _sum0 = _mm_add_ps(_sum0, _mm_mul_ps(_val0, _mm_loadu_ps(kptr)));
+            _sum1 = _mm_add_ps(_sum1, _mm_mul_ps(_val0, _mm_loadu_ps(kptr+4)));
+            _sum2 = _mm_add_ps(_sum2, _mm_mul_ps(_val0, _mm_loadu_ps(kptr+8)));
+            _sum3 = _mm_add_ps(_sum3, _mm_mul_ps(_val1, _mm_loadu_ps(kptr+12)));
+            _sum4 = _mm_add_ps(_sum4, _mm_mul_ps(_val1, _mm_loadu_ps(kptr+16)));
+            _sum5 = _mm_add_ps(_sum5, _mm_mul_ps(_val1, _mm_loadu_ps(kptr+20)));
+
+            m += 2;
+            kptr += 24;
+        }
+        for (; i<num_input; i++)
+        {
+            __m128 _val = _mm_load1_ps(m);
+
+            _sum0 = _mm_add_ps(_sum0, _mm_mul_ps(_val, _mm_loadu_ps(kptr)));
+            _sum1 = _mm_add_ps(_sum1, _mm_mul_ps(_val, _mm_loadu_ps(kptr+4)));
+            _sum2 = _mm_add_ps(_sum2, _mm_mul_ps(_val, _mm_loadu_ps(kptr+8)));
+
+            m += 1;
+            kptr += 12;
+        }
+
+        _sum0 = activation_sse(_mm_add_ps(_sum0, _sum3), activation_type, activation_params);
+        _sum1 = activation_sse(_mm_add_ps(_sum1, _sum4), activation_type, activation_params);
+        _sum2 = activation_sse(_mm_add_ps(_sum2, _sum5), activation_type, activation_params);
+
+        _mm_storeu_ps(outptr0, _sum0);
+        _mm_storeu_ps(outptr0 + 4, _sum1);
+        _mm_storeu_ps(outptr0 + 8, _sum2);
+#else
+        float sum[sgemm_nr];
+        for (int k=0; k<sgemm_nr; k++)
+        {
+            sum[k] = biasptr ? biasptr[k] : 0.f;
+        }
+
+        for (int i=0; i<num_input; i++)
+        {
+            for (int k=0; k<sgemm_nr; k++)
+            {
+                sum[k] += *m * kptr[k];
+            }
+
+            m += 1;
+            kptr += sgemm_nr;
+        }
+
+        for (int k=0; k<sgemm_nr; k++)
+        {
+            outptr0[k] = activation_ss(sum[k], activation_type, activation_params);
+        }
+#endif // __AVX__
+
+        if (outptr0 == out_tail)
+        {
+            for (int k=0; k<valid; k++)
+            {
+                outptr[p + k] = out_tail[k];
+            }
+        }
+    }
+
+    return 0;
+}
+
+int InnerProduct_x86::forward_batch(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    size_t elemsize = bottom_blob.elemsize;
+    int num_input = bottom_blob.w;
+    int batch = bottom_blob.h;
+
+    // one input vector per row, the whole batch as a single sgemm against the packed weights
+    Mat bottom_blob_packed;
+    sgemm_pack_a(bottom_blob, bottom_blob.w, 1, batch, num_input, bottom_blob_packed, opt.workspace_allocator);
+    if (bottom_blob_packed.empty())
+        return -100;
+
+    top_blob.create(num_output, batch, elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    sgemm(batch, num_output, num_input, bottom_blob_packed, weight_data_packed, 0, top_blob, top_blob.w, 1, opt);
+
+    // bias is per output column here, add it with the activation
+    const float* bias_data_ptr = bias_term ? (const float*)bias_data : 0;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int i=0; i<batch; i++)
+    {
+        float* outptr = top_blob.row(i);
+
+        int p=0;
+#if __AVX__
+        for (; p+7<num_output; p+=8)
+        {
+            __m256 _v = _mm256_loadu_ps(outptr + p);
+            if (bias_data_ptr)
+                _v = _mm256_add_ps(_v, _mm256_loadu_ps(bias_data_ptr + p));
+            _mm256_storeu_ps(outptr + p, activation_avx(_v, activation_type, activation_params));
+        }
+#endif // __AVX__
+#if __SSE2__
+        for (; p+3<num_output; p+=4)
+        {
+            __m128 _v = _mm_loadu_ps(outptr + p);
+            if (bias_data_ptr)
+                _v = _mm_add_ps(_v, _mm_loadu_ps(bias_data_ptr + p));
+            _mm_storeu_ps(outptr + p, activation_sse(_v, activation_type, activation_params));
+        }
+#endif // __SSE2__
+        for (; p<num_output; p++)
+        {
+            float v = outptr[p];
+            if (bias_data_ptr)
+                v += bias_data_ptr[p];
+            outptr[p] = activation_ss(v, activation_type, activation_params);
+        }
+    }
+
+    return 0;
+}
+
+int InnerProduct_x86::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+#if __SSE2__
+    size_t elemsize = bottom_blob.elemsize;
+    int num_input = weight_data_size / num_output;
+    int num_input_4 = (num_input + 3) / 4 * 4;
+
+    if (bottom_blob.w * bottom_blob.h * bottom_blob.c != num_input)
+    {
+        return InnerProduct::forward(bottom_blob, top_blob, opt);
+    }
+
+    Mat bottom_blob_flattened = bottom_blob;
+    if (bottom_blob.dims != 1)
+    {
+        bottom_blob_flattened = bottom_blob.reshape(num_input, opt.workspace_allocator);
+        if (bottom_blob_flattened.empty())
+            return -100;
+    }
+
+    // quantize, scale and round to nearest
+    Mat bottom_blob_int8 = bottom_blob_flattened;
+    if (elemsize != 1)
+    {
+        bottom_blob_int8.create(num_input, (size_t)1u, opt.workspace_allocator);
+        if (bottom_blob_int8.empty())
+            return -100;
+
+        ncnn::Option opt_g = opt;
+        opt_g.blob_allocator = bottom_blob_int8.allocator;
+
+        quantize->forward(bottom_blob_flattened, bottom_blob_int8, opt_g);
+    }
+
+    // zero pad to whole groups of 4 inputs
+    if (num_input_4 != num_input)
+    {
+        Mat bottom_blob_int8_padded;
+        bottom_blob_int8_padded.create(num_input_4, (size_t)1u, opt.workspace_allocator);
+        if (bottom_blob_int8_padded.empty())
+            return -100;
+
+        signed char* ptr = bottom_blob_int8_padded;
+        memcpy(ptr, bottom_blob_int8.data, num_input);
+        memset(ptr + num_input, 0, num_input_4 - num_input);
+
+        bottom_blob_int8 = bottom_blob_int8_padded;
+    }
+
+    top_blob.create(num_output, use_int8_requantize ? (size_t)1u : (size_t)4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const int* xptr = bottom_blob_int8;
+    const int nn_input = num_input_4 / 4;
+    const int nn_num_output = (num_output + 7) / 8;
+
+    const float* scales = dequantize_scales_data;
+    const float* biases = dequantize_bias_data;
+
+#if __AVX2__
+    int vnni_type = 0;
+#if NCNN_X86_AVX512_VNNI
+    if (vnni_type == 0 && cpu_support_x86_avx512_vnni())
+        vnni_type = 2;
+#endif
+#if NCNN_X86_AVX_VNNI
+    if (vnni_type == 0 && cpu_support_x86_avx_vnni())
+        vnni_type = 1;
+#endif
+
+    // vnni takes unsigned input, shift x by 128 and compensate with the weight sums
+    Mat bottom_blob_uint8;
+    if (vnni_type)
+    {
+        bottom_blob_uint8.create(num_input_4, (size_t)1u, opt.workspace_allocator);
+        if (bottom_blob_uint8.empty())
+            return -100;
+
+        const unsigned char* ptr = bottom_blob_int8;
+        unsigned char* outptr = bottom_blob_uint8;
+        for (int i=0; i<num_input_4; i++)
+        {
+            outptr[i] = ptr[i] ^ 0x80;
+        }
+    }
+    const int* xuptr = bottom_blob_uint8;
+    const int* sums = weight_data_int8_sums;
+#endif // __AVX2__
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp=0; pp<nn_num_output; pp++)
+    {
+        int p = pp * 8;
+
+        const signed char* kptr = weight_data_int8_packed.row<const signed char>(pp);
+
+        float out[8];
+
+#if __AVX2__
+        __m256i _sum;
+#if NCNN_X86_AVX512_VNNI
+        if (vnni_type == 2)
+        {
+            _sum = innerproduct_int8_block_avx512vnni(kptr, xuptr, nn_input);
+            _sum = _mm256_sub_epi32(_sum, _mm256_loadu_si256((const __m256i*)(sums + p)));
+        }
+        else
+#endif
+#if NCNN_X86_AVX_VNNI
+        if (vnni_type == 1)
+        {
+            _sum = innerproduct_int8_block_avxvnni(kptr, xuptr, nn_input);
+            _sum = _mm256_sub_epi32(_sum, _mm256_loadu_si256((const __m256i*)(sums + p)));
+        }
+        else
+#endif
+        {
+            _sum = innerproduct_int8_block_avx2(kptr, xptr, nn_input);
+        }
+
+        // dequantize, bias and activation
+        __m256 _v = _mm256_cvtepi32_ps(_sum);
+        _v = _mm256_fmadd_ps(_v, _mm256_loadu_ps(scales + p), _mm256_loadu_ps(biases + p));
+        _v = activation_avx(_v, activation_type, activation_params);
+        _mm256_storeu_ps(out, _v);
+#else
+        __m128i _sum0;
+        __m128i _sum1;
+        innerproduct_int8_block_sse2(kptr, xptr, nn_input, _sum0, _sum1);
+
+        // dequantize, bias and activation
+        __m128 _v0 = _mm_cvtepi32_ps(_sum0);
+        __m128 _v1 = _mm_cvtepi32_ps(_sum1);
+        _v0 = _mm_add_ps(_mm_mul_ps(_v0, _mm_loadu_ps(scales + p)), _mm_loadu_ps(biases + p));
+        _v1 = _mm_add_ps(_mm_mul_ps(_v1, _mm_loadu_ps(scales + p + 4)), _mm_loadu_ps(biases + p + 4));
+        _v0 = activation_sse(_v0, activation_type, activation_params);
+        _v1 = activation_sse(_v1, activation_type, activation_params);
+        _mm_storeu_ps(out, _v0);
+        _mm_storeu_ps(out + 4, _v1);
+#endif // __AVX2__
+
+        int valid = std::min(8, num_output - p);
+
+        if (use_int8_requantize)
+        {
+            signed char* outptr = (signed char*)top_blob + p;
+            for (int k=0; k<valid; k++)
+            {
+                outptr[k] = float2int8(out[k] * top_blob_int8_scale);
+            }
+        }
+        else
+        {
+            float* outptr = (float*)top_blob + p;
+            for (int k=0; k<valid; k++)
+            {
+                outptr[k] = out[k];
+            }
+        }
+    }
+
+    return 0;
+#else
+    return InnerProduct::forward(bottom_blob, top_blob, opt);
+#endif // __SSE2__
+}
+
+} // namespace ncnn
@@ -0,0 +1,51 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef LAYER_INNERPRODUCT_X86_H
+#define LAYER_INNERPRODUCT_X86_H
+
+#include "innerproduct.h"
+
+namespace ncnn {
+
+class InnerProduct_x86 : virtual public InnerProduct
+{
+public:
+    InnerProduct_x86();
+
+    virtual int create_pipeline(const Option& opt);
+
+    virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+    virtual int forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+
+protected:
+    // dims 2 input with one num_input vector per row
+    int forward_batch(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+
+public:
+    // sgemm B panels, sgemm_nr outputs interleaved per input
+    Mat weight_data_packed;
+
+    // int8, 8 outputs x 4 inputs interleaved
+    Mat weight_data_int8_packed;
+    // 128 * sum of packed weights per output, offset compensation for the vnni path
+    Mat weight_data_int8_sums;
+    // dequantize scale and bias, padded to the packed output count
+    Mat dequantize_scales_data;
+    Mat dequantize_bias_data;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_INNERPRODUCT_X86_H
@@ -0,0 +1,292 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "packing_x86.h"
+
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Packing_x86)
+
+Packing_x86::Packing_x86()
+{
+    support_packing = true;
+}
+
+#if __AVX__
+static inline void transpose8_ps(__m256& _r0, __m256& _r1, __m256& _r2, __m256& _r3, __m256& _r4, __m256& _r5, __m256& _r6, __m256& _r7)
+{
+    __m256 _t0 = _mm256_unpacklo_ps(_r0, _r1);
+    __m256 _t1 = _mm256_unpackhi_ps(_r0, _r1);
+    __m256 _t2 = _mm256_unpacklo_ps(_r2, _r3);
+    __m256 _t3 = _mm256_unpackhi_ps(_r2, _r3);
+    __m256 _t4 = _mm256_unpacklo_ps(_r4, _r5);
+    __m256 _t5 = _mm256_unpackhi_ps(_r4, _r5);
+    __m256 _t6 = _mm256_unpacklo_ps(_r6, _r7);
+    __m256 _t7 = _mm256_unpackhi_ps(_r6, _r7);
+
+    __m256 _u0 = _mm256_shuffle_ps(_t0, _t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _u1 = _mm256_shuffle_ps(_t0, _t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _u2 = _mm256_shuffle_ps(_t1, _t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _u3 = _mm256_shuffle_ps(_t1, _t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _u4 = _mm256_shuffle_ps(_t4, _t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _u5 = _mm256_shuffle_ps(_t4, _t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _u6 = _mm256_shuffle_ps(_t5, _t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _u7 = _mm256_shuffle_ps(_t5, _t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _r0 = _mm256_permute2f128_ps(_u0, _u4, 0x20);
+    _r1 = _mm256_permute2f128_ps(_u1, _u5, 0x20);
+    _r2 = _mm256_permute2f128_ps(_u2, _u6, 0x20);
+    _r3 = _mm256_permute2f128_ps(_u3, _u7, 0x20);
+    _r4 = _mm256_permute2f128_ps(_u0, _u4, 0x31);
+    _r5 = _mm256_permute2f128_ps(_u1, _u5, 0x31);
+    _r6 = _mm256_permute2f128_ps(_u2, _u6, 0x31);
+    _r7 = _mm256_permute2f128_ps(_u3, _u7, 0x31);
+}
+#endif // __AVX__
+
+// interleave 8 rows of size elements into one pack8 row
+static void packing_pack1to8(const float* r0, const float* r1, const float* r2, const float* r3, const float* r4, const float* r5, const float* r6, const float* r7, float* outptr, int size)
+{
+    int i = 0;
+#if __AVX__
+    for (; i+7<size; i+=8)
+    {
+        __m256 _r0 = _mm256_loadu_ps(r0);
+        __m256 _r1 = _mm256_loadu_ps(r1);
+        __m256 _r2 = _mm256_loadu_ps(r2);
+        __m256 _r3 = _mm256_loadu_ps(r3);
+        __m256 _r4 = _mm256_loadu_ps(r4);
+        __m256 _r5 = _mm256_loadu_ps(r5);
+        __m256 _r6 = _mm256_loadu_ps(r6);
+        __m256 _r7 = _mm256_loadu_ps(r7);
+
+        transpose8_ps(_r0, _r1, _r2, _r3, _r4, _r5, _r6, _r7);
+
+        _mm256_storeu_ps(outptr, _r0);
+        _mm256_storeu_ps(outptr + 8, _r1);
+        _mm256_storeu_ps(outptr + 16, _r2);
+        _mm256_storeu_ps(outptr + 24, _r3);
+        _mm256_storeu_ps(outptr + 32, _r4);
+        _mm256_storeu_ps(outptr + 40, _r5);
+        _mm256_storeu_ps(outptr + 48, _r6);
+        _mm256_storeu_ps(outptr + 56, _r7);
+
+        r0 += 8;
+        r1 += 8;
+        r2 += 8;
+        r3 += 8;
+        r4 += 8;
+        r5 += 8;
+        r6 += 8;
+        r7 += 8;
+        outptr += 64;
+    }
+#endif // __AVX__
+    for (; i<size; i++)
+    {
+        outptr[0] = *r0++;
+        outptr[1] = *r1++;
+        outptr[2] = *r2++;
+        outptr[3] = *r3++;
+        outptr[4] = *r4++;
+        outptr[5] = *r5++;
+        outptr[6] = *r6++;
+        outptr[7] = *r7++;
+
+        outptr += 8;
+    }
+}
+
+// split one pack8 row of size elements into 8 rows
+static void packing_pack8to1(const float* r0, float* outptr0, float* outptr1, float* outptr2, float* outptr3, float* outptr4, float* outptr5, float* outptr6, float* outptr7, int size)
+{
+    int i = 0;
+#if __AVX__
+    for (; i+7<size; i+=8)
+    {
+        __m256 _r0 = _mm256_loadu_ps(r0);
+        __m256 _r1 = _mm256_loadu_ps(r0 + 8);
+        __m256 _r2 = _mm256_loadu_ps(r0 + 16);
+        __m256 _r3 = _mm256_loadu_ps(r0 + 24);
+        __m256 _r4 = _mm256_loadu_ps(r0 + 32);
+        __m256 _r5 = _mm256_loadu_ps(r0 + 40);
+        __m256 _r6 = _mm256_loadu_ps(r0 + 48);
+        __m256 _r7 = _mm256_loadu_ps(r0 + 56);
+
+        transpose8_ps(_r0, _r1, _r2, _r3, _r4, _r5, _r6, _r7);
+
+        _mm256_storeu_ps(outptr0, _r0);
+        _mm256_storeu_ps(outptr1, _r1);
+        _mm256_storeu_ps(outptr2, _r2);
+        _mm256_storeu_ps(outptr3, _r3);
+        _mm256_storeu_ps(outptr4, _r4);
+        _mm256_storeu_ps(outptr5, _r5);
+        _mm256_storeu_ps(outptr6, _r6);
+        _mm256_storeu_ps(outptr7, _r7);
+
+        r0 += 64;
+        outptr0 += 8;
+        outptr1 += 8;
+        outptr2 += 8;
+        outptr3 += 8;
+        outptr4 += 8;
+        outptr5 += 8;
+        outptr6 += 8;
+        outptr7 += 8;
+    }
+#endif // __AVX__
+    for (; i<size; i++)
+    {
+        *outptr0++ = r0[0];
+        *outptr1++ = r0[1];
+        *outptr2++ = r0[2];
+        *outptr3++ = r0[3];
+        *outptr4++ = r0[4];
+        *outptr5++ = r0[5];
+        *outptr6++ = r0[6];
+        *outptr7++ = r0[7];
+
+        r0 += 8;
+    }
+}
+
+int Packing_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    if (use_padding)
+    {
+        return Packing::forward(bottom_blob, top_blob, opt);
+    }
+
+    int elempack = bottom_blob.elempack;
+
+    if (elempack == out_elempack)
+    {
+        top_blob = bottom_blob;
+        return 0;
+    }
+
+    bool pack1to8 = elempack == 1 && out_elempack == 8;
+    bool pack8to1 = elempack == 8 && out_elempack == 1;
+
+    if ((!pack1to8 && !pack8to1) || bottom_blob.elemsize / elempack != 4u)
+    {
+        return Packing::forward(bottom_blob, top_blob, opt);
+    }
+
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    int dims = bottom_blob.dims;
+    size_t elemsize = bottom_blob.elemsize;
+
+    // identity if use_padding not allowed
+    if (dims == 1 && w * elempack % out_elempack != 0)
+    {
+        top_blob = bottom_blob;
+        return 0;
+    }
+    if (dims == 2 && h * elempack % out_elempack != 0)
+    {
+        top_blob = bottom_blob;
+        return 0;
+    }
+    if (dims == 3 && channels * elempack % out_elempack != 0)
+    {
+        top_blob = bottom_blob;
+        return 0;
+    }
+
+    if (dims == 1)
+    {
+        top_blob = bottom_blob;
+        top_blob.w = w * elempack / out_elempack;
+        top_blob.cstep = w * elempack / out_elempack;
+        top_blob.elemsize = elemsize / elempack * out_elempack;
+        top_blob.elempack = out_elempack;
+        return 0;
+    }
+
+    if (dims == 2)
+    {
+        int outh = h * elempack / out_elempack;
+        size_t out_elemsize = elemsize / elempack * out_elempack;
+
+        top_blob.create(w, outh, out_elemsize, out_elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        if (pack1to8)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i=0; i<outh; i++)
+            {
+                packing_pack1to8(bottom_blob.row(i*8), bottom_blob.row(i*8+1), bottom_blob.row(i*8+2), bottom_blob.row(i*8+3),
+                                 bottom_blob.row(i*8+4), bottom_blob.row(i*8+5), bottom_blob.row(i*8+6), bottom_blob.row(i*8+7),
+                                 top_blob.row(i), w);
+            }
+        }
+        if (pack8to1)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i=0; i<h; i++)
+            {
+                packing_pack8to1(bottom_blob.row(i), top_blob.row(i*8), top_blob.row(i*8+1), top_blob.row(i*8+2), top_blob.row(i*8+3),
+                                 top_blob.row(i*8+4), top_blob.row(i*8+5), top_blob.row(i*8+6), top_blob.row(i*8+7), w);
+            }
+        }
+
+        return 0;
+    }
+
+    if (dims == 3)
+    {
+        int size = w * h;
+        int outc = channels * elempack / out_elempack;
+        size_t out_elemsize = elemsize / elempack * out_elempack;
+
+        top_blob.create(w, h, outc, out_elemsize, out_elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        if (pack1to8)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<outc; q++)
+            {
+                packing_pack1to8(bottom_blob.channel(q*8), bottom_blob.channel(q*8+1), bottom_blob.channel(q*8+2), bottom_blob.channel(q*8+3),
+                                 bottom_blob.channel(q*8+4), bottom_blob.channel(q*8+5), bottom_blob.channel(q*8+6), bottom_blob.channel(q*8+7),
+                                 top_blob.channel(q), size);
+            }
+        }
+        if (pack8to1)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                packing_pack8to1(bottom_blob.channel(q), top_blob.channel(q*8), top_blob.channel(q*8+1), top_blob.channel(q*8+2), top_blob.channel(q*8+3),
+                                 top_blob.channel(q*8+4), top_blob.channel(q*8+5), top_blob.channel(q*8+6), top_blob.channel(q*8+7), size);
+            }
+        }
+
+        return 0;
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,168 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "padding_x86.h"
+
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Padding_x86)
+
+Padding_x86::Padding_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+#if __AVX__
+// source index of a border position, -1 for the constant border
+static inline int padding_source_index(int x, int size, int type)
+{
+    if (x >= 0 && x < size)
+        return x;
+
+    if (type == 0)
+        return -1;
+
+    if (type == 1)
+        return x < 0 ? 0 : size - 1;
+
+    // reflect without repeating the edge
+    return x < 0 ? -x : 2 * (size - 1) - x;
+}
+
+static void padding_pack8_avx(const Mat& src, Mat& dst, int top, int left, int type, float v)
+{
+    const int w = src.w;
+    const int h = src.h;
+    const int outw = dst.w;
+    const int outh = dst.h;
+
+    __m256 _v = _mm256_set1_ps(v);
+
+    float* outptr = dst;
+
+    for (int y = 0; y < outh; y++)
+    {
+        const int sy = padding_source_index(y - top, h, type);
+        if (sy < 0)
+        {
+            for (int x = 0; x < outw; x++)
+            {
+                _mm256_storeu_ps(outptr, _v);
+                outptr += 8;
+            }
+            continue;
+        }
+
+        const float* ptr = (const float*)src + sy * w * 8;
+
+        int x = 0;
+        for (; x < left; x++)
+        {
+            const int sx = padding_source_index(x - left, w, type);
+            _mm256_storeu_ps(outptr, sx < 0 ? _v : _mm256_loadu_ps(ptr + sx * 8));
+            outptr += 8;
+        }
+        for (; x < left + w; x++)
+        {
+            _mm256_storeu_ps(outptr, _mm256_loadu_ps(ptr + (x - left) * 8));
+            outptr += 8;
+        }
+        for (; x < outw; x++)
+        {
+            const int sx = padding_source_index(x - left, w, type);
+            _mm256_storeu_ps(outptr, sx < 0 ? _v : _mm256_loadu_ps(ptr + sx * 8));
+            outptr += 8;
+        }
+    }
+}
+#endif // __AVX__
+
+int Padding_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    if (top == 0 && bottom == 0 && left == 0 && right == 0)
+    {
+        top_blob = bottom_blob;
+        return 0;
+    }
+
+#if __AVX__
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    int dims = bottom_blob.dims;
+    size_t elemsize = bottom_blob.elemsize;
+    int elempack = bottom_blob.elempack;
+
+    if (opt.use_packing_layout)
+    {
+
+    if (elempack == 8)
+    {
+        if (dims != 3)
+        {
+            // 1d and 2d blobs pack along the padded axis, pad them unpacked
+            Mat bottom_blob_unpacked;
+            Option opt_pack = opt;
+            opt_pack.blob_allocator = opt.workspace_allocator;
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack);
+
+            return Padding::forward(bottom_blob_unpacked, top_blob, opt);
+        }
+
+        int outw = w + left + right;
+        int outh = h + top + bottom;
+
+        top_blob.create(outw, outh, channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q=0; q<channels; q++)
+        {
+            const Mat m = bottom_blob.channel(q);
+            Mat borderm = top_blob.channel(q);
+
+            padding_pack8_avx(m, borderm, top, left, type, value);
+        }
+
+        return 0;
+    }
+
+    } // opt.use_packing_layout
+#endif // __AVX__
+
+    return Padding::forward(bottom_blob, top_blob, opt);
+}
+
+int Padding_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    if (bottom_blobs[0].elempack == 1)
+        return Padding::forward(bottom_blobs, top_blobs, opt);
+
+    // dynamic offsets are rare, pad them unpacked
+    std::vector<Mat> bottom_blobs_unpacked = bottom_blobs;
+    Option opt_pack = opt;
+    opt_pack.blob_allocator = opt.workspace_allocator;
+    convert_packing(bottom_blobs[0], bottom_blobs_unpacked[0], 1, opt_pack);
+
+    return Padding::forward(bottom_blobs_unpacked, top_blobs, opt);
+}
+
+} // namespace ncnn
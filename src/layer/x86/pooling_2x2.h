@@ -0,0 +1,116 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+template<typename Op>
+static void pooling2x2s2_sse(const Mat& bottom_blob, Mat& top_blob, int pad_left, int pad_top, const Op& op, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+
+    // output columns whose window lies inside the input
+    int jstart = std::min((pad_left + 1) / 2, outw);
+    int jend = w - 2 + pad_left < 0 ? 0 : std::min((w - 2 + pad_left) / 2 + 1, outw);
+    jend = std::max(jend, jstart);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<inch; q++)
+    {
+        const Mat m = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        for (int i = 0; i < outh; i++)
+        {
+            int sy = i * 2 - pad_top;
+
+            if (sy < 0 || sy + 2 > h)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    outptr[j] = op.post(pooling_window(m, j * 2 - pad_left, sy, 2, 2, op));
+                }
+
+                outptr += outw;
+                continue;
+            }
+
+            for (int j = 0; j < jstart; j++)
+            {
+                outptr[j] = op.post(pooling_window(m, j * 2 - pad_left, sy, 2, 2, op));
+            }
+
+            const float* r0 = m.row(sy) + jstart * 2 - pad_left;
+            const float* r1 = r0 + w;
+
+            int j = jstart;
+#if __AVX__
+            for (; j+7<jend; j+=8)
+            {
+                __m256 _r00 = _mm256_loadu_ps(r0);
+                __m256 _r01 = _mm256_loadu_ps(r0 + 8);
+                __m256 _r10 = _mm256_loadu_ps(r1);
+                __m256 _r11 = _mm256_loadu_ps(r1 + 8);
+
+                __m256 _m0 = op(_r00, _r10);
+                __m256 _m1 = op(_r01, _r11);
+
+                // deinterleave even and odd columns
+                __m256 _lo = _mm256_permute2f128_ps(_m0, _m1, 0x20);
+                __m256 _hi = _mm256_permute2f128_ps(_m0, _m1, 0x31);
+                __m256 _even = _mm256_shuffle_ps(_lo, _hi, _MM_SHUFFLE(2, 0, 2, 0));
+                __m256 _odd = _mm256_shuffle_ps(_lo, _hi, _MM_SHUFFLE(3, 1, 3, 1));
+
+                _mm256_storeu_ps(outptr + j, op.post(op(_even, _odd)));
+
+                r0 += 16;
+                r1 += 16;
+            }
+#endif // __AVX__
+#if __SSE2__
+            for (; j+3<jend; j+=4)
+            {
+                __m128 _m0 = op(_mm_loadu_ps(r0), _mm_loadu_ps(r1));
+                __m128 _m1 = op(_mm_loadu_ps(r0 + 4), _mm_loadu_ps(r1 + 4));
+
+                __m128 _even = _mm_shuffle_ps(_m0, _m1, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 _odd = _mm_shuffle_ps(_m0, _m1, _MM_SHUFFLE(3, 1, 3, 1));
+
+                _mm_storeu_ps(outptr + j, op.post(op(_even, _odd)));
+
+                r0 += 8;
+                r1 += 8;
+            }
+#endif // __SSE2__
+            for (; j<jend; j++)
+            {
+                float v = op(op(r0[0], r0[1]), op(r1[0], r1[1]));
+
+                outptr[j] = op.post(v);
+
+                r0 += 2;
+                r1 += 2;
+            }
+
+            for (; j<outw; j++)
+            {
+                outptr[j] = op.post(pooling_window(m, j * 2 - pad_left, sy, 2, 2, op));
+            }
+
+            outptr += outw;
+        }
+    }
+}
@@ -0,0 +1,133 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+template<typename Op>
+static void pooling3x3s2_sse(const Mat& bottom_blob, Mat& top_blob, int pad_left, int pad_top, const Op& op, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+
+    // output columns whose window lies inside the input
+    int jstart = std::min((pad_left + 1) / 2, outw);
+    int jend = w - 3 + pad_left < 0 ? 0 : std::min((w - 3 + pad_left) / 2 + 1, outw);
+    jend = std::max(jend, jstart);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<inch; q++)
+    {
+        const Mat m = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        for (int i = 0; i < outh; i++)
+        {
+            int sy = i * 2 - pad_top;
+
+            if (sy < 0 || sy + 3 > h)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    outptr[j] = op.post(pooling_window(m, j * 2 - pad_left, sy, 3, 3, op));
+                }
+
+                outptr += outw;
+                continue;
+            }
+
+            for (int j = 0; j < jstart; j++)
+            {
+                outptr[j] = op.post(pooling_window(m, j * 2 - pad_left, sy, 3, 3, op));
+            }
+
+            const float* r0 = m.row(sy) + jstart * 2 - pad_left;
+            const float* r1 = r0 + w;
+            const float* r2 = r1 + w;
+
+            int j = jstart;
+#if __AVX__
+            for (; j+7<jend; j+=8)
+            {
+                // reduce the three rows first
+                __m256 _v0 = op(op(_mm256_loadu_ps(r0), _mm256_loadu_ps(r1)), _mm256_loadu_ps(r2));
+                __m256 _v1 = op(op(_mm256_loadu_ps(r0 + 8), _mm256_loadu_ps(r1 + 8)), _mm256_loadu_ps(r2 + 8));
+                __m128 _v2 = op(op(_mm_load_ss(r0 + 16), _mm_load_ss(r1 + 16)), _mm_load_ss(r2 + 16));
+
+                // x0 x2 x4 x6 x8 x10 x12 x14
+                // x1 x3 x5 x7 x9 x11 x13 x15
+                __m256 _lo = _mm256_permute2f128_ps(_v0, _v1, 0x20);
+                __m256 _hi = _mm256_permute2f128_ps(_v0, _v1, 0x31);
+                __m256 _even = _mm256_shuffle_ps(_lo, _hi, _MM_SHUFFLE(2, 0, 2, 0));
+                __m256 _odd = _mm256_shuffle_ps(_lo, _hi, _MM_SHUFFLE(3, 1, 3, 1));
+
+                // x2 x4 x6 x8 x10 x12 x14 x16
+                __m256 _t = _mm256_permute2f128_ps(_even, _mm256_castps128_ps256(_v2), 0x21);
+                __m256 _u = _mm256_shuffle_ps(_even, _t, _MM_SHUFFLE(0, 0, 3, 3));
+                __m256 _even1 = _mm256_shuffle_ps(_even, _u, _MM_SHUFFLE(2, 0, 2, 1));
+
+                _mm256_storeu_ps(outptr + j, op.post(op(op(_even, _odd), _even1)));
+
+                r0 += 16;
+                r1 += 16;
+                r2 += 16;
+            }
+#endif // __AVX__
+#if __SSE2__
+            for (; j+3<jend; j+=4)
+            {
+                // reduce the three rows first
+                __m128 _v0 = op(op(_mm_loadu_ps(r0), _mm_loadu_ps(r1)), _mm_loadu_ps(r2));
+                __m128 _v1 = op(op(_mm_loadu_ps(r0 + 4), _mm_loadu_ps(r1 + 4)), _mm_loadu_ps(r2 + 4));
+                __m128 _v2 = op(op(_mm_load_ss(r0 + 8), _mm_load_ss(r1 + 8)), _mm_load_ss(r2 + 8));
+
+                // x0 x2 x4 x6
+                // x1 x3 x5 x7
+                __m128 _even = _mm_shuffle_ps(_v0, _v1, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 _odd = _mm_shuffle_ps(_v0, _v1, _MM_SHUFFLE(3, 1, 3, 1));
+
+                // x2 x4 x6 x8
+                __m128 _t = _mm_shuffle_ps(_even, _v2, _MM_SHUFFLE(0, 0, 3, 3));
+                __m128 _even1 = _mm_shuffle_ps(_even, _t, _MM_SHUFFLE(2, 0, 2, 1));
+
+                _mm_storeu_ps(outptr + j, op.post(op(op(_even, _odd), _even1)));
+
+                r0 += 8;
+                r1 += 8;
+                r2 += 8;
+            }
+#endif // __SSE2__
+            for (; j<jend; j++)
+            {
+                float v0 = op(op(r0[0], r0[1]), r0[2]);
+                float v1 = op(op(r1[0], r1[1]), r1[2]);
+                float v2 = op(op(r2[0], r2[1]), r2[2]);
+
+                outptr[j] = op.post(op(op(v0, v1), v2));
+
+                r0 += 2;
+                r1 += 2;
+                r2 += 2;
+            }
+
+            for (; j<outw; j++)
+            {
+                outptr[j] = op.post(pooling_window(m, j * 2 - pad_left, sy, 3, 3, op));
+            }
+
+            outptr += outw;
+        }
+    }
+}
@@ -0,0 +1,661 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "pooling_x86.h"
+#include <float.h>
+#include <algorithm>
+
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+struct pooling_op_max
+{
+    float init() const { return -FLT_MAX; }
+    float operator()(float x, float y) const { return std::max(x, y); }
+    float post(float v) const { return v; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_max_ps(x, y); }
+    __m128 post(const __m128& v) const { return v; }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_max_ps(x, y); }
+    __m256 post(const __m256& v) const { return v; }
+#endif // __AVX__
+};
+
+struct pooling_op_avg
+{
+    pooling_op_avg(int maxk) : inv_maxk(1.f / maxk) {}
+
+    float init() const { return 0.f; }
+    float operator()(float x, float y) const { return x + y; }
+    float post(float v) const { return v * inv_maxk; }
+#if __SSE2__
+    __m128 operator()(const __m128& x, const __m128& y) const { return _mm_add_ps(x, y); }
+    __m128 post(const __m128& v) const { return _mm_mul_ps(v, _mm_set1_ps(inv_maxk)); }
+#endif // __SSE2__
+#if __AVX__
+    __m256 operator()(const __m256& x, const __m256& y) const { return _mm256_add_ps(x, y); }
+    __m256 post(const __m256& v) const { return _mm256_mul_ps(v, _mm256_set1_ps(inv_maxk)); }
+#endif // __AVX__
+
+    float inv_maxk;
+};
+
+// window partially outside the input, padding contributes init()
+template<typename Op>
+static inline float pooling_window(const Mat& m, int sx, int sy, int kernel_w, int kernel_h, const Op& op)
+{
+    float v = op.init();
+
+    for (int y = std::max(sy, 0); y < std::min(sy + kernel_h, m.h); y++)
+    {
+        const float* ptr = m.row(y);
+
+        for (int x = std::max(sx, 0); x < std::min(sx + kernel_w, m.w); x++)
+        {
+            v = op(v, ptr[x]);
+        }
+    }
+
+    return v;
+}
+
+#if __AVX__
+// pack8 window partially outside the input, padding contributes init()
+template<typename Op>
+static inline __m256 pooling_window_pack8(const Mat& m, int sx, int sy, int kernel_w, int kernel_h, const Op& op)
+{
+    __m256 _v = _mm256_set1_ps(op.init());
+
+    for (int y = std::max(sy, 0); y < std::min(sy + kernel_h, m.h); y++)
+    {
+        const float* ptr = m.row(y);
+
+        for (int x = std::max(sx, 0); x < std::min(sx + kernel_w, m.w); x++)
+        {
+            _v = op(_v, _mm256_loadu_ps(ptr + x * 8));
+        }
+    }
+
+    return _v;
+}
+
+template<typename Op>
+static void pooling_pack8_avx(const Mat& bottom_blob, Mat& top_blob, int kernel_w, int kernel_h, int stride_w, int stride_h, int pad_left, int pad_top, const Op& op, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+
+    const int maxk = kernel_w * kernel_h;
+
+    // kernel offsets in pack8 elements
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = w - kernel_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2 * 8;
+                p1++;
+                p2++;
+            }
+            p2 += gap;
+        }
+    }
+
+    // output columns whose window lies inside the input
+    int jstart = std::min(std::max((pad_left + stride_w - 1) / stride_w, 0), outw);
+    int jend = w - kernel_w + pad_left < 0 ? 0 : std::min((w - kernel_w + pad_left) / stride_w + 1, outw);
+    jend = std::max(jend, jstart);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<channels; q++)
+    {
+        const Mat m = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        for (int i = 0; i < outh; i++)
+        {
+            int sy = i * stride_h - pad_top;
+
+            if (sy < 0 || sy + kernel_h > h)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    _mm256_storeu_ps(outptr + j * 8, op.post(pooling_window_pack8(m, j * stride_w - pad_left, sy, kernel_w, kernel_h, op)));
+                }
+
+                outptr += outw * 8;
+                continue;
+            }
+
+            for (int j = 0; j < jstart; j++)
+            {
+                _mm256_storeu_ps(outptr + j * 8, op.post(pooling_window_pack8(m, j * stride_w - pad_left, sy, kernel_w, kernel_h, op)));
+            }
+
+            const float* sptr0 = m.row(sy);
+
+            for (int j = jstart; j < jend; j++)
+            {
+                const float* sptr = sptr0 + (j * stride_w - pad_left) * 8;
+
+                __m256 _v = _mm256_loadu_ps(sptr);
+                for (int k = 1; k < maxk; k++)
+                {
+                    _v = op(_v, _mm256_loadu_ps(sptr + space_ofs[k]));
+                }
+
+                _mm256_storeu_ps(outptr + j * 8, op.post(_v));
+            }
+
+            for (int j = jend; j < outw; j++)
+            {
+                _mm256_storeu_ps(outptr + j * 8, op.post(pooling_window_pack8(m, j * stride_w - pad_left, sy, kernel_w, kernel_h, op)));
+            }
+
+            outptr += outw * 8;
+        }
+    }
+}
+#endif // __AVX__
+
+#include "pooling_2x2.h"
+#include "pooling_3x3.h"
+
+DEFINE_LAYER_CREATOR(Pooling_x86)
+
+Pooling_x86::Pooling_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int Pooling_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    // max value in NxN window
+    // avg value in NxN window
+
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+
+#if __AVX__
+    int elempack = bottom_blob.elempack;
+
+    if (opt.use_packing_layout)
+    {
+
+    if (elempack == 8)
+    {
+        return forward_pack8(bottom_blob, top_blob, opt);
+    }
+
+    } // opt.use_packing_layout
+#endif // __AVX__
+
+    if (global_pooling)
+    {
+        top_blob.create(channels, elemsize, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        int size = w * h;
+
+        if (pooling_type == PoolMethod_MAX)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                const float* ptr = bottom_blob.channel(q);
+
+                float max = ptr[0];
+
+                int i=0;
+#if __AVX__
+                __m256 _max8 = _mm256_set1_ps(max);
+                for (; i+7<size; i+=8)
+                {
+                    _max8 = _mm256_max_ps(_max8, _mm256_loadu_ps(ptr + i));
+                }
+                __m128 _max = _mm_max_ps(_mm256_castps256_ps128(_max8), _mm256_extractf128_ps(_max8, 1));
+#elif __SSE2__
+                __m128 _max = _mm_set1_ps(max);
+#endif
+#if __SSE2__
+                for (; i+3<size; i+=4)
+                {
+                    _max = _mm_max_ps(_max, _mm_loadu_ps(ptr + i));
+                }
+                _max = _mm_max_ps(_max, _mm_movehl_ps(_max, _max));
+                _max = _mm_max_ss(_max, _mm_shuffle_ps(_max, _max, _MM_SHUFFLE(1, 1, 1, 1)));
+                max = _mm_cvtss_f32(_max);
+#endif // __SSE2__
+                for (; i<size; i++)
+                {
+                    max = std::max(max, ptr[i]);
+                }
+
+                top_blob[q] = max;
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE)
+        {
+            // sum and scale in one pass
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                const float* ptr = bottom_blob.channel(q);
+
+                float sum = 0.f;
+
+                int i=0;
+#if __AVX__
+                __m256 _sum0 = _mm256_setzero_ps();
+                __m256 _sum1 = _mm256_setzero_ps();
+                for (; i+15<size; i+=16)
+                {
+                    _sum0 = _mm256_add_ps(_sum0, _mm256_loadu_ps(ptr + i));
+                    _sum1 = _mm256_add_ps(_sum1, _mm256_loadu_ps(ptr + i + 8));
+                }
+                _sum0 = _mm256_add_ps(_sum0, _sum1);
+                __m128 _sum = _mm_add_ps(_mm256_castps256_ps128(_sum0), _mm256_extractf128_ps(_sum0, 1));
+#elif __SSE2__
+                __m128 _sum = _mm_setzero_ps();
+#endif
+#if __SSE2__
+                for (; i+3<size; i+=4)
+                {
+                    _sum = _mm_add_ps(_sum, _mm_loadu_ps(ptr + i));
+                }
+                _sum = _mm_add_ps(_sum, _mm_movehl_ps(_sum, _sum));
+                _sum = _mm_add_ss(_sum, _mm_shuffle_ps(_sum, _sum, _MM_SHUFFLE(1, 1, 1, 1)));
+                sum = _mm_cvtss_f32(_sum);
+#endif // __SSE2__
+                for (; i<size; i++)
+                {
+                    sum += ptr[i];
+                }
+
+                top_blob[q] = sum / size;
+            }
+        }
+
+        return 0;
+    }
+
+    if (kernel_w != kernel_h || stride_w != stride_h)
+    {
+        return Pooling::forward(bottom_blob, top_blob, opt);
+    }
+
+    const int kernel_size = kernel_w;
+    const int stride = stride_w;
+
+    if (stride != 2 || (kernel_size != 2 && kernel_size != 3))
+    {
+        return Pooling::forward(bottom_blob, top_blob, opt);
+    }
+
+    if (pooling_type != PoolMethod_MAX && pooling_type != PoolMethod_AVE)
+    {
+        return Pooling::forward(bottom_blob, top_blob, opt);
+    }
+
+    // resolve the padding, the kernels read the border in place
+    int pad_l = pad_left;
+    int pad_r = pad_right;
+    int pad_t = pad_top;
+    int pad_b = pad_bottom;
+
+    int wtailpad = 0;
+    int htailpad = 0;
+
+    if (pad_mode == 0) // full padding
+    {
+        int wtail = (w + pad_left + pad_right - kernel_w) % stride_w;
+        int htail = (h + pad_top + pad_bottom - kernel_h) % stride_h;
+
+        if (wtail != 0)
+            wtailpad = stride_w - wtail;
+        if (htail != 0)
+            htailpad = stride_h - htail;
+
+        pad_r += wtailpad;
+        pad_b += htailpad;
+    }
+    else if (pad_mode == 2 || pad_mode == 3) // tensorflow padding=SAME or onnx padding=SAME_UPPER/SAME_LOWER
+    {
+        int wpad = kernel_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_h + (h - 1) / stride_h * stride_h - h;
+
+        pad_l = 0;
+        pad_r = 0;
+        pad_t = 0;
+        pad_b = 0;
+
+        if (wpad > 0 || hpad > 0)
+        {
+            pad_l = pad_mode == 2 ? wpad / 2 : wpad - wpad / 2;
+            pad_r = wpad - pad_l;
+            pad_t = pad_mode == 2 ? hpad / 2 : hpad - hpad / 2;
+            pad_b = hpad - pad_t;
+        }
+    }
+
+    if (pad_l < 0 || pad_r < 0 || pad_t < 0 || pad_b < 0)
+    {
+        return Pooling::forward(bottom_blob, top_blob, opt);
+    }
+
+    int outw = (w + pad_l + pad_r - kernel_w) / stride_w + 1;
+    int outh = (h + pad_t + pad_b - kernel_h) / stride_h + 1;
+
+    top_blob.create(outw, outh, channels, elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    if (pooling_type == PoolMethod_MAX)
+    {
+        pooling_op_max op;
+
+        if (kernel_size == 2)
+            pooling2x2s2_sse(bottom_blob, top_blob, pad_l, pad_t, op, opt);
+        if (kernel_size == 3)
+            pooling3x3s2_sse(bottom_blob, top_blob, pad_l, pad_t, op, opt);
+    }
+    else if (pooling_type == PoolMethod_AVE)
+    {
+        pooling_op_avg op(kernel_size * kernel_size);
+
+        if (kernel_size == 2)
+            pooling2x2s2_sse(bottom_blob, top_blob, pad_l, pad_t, op, opt);
+        if (kernel_size == 3)
+            pooling3x3s2_sse(bottom_blob, top_blob, pad_l, pad_t, op, opt);
+
+        if (avgpool_count_include_pad == 0)
+        {
+            // fix pad
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                float* outptr;
+
+                if (pad_top != 0)
+                {
+                    const float scale = (float)kernel_h / (kernel_h - pad_top);
+
+                    outptr = top_blob.channel(q).row(0);
+                    for (int i = 0; i < outw; i++)
+                    {
+                        outptr[i] *= scale;
+                    }
+                }
+                if (pad_bottom + htailpad != 0)
+                {
+                    const float scale = (float)kernel_h / (kernel_h - pad_bottom - htailpad);
+
+                    outptr = top_blob.channel(q).row(outh - 1);
+                    for (int i = 0; i < outw; i++)
+                    {
+                        outptr[i] *= scale;
+                    }
+                }
+                if (pad_left != 0)
+                {
+                    const float scale = (float)kernel_w / (kernel_w - pad_left);
+
+                    outptr = top_blob.channel(q);
+                    for (int i = 0; i < outh; i++)
+                    {
+                        *outptr *= scale;
+                        outptr += outw;
+                    }
+                }
+                if (pad_right + wtailpad != 0)
+                {
+                    const float scale = (float)kernel_w / (kernel_w - pad_right - wtailpad);
+
+                    outptr = top_blob.channel(q);
+                    outptr += outw - 1;
+                    for (int i = 0; i < outh; i++)
+                    {
+                        *outptr *= scale;
+                        outptr += outw;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+#if __AVX__
+int Pooling_x86::forward_pack8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+    int elempack = bottom_blob.elempack;
+
+    if (global_pooling)
+    {
+        top_blob.create(channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        int size = w * h;
+
+        if (pooling_type == PoolMethod_MAX)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                const float* ptr = bottom_blob.channel(q);
+
+                __m256 _max = _mm256_loadu_ps(ptr);
+                for (int i=1; i<size; i++)
+                {
+                    _max = _mm256_max_ps(_max, _mm256_loadu_ps(ptr + i * 8));
+                }
+
+                _mm256_storeu_ps((float*)top_blob + q * 8, _max);
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE)
+        {
+            const __m256 _inv_size = _mm256_set1_ps(1.f / size);
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                const float* ptr = bottom_blob.channel(q);
+
+                __m256 _sum0 = _mm256_setzero_ps();
+                __m256 _sum1 = _mm256_setzero_ps();
+                int i=0;
+                for (; i+1<size; i+=2)
+                {
+                    _sum0 = _mm256_add_ps(_sum0, _mm256_loadu_ps(ptr + i * 8));
+                    _sum1 = _mm256_add_ps(_sum1, _mm256_loadu_ps(ptr + i * 8 + 8));
+                }
+                for (; i<size; i++)
+                {
+                    _sum0 = _mm256_add_ps(_sum0, _mm256_loadu_ps(ptr + i * 8));
+                }
+
+                _mm256_storeu_ps((float*)top_blob + q * 8, _mm256_mul_ps(_mm256_add_ps(_sum0, _sum1), _inv_size));
+            }
+        }
+
+        return 0;
+    }
+
+    // resolve the padding, the kernels read the border in place
+    int wtailpad = 0;
+    int htailpad = 0;
+
+    int pad_t = 0;
+    int pad_b = 0;
+    int pad_l = 0;
+    int pad_r = 0;
+
+    if (pad_mode == 0) // full padding
+    {
+        int wtail = (w + pad_left + pad_right - kernel_w) % stride_w;
+        int htail = (h + pad_top + pad_bottom - kernel_h) % stride_h;
+
+        if (wtail != 0)
+            wtailpad = stride_w - wtail;
+        if (htail != 0)
+            htailpad = stride_h - htail;
+
+        pad_t = pad_top;
+        pad_b = pad_bottom + htailpad;
+        pad_l = pad_left;
+        pad_r = pad_right + wtailpad;
+    }
+    else if (pad_mode == 1) // valid padding
+    {
+        pad_t = pad_top;
+        pad_b = pad_bottom;
+        pad_l = pad_left;
+        pad_r = pad_right;
+    }
+    else if (pad_mode == 2 || pad_mode == 3) // tensorflow padding=SAME or onnx padding=SAME_UPPER/SAME_LOWER
+    {
+        int wpad = kernel_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_h + (h - 1) / stride_h * stride_h - h;
+
+        if (wpad > 0 || hpad > 0)
+        {
+            pad_l = pad_mode == 2 ? wpad / 2 : wpad - wpad / 2;
+            pad_r = wpad - pad_l;
+            pad_t = pad_mode == 2 ? hpad / 2 : hpad - hpad / 2;
+            pad_b = hpad - pad_t;
+        }
+    }
+
+    if (pad_l < 0 || pad_r < 0 || pad_t < 0 || pad_b < 0)
+    {
+        // negative padding crops the input, leave it to the pack1 path
+        Option opt_pack = opt;
+        opt_pack.blob_allocator = opt.workspace_allocator;
+
+        Mat bottom_blob_unpacked;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+
+        return forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
+    int outw = (w + pad_l + pad_r - kernel_w) / stride_w + 1;
+    int outh = (h + pad_t + pad_b - kernel_h) / stride_h + 1;
+
+    top_blob.create(outw, outh, channels, elemsize, elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    if (pooling_type == PoolMethod_MAX)
+    {
+        pooling_op_max op;
+
+        pooling_pack8_avx(bottom_blob, top_blob, kernel_w, kernel_h, stride_w, stride_h, pad_l, pad_t, op, opt);
+    }
+    else if (pooling_type == PoolMethod_AVE)
+    {
+        pooling_op_avg op(kernel_w * kernel_h);
+
+        pooling_pack8_avx(bottom_blob, top_blob, kernel_w, kernel_h, stride_w, stride_h, pad_l, pad_t, op, opt);
+
+        if (avgpool_count_include_pad == 0)
+        {
+            // fix pad
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                float* outptr;
+
+                if (pad_top != 0)
+                {
+                    const __m256 _scale = _mm256_set1_ps((float)kernel_h / (kernel_h - pad_top));
+
+                    outptr = top_blob.channel(q).row(0);
+                    for (int i = 0; i < outw; i++)
+                    {
+                        _mm256_storeu_ps(outptr + i * 8, _mm256_mul_ps(_mm256_loadu_ps(outptr + i * 8), _scale));
+                    }
+                }
+                if (pad_bottom + htailpad != 0)
+                {
+                    const __m256 _scale = _mm256_set1_ps((float)kernel_h / (kernel_h - pad_bottom - htailpad));
+
+                    outptr = top_blob.channel(q).row(outh - 1);
+                    for (int i = 0; i < outw; i++)
+                    {
+                        _mm256_storeu_ps(outptr + i * 8, _mm256_mul_ps(_mm256_loadu_ps(outptr + i * 8), _scale));
+                    }
+                }
+                if (pad_left != 0)
+                {
+                    const __m256 _scale = _mm256_set1_ps((float)kernel_w / (kernel_w - pad_left));
+
+                    outptr = top_blob.channel(q);
+                    for (int i = 0; i < outh; i++)
+                    {
+                        _mm256_storeu_ps(outptr, _mm256_mul_ps(_mm256_loadu_ps(outptr), _scale));
+                        outptr += outw * 8;
+                    }
+                }
+                if (pad_right + wtailpad != 0)
+                {
+                    const __m256 _scale = _mm256_set1_ps((float)kernel_w / (kernel_w - pad_right - wtailpad));
+
+                    outptr = top_blob.channel(q);
+                    outptr += (outw - 1) * 8;
+                    for (int i = 0; i < outh; i++)
+                    {
+                        _mm256_storeu_ps(outptr, _mm256_mul_ps(_mm256_loadu_ps(outptr), _scale));
+                        outptr += outw * 8;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+#endif // __AVX__
+
+} // namespace ncnn
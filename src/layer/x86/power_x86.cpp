@@ -0,0 +1,115 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "power_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+#include <math.h>
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Power_x86)
+
+Power_x86::Power_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int Power_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    int w = bottom_top_blob.w;
+    int h = bottom_top_blob.h;
+    int channels = bottom_top_blob.c;
+    int elempack = bottom_top_blob.elempack;
+    int size = w * h * elempack;
+
+    // exponents with an exact vector form, others keep the scalar pow over the packed size
+    if (power != 1.f && power != 2.f && power != 0.5f && power != -1.f)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q=0; q<channels; q++)
+        {
+            float* ptr = bottom_top_blob.channel(q);
+
+            for (int i=0; i<size; i++)
+            {
+                ptr[i] = pow((shift + ptr[i] * scale), power);
+            }
+        }
+
+        return 0;
+    }
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<channels; q++)
+    {
+        float* ptr = bottom_top_blob.channel(q);
+
+        int i=0;
+#if __AVX__
+        __m256 _scale8 = _mm256_set1_ps(scale);
+        __m256 _shift8 = _mm256_set1_ps(shift);
+        for (; i+7<size; i+=8)
+        {
+            __m256 _p = _mm256_loadu_ps(ptr);
+            _p = _mm256_fmadd_ps(_p, _scale8, _shift8);
+            if (power == 2.f)
+                _p = _mm256_mul_ps(_p, _p);
+            else if (power == 0.5f)
+                _p = _mm256_sqrt_ps(_p);
+            else if (power == -1.f)
+                _p = _mm256_div_ps(_mm256_set1_ps(1.f), _p);
+            _mm256_storeu_ps(ptr, _p);
+
+            ptr += 8;
+        }
+#endif // __AVX__
+#if __SSE2__
+        __m128 _scale = _mm_set1_ps(scale);
+        __m128 _shift = _mm_set1_ps(shift);
+        for (; i+3<size; i+=4)
+        {
+            __m128 _p = _mm_loadu_ps(ptr);
+            _p = _mm_add_ps(_mm_mul_ps(_p, _scale), _shift);
+            if (power == 2.f)
+                _p = _mm_mul_ps(_p, _p);
+            else if (power == 0.5f)
+                _p = _mm_sqrt_ps(_p);
+            else if (power == -1.f)
+                _p = _mm_div_ps(_mm_set1_ps(1.f), _p);
+            _mm_storeu_ps(ptr, _p);
+
+            ptr += 4;
+        }
+#endif // __SSE2__
+        for (; i<size; i++)
+        {
+            *ptr = pow((shift + *ptr * scale), power);
+
+            ptr++;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,233 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "prelu_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(PReLU_x86)
+
+PReLU_x86::PReLU_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+// max(x, 0) + slope * min(x, 0)
+#if __AVX__
+static inline __m256 prelu_avx(__m256 _p, __m256 _slope)
+{
+    __m256 _zero = _mm256_setzero_ps();
+    return _mm256_fmadd_ps(_slope, _mm256_min_ps(_p, _zero), _mm256_max_ps(_p, _zero));
+}
+#endif // __AVX__
+
+#if __SSE2__
+static inline __m128 prelu_sse(__m128 _p, __m128 _slope)
+{
+    __m128 _zero = _mm_setzero_ps();
+    return _mm_add_ps(_mm_max_ps(_p, _zero), _mm_mul_ps(_slope, _mm_min_ps(_p, _zero)));
+}
+#endif // __SSE2__
+
+// one slope for the whole row
+static void prelu_row(float* ptr, int size, float slope)
+{
+    int i=0;
+#if __AVX__
+    __m256 _slope8 = _mm256_set1_ps(slope);
+    for (; i+7<size; i+=8)
+    {
+        _mm256_storeu_ps(ptr, prelu_avx(_mm256_loadu_ps(ptr), _slope8));
+        ptr += 8;
+    }
+#endif // __AVX__
+#if __SSE2__
+    __m128 _slope = _mm_set1_ps(slope);
+    for (; i+3<size; i+=4)
+    {
+        _mm_storeu_ps(ptr, prelu_sse(_mm_loadu_ps(ptr), _slope));
+        ptr += 4;
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        if (*ptr < 0)
+            *ptr *= slope;
+        ptr++;
+    }
+}
+
+#if __AVX__
+// pack8 row, one slope per lane
+static void prelu_row_pack8(float* ptr, int size, __m256 _slope)
+{
+    for (int i=0; i<size; i++)
+    {
+        _mm256_storeu_ps(ptr, prelu_avx(_mm256_loadu_ps(ptr), _slope));
+        ptr += 8;
+    }
+}
+#endif // __AVX__
+
+int PReLU_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    int dims = bottom_top_blob.dims;
+
+#if __AVX__
+    int elempack = bottom_top_blob.elempack;
+
+    if (opt.use_packing_layout)
+    {
+
+    if (elempack == 8)
+    {
+        if (dims == 1)
+        {
+            int w = bottom_top_blob.w * elempack;
+
+            float* ptr = bottom_top_blob;
+
+            if (num_slope > 1)
+            {
+                const float* slope = slope_data;
+
+                for (int i=0; i<w; i+=8)
+                {
+                    _mm256_storeu_ps(ptr + i, prelu_avx(_mm256_loadu_ps(ptr + i), _mm256_loadu_ps(slope + i)));
+                }
+            }
+            else
+            {
+                prelu_row(ptr, w, slope_data[0]);
+            }
+        }
+
+        if (dims == 2)
+        {
+            int w = bottom_top_blob.w;
+            int h = bottom_top_blob.h;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i=0; i<h; i++)
+            {
+                float* ptr = bottom_top_blob.row(i);
+                __m256 _slope = num_slope > 1 ? _mm256_loadu_ps((const float*)slope_data + i * 8) : _mm256_set1_ps(slope_data[0]);
+
+                prelu_row_pack8(ptr, w, _slope);
+            }
+        }
+
+        if (dims == 3)
+        {
+            int w = bottom_top_blob.w;
+            int h = bottom_top_blob.h;
+            int channels = bottom_top_blob.c;
+            int size = w * h;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q=0; q<channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+                __m256 _slope = num_slope > 1 ? _mm256_loadu_ps((const float*)slope_data + q * 8) : _mm256_set1_ps(slope_data[0]);
+
+                prelu_row_pack8(ptr, size, _slope);
+            }
+        }
+
+        return 0;
+    }
+
+    } // opt.use_packing_layout
+#endif // __AVX__
+
+    if (dims == 1)
+    {
+        int w = bottom_top_blob.w;
+
+        float* ptr = bottom_top_blob;
+
+        if (num_slope > 1)
+        {
+            const float* slope = slope_data;
+
+            int i=0;
+#if __AVX__
+            for (; i+7<w; i+=8)
+            {
+                _mm256_storeu_ps(ptr + i, prelu_avx(_mm256_loadu_ps(ptr + i), _mm256_loadu_ps(slope + i)));
+            }
+#endif // __AVX__
+#if __SSE2__
+            for (; i+3<w; i+=4)
+            {
+                _mm_storeu_ps(ptr + i, prelu_sse(_mm_loadu_ps(ptr + i), _mm_loadu_ps(slope + i)));
+            }
+#endif // __SSE2__
+            for (; i<w; i++)
+            {
+                if (ptr[i] < 0)
+                    ptr[i] *= slope[i];
+            }
+        }
+        else
+        {
+            prelu_row(ptr, w, slope_data[0]);
+        }
+    }
+
+    if (dims == 2)
+    {
+        int w = bottom_top_blob.w;
+        int h = bottom_top_blob.h;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i=0; i<h; i++)
+        {
+            float* ptr = bottom_top_blob.row(i);
+            float slope = num_slope > 1 ? slope_data[i] : slope_data[0];
+
+            prelu_row(ptr, w, slope);
+        }
+    }
+
+    if (dims == 3)
+    {
+        int w = bottom_top_blob.w;
+        int h = bottom_top_blob.h;
+        int channels = bottom_top_blob.c;
+        int size = w * h;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q=0; q<channels; q++)
+        {
+            float* ptr = bottom_top_blob.channel(q);
+            float slope = num_slope > 1 ? slope_data[q] : slope_data[0];
+
+            prelu_row(ptr, size, slope);
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
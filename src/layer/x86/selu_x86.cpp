@@ -0,0 +1,102 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "selu_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#endif // __AVX__
+
+#include <math.h>
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(SELU_x86)
+
+SELU_x86::SELU_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int SELU_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    int w = bottom_top_blob.w;
+    int h = bottom_top_blob.h;
+    int channels = bottom_top_blob.c;
+    int elempack = bottom_top_blob.elempack;
+    int size = w * h * elempack;
+
+    float alphaxlambda = alpha * lambda;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q=0; q<channels; q++)
+    {
+        float* ptr = bottom_top_blob.channel(q);
+
+        int i=0;
+#if __AVX__
+        __m256 _zero8 = _mm256_setzero_ps();
+        __m256 _one8 = _mm256_set1_ps(1.f);
+        __m256 _alphaxlambda8 = _mm256_set1_ps(alphaxlambda);
+        __m256 _lambda8 = _mm256_set1_ps(lambda);
+        for (; i+7<size; i+=8)
+        {
+            __m256 _p = _mm256_loadu_ps(ptr);
+            __m256 _neg = _mm256_mul_ps(_mm256_sub_ps(exp256_ps(_mm256_min_ps(_p, _zero8)), _one8), _alphaxlambda8);
+            __m256 _pos = _mm256_mul_ps(_p, _lambda8);
+            _p = _mm256_blendv_ps(_pos, _neg, _mm256_cmp_ps(_p, _zero8, _CMP_LT_OQ));
+            _mm256_storeu_ps(ptr, _p);
+
+            ptr += 8;
+        }
+#endif // __AVX__
+#if __SSE2__
+        __m128 _zero = _mm_setzero_ps();
+        __m128 _one = _mm_set1_ps(1.f);
+        __m128 _alphaxlambda = _mm_set1_ps(alphaxlambda);
+        __m128 _lambda = _mm_set1_ps(lambda);
+        for (; i+3<size; i+=4)
+        {
+            __m128 _p = _mm_loadu_ps(ptr);
+            __m128 _neg = _mm_mul_ps(_mm_sub_ps(exp_ps(_mm_min_ps(_p, _zero)), _one), _alphaxlambda);
+            __m128 _pos = _mm_mul_ps(_p, _lambda);
+            __m128 _mask = _mm_cmplt_ps(_p, _zero);
+            _p = _mm_or_ps(_mm_and_ps(_mask, _neg), _mm_andnot_ps(_mask, _pos));
+            _mm_storeu_ps(ptr, _p);
+
+            ptr += 4;
+        }
+#endif // __SSE2__
+        for (; i<size; i++)
+        {
+            if (*ptr < 0.f)
+                *ptr = (exp(*ptr) - 1.f) * alphaxlambda;
+            else
+                *ptr *= lambda;
+
+            ptr++;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
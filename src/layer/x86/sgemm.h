@@ -0,0 +1,550 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// blocked sgemm, C[M x N] = A[M x K] * B[K x N] + bias[M]
+//
+// A is packed into panels of sgemm_mr rows and B into panels of sgemm_nr columns,
+// each panel stores its K slices contiguously and is zero padded at the edge.
+// The driver walks K in sgemm_kc slices so that one kc x nr B micro-panel stays in L1
+// while the mc x kc block of A is streamed from L2, threads split the M x N plane.
+
+#if __AVX__
+static const int sgemm_nr = 24;
+#elif __SSE2__
+static const int sgemm_nr = 12;
+#else
+static const int sgemm_nr = 4;
+#endif
+static const int sgemm_mr = 4;
+
+static const int sgemm_kc = 128;
+static const int sgemm_mc = 256;
+static const int sgemm_nc = 480;
+
+// a(m, k) = a[m * a_mstep + k * a_kstep]
+static void sgemm_pack_a(const float* a, int a_mstep, int a_kstep, int M, int K, Mat& a_packed, Allocator* allocator)
+{
+    const int nn = (M + sgemm_mr - 1) / sgemm_mr;
+
+    a_packed.create(sgemm_mr * K, nn, (size_t)4u, allocator);
+    if (a_packed.empty())
+        return;
+
+    for (int pp=0; pp<nn; pp++)
+    {
+        float* outptr = a_packed.row(pp);
+
+        for (int k=0; k<K; k++)
+        {
+            for (int i=0; i<sgemm_mr; i++)
+            {
+                int m = pp * sgemm_mr + i;
+                outptr[i] = m < M ? a[m * a_mstep + k * a_kstep] : 0.f;
+            }
+
+            outptr += sgemm_mr;
+        }
+    }
+}
+
+// b(k, n) = b[k * b_kstep + n * b_nstep]
+static void sgemm_pack_b(const float* b, int b_kstep, int b_nstep, int K, int N, Mat& b_packed, Allocator* allocator, const Option& opt)
+{
+    const int nn = (N + sgemm_nr - 1) / sgemm_nr;
+
+    b_packed.create(sgemm_nr * K, nn, (size_t)4u, allocator);
+    if (b_packed.empty())
+        return;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp=0; pp<nn; pp++)
+    {
+        float* outptr = b_packed.row(pp);
+
+        const int n0 = pp * sgemm_nr;
+        const int nr = std::min(sgemm_nr, N - n0);
+
+        if (nr == sgemm_nr && b_nstep == 1)
+        {
+            const float* ptr = b + n0;
+
+            for (int k=0; k<K; k++)
+            {
+#if __AVX__
+                _mm256_storeu_ps(outptr, _mm256_loadu_ps(ptr));
+                _mm256_storeu_ps(outptr + 8, _mm256_loadu_ps(ptr + 8));
+                _mm256_storeu_ps(outptr + 16, _mm256_loadu_ps(ptr + 16));
+#elif __SSE2__
+                _mm_storeu_ps(outptr, _mm_loadu_ps(ptr));
+                _mm_storeu_ps(outptr + 4, _mm_loadu_ps(ptr + 4));
+                _mm_storeu_ps(outptr + 8, _mm_loadu_ps(ptr + 8));
+#else
+                for (int j=0; j<sgemm_nr; j++)
+                {
+                    outptr[j] = ptr[j];
+                }
+#endif
+                ptr += b_kstep;
+                outptr += sgemm_nr;
+            }
+
+            continue;
+        }
+
+        for (int k=0; k<K; k++)
+        {
+            for (int j=0; j<sgemm_nr; j++)
+            {
+                outptr[j] = j < nr ? b[k * b_kstep + (n0 + j) * b_nstep] : 0.f;
+            }
+
+            outptr += sgemm_nr;
+        }
+    }
+}
+
+// one sgemm_mr x sgemm_nr tile of C over kc, c rows are ldc apart
+static void sgemm_kernel(int kc, const float* a, const float* b, const float* bias, float* c, int ldc, bool accumulate)
+{
+#if __AVX__
+    __m256 _c00, _c01, _c02, _c10, _c11, _c12, _c20, _c21, _c22, _c30, _c31, _c32;
+
+    if (accumulate)
+    {
+        _c00 = _mm256_loadu_ps(c);
+        _c01 = _mm256_loadu_ps(c + 8);
+        _c02 = _mm256_loadu_ps(c + 16);
+        _c10 = _mm256_loadu_ps(c + ldc);
+        _c11 = _mm256_loadu_ps(c + ldc + 8);
+        _c12 = _mm256_loadu_ps(c + ldc + 16);
+        _c20 = _mm256_loadu_ps(c + ldc * 2);
+        _c21 = _mm256_loadu_ps(c + ldc * 2 + 8);
+        _c22 = _mm256_loadu_ps(c + ldc * 2 + 16);
+        _c30 = _mm256_loadu_ps(c + ldc * 3);
+        _c31 = _mm256_loadu_ps(c + ldc * 3 + 8);
+        _c32 = _mm256_loadu_ps(c + ldc * 3 + 16);
+    }
+    else
+    {
+        _c00 = _mm256_set1_ps(bias ? bias[0] : 0.f);
+        _c10 = _mm256_set1_ps(bias ? bias[1] : 0.f);
+        _c20 = _mm256_set1_ps(bias ? bias[2] : 0.f);
+        _c30 = _mm256_set1_ps(bias ? bias[3] : 0.f);
+        _c01 = _c00;
+        _c02 = _c00;
+        _c11 = _c10;
+        _c12 = _c10;
+        _c21 = _c20;
+        _c22 = _c20;
+        _c31 = _c30;
+        _c32 = _c30;
+    }
+
+    for (int k=0; k<kc; k++)
+    {
+        __m256 _b0 = _mm256_loadu_ps(b);
+        __m256 _b1 = _mm256_loadu_ps(b + 8);
+        __m256 _b2 = _mm256_loadu_ps(b + 16);
+
+        __m256 _a0 = _mm256_broadcast_ss(a);
+        _c00 = _mm256_fmadd_ps(_a0, _b0, _c00);
+        _c01 = _mm256_fmadd_ps(_a0, _b1, _c01);
+        _c02 = _mm256_fmadd_ps(_a0, _b2, _c02);
+
+        __m256 _a1 = _mm256_broadcast_ss(a + 1);
+        _c10 = _mm256_fmadd_ps(_a1, _b0, _c10);
+        _c11 = _mm256_fmadd_ps(_a1, _b1, _c11);
+        _c12 = _mm256_fmadd_ps(_a1, _b2, _c12);
+
+        __m256 _a2 = _mm256_broadcast_ss(a + 2);
+        _c20 = _mm256_fmadd_ps(_a2, _b0, _c20);
+        _c21 = _mm256_fmadd_ps(_a2, _b1, _c21);
+        _c22 = _mm256_fmadd_ps(_a2, _b2, _c22);
+
+        __m256 _a3 = _mm256_broadcast_ss(a + 3);
+        _c30 = _mm256_fmadd_ps(_a3, _b0, _c30);
+        _c31 = _mm256_fmadd_ps(_a3, _b1, _c31);
+        _c32 = _mm256_fmadd_ps(_a3, _b2, _c32);
+
+        a += 4;
+        b += 24;
+    }
+
+    _mm256_storeu_ps(c, _c00);
+    _mm256_storeu_ps(c + 8, _c01);
+    _mm256_storeu_ps(c + 16, _c02);
+    _mm256_storeu_ps(c + ldc, _c10);
+    _mm256_storeu_ps(c + ldc + 8, _c11);
+    _mm256_storeu_ps(c + ldc + 16, _c12);
+    _mm256_storeu_ps(c + ldc * 2, _c20);
+    _mm256_storeu_ps(c + ldc * 2 + 8, _c21);
+    _mm256_storeu_ps(c + ldc * 2 + 16, _c22);
+    _mm256_storeu_ps(c + ldc * 3, _c30);
+    _mm256_storeu_ps(c + ldc * 3 + 8, _c31);
+    _mm256_storeu_ps(c + ldc * 3 + 16, _c32);
+#elif __SSE2__
+    __m128 _c00, _c01, _c02, _c10, _c11, _c12, _c20, _c21, _c22, _c30, _c31, _c32;
+
+    if (accumulate)
+    {
+        _c00 = _mm_loadu_ps(c);
+        _c01 = _mm_loadu_ps(c + 4);
+        _c02 = _mm_loadu_ps(c + 8);
+        _c10 = _mm_loadu_ps(c + ldc);
+        _c11 = _mm_loadu_ps(c + ldc + 4);
+        _c12 = _mm_loadu_ps(c + ldc + 8);
+        _c20 = _mm_loadu_ps(c + ldc * 2);
+        _c21 = _mm_loadu_ps(c + ldc * 2 + 4);
+        _c22 = _mm_loadu_ps(c + ldc * 2 + 8);
+        _c30 = _mm_loadu_ps(c + ldc * 3);
+        _c31 = _mm_loadu_ps(c + ldc * 3 + 4);
+        _c32 = _mm_loadu_ps(c + ldc * 3 + 8);
+    }
+    else
+    {
+        _c00 = _mm_set1_ps(bias ? bias[0] : 0.f);
+        _c10 = _mm_set1_ps(bias ? bias[1] : 0.f);
+        _c20 = _mm_set1_ps(bias ? bias[2] : 0.f);
+        _c30 = _mm_set1_ps(bias ? bias[3] : 0.f);
+        _c01 = _c00;
+        _c02 = _c00;
+        _c11 = _c10;
+        _c12 = _c10;
+        _c21 = _c20;
+        _c22 = _c20;
+        _c31 = _c30;
+        _c32 = _c30;
+    }
+
+    for (int k=0; k<kc; k++)
+    {
+        __m128 _b0 = _mm_loadu_ps(b);
+        __m128 _b1 = _mm_loadu_ps(b + 4);
+        __m128 _b2 = _mm_loadu_ps(b + 8);
+
+        __m128 _a0 = _mm_load1_ps(a);
+        _c00 = _mm_add_ps(_c00, _mm_mul_ps(_a0, _b0));
+        _c01 = _mm_add_ps(_c01, _mm_mul_ps(_a0, _b1));
+        _c02 = _mm_add_ps(_c02, _mm_mul_ps(_a0, _b2));
+
+        __m128 _a1 = _mm_load1_ps(a + 1);
+        _c10 = _mm_add_ps(_c10, _mm_mul_ps(_a1, _b0));
+        _c11 = _mm_add_ps(_c11, _mm_mul_ps(_a1, _b1));
+        _c12 = _mm_add_ps(_c12, _mm_mul_ps(_a1, _b2));
+
+        __m128 _a2 = _mm_load1_ps(a + 2);
+        _c20 = _mm_add_ps(_c20, _mm_mul_ps(_a2, _b0));
+        _c21 = _mm_add_ps(_c21, _mm_mul_ps(_a2, _b1));
+        _c22 = _mm_add_ps(_c22, _mm_mul_ps(_a2, _b2));
+
+        __m128 _a3 = _mm_load1_ps(a + 3);
+        _c30 = _mm_add_ps(_c30, _mm_mul_ps(_a3, _b0));
+        _c31 = _mm_add_ps(_c31, _mm_mul_ps(_a3, _b1));
+        _c32 = _mm_add_ps(_c32, _mm_mul_ps(_a3, _b2));
+
+        a += 4;
+        b += 12;
+    }
+
+    _mm_storeu_ps(c, _c00);
+    _mm_storeu_ps(c + 4, _c01);
+    _mm_storeu_ps(c + 8, _c02);
+    _mm_storeu_ps(c + ldc, _c10);
+    _mm_storeu_ps(c + ldc + 4, _c11);
+    _mm_storeu_ps(c + ldc + 8, _c12);
+    _mm_storeu_ps(c + ldc * 2, _c20);
+    _mm_storeu_ps(c + ldc * 2 + 4, _c21);
+    _mm_storeu_ps(c + ldc * 2 + 8, _c22);
+    _mm_storeu_ps(c + ldc * 3, _c30);
+    _mm_storeu_ps(c + ldc * 3 + 4, _c31);
+    _mm_storeu_ps(c + ldc * 3 + 8, _c32);
+#else
+    float sum[sgemm_mr * sgemm_nr];
+
+    for (int i=0; i<sgemm_mr; i++)
+    {
+        for (int j=0; j<sgemm_nr; j++)
+        {
+            sum[i * sgemm_nr + j] = accumulate ? c[i * ldc + j] : bias ? bias[i] : 0.f;
+        }
+    }
+
+    for (int k=0; k<kc; k++)
+    {
+        for (int i=0; i<sgemm_mr; i++)
+        {
+            for (int j=0; j<sgemm_nr; j++)
+            {
+                sum[i * sgemm_nr + j] += a[i] * b[j];
+            }
+        }
+
+        a += sgemm_mr;
+        b += sgemm_nr;
+    }
+
+    for (int i=0; i<sgemm_mr; i++)
+    {
+        for (int j=0; j<sgemm_nr; j++)
+        {
+            c[i * ldc + j] = sum[i * sgemm_nr + j];
+        }
+    }
+#endif // __AVX__
+}
+
+// one sgemm_mr x sgemm_nv tile at the narrow edge of a B panel
+#if __AVX__
+static const int sgemm_nv = 8;
+#elif __SSE2__
+static const int sgemm_nv = 4;
+#else
+static const int sgemm_nv = 4;
+#endif
+
+static void sgemm_kernel_narrow(int kc, const float* a, const float* b, const float* bias, float* c, int ldc, bool accumulate)
+{
+#if __AVX__
+    __m256 _c0, _c1, _c2, _c3;
+
+    if (accumulate)
+    {
+        _c0 = _mm256_loadu_ps(c);
+        _c1 = _mm256_loadu_ps(c + ldc);
+        _c2 = _mm256_loadu_ps(c + ldc * 2);
+        _c3 = _mm256_loadu_ps(c + ldc * 3);
+    }
+    else
+    {
+        _c0 = _mm256_set1_ps(bias ? bias[0] : 0.f);
+        _c1 = _mm256_set1_ps(bias ? bias[1] : 0.f);
+        _c2 = _mm256_set1_ps(bias ? bias[2] : 0.f);
+        _c3 = _mm256_set1_ps(bias ? bias[3] : 0.f);
+    }
+
+    for (int k=0; k<kc; k++)
+    {
+        __m256 _b0 = _mm256_loadu_ps(b);
+
+        _c0 = _mm256_fmadd_ps(_mm256_broadcast_ss(a), _b0, _c0);
+        _c1 = _mm256_fmadd_ps(_mm256_broadcast_ss(a + 1), _b0, _c1);
+        _c2 = _mm256_fmadd_ps(_mm256_broadcast_ss(a + 2), _b0, _c2);
+        _c3 = _mm256_fmadd_ps(_mm256_broadcast_ss(a + 3), _b0, _c3);
+
+        a += 4;
+        b += sgemm_nr;
+    }
+
+    _mm256_storeu_ps(c, _c0);
+    _mm256_storeu_ps(c + ldc, _c1);
+    _mm256_storeu_ps(c + ldc * 2, _c2);
+    _mm256_storeu_ps(c + ldc * 3, _c3);
+#elif __SSE2__
+    __m128 _c0, _c1, _c2, _c3;
+
+    if (accumulate)
+    {
+        _c0 = _mm_loadu_ps(c);
+        _c1 = _mm_loadu_ps(c + ldc);
+        _c2 = _mm_loadu_ps(c + ldc * 2);
+        _c3 = _mm_loadu_ps(c + ldc * 3);
+    }
+    else
+    {
+        _c0 = _mm_set1_ps(bias ? bias[0] : 0.f);
+        _c1 = _mm_set1_ps(bias ? bias[1] : 0.f);
+        _c2 = _mm_set1_ps(bias ? bias[2] : 0.f);
+        _c3 = _mm_set1_ps(bias ? bias[3] : 0.f);
+    }
+
+    for (int k=0; k<kc; k++)
+    {
+        __m128 _b0 = _mm_loadu_ps(b);
+
+        _c0 = _mm_add_ps(_c0, _mm_mul_ps(_mm_load1_ps(a), _b0));
+        _c1 = _mm_add_ps(_c1, _mm_mul_ps(_mm_load1_ps(a + 1), _b0));
+        _c2 = _mm_add_ps(_c2, _mm_mul_ps(_mm_load1_ps(a + 2), _b0));
+        _c3 = _mm_add_ps(_c3, _mm_mul_ps(_mm_load1_ps(a + 3), _b0));
+
+        a += 4;
+        b += sgemm_nr;
+    }
+
+    _mm_storeu_ps(c, _c0);
+    _mm_storeu_ps(c + ldc, _c1);
+    _mm_storeu_ps(c + ldc * 2, _c2);
+    _mm_storeu_ps(c + ldc * 3, _c3);
+#else
+    sgemm_kernel(kc, a, b, bias, c, ldc, accumulate);
+#endif // __AVX__
+}
+
+// mr x nr tile, edge tiles and strided output go through a local tile
+static void sgemm_tile(int kc, const float* a, const float* b, const float* bias, float* c, int c_mstep, int c_nstep, int mr, int nr, bool accumulate)
+{
+    if (mr == sgemm_mr && nr == sgemm_nr && c_nstep == 1)
+    {
+        sgemm_kernel(kc, a, b, bias, c, c_mstep, accumulate);
+        return;
+    }
+
+    float bias_tmp[sgemm_mr] = {0.f};
+    if (bias)
+    {
+        for (int i=0; i<mr; i++)
+        {
+            bias_tmp[i] = bias[i];
+        }
+    }
+
+    const float* biasptr = bias ? bias_tmp : 0;
+
+    float tmp[sgemm_mr * sgemm_nr] = {0.f};
+
+    for (int j0=0; j0<nr; j0+=sgemm_nv)
+    {
+        const int nv = std::min(sgemm_nv, nr - j0);
+
+        float* cptr = c + j0 * c_nstep;
+
+        if (mr == sgemm_mr && nv == sgemm_nv && c_nstep == 1)
+        {
+            sgemm_kernel_narrow(kc, a, b + j0, biasptr, cptr, c_mstep, accumulate);
+            continue;
+        }
+
+        if (accumulate)
+        {
+            for (int i=0; i<mr; i++)
+            {
+                for (int j=0; j<nv; j++)
+                {
+                    tmp[i * sgemm_nr + j] = cptr[i * c_mstep + j * c_nstep];
+                }
+            }
+        }
+
+        sgemm_kernel_narrow(kc, a, b + j0, biasptr, tmp, sgemm_nr, accumulate);
+
+        for (int i=0; i<mr; i++)
+        {
+            for (int j=0; j<nv; j++)
+            {
+                cptr[i * c_mstep + j * c_nstep] = tmp[i * sgemm_nr + j];
+            }
+        }
+    }
+}
+
+// split the output plane into mc x nc work blocks, at least one per thread
+static void sgemm_blocking(int M, int N, int num_threads, int& mc, int& nc, int& nn_m, int& nn_n)
+{
+    mc = std::min(sgemm_mc, (M + sgemm_mr - 1) / sgemm_mr * sgemm_mr);
+    nc = std::min(sgemm_nc, (N + sgemm_nr - 1) / sgemm_nr * sgemm_nr);
+
+    nn_m = (M + mc - 1) / mc;
+    nn_n = (N + nc - 1) / nc;
+
+    if (nn_m * nn_n < num_threads)
+    {
+        int nn_nr = (N + sgemm_nr - 1) / sgemm_nr;
+        nn_n = std::min(nn_nr, (num_threads + nn_m - 1) / nn_m);
+        nc = (nn_nr + nn_n - 1) / nn_n * sgemm_nr;
+        nn_n = (N + nc - 1) / nc;
+    }
+
+    if (nn_m * nn_n < num_threads)
+    {
+        int nn_mr = (M + sgemm_mr - 1) / sgemm_mr;
+        nn_m = std::min(nn_mr, (num_threads + nn_n - 1) / nn_n);
+        mc = (nn_mr + nn_m - 1) / nn_m * sgemm_mr;
+        nn_m = (M + mc - 1) / mc;
+    }
+}
+
+// the kc x nc block of packed B at (k0, n0), panels of sgemm_nr columns
+static void sgemm_block(int m0, int m1, int n0, int n1, int k0, int kc, const Mat& a_packed, const float* b, int b_panelstep, const float* bias, float* c, int c_mstep, int c_nstep)
+{
+    const bool accumulate = k0 > 0;
+
+    for (int n=n0; n<n1; n+=sgemm_nr)
+    {
+        const float* bptr = b + (n - n0) / sgemm_nr * b_panelstep;
+        const int nr = std::min(sgemm_nr, n1 - n);
+
+        for (int m=m0; m<m1; m+=sgemm_mr)
+        {
+            const float* aptr = (const float*)a_packed.row(m / sgemm_mr) + k0 * sgemm_mr;
+            const float* biasptr = bias ? bias + m : 0;
+            const int mr = std::min(sgemm_mr, m1 - m);
+
+            sgemm_tile(kc, aptr, bptr, biasptr, c + m * c_mstep + n * c_nstep, c_mstep, c_nstep, mr, nr, accumulate);
+        }
+    }
+}
+
+// C(m, n) = c[m * c_mstep + n * c_nstep], bias may be null
+static void sgemm(int M, int N, int K, const Mat& a_packed, const Mat& b_packed, const float* bias, float* c, int c_mstep, int c_nstep, const Option& opt)
+{
+    int mc, nc, nn_m, nn_n;
+    sgemm_blocking(M, N, opt.num_threads, mc, nc, nn_m, nn_n);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int ij=0; ij<nn_m * nn_n; ij++)
+    {
+        const int m0 = ij / nn_n * mc;
+        const int n0 = ij % nn_n * nc;
+        const int m1 = std::min(m0 + mc, M);
+        const int n1 = std::min(n0 + nc, N);
+
+        for (int k0=0; k0<K; k0+=sgemm_kc)
+        {
+            const int kc = std::min(sgemm_kc, K - k0);
+
+            const float* bptr = (const float*)b_packed.row(n0 / sgemm_nr) + k0 * sgemm_nr;
+
+            sgemm_block(m0, m1, n0, n1, k0, kc, a_packed, bptr, (int)b_packed.w, bias, c, c_mstep, c_nstep);
+        }
+    }
+}
+
+// sgemm with B produced block by block instead of prepacked,
+// pack_b(k0, kc, n0, n1, buf) writes the kc x (n1 - n0) block as sgemm_nr column panels of kc * sgemm_nr
+// so the workspace stays at one kc x nc block per thread whatever the size of B
+template<typename PackB>
+static void sgemm_implicit(int M, int N, int K, const Mat& a_packed, const PackB& pack_b, const float* bias, float* c, int c_mstep, int c_nstep, const Option& opt)
+{
+    int mc, nc, nn_m, nn_n;
+    sgemm_blocking(M, N, opt.num_threads, mc, nc, nn_m, nn_n);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int ij=0; ij<nn_m * nn_n; ij++)
+    {
+        const int m0 = ij / nn_n * mc;
+        const int n0 = ij % nn_n * nc;
+        const int m1 = std::min(m0 + mc, M);
+        const int n1 = std::min(n0 + nc, N);
+
+        Mat b_block(sgemm_kc * sgemm_nr, nc / sgemm_nr, (size_t)4u, opt.workspace_allocator);
+
+        for (int k0=0; k0<K; k0+=sgemm_kc)
+        {
+            const int kc = std::min(sgemm_kc, K - k0);
+
+            pack_b(k0, kc, n0, n1, (float*)b_block);
+
+            sgemm_block(m0, m1, n0, n1, k0, kc, a_packed, b_block, kc * sgemm_nr, bias, c, c_mstep, c_nstep);
+        }
+    }
+}
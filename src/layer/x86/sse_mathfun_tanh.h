@@ -0,0 +1,61 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// tanh sse vector version
+// refer the scalar version from Cephes Math Library
+
+#define c_cephes_HALFMAXLOGF 44.014845935754205f
+#define c_cephes_tanh_C1 0.625f
+
+#define c_cephes_tanh_p0 - 5.70498872745E-3
+#define c_cephes_tanh_p1 + 2.06390887954E-2
+#define c_cephes_tanh_p2 - 5.37397155531E-2
+#define c_cephes_tanh_p3 + 1.33314422036E-1
+#define c_cephes_tanh_p4 - 3.33332819422E-1
+
+/* Single precision hyperbolic tangent computed for 4 simultaneous float */
+static inline v4sf tanh_ps(v4sf x)
+{
+    v4sf sign = _mm_and_ps(x, _mm_set1_ps(-0.f));
+    v4sf x2 = _mm_andnot_ps(_mm_set1_ps(-0.f), x);
+
+    v4sf mask_l = _mm_cmpge_ps(x2, _mm_set1_ps(c_cephes_tanh_C1));
+    v4sf mask_l2 = _mm_cmpgt_ps(x2, _mm_set1_ps(c_cephes_HALFMAXLOGF));
+
+    // abs(x) >= 0.625
+    // tanh(x) = (exp(2x) - 1) / (exp(2x) + 1)
+    v4sf one = _mm_set1_ps(1.f);
+    v4sf exp_x_x = exp_ps(_mm_add_ps(x, x));
+    v4sf y0 = _mm_div_ps(_mm_sub_ps(exp_x_x, one), _mm_add_ps(exp_x_x, one));
+
+    // abs(x) < 0.625
+    v4sf z = _mm_mul_ps(x, x);
+
+    v4sf y = _mm_set1_ps(c_cephes_tanh_p0);
+    y = _mm_add_ps(_mm_mul_ps(y, z), _mm_set1_ps(c_cephes_tanh_p1));
+    y = _mm_add_ps(_mm_mul_ps(y, z), _mm_set1_ps(c_cephes_tanh_p2));
+    y = _mm_add_ps(_mm_mul_ps(y, z), _mm_set1_ps(c_cephes_tanh_p3));
+    y = _mm_add_ps(_mm_mul_ps(y, z), _mm_set1_ps(c_cephes_tanh_p4));
+
+    y = _mm_mul_ps(y, z);
+    y = _mm_add_ps(_mm_mul_ps(y, x), x);
+
+    // abs(x) > HALFMAXLOGF
+    // return 1.0 or -1.0
+    v4sf y1 = _mm_or_ps(one, sign);
+
+    y = _mm_or_ps(_mm_and_ps(mask_l, y0), _mm_andnot_ps(mask_l, y));
+    y = _mm_or_ps(_mm_and_ps(mask_l2, y1), _mm_andnot_ps(mask_l2, y));
+    return y;
+}
@@ -54,15 +54,18 @@ DEFINE_LAYER_CREATOR(Bias_final)
 } // namespace ncnn
 
 #include "layer/bnll.h"
+#include "layer/x86/bnll_x86.h"
 namespace ncnn {
-class BNLL_final : virtual public BNLL
+class BNLL_final : virtual public BNLL, virtual public BNLL_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = BNLL::create_pipeline(opt); if (ret) return ret; }
+        { int ret = BNLL_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = BNLL_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = BNLL::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -70,6 +73,27 @@ public:
 DEFINE_LAYER_CREATOR(BNLL_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/bnll_x86_avx2.h"
+namespace ncnn {
+class BNLL_final_avx2 : virtual public BNLL, virtual public avx2::BNLL_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = BNLL::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::BNLL_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::BNLL_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = BNLL::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(BNLL_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/concat.h"
 namespace ncnn {
 class Concat_final : virtual public Concat
@@ -107,6 +131,27 @@ public:
 DEFINE_LAYER_CREATOR(Convolution_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/convolution_x86_avx2.h"
+namespace ncnn {
+class Convolution_final_avx2 : virtual public Convolution, virtual public avx2::Convolution_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Convolution::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Convolution_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Convolution_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Convolution::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Convolution_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/crop.h"
 namespace ncnn {
 class Crop_final : virtual public Crop
@@ -125,15 +170,18 @@ DEFINE_LAYER_CREATOR(Crop_final)
 } // namespace ncnn
 
 #include "layer/deconvolution.h"
+#include "layer/x86/deconvolution_x86.h"
 namespace ncnn {
-class Deconvolution_final : virtual public Deconvolution
+class Deconvolution_final : virtual public Deconvolution, virtual public Deconvolution_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Deconvolution::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Deconvolution_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Deconvolution_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Deconvolution::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -141,6 +189,27 @@ public:
 DEFINE_LAYER_CREATOR(Deconvolution_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/deconvolution_x86_avx2.h"
+namespace ncnn {
+class Deconvolution_final_avx2 : virtual public Deconvolution, virtual public avx2::Deconvolution_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Deconvolution::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Deconvolution_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Deconvolution_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Deconvolution::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Deconvolution_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/dropout.h"
 namespace ncnn {
 class Dropout_final : virtual public Dropout
@@ -159,15 +228,18 @@ DEFINE_LAYER_CREATOR(Dropout_final)
 } // namespace ncnn
 
 #include "layer/eltwise.h"
+#include "layer/x86/eltwise_x86.h"
 namespace ncnn {
-class Eltwise_final : virtual public Eltwise
+class Eltwise_final : virtual public Eltwise, virtual public Eltwise_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Eltwise::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Eltwise_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Eltwise_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Eltwise::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -175,16 +247,40 @@ public:
 DEFINE_LAYER_CREATOR(Eltwise_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/eltwise_x86_avx2.h"
+namespace ncnn {
+class Eltwise_final_avx2 : virtual public Eltwise, virtual public avx2::Eltwise_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Eltwise::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Eltwise_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Eltwise_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Eltwise::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Eltwise_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/elu.h"
+#include "layer/x86/elu_x86.h"
 namespace ncnn {
-class ELU_final : virtual public ELU
+class ELU_final : virtual public ELU, virtual public ELU_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = ELU::create_pipeline(opt); if (ret) return ret; }
+        { int ret = ELU_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = ELU_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = ELU::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -192,6 +288,27 @@ public:
 DEFINE_LAYER_CREATOR(ELU_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/elu_x86_avx2.h"
+namespace ncnn {
+class ELU_final_avx2 : virtual public ELU, virtual public avx2::ELU_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = ELU::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::ELU_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::ELU_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = ELU::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(ELU_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/embed.h"
 namespace ncnn {
 class Embed_final : virtual public Embed
@@ -210,15 +327,18 @@ DEFINE_LAYER_CREATOR(Embed_final)
 } // namespace ncnn
 
 #include "layer/exp.h"
+#include "layer/x86/exp_x86.h"
 namespace ncnn {
-class Exp_final : virtual public Exp
+class Exp_final : virtual public Exp, virtual public Exp_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Exp::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Exp_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Exp_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Exp::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -226,6 +346,27 @@ public:
 DEFINE_LAYER_CREATOR(Exp_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/exp_x86_avx2.h"
+namespace ncnn {
+class Exp_final_avx2 : virtual public Exp, virtual public avx2::Exp_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Exp::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Exp_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Exp_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Exp::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Exp_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/flatten.h"
 namespace ncnn {
 class Flatten_final : virtual public Flatten
@@ -244,15 +385,18 @@ DEFINE_LAYER_CREATOR(Flatten_final)
 } // namespace ncnn
 
 #include "layer/innerproduct.h"
+#include "layer/x86/innerproduct_x86.h"
 namespace ncnn {
-class InnerProduct_final : virtual public InnerProduct
+class InnerProduct_final : virtual public InnerProduct, virtual public InnerProduct_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = InnerProduct::create_pipeline(opt); if (ret) return ret; }
+        { int ret = InnerProduct_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = InnerProduct_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = InnerProduct::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -260,6 +404,27 @@ public:
 DEFINE_LAYER_CREATOR(InnerProduct_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/innerproduct_x86_avx2.h"
+namespace ncnn {
+class InnerProduct_final_avx2 : virtual public InnerProduct, virtual public avx2::InnerProduct_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = InnerProduct::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::InnerProduct_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::InnerProduct_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = InnerProduct::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(InnerProduct_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/input.h"
 namespace ncnn {
 class Input_final : virtual public Input
@@ -278,15 +443,18 @@ DEFINE_LAYER_CREATOR(Input_final)
 } // namespace ncnn
 
 #include "layer/log.h"
+#include "layer/x86/log_x86.h"
 namespace ncnn {
-class Log_final : virtual public Log
+class Log_final : virtual public Log, virtual public Log_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Log::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Log_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Log_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Log::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -294,6 +462,27 @@ public:
 DEFINE_LAYER_CREATOR(Log_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/log_x86_avx2.h"
+namespace ncnn {
+class Log_final_avx2 : virtual public Log, virtual public avx2::Log_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Log::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Log_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Log_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Log::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Log_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/lrn.h"
 namespace ncnn {
 class LRN_final : virtual public LRN
@@ -346,15 +535,18 @@ DEFINE_LAYER_CREATOR(MVN_final)
 } // namespace ncnn
 
 #include "layer/pooling.h"
+#include "layer/x86/pooling_x86.h"
 namespace ncnn {
-class Pooling_final : virtual public Pooling
+class Pooling_final : virtual public Pooling, virtual public Pooling_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Pooling::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Pooling_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Pooling_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Pooling::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -362,16 +554,40 @@ public:
 DEFINE_LAYER_CREATOR(Pooling_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/pooling_x86_avx2.h"
+namespace ncnn {
+class Pooling_final_avx2 : virtual public Pooling, virtual public avx2::Pooling_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Pooling::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Pooling_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Pooling_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Pooling::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Pooling_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/power.h"
+#include "layer/x86/power_x86.h"
 namespace ncnn {
-class Power_final : virtual public Power
+class Power_final : virtual public Power, virtual public Power_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Power::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Power_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Power_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Power::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -379,16 +595,40 @@ public:
 DEFINE_LAYER_CREATOR(Power_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/power_x86_avx2.h"
+namespace ncnn {
+class Power_final_avx2 : virtual public Power, virtual public avx2::Power_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Power::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Power_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Power_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Power::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Power_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/prelu.h"
+#include "layer/x86/prelu_x86.h"
 namespace ncnn {
-class PReLU_final : virtual public PReLU
+class PReLU_final : virtual public PReLU, virtual public PReLU_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = PReLU::create_pipeline(opt); if (ret) return ret; }
+        { int ret = PReLU_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = PReLU_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = PReLU::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -396,6 +636,27 @@ public:
 DEFINE_LAYER_CREATOR(PReLU_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/prelu_x86_avx2.h"
+namespace ncnn {
+class PReLU_final_avx2 : virtual public PReLU, virtual public avx2::PReLU_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = PReLU::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::PReLU_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::PReLU_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = PReLU::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(PReLU_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/proposal.h"
 namespace ncnn {
 class Proposal_final : virtual public Proposal
@@ -431,15 +692,18 @@ DEFINE_LAYER_CREATOR(Reduction_final)
 } // namespace ncnn
 
 #include "layer/relu.h"
+#include "layer/x86/relu_x86.h"
 namespace ncnn {
-class ReLU_final : virtual public ReLU
+class ReLU_final : virtual public ReLU, virtual public ReLU_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = ReLU::create_pipeline(opt); if (ret) return ret; }
+        { int ret = ReLU_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = ReLU_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = ReLU::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -447,6 +711,27 @@ public:
 DEFINE_LAYER_CREATOR(ReLU_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/relu_x86_avx2.h"
+namespace ncnn {
+class ReLU_final_avx2 : virtual public ReLU, virtual public avx2::ReLU_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = ReLU::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::ReLU_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::ReLU_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = ReLU::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(ReLU_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/reshape.h"
 namespace ncnn {
 class Reshape_final : virtual public Reshape
@@ -499,15 +784,18 @@ DEFINE_LAYER_CREATOR(Scale_final)
 } // namespace ncnn
 
 #include "layer/sigmoid.h"
+#include "layer/x86/sigmoid_x86.h"
 namespace ncnn {
-class Sigmoid_final : virtual public Sigmoid
+class Sigmoid_final : virtual public Sigmoid, virtual public Sigmoid_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Sigmoid::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Sigmoid_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Sigmoid_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Sigmoid::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -515,6 +803,27 @@ public:
 DEFINE_LAYER_CREATOR(Sigmoid_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/sigmoid_x86_avx2.h"
+namespace ncnn {
+class Sigmoid_final_avx2 : virtual public Sigmoid, virtual public avx2::Sigmoid_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Sigmoid::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Sigmoid_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Sigmoid_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Sigmoid::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Sigmoid_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/slice.h"
 namespace ncnn {
 class Slice_final : virtual public Slice
@@ -567,15 +876,18 @@ DEFINE_LAYER_CREATOR(Split_final)
 } // namespace ncnn
 
 #include "layer/tanh.h"
+#include "layer/x86/tanh_x86.h"
 namespace ncnn {
-class TanH_final : virtual public TanH
+class TanH_final : virtual public TanH, virtual public TanH_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = TanH::create_pipeline(opt); if (ret) return ret; }
+        { int ret = TanH_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = TanH_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = TanH::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -583,6 +895,27 @@ public:
 DEFINE_LAYER_CREATOR(TanH_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/tanh_x86_avx2.h"
+namespace ncnn {
+class TanH_final_avx2 : virtual public TanH, virtual public avx2::TanH_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = TanH::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::TanH_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::TanH_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = TanH::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(TanH_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/threshold.h"
 namespace ncnn {
 class Threshold_final : virtual public Threshold
@@ -601,15 +934,18 @@ DEFINE_LAYER_CREATOR(Threshold_final)
 } // namespace ncnn
 
 #include "layer/binaryop.h"
+#include "layer/x86/binaryop_x86.h"
 namespace ncnn {
-class BinaryOp_final : virtual public BinaryOp
+class BinaryOp_final : virtual public BinaryOp, virtual public BinaryOp_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = BinaryOp::create_pipeline(opt); if (ret) return ret; }
+        { int ret = BinaryOp_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = BinaryOp_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = BinaryOp::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -617,6 +953,27 @@ public:
 DEFINE_LAYER_CREATOR(BinaryOp_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/binaryop_x86_avx2.h"
+namespace ncnn {
+class BinaryOp_final_avx2 : virtual public BinaryOp, virtual public avx2::BinaryOp_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = BinaryOp::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::BinaryOp_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::BinaryOp_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = BinaryOp::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(BinaryOp_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/unaryop.h"
 namespace ncnn {
 class UnaryOp_final : virtual public UnaryOp
@@ -654,16 +1011,40 @@ public:
 DEFINE_LAYER_CREATOR(ConvolutionDepthWise_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/convolutiondepthwise_x86_avx2.h"
+namespace ncnn {
+class ConvolutionDepthWise_final_avx2 : virtual public ConvolutionDepthWise, virtual public avx2::ConvolutionDepthWise_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = ConvolutionDepthWise::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::ConvolutionDepthWise_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::ConvolutionDepthWise_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = ConvolutionDepthWise::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(ConvolutionDepthWise_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/padding.h"
+#include "layer/x86/padding_x86.h"
 namespace ncnn {
-class Padding_final : virtual public Padding
+class Padding_final : virtual public Padding, virtual public Padding_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Padding::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Padding_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Padding_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Padding::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -671,6 +1052,27 @@ public:
 DEFINE_LAYER_CREATOR(Padding_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/padding_x86_avx2.h"
+namespace ncnn {
+class Padding_final_avx2 : virtual public Padding, virtual public avx2::Padding_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Padding::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Padding_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Padding_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Padding::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Padding_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/squeeze.h"
 namespace ncnn {
 class Squeeze_final : virtual public Squeeze
@@ -791,15 +1193,18 @@ DEFINE_LAYER_CREATOR(Interp_final)
 } // namespace ncnn
 
 #include "layer/deconvolutiondepthwise.h"
+#include "layer/x86/deconvolutiondepthwise_x86.h"
 namespace ncnn {
-class DeconvolutionDepthWise_final : virtual public DeconvolutionDepthWise
+class DeconvolutionDepthWise_final : virtual public DeconvolutionDepthWise, virtual public DeconvolutionDepthWise_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = DeconvolutionDepthWise::create_pipeline(opt); if (ret) return ret; }
+        { int ret = DeconvolutionDepthWise_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = DeconvolutionDepthWise_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = DeconvolutionDepthWise::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -807,6 +1212,27 @@ public:
 DEFINE_LAYER_CREATOR(DeconvolutionDepthWise_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/deconvolutiondepthwise_x86_avx2.h"
+namespace ncnn {
+class DeconvolutionDepthWise_final_avx2 : virtual public DeconvolutionDepthWise, virtual public avx2::DeconvolutionDepthWise_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = DeconvolutionDepthWise::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::DeconvolutionDepthWise_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::DeconvolutionDepthWise_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = DeconvolutionDepthWise::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(DeconvolutionDepthWise_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/shufflechannel.h"
 namespace ncnn {
 class ShuffleChannel_final : virtual public ShuffleChannel
@@ -842,15 +1268,18 @@ DEFINE_LAYER_CREATOR(InstanceNorm_final)
 } // namespace ncnn
 
 #include "layer/clip.h"
+#include "layer/x86/clip_x86.h"
 namespace ncnn {
-class Clip_final : virtual public Clip
+class Clip_final : virtual public Clip, virtual public Clip_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Clip::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Clip_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Clip_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Clip::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -858,6 +1287,27 @@ public:
 DEFINE_LAYER_CREATOR(Clip_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/clip_x86_avx2.h"
+namespace ncnn {
+class Clip_final_avx2 : virtual public Clip, virtual public avx2::Clip_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Clip::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Clip_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Clip_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Clip::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Clip_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/reorg.h"
 namespace ncnn {
 class Reorg_final : virtual public Reorg
@@ -961,15 +1411,18 @@ DEFINE_LAYER_CREATOR(PSROIPooling_final)
 } // namespace ncnn
 
 #include "layer/packing.h"
+#include "layer/x86/packing_x86.h"
 namespace ncnn {
-class Packing_final : virtual public Packing
+class Packing_final : virtual public Packing, virtual public Packing_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = Packing::create_pipeline(opt); if (ret) return ret; }
+        { int ret = Packing_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = Packing_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = Packing::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -977,6 +1430,27 @@ public:
 DEFINE_LAYER_CREATOR(Packing_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/packing_x86_avx2.h"
+namespace ncnn {
+class Packing_final_avx2 : virtual public Packing, virtual public avx2::Packing_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = Packing::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::Packing_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::Packing_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = Packing::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(Packing_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/requantize.h"
 namespace ncnn {
 class Requantize_final : virtual public Requantize
@@ -1012,15 +1486,18 @@ DEFINE_LAYER_CREATOR(Cast_final)
 } // namespace ncnn
 
 #include "layer/hardsigmoid.h"
+#include "layer/x86/hardsigmoid_x86.h"
 namespace ncnn {
-class HardSigmoid_final : virtual public HardSigmoid
+class HardSigmoid_final : virtual public HardSigmoid, virtual public HardSigmoid_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = HardSigmoid::create_pipeline(opt); if (ret) return ret; }
+        { int ret = HardSigmoid_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = HardSigmoid_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = HardSigmoid::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -1028,16 +1505,40 @@ public:
 DEFINE_LAYER_CREATOR(HardSigmoid_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/hardsigmoid_x86_avx2.h"
+namespace ncnn {
+class HardSigmoid_final_avx2 : virtual public HardSigmoid, virtual public avx2::HardSigmoid_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = HardSigmoid::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::HardSigmoid_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::HardSigmoid_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = HardSigmoid::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(HardSigmoid_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/selu.h"
+#include "layer/x86/selu_x86.h"
 namespace ncnn {
-class SELU_final : virtual public SELU
+class SELU_final : virtual public SELU, virtual public SELU_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = SELU::create_pipeline(opt); if (ret) return ret; }
+        { int ret = SELU_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = SELU_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = SELU::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -1045,16 +1546,40 @@ public:
 DEFINE_LAYER_CREATOR(SELU_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/selu_x86_avx2.h"
+namespace ncnn {
+class SELU_final_avx2 : virtual public SELU, virtual public avx2::SELU_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = SELU::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::SELU_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::SELU_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = SELU::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(SELU_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 #include "layer/hardswish.h"
+#include "layer/x86/hardswish_x86.h"
 namespace ncnn {
-class HardSwish_final : virtual public HardSwish
+class HardSwish_final : virtual public HardSwish, virtual public HardSwish_x86
 {
 public:
     virtual int create_pipeline(const Option& opt) {
         { int ret = HardSwish::create_pipeline(opt); if (ret) return ret; }
+        { int ret = HardSwish_x86::create_pipeline(opt); if (ret) return ret; }
         return 0;
     }
     virtual int destroy_pipeline(const Option& opt) {
+        { int ret = HardSwish_x86::destroy_pipeline(opt); if (ret) return ret; }
         { int ret = HardSwish::destroy_pipeline(opt); if (ret) return ret; }
         return 0;
     }
@@ -1062,4 +1587,25 @@ public:
 DEFINE_LAYER_CREATOR(HardSwish_final)
 } // namespace ncnn
 
+#if NCNN_RUNTIME_CPU
+#include "layer/x86/hardswish_x86_avx2.h"
+namespace ncnn {
+class HardSwish_final_avx2 : virtual public HardSwish, virtual public avx2::HardSwish_x86
+{
+public:
+    virtual int create_pipeline(const Option& opt) {
+        { int ret = HardSwish::create_pipeline(opt); if (ret) return ret; }
+        { int ret = avx2::HardSwish_x86::create_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+    virtual int destroy_pipeline(const Option& opt) {
+        { int ret = avx2::HardSwish_x86::destroy_pipeline(opt); if (ret) return ret; }
+        { int ret = HardSwish::destroy_pipeline(opt); if (ret) return ret; }
+        return 0;
+    }
+};
+DEFINE_LAYER_CREATOR(HardSwish_final_avx2)
+} // namespace ncnn
+#endif // NCNN_RUNTIME_CPU
+
 
@@ -17,7 +17,15 @@
 #if __ARM_NEON
 #include <arm_neon.h>
 #endif // __ARM_NEON
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
 #include <math.h>
+#include <algorithm>
+#include <vector>
 
 #include "cpu.h"
 
@@ -26,6 +34,8 @@
 
 namespace ncnn {
 
+#include "mat_resize_area.h"
+
 void Mat::substract_mean_normalize(const float* mean_vals, const float* norm_vals)
 {
     ncnn::Layer* op;
@@ -274,6 +284,304 @@ void resize_bilinear(const Mat& src, Mat& dst, int w, int h, const Option& opt)
     delete interp;
 }
 
+// the linear_coeffs of Interp for a crop of w pixels starting at x0, scale is w / outw for a plain resize
+// the two taps are kept apart so that a crop of one pixel never reads past it
+static void crop_resize_linear_coeffs(int x0, int w, int outw, double scale, int* xofs0, int* xofs1, float* alpha0, float* alpha1)
+{
+    for (int dx = 0; dx < outw; dx++)
+    {
+        float fx = (float)((dx + 0.5) * scale - 0.5);
+        int sx = floor(fx);
+        fx -= sx;
+
+        if (sx < 0)
+        {
+            sx = 0;
+            fx = 0.f;
+        }
+        if (sx >= w - 1)
+        {
+            sx = std::max(w - 2, 0);
+            fx = w == 1 ? 0.f : 1.f;
+        }
+
+        xofs0[dx] = x0 + sx;
+        xofs1[dx] = x0 + std::min(sx + 1, w - 1);
+
+        alpha0[dx] = 1.f - fx;
+        alpha1[dx] = fx;
+    }
+}
+
+// rows[dx] = S[xofs0[dx]] * alpha0[dx] + S[xofs1[dx]] * alpha1[dx]
+static void crop_resize_hresize(const float* S, float* rows, const int* xofs0, const int* xofs1, const float* alpha0, const float* alpha1, int w)
+{
+    int dx = 0;
+#if __SSE2__
+    for (; dx+3<w; dx+=4)
+    {
+        __m128 _S0 = _mm_setr_ps(S[xofs0[dx]], S[xofs0[dx + 1]], S[xofs0[dx + 2]], S[xofs0[dx + 3]]);
+        __m128 _S1 = _mm_setr_ps(S[xofs1[dx]], S[xofs1[dx + 1]], S[xofs1[dx + 2]], S[xofs1[dx + 3]]);
+        __m128 _rows = _mm_add_ps(_mm_mul_ps(_S0, _mm_loadu_ps(alpha0 + dx)), _mm_mul_ps(_S1, _mm_loadu_ps(alpha1 + dx)));
+        _mm_storeu_ps(rows + dx, _rows);
+    }
+#endif // __SSE2__
+    for (; dx<w; dx++)
+    {
+        rows[dx] = S[xofs0[dx]] * alpha0[dx] + S[xofs1[dx]] * alpha1[dx];
+    }
+}
+
+// crop and resize one channel, the same row caching as Interp
+static void crop_resize_image(const Mat& src, Mat& dst, const int* xofs0, const int* xofs1, const float* alpha0, const float* alpha1,
+                              const int* yofs0, const int* yofs1, const float* beta0, const float* beta1)
+{
+    int w = dst.w;
+    int h = dst.h;
+
+    Mat rowsbuf0(w);
+    Mat rowsbuf1(w);
+    float* rows0 = rowsbuf0;
+    float* rows1 = rowsbuf1;
+
+    int prev_sy0 = -1;
+    int prev_sy1 = -1;
+
+    for (int dy = 0; dy < h; dy++)
+    {
+        int sy0 = yofs0[dy];
+        int sy1 = yofs1[dy];
+
+        if (sy0 == prev_sy0 && sy1 == prev_sy1)
+        {
+            // reuse all rows
+        }
+        else if (sy0 == prev_sy1)
+        {
+            std::swap(rows0, rows1);
+            crop_resize_hresize(src.row(sy1), rows1, xofs0, xofs1, alpha0, alpha1, w);
+        }
+        else
+        {
+            crop_resize_hresize(src.row(sy0), rows0, xofs0, xofs1, alpha0, alpha1, w);
+            crop_resize_hresize(src.row(sy1), rows1, xofs0, xofs1, alpha0, alpha1, w);
+        }
+
+        prev_sy0 = sy0;
+        prev_sy1 = sy1;
+
+        float b0 = beta0[dy];
+        float b1 = beta1[dy];
+
+        float* Dp = dst.row(dy);
+        int dx = 0;
+#if __SSE2__
+        __m128 _b0 = _mm_set1_ps(b0);
+        __m128 _b1 = _mm_set1_ps(b1);
+        for (; dx+3<w; dx+=4)
+        {
+            __m128 _D = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(rows0 + dx), _b0), _mm_mul_ps(_mm_loadu_ps(rows1 + dx), _b1));
+            _mm_storeu_ps(Dp + dx, _D);
+        }
+#endif // __SSE2__
+        for (; dx<w; dx++)
+        {
+            Dp[dx] = rows0[dx] * b0 + rows1[dx] * b1;
+        }
+    }
+}
+
+void crop_resize_rois(const Mat& src, const int* rois, int num_roi, Mat& dst, int w, int h, const Option& opt)
+{
+    int channels = src.c;
+
+    dst.create(w, h, channels * num_roi, (size_t)4u, opt.blob_allocator);
+    if (dst.empty())
+        return;
+
+    // coefficients of every roi, rois are clipped to the image
+    std::vector<int> ofs(num_roi * (w + h) * 2);
+    std::vector<float> coeffs(num_roi * (w + h) * 2);
+    std::vector<char> empty_roi(num_roi);
+
+    for (int i = 0; i < num_roi; i++)
+    {
+        const int x0 = std::max(rois[i * 4], 0);
+        const int y0 = std::max(rois[i * 4 + 1], 0);
+        const int x1 = std::min(rois[i * 4] + rois[i * 4 + 2], src.w);
+        const int y1 = std::min(rois[i * 4 + 1] + rois[i * 4 + 3], src.h);
+
+        empty_roi[i] = x1 <= x0 || y1 <= y0;
+        if (empty_roi[i])
+            continue;
+
+        int* xofs = &ofs[i * (w + h) * 2];
+        int* yofs = xofs + w * 2;
+        float* alpha = &coeffs[i * (w + h) * 2];
+        float* beta = alpha + w * 2;
+
+        crop_resize_linear_coeffs(x0, x1 - x0, w, (double)(x1 - x0) / w, xofs, xofs + w, alpha, alpha + w);
+        crop_resize_linear_coeffs(y0, y1 - y0, h, (double)(y1 - y0) / h, yofs, yofs + h, beta, beta + h);
+    }
+
+    // one task per channel of every roi
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int t = 0; t < num_roi * channels; t++)
+    {
+        const int i = t / channels;
+        const int q = t % channels;
+
+        Mat m = dst.channel(t);
+
+        if (empty_roi[i])
+        {
+            m.fill(0.f);
+            continue;
+        }
+
+        const int* xofs = &ofs[i * (w + h) * 2];
+        const int* yofs = xofs + w * 2;
+        const float* alpha = &coeffs[i * (w + h) * 2];
+        const float* beta = alpha + w * 2;
+
+        crop_resize_image(src.channel(q), m, xofs, xofs + w, alpha, alpha + w, yofs, yofs + h, beta, beta + h);
+    }
+}
+
+// average every 2x2 block of one channel, an odd last row or column is averaged on its own
+static void pyramid_downsample2x(const Mat& src, Mat& dst)
+{
+    int w = src.w / 2;
+    int h = dst.h;
+
+    for (int y = 0; y < h; y++)
+    {
+        const float* r0 = src.row(y * 2);
+        const float* r1 = y * 2 + 1 < src.h ? src.row(y * 2 + 1) : r0;
+        float* outptr = dst.row(y);
+
+        int x = 0;
+#if __SSE2__
+        __m128 _quarter = _mm_set1_ps(0.25f);
+        for (; x+3<w; x+=4)
+        {
+            __m128 _a = _mm_add_ps(_mm_loadu_ps(r0), _mm_loadu_ps(r1));
+            __m128 _b = _mm_add_ps(_mm_loadu_ps(r0 + 4), _mm_loadu_ps(r1 + 4));
+            __m128 _even = _mm_shuffle_ps(_a, _b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 _odd = _mm_shuffle_ps(_a, _b, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(outptr, _mm_mul_ps(_mm_add_ps(_even, _odd), _quarter));
+
+            r0 += 8;
+            r1 += 8;
+            outptr += 4;
+        }
+#endif // __SSE2__
+        for (; x<w; x++)
+        {
+            *outptr = (r0[0] + r0[1] + r1[0] + r1[1]) * 0.25f;
+
+            r0 += 2;
+            r1 += 2;
+            outptr++;
+        }
+        if (dst.w > w)
+        {
+            *outptr = (r0[0] + r1[0]) * 0.5f;
+        }
+    }
+}
+
+void resize_pyramid(const Mat& src, Mat* levels, const int* sizes, int num_level, const Option& opt)
+{
+    int channels = src.c;
+
+    // halve the image while the half still covers the smallest level
+    int min_w = src.w;
+    int min_h = src.h;
+    for (int i = 0; i < num_level; i++)
+    {
+        min_w = std::min(min_w, sizes[i * 2]);
+        min_h = std::min(min_h, sizes[i * 2 + 1]);
+    }
+
+    std::vector<Mat> octaves(1, src);
+    while ((octaves.back().w + 1) / 2 >= min_w && (octaves.back().h + 1) / 2 >= min_h && octaves.back().w > 1 && octaves.back().h > 1)
+    {
+        const Mat& prev = octaves.back();
+
+        Mat m((prev.w + 1) / 2, (prev.h + 1) / 2, channels, (size_t)4u, opt.workspace_allocator);
+        if (m.empty())
+            break;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            Mat m_q = m.channel(q);
+            pyramid_downsample2x(prev.channel(q), m_q);
+        }
+
+        octaves.push_back(m);
+    }
+
+    // every level is a bilinear step of less than 2x from the smallest octave covering it
+    std::vector<int> level_octave(num_level);
+    std::vector<int> ofs;
+    std::vector<float> coeffs;
+    std::vector<int> coeffs_offset(num_level);
+
+    for (int i = 0; i < num_level; i++)
+    {
+        const int w = sizes[i * 2];
+        const int h = sizes[i * 2 + 1];
+
+        int k = 0;
+        while (k + 1 < (int)octaves.size() && octaves[k + 1].w >= w && octaves[k + 1].h >= h)
+            k++;
+
+        level_octave[i] = k;
+        coeffs_offset[i] = (int)ofs.size();
+
+        ofs.resize(ofs.size() + (w + h) * 2);
+        coeffs.resize(coeffs.size() + (w + h) * 2);
+
+        int* xofs = &ofs[coeffs_offset[i]];
+        int* yofs = xofs + w * 2;
+        float* alpha = &coeffs[coeffs_offset[i]];
+        float* beta = alpha + w * 2;
+
+        // octave k pixel covers (1 << k) source pixels, map through the source size
+        // so that the odd rows and columns rounded up along the way do not stretch the level
+        crop_resize_linear_coeffs(0, octaves[k].w, w, (double)src.w / w / (1 << k), xofs, xofs + w, alpha, alpha + w);
+        crop_resize_linear_coeffs(0, octaves[k].h, h, (double)src.h / h / (1 << k), yofs, yofs + h, beta, beta + h);
+
+        levels[i].create(w, h, channels, (size_t)4u, opt.blob_allocator);
+    }
+
+    for (int i = 0; i < num_level; i++)
+    {
+        if (levels[i].empty())
+            return;
+    }
+
+    // one task per channel of every level
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int t = 0; t < num_level * channels; t++)
+    {
+        const int i = t / channels;
+        const int q = t % channels;
+        const int w = sizes[i * 2];
+        const int h = sizes[i * 2 + 1];
+
+        const int* xofs = &ofs[coeffs_offset[i]];
+        const int* yofs = xofs + w * 2;
+        const float* alpha = &coeffs[coeffs_offset[i]];
+        const float* beta = alpha + w * 2;
+
+        Mat m = levels[i].channel(q);
+        crop_resize_image(octaves[level_octave[i]].channel(q), m, xofs, xofs + w, alpha, alpha + w, yofs, yofs + h, beta, beta + h);
+    }
+}
+
 void resize_bicubic(const Mat& src, Mat& dst, int w, int h, const Option& opt)
 {
     ncnn::Layer* interp = ncnn::create_layer(ncnn::LayerType::Interp);
@@ -290,6 +598,90 @@ void resize_bicubic(const Mat& src, Mat& dst, int w, int h, const Option& opt)
     delete interp;
 }
 
+// acc = S * b for the first source row of a dst row, acc += S * b for the others
+static void resize_area_vresize(const float* S, float* acc, float b, int n, bool first)
+{
+    int x = 0;
+#if __AVX__
+    {
+        __m256 _b = _mm256_set1_ps(b);
+        for (; x+7<n; x+=8)
+        {
+            __m256 _acc = first ? _mm256_setzero_ps() : _mm256_loadu_ps(acc + x);
+            _mm256_storeu_ps(acc + x, _mm256_add_ps(_acc, _mm256_mul_ps(_mm256_loadu_ps(S + x), _b)));
+        }
+    }
+#elif __SSE2__
+    {
+        __m128 _b = _mm_set1_ps(b);
+        for (; x+3<n; x+=4)
+        {
+            __m128 _acc = first ? _mm_setzero_ps() : _mm_loadu_ps(acc + x);
+            _mm_storeu_ps(acc + x, _mm_add_ps(_acc, _mm_mul_ps(_mm_loadu_ps(S + x), _b)));
+        }
+    }
+#endif // __AVX__
+    for (; x<n; x++)
+    {
+        acc[x] = (first ? 0.f : acc[x]) + S[x] * b;
+    }
+}
+
+
+void resize_area(const Mat& src, Mat& dst, int w, int h, const Option& opt)
+{
+    if (w > src.w || h > src.h)
+    {
+        resize_bilinear(src, dst, w, h, opt);
+        return;
+    }
+
+    if (w == src.w && h == src.h)
+    {
+        dst = src;
+        return;
+    }
+
+    int channels = src.c;
+
+    dst.create(w, h, channels, (size_t)4u, opt.blob_allocator);
+    if (dst.empty())
+        return;
+
+    std::vector<int> tab(w + 1 + h + 1);
+    std::vector<int> idx(src.w + w * 2 + src.h + h * 2);
+    std::vector<float> alpha(src.w + w * 2 + src.h + h * 2);
+    int* xtab = &tab[0];
+    int* ytab = &tab[w + 1];
+    int* xidx = &idx[0];
+    int* yidx = &idx[src.w + w * 2];
+    float* xalpha = &alpha[0];
+    float* ybeta = &alpha[src.w + w * 2];
+
+    resize_area_coeffs(src.w, w, xtab, xidx, xalpha);
+    resize_area_coeffs(src.h, h, ytab, yidx, ybeta);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const Mat m = src.channel(q);
+        Mat outm = dst.channel(q);
+
+        Mat accbuf(src.w);
+        float* acc = accbuf;
+
+        for (int dy = 0; dy < h; dy++)
+        {
+            for (int k = ytab[dy]; k < ytab[dy + 1]; k++)
+            {
+                resize_area_vresize(m.row(yidx[k]), acc, ybeta[k], src.w, k == ytab[dy]);
+            }
+
+            resize_area_hresize(acc, outm.row(dy), w, 1, xtab, xidx, xalpha);
+        }
+    }
+}
+
 void convert_packing(const Mat& src, Mat& dst, int _elempack, const Option& opt)
 {
     ncnn::Layer* packing = ncnn::create_layer(ncnn::LayerType::Packing);
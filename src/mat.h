@@ -149,6 +149,11 @@ public:
         PIXEL_GRAY      = (1 << 2),
         PIXEL_RGBA      = (1 << 3),
 
+        // yuv420 with even w and h, the y plane followed by interleaved vu, interleaved uv, or planar u and v
+        PIXEL_NV21      = (1 << 4),
+        PIXEL_NV12      = (1 << 5),
+        PIXEL_I420      = (1 << 6),
+
         PIXEL_RGB2BGR   = PIXEL_RGB | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
         PIXEL_RGB2GRAY  = PIXEL_RGB | (PIXEL_GRAY << PIXEL_CONVERT_SHIFT),
 
@@ -161,16 +166,52 @@ public:
         PIXEL_RGBA2RGB  = PIXEL_RGBA | (PIXEL_RGB << PIXEL_CONVERT_SHIFT),
         PIXEL_RGBA2BGR  = PIXEL_RGBA | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
         PIXEL_RGBA2GRAY = PIXEL_RGBA | (PIXEL_GRAY << PIXEL_CONVERT_SHIFT),
+
+        PIXEL_NV212RGB  = PIXEL_NV21 | (PIXEL_RGB << PIXEL_CONVERT_SHIFT),
+        PIXEL_NV212BGR  = PIXEL_NV21 | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
+
+        PIXEL_NV122RGB  = PIXEL_NV12 | (PIXEL_RGB << PIXEL_CONVERT_SHIFT),
+        PIXEL_NV122BGR  = PIXEL_NV12 | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
+
+        PIXEL_I4202RGB  = PIXEL_I420 | (PIXEL_RGB << PIXEL_CONVERT_SHIFT),
+        PIXEL_I4202BGR  = PIXEL_I420 | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
     };
     // convenient construct from pixel data
     static Mat from_pixels(const unsigned char* pixels, int type, int w, int h, Allocator* allocator = 0);
     // convenient construct from pixel data and resize to specific size
     static Mat from_pixels_resize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, Allocator* allocator = 0);
+    // resize_type is RESIZE_BILINEAR or RESIZE_AREA, area averaging applies to downscaling only
+    static Mat from_pixels_resize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, int resize_type, Allocator* allocator = 0);
+    // the same with the thread count and blob allocator of opt
+    static Mat from_pixels(const unsigned char* pixels, int type, int w, int h, const Option& opt);
+    static Mat from_pixels_resize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, const Option& opt);
+    static Mat from_pixels_resize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, int resize_type, const Option& opt);
+
+    // convenient construct from pixel data, resize to specific size, then substract mean and normalize, all in a single pass
+    static Mat from_pixels_resize_normalize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, const float* mean_vals, const float* norm_vals, Allocator* allocator = 0);
+    // same as from_pixels_resize_normalize on the roi rectangle of the pixel data
+    static Mat from_pixels_roi_resize_normalize(const unsigned char* pixels, int type, int w, int h, int roix, int roiy, int roiw, int roih, int target_width, int target_height, const float* mean_vals, const float* norm_vals, Allocator* allocator = 0);
+    // convenient construct from pixel data warped by the affine transform tm to specific size, then substract mean and normalize, all in a single pass
+    // tm and the border arguments are the same as warpaffine_bilinear_c1
+    static Mat from_pixels_warpaffine_normalize(const unsigned char* pixels, int type, int w, int h, const float* tm, int target_width, int target_height, const float* mean_vals, const float* norm_vals, int border_type = 0, unsigned int v = 0, Allocator* allocator = 0);
+    // the same with the thread count and blob allocator of opt
+    static Mat from_pixels_resize_normalize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, const float* mean_vals, const float* norm_vals, const Option& opt);
+    static Mat from_pixels_roi_resize_normalize(const unsigned char* pixels, int type, int w, int h, int roix, int roiy, int roiw, int roih, int target_width, int target_height, const float* mean_vals, const float* norm_vals, const Option& opt);
+    static Mat from_pixels_warpaffine_normalize(const unsigned char* pixels, int type, int w, int h, const float* tm, int target_width, int target_height, const float* mean_vals, const float* norm_vals, int border_type, unsigned int v, const Option& opt);
+#if NCNN_PIXEL_ROTATE
+    // convenient construct from pixel data rotated by the exif orientation rotate_type, see kanna_rotate_c1
+    static Mat from_pixels_rotate(const unsigned char* pixels, int type, int w, int h, int rotate_type, Allocator* allocator = 0);
+    // fused from_pixels_rotate and substract_mean_normalize, without a rotated copy of the pixel data
+    static Mat from_pixels_rotate_normalize(const unsigned char* pixels, int type, int w, int h, int rotate_type, const float* mean_vals, const float* norm_vals, Allocator* allocator = 0);
+    // the same with the thread count and blob allocator of opt
+    static Mat from_pixels_rotate(const unsigned char* pixels, int type, int w, int h, int rotate_type, const Option& opt);
+    static Mat from_pixels_rotate_normalize(const unsigned char* pixels, int type, int w, int h, int rotate_type, const float* mean_vals, const float* norm_vals, const Option& opt);
+#endif // NCNN_PIXEL_ROTATE
 
     // convenient export to pixel data
-    void to_pixels(unsigned char* pixels, int type) const;
+    void to_pixels(unsigned char* pixels, int type, const Option& opt = Option()) const;
     // convenient export to pixel data and resize to specific size
-    void to_pixels_resize(unsigned char* pixels, int type, int target_width, int target_height) const;
+    void to_pixels_resize(unsigned char* pixels, int type, int target_width, int target_height, const Option& opt = Option()) const;
 #endif // NCNN_PIXEL
 
     // substract channel-wise mean values, then multiply by normalize values, pass 0 to skip
@@ -355,12 +396,41 @@ union vk_constant_type { int i; float f; };
 // convert yuv420sp(nv21) to rgb, the fast approximate version
 void yuv420sp2rgb(const unsigned char* yuv420sp, int w, int h, unsigned char* rgb);
 // image pixel bilinear resize
-void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h);
-void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h);
-void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h);
-void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h);
+void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
+void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
+void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
+void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
 // image pixel bilinear resize, convenient wrapper for yuv420sp(nv21)
-void resize_bilinear_yuv420sp(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h);
+void resize_bilinear_yuv420sp(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
+// image pixel area resize, every output pixel is the average of the source area it covers, for downscaling
+void resize_area_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
+void resize_area_c2(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
+void resize_area_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
+void resize_area_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt = Option());
+// image pixel bilinear affine transform, tm is the 2x3 matrix mapping source pixel coordinates to destination coordinates
+// pixels sampled outside the source take the packed pixel value v with BORDER_CONSTANT, or the nearest edge pixel with BORDER_REPLICATE
+void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int border_type = 0, unsigned int v = 0, const Option& opt = Option());
+void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int border_type = 0, unsigned int v = 0, const Option& opt = Option());
+void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int border_type = 0, unsigned int v = 0, const Option& opt = Option());
+// inverse of the 2x3 affine transform matrix
+void invert_affine_transform(const float* tm, float* tm_inv);
+// similarity transform matrix mapping points_from onto points_to in the least squares sense, points are num_point x y pairs
+void get_similarity_transform(const float* points_from, const float* points_to, int num_point, float* tm);
+#if NCNN_PIXEL_ROTATE
+// image pixel kanna rotate, type is the exif orientation
+//   1 = as is         2 = flip horizontal           3 = rotate 180  4 = flip vertical
+//   5 = transpose     6 = rotate 90 clockwise       7 = transverse  8 = rotate 90 counterclockwise
+// w h is the rotated size, which is srch srcw for the types 5 6 7 8
+void kanna_rotate_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, const Option& opt = Option());
+void kanna_rotate_c2(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, const Option& opt = Option());
+void kanna_rotate_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, const Option& opt = Option());
+void kanna_rotate_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, const Option& opt = Option());
+// image pixel kanna rotate with row strides in bytes
+void kanna_rotate_c1(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int type, const Option& opt = Option());
+void kanna_rotate_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int type, const Option& opt = Option());
+void kanna_rotate_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int type, const Option& opt = Option());
+void kanna_rotate_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int type, const Option& opt = Option());
+#endif // NCNN_PIXEL_ROTATE
 #endif // NCNN_PIXEL
 
 // mat process
@@ -369,10 +439,23 @@ enum
     BORDER_CONSTANT = 0,
     BORDER_REPLICATE = 1,
 };
+enum
+{
+    RESIZE_BILINEAR = 0,
+    RESIZE_AREA = 1,
+};
 void copy_make_border(const Mat& src, Mat& dst, int top, int bottom, int left, int right, int type, float v, const Option& opt = Option());
 void copy_cut_border(const Mat& src, Mat& dst, int top, int bottom, int left, int right, const Option& opt = Option());
 void resize_bilinear(const Mat& src, Mat& dst, int w, int h, const Option& opt = Option());
 void resize_bicubic(const Mat& src, Mat& dst, int w, int h, const Option& opt = Option());
+// every output pixel is the average of the source area it covers, upscaling falls back to resize_bilinear
+void resize_area(const Mat& src, Mat& dst, int w, int h, const Option& opt = Option());
+// crop every roi out of src and resize it to w x h like resize_bilinear, roi i is x y w h at rois[i * 4] and is clipped to src
+// the crops are stored one after another in the channels of dst, crop i is dst.channel_range(i * src.c, src.c)
+void crop_resize_rois(const Mat& src, const int* rois, int num_roi, Mat& dst, int w, int h, const Option& opt = Option());
+// resize src to every w h pair in sizes, the levels are built from 2x box downscaled octaves of src
+// so that src is read once, octaves come from opt.workspace_allocator
+void resize_pyramid(const Mat& src, Mat* levels, const int* sizes, int num_level, const Option& opt = Option());
 void convert_packing(const Mat& src, Mat& dst, int elempack, const Option& opt = Option());
 void cast_float32_to_float16(const Mat& src, Mat& dst, const Option& opt = Option());
 void cast_float16_to_float32(const Mat& src, Mat& dst, const Option& opt = Option());
@@ -19,14 +19,344 @@
 #if __ARM_NEON
 #include <arm_neon.h>
 #endif // __ARM_NEON
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX2__
+#include <immintrin.h>
+#endif // __AVX2__
 #include "platform.h"
 
 namespace ncnn {
 
 #if NCNN_PIXEL
-static Mat from_rgb(const unsigned char* rgb, int w, int h, Allocator* allocator)
+// images with at least this many pixels are converted with one thread per row block
+static const int pixel_parallel_size = 256 * 256;
+
+#if __SSE2__
+#include "mat_pixel_sse.h"
+#endif // __SSE2__
+
+#if !__ARM_NEON
+// gray to one plane, optionally duplicated into two more planes
+static void pixel_c1_to_planar(const unsigned char* gray, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+    int i = 0;
+#if __AVX2__
+    for (; i+7<size; i+=8)
+    {
+        __m256 _p = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)gray)));
+
+        _mm256_storeu_ps(ptr0, _p);
+        if (ptr1)
+        {
+            _mm256_storeu_ps(ptr1, _p);
+            _mm256_storeu_ps(ptr2, _p);
+            ptr1 += 8;
+            ptr2 += 8;
+        }
+
+        gray += 8;
+        ptr0 += 8;
+    }
+#elif __SSE2__
+    for (; i+15<size; i+=16)
+    {
+        __m128 _p0, _p1, _p2, _p3;
+        pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)gray), _p0, _p1, _p2, _p3);
+
+        _mm_storeu_ps(ptr0, _p0);
+        _mm_storeu_ps(ptr0 + 4, _p1);
+        _mm_storeu_ps(ptr0 + 8, _p2);
+        _mm_storeu_ps(ptr0 + 12, _p3);
+        if (ptr1)
+        {
+            _mm_storeu_ps(ptr1, _p0);
+            _mm_storeu_ps(ptr1 + 4, _p1);
+            _mm_storeu_ps(ptr1 + 8, _p2);
+            _mm_storeu_ps(ptr1 + 12, _p3);
+            _mm_storeu_ps(ptr2, _p0);
+            _mm_storeu_ps(ptr2 + 4, _p1);
+            _mm_storeu_ps(ptr2 + 8, _p2);
+            _mm_storeu_ps(ptr2 + 12, _p3);
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+
+        gray += 16;
+        ptr0 += 16;
+    }
+#endif // __AVX2__
+    for (; i<size; i++)
+    {
+        *ptr0++ = *gray;
+        if (ptr1)
+        {
+            *ptr1++ = *gray;
+            *ptr2++ = *gray;
+        }
+
+        gray++;
+    }
+}
+
+// interleaved 3 channels to 3 planes
+static void pixel_c3_to_planar(const unsigned char* rgb, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+    int i = 0;
+#if __SSE2__
+    for (; i+15<size; i+=16)
+    {
+        __m128 _v[12];
+        pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)rgb), _v[0], _v[1], _v[2], _v[3]);
+        pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)(rgb + 16)), _v[4], _v[5], _v[6], _v[7]);
+        pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)(rgb + 32)), _v[8], _v[9], _v[10], _v[11]);
+
+        for (int k=0; k<4; k++)
+        {
+            __m128 _p0, _p1, _p2;
+            pixel_deinterleave3_ps(_v[k * 3], _v[k * 3 + 1], _v[k * 3 + 2], _p0, _p1, _p2);
+
+            _mm_storeu_ps(ptr0 + k * 4, _p0);
+            _mm_storeu_ps(ptr1 + k * 4, _p1);
+            _mm_storeu_ps(ptr2 + k * 4, _p2);
+        }
+
+        rgb += 3*16;
+        ptr0 += 16;
+        ptr1 += 16;
+        ptr2 += 16;
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        *ptr0++ = rgb[0];
+        *ptr1++ = rgb[1];
+        *ptr2++ = rgb[2];
+
+        rgb += 3;
+    }
+}
+
+// interleaved 4 channels to 4 planes, the 4th channel is dropped if ptr3 is null
+static void pixel_c4_to_planar(const unsigned char* rgba, float* ptr0, float* ptr1, float* ptr2, float* ptr3, int size)
 {
-    Mat m(w, h, 3, 4u, allocator);
+    int i = 0;
+#if __SSE2__
+    for (; i+3<size; i+=4)
+    {
+        __m128 _p0, _p1, _p2, _p3;
+        pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)rgba), _p0, _p1, _p2, _p3);
+
+        _MM_TRANSPOSE4_PS(_p0, _p1, _p2, _p3);
+
+        _mm_storeu_ps(ptr0, _p0);
+        _mm_storeu_ps(ptr1, _p1);
+        _mm_storeu_ps(ptr2, _p2);
+        if (ptr3)
+        {
+            _mm_storeu_ps(ptr3, _p3);
+            ptr3 += 4;
+        }
+
+        rgba += 4*4;
+        ptr0 += 4;
+        ptr1 += 4;
+        ptr2 += 4;
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        *ptr0++ = rgba[0];
+        *ptr1++ = rgba[1];
+        *ptr2++ = rgba[2];
+        if (ptr3)
+            *ptr3++ = rgba[3];
+
+        rgba += 4;
+    }
+}
+
+// interleaved 3 or 4 channels to gray, y = (c0 * coeff0 + c1 * coeff1 + c2 * coeff2) >> shift
+static void pixel_cn_to_gray(const unsigned char* rgb, int elempack, float* ptr, int size, int coeff0, int coeff1, int coeff2, int shift)
+{
+    int i = 0;
+#if __SSE2__
+    if (elempack == 3)
+    {
+        // the weighted sum stays below 2^24, exact in float, and truncation of the scaled sum is the shift
+        __m128 _coeff0 = _mm_set1_ps((float)coeff0);
+        __m128 _coeff1 = _mm_set1_ps((float)coeff1);
+        __m128 _coeff2 = _mm_set1_ps((float)coeff2);
+        __m128 _scale = _mm_set1_ps(1.f / (1 << shift));
+        for (; i+15<size; i+=16)
+        {
+            __m128 _v[12];
+            pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)rgb), _v[0], _v[1], _v[2], _v[3]);
+            pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)(rgb + 16)), _v[4], _v[5], _v[6], _v[7]);
+            pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)(rgb + 32)), _v[8], _v[9], _v[10], _v[11]);
+
+            for (int k=0; k<4; k++)
+            {
+                __m128 _p0, _p1, _p2;
+                pixel_deinterleave3_ps(_v[k * 3], _v[k * 3 + 1], _v[k * 3 + 2], _p0, _p1, _p2);
+
+                __m128 _y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_p0, _coeff0), _mm_mul_ps(_p1, _coeff1)), _mm_mul_ps(_p2, _coeff2));
+                _mm_storeu_ps(ptr + k * 4, _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(_y, _scale))));
+            }
+
+            rgb += 3*16;
+            ptr += 16;
+        }
+    }
+    if (elempack == 4)
+    {
+        // every pixel is one 32bit lane, madd with zero high halves is a plain 32bit multiply
+        __m128i _mask = _mm_set1_epi32(0xff);
+        __m128i _coeff0 = _mm_set1_epi32(coeff0);
+        __m128i _coeff1 = _mm_set1_epi32(coeff1);
+        __m128i _coeff2 = _mm_set1_epi32(coeff2);
+        for (; i+3<size; i+=4)
+        {
+            __m128i _v = _mm_loadu_si128((const __m128i*)rgb);
+
+            __m128i _c0 = _mm_and_si128(_v, _mask);
+            __m128i _c1 = _mm_and_si128(_mm_srli_epi32(_v, 8), _mask);
+            __m128i _c2 = _mm_and_si128(_mm_srli_epi32(_v, 16), _mask);
+
+            __m128i _y = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(_c0, _coeff0), _mm_madd_epi16(_c1, _coeff1)), _mm_madd_epi16(_c2, _coeff2));
+            _mm_storeu_ps(ptr, _mm_cvtepi32_ps(_mm_srli_epi32(_y, shift)));
+
+            rgb += 4*4;
+            ptr += 4;
+        }
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        *ptr++ = (rgb[0] * coeff0 + rgb[1] * coeff1 + rgb[2] * coeff2) >> shift;
+
+        rgb += elempack;
+    }
+}
+#endif // !__ARM_NEON
+
+#define SATURATE_CAST_UCHAR(X) (unsigned char)::std::min(::std::max((int)(X), 0), 255);
+
+static void pixel_planar_to_c1(const float* ptr, unsigned char* gray, int size)
+{
+    int i = 0;
+#if __AVX2__
+    for (; i+15<size; i+=16)
+    {
+        __m256i _i0 = _mm256_cvttps_epi32(_mm256_loadu_ps(ptr));
+        __m256i _i1 = _mm256_cvttps_epi32(_mm256_loadu_ps(ptr + 8));
+
+        // packs works within 128bit lanes, restore the element order before the final narrowing
+        __m256i _s16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(_i0, _i1), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i _u8 = _mm_packus_epi16(_mm256_castsi256_si128(_s16), _mm256_extracti128_si256(_s16, 1));
+
+        _mm_storeu_si128((__m128i*)gray, _u8);
+
+        ptr += 16;
+        gray += 16;
+    }
+#elif __SSE2__
+    for (; i+15<size; i+=16)
+    {
+        __m128i _u8 = pixel_ps_to_u8(_mm_loadu_ps(ptr), _mm_loadu_ps(ptr + 4), _mm_loadu_ps(ptr + 8), _mm_loadu_ps(ptr + 12));
+
+        _mm_storeu_si128((__m128i*)gray, _u8);
+
+        ptr += 16;
+        gray += 16;
+    }
+#endif // __AVX2__
+    for (; i<size; i++)
+    {
+        *gray++ = SATURATE_CAST_UCHAR(*ptr);
+
+        ptr++;
+    }
+}
+
+static void pixel_planar_to_c3(const float* ptr0, const float* ptr1, const float* ptr2, unsigned char* rgb, int size)
+{
+    int i = 0;
+#if __SSE2__
+    for (; i+15<size; i+=16)
+    {
+        __m128 _v[12];
+        for (int k=0; k<4; k++)
+        {
+            pixel_interleave3_ps(_mm_loadu_ps(ptr0 + k * 4), _mm_loadu_ps(ptr1 + k * 4), _mm_loadu_ps(ptr2 + k * 4), _v[k * 3], _v[k * 3 + 1], _v[k * 3 + 2]);
+        }
+
+        _mm_storeu_si128((__m128i*)rgb, pixel_ps_to_u8(_v[0], _v[1], _v[2], _v[3]));
+        _mm_storeu_si128((__m128i*)(rgb + 16), pixel_ps_to_u8(_v[4], _v[5], _v[6], _v[7]));
+        _mm_storeu_si128((__m128i*)(rgb + 32), pixel_ps_to_u8(_v[8], _v[9], _v[10], _v[11]));
+
+        rgb += 3*16;
+        ptr0 += 16;
+        ptr1 += 16;
+        ptr2 += 16;
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        rgb[0] = SATURATE_CAST_UCHAR(*ptr0);
+        rgb[1] = SATURATE_CAST_UCHAR(*ptr1);
+        rgb[2] = SATURATE_CAST_UCHAR(*ptr2);
+
+        rgb += 3;
+        ptr0++;
+        ptr1++;
+        ptr2++;
+    }
+}
+
+static void pixel_planar_to_c4(const float* ptr0, const float* ptr1, const float* ptr2, const float* ptr3, unsigned char* rgba, int size)
+{
+    int i = 0;
+#if __SSE2__
+    for (; i+3<size; i+=4)
+    {
+        __m128 _p0 = _mm_loadu_ps(ptr0);
+        __m128 _p1 = _mm_loadu_ps(ptr1);
+        __m128 _p2 = _mm_loadu_ps(ptr2);
+        __m128 _p3 = _mm_loadu_ps(ptr3);
+
+        _MM_TRANSPOSE4_PS(_p0, _p1, _p2, _p3);
+
+        _mm_storeu_si128((__m128i*)rgba, pixel_ps_to_u8(_p0, _p1, _p2, _p3));
+
+        rgba += 4*4;
+        ptr0 += 4;
+        ptr1 += 4;
+        ptr2 += 4;
+        ptr3 += 4;
+    }
+#endif // __SSE2__
+    for (; i<size; i++)
+    {
+        rgba[0] = SATURATE_CAST_UCHAR(*ptr0);
+        rgba[1] = SATURATE_CAST_UCHAR(*ptr1);
+        rgba[2] = SATURATE_CAST_UCHAR(*ptr2);
+        rgba[3] = SATURATE_CAST_UCHAR(*ptr3);
+
+        rgba += 4;
+        ptr0++;
+        ptr1++;
+        ptr2++;
+        ptr3++;
+    }
+}
+
+#undef SATURATE_CAST_UCHAR
+
+static Mat from_rgb(const unsigned char* rgb, int w, int h, const Option& opt)
+{
+    Mat m(w, h, 3, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
@@ -34,16 +364,11 @@ static Mat from_rgb(const unsigned char* rgb, int w, int h, Allocator* allocator
     float* ptr1 = m.channel(1);
     float* ptr2 = m.channel(2);
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 3;
     int remain = size - (nn << 3);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     for (; nn>0; nn--)
     {
@@ -112,7 +437,6 @@ static Mat from_rgb(const unsigned char* rgb, int w, int h, Allocator* allocator
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr0 = rgb[0];
@@ -124,55 +448,46 @@ static Mat from_rgb(const unsigned char* rgb, int w, int h, Allocator* allocator
         ptr1++;
         ptr2++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_c3_to_planar(rgb + w * 3 * i, ptr0 + w * i, ptr1 + w * i, ptr2 + w * i, w);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static void to_rgb(const Mat& m, unsigned char* rgb)
+static void to_rgb(const Mat& m, unsigned char* rgb, const Option& opt)
 {
     const float* ptr0 = m.channel(0);
     const float* ptr1 = m.channel(1);
     const float* ptr2 = m.channel(2);
 
-    int size = m.w * m.h;
-
-#define SATURATE_CAST_UCHAR(X) (unsigned char)::std::min(::std::max((int)(X), 0), 255);
+    int w = m.w;
+    int h = m.h;
 
-    int remain = size;
-
-    for (; remain>0; remain--)
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
     {
-        rgb[0] = SATURATE_CAST_UCHAR(*ptr0);
-        rgb[1] = SATURATE_CAST_UCHAR(*ptr1);
-        rgb[2] = SATURATE_CAST_UCHAR(*ptr2);
-
-        rgb += 3;
-        ptr0++;
-        ptr1++;
-        ptr2++;
+        pixel_planar_to_c3(ptr0 + w * i, ptr1 + w * i, ptr2 + w * i, rgb + w * 3 * i, w);
     }
-
-#undef SATURATE_CAST_UCHAR
 }
 
-static Mat from_gray(const unsigned char* gray, int w, int h, Allocator* allocator)
+static Mat from_gray(const unsigned char* gray, int w, int h, const Option& opt)
 {
-    Mat m(w, h, 1, 4u, allocator);
+    Mat m(w, h, 1, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
     float* ptr = m;
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 4;
     int remain = size - (nn << 4);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     for (; nn>0; nn--)
     {
@@ -224,7 +539,6 @@ static Mat from_gray(const unsigned char* gray, int w, int h, Allocator* allocat
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr = *gray;
@@ -232,34 +546,34 @@ static Mat from_gray(const unsigned char* gray, int w, int h, Allocator* allocat
         gray++;
         ptr++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_c1_to_planar(gray + w * i, ptr + w * i, 0, 0, w);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static void to_gray(const Mat& m, unsigned char* gray)
+static void to_gray(const Mat& m, unsigned char* gray, const Option& opt)
 {
     const float* ptr = m;
 
-    int size = m.w * m.h;
-
-#define SATURATE_CAST_UCHAR(X) (unsigned char)::std::min(::std::max((int)(X), 0), 255);
-
-    int remain = size;
+    int w = m.w;
+    int h = m.h;
 
-    for (; remain>0; remain--)
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
     {
-        *gray = SATURATE_CAST_UCHAR(*ptr);
-
-        gray++;
-        ptr++;
+        pixel_planar_to_c1(ptr + w * i, gray + w * i, w);
     }
-
-#undef SATURATE_CAST_UCHAR
 }
 
-static Mat from_rgba(const unsigned char* rgba, int w, int h, Allocator* allocator)
+static Mat from_rgba(const unsigned char* rgba, int w, int h, const Option& opt)
 {
-    Mat m(w, h, 4, 4u, allocator);
+    Mat m(w, h, 4, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
@@ -268,16 +582,11 @@ static Mat from_rgba(const unsigned char* rgba, int w, int h, Allocator* allocat
     float* ptr2 = m.channel(2);
     float* ptr3 = m.channel(3);
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 3;
     int remain = size - (nn << 3);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     for (; nn>0; nn--)
     {
@@ -360,7 +669,6 @@ static Mat from_rgba(const unsigned char* rgba, int w, int h, Allocator* allocat
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr0 = rgba[0];
@@ -374,43 +682,37 @@ static Mat from_rgba(const unsigned char* rgba, int w, int h, Allocator* allocat
         ptr2++;
         ptr3++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_c4_to_planar(rgba + w * 4 * i, ptr0 + w * i, ptr1 + w * i, ptr2 + w * i, ptr3 + w * i, w);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static void to_rgba(const Mat& m, unsigned char* rgba)
+static void to_rgba(const Mat& m, unsigned char* rgba, const Option& opt)
 {
     const float* ptr0 = m.channel(0);
     const float* ptr1 = m.channel(1);
     const float* ptr2 = m.channel(2);
     const float* ptr3 = m.channel(3);
 
-    int size = m.w * m.h;
+    int w = m.w;
+    int h = m.h;
 
-#define SATURATE_CAST_UCHAR(X) (unsigned char)::std::min(::std::max((int)(X), 0), 255);
-
-    int remain = size;
-
-    for (; remain>0; remain--)
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
     {
-        rgba[0] = SATURATE_CAST_UCHAR(*ptr0);
-        rgba[1] = SATURATE_CAST_UCHAR(*ptr1);
-        rgba[2] = SATURATE_CAST_UCHAR(*ptr2);
-        rgba[3] = SATURATE_CAST_UCHAR(*ptr3);
-
-        rgba += 4;
-        ptr0++;
-        ptr1++;
-        ptr2++;
-        ptr3++;
+        pixel_planar_to_c4(ptr0 + w * i, ptr1 + w * i, ptr2 + w * i, ptr3 + w * i, rgba + w * 4 * i, w);
     }
-
-#undef SATURATE_CAST_UCHAR
 }
 
-static Mat from_rgb2bgr(const unsigned char* rgb, int w, int h, Allocator* allocator)
+static Mat from_rgb2bgr(const unsigned char* rgb, int w, int h, const Option& opt)
 {
-    Mat m(w, h, 3, 4u, allocator);
+    Mat m(w, h, 3, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
@@ -418,16 +720,11 @@ static Mat from_rgb2bgr(const unsigned char* rgb, int w, int h, Allocator* alloc
     float* ptr1 = m.channel(1);
     float* ptr2 = m.channel(2);
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 3;
     int remain = size - (nn << 3);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     for (; nn>0; nn--)
     {
@@ -496,7 +793,6 @@ static Mat from_rgb2bgr(const unsigned char* rgb, int w, int h, Allocator* alloc
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr0 = rgb[2];
@@ -508,38 +804,34 @@ static Mat from_rgb2bgr(const unsigned char* rgb, int w, int h, Allocator* alloc
         ptr1++;
         ptr2++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_c3_to_planar(rgb + w * 3 * i, ptr2 + w * i, ptr1 + w * i, ptr0 + w * i, w);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static void to_bgr2rgb(const Mat& m, unsigned char* rgb)
+static void to_bgr2rgb(const Mat& m, unsigned char* rgb, const Option& opt)
 {
     const float* ptr0 = m.channel(0);
     const float* ptr1 = m.channel(1);
     const float* ptr2 = m.channel(2);
 
-    int size = m.w * m.h;
+    int w = m.w;
+    int h = m.h;
 
-#define SATURATE_CAST_UCHAR(X) (unsigned char)::std::min(::std::max((int)(X), 0), 255);
-
-    int remain = size;
-
-    for (; remain>0; remain--)
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
     {
-        rgb[2] = SATURATE_CAST_UCHAR(*ptr0);
-        rgb[1] = SATURATE_CAST_UCHAR(*ptr1);
-        rgb[0] = SATURATE_CAST_UCHAR(*ptr2);
-
-        rgb += 3;
-        ptr0++;
-        ptr1++;
-        ptr2++;
+        pixel_planar_to_c3(ptr2 + w * i, ptr1 + w * i, ptr0 + w * i, rgb + w * 3 * i, w);
     }
-
-#undef SATURATE_CAST_UCHAR
 }
 
-static Mat from_rgb2gray(const unsigned char* rgb, int w, int h, Allocator* allocator)
+static Mat from_rgb2gray(const unsigned char* rgb, int w, int h, const Option& opt)
 {
     // coeffs for r g b = 0.299f, 0.587f, 0.114f
     const unsigned char Y_shift = 8;//14
@@ -547,22 +839,17 @@ static Mat from_rgb2gray(const unsigned char* rgb, int w, int h, Allocator* allo
     const unsigned char G2Y = 150;
     const unsigned char B2Y = 29;
 
-    Mat m(w, h, 1, 4u, allocator);
+    Mat m(w, h, 1, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
     float* ptr = m;
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 3;
     int remain = size - (nn << 3);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     uint8x8_t _R2Y = vdup_n_u8(R2Y);
     uint8x8_t _G2Y = vdup_n_u8(G2Y);
@@ -619,7 +906,6 @@ static Mat from_rgb2gray(const unsigned char* rgb, int w, int h, Allocator* allo
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr = (rgb[0] * R2Y + rgb[1] * G2Y + rgb[2] * B2Y) >> Y_shift;
@@ -627,11 +913,18 @@ static Mat from_rgb2gray(const unsigned char* rgb, int w, int h, Allocator* allo
         rgb += 3;
         ptr++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_cn_to_gray(rgb + w * 3 * i, 3, ptr + w * i, w, R2Y, G2Y, B2Y, Y_shift);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static Mat from_bgr2gray(const unsigned char* bgr, int w, int h, Allocator* allocator)
+static Mat from_bgr2gray(const unsigned char* bgr, int w, int h, const Option& opt)
 {
     // coeffs for r g b = 0.299f, 0.587f, 0.114f
     const unsigned char Y_shift = 8;//14
@@ -639,22 +932,17 @@ static Mat from_bgr2gray(const unsigned char* bgr, int w, int h, Allocator* allo
     const unsigned char G2Y = 150;
     const unsigned char B2Y = 29;
 
-    Mat m(w, h, 1, 4u, allocator);
+    Mat m(w, h, 1, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
     float* ptr = m;
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 3;
     int remain = size - (nn << 3);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     uint8x8_t _R2Y = vdup_n_u8(R2Y);
     uint8x8_t _G2Y = vdup_n_u8(G2Y);
@@ -711,7 +999,6 @@ static Mat from_bgr2gray(const unsigned char* bgr, int w, int h, Allocator* allo
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr = (bgr[2] * R2Y + bgr[1] * G2Y + bgr[0] * B2Y) >> Y_shift;
@@ -719,13 +1006,20 @@ static Mat from_bgr2gray(const unsigned char* bgr, int w, int h, Allocator* allo
         bgr += 3;
         ptr++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_cn_to_gray(bgr + w * 3 * i, 3, ptr + w * i, w, B2Y, G2Y, R2Y, Y_shift);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static Mat from_gray2rgb(const unsigned char* gray, int w, int h, Allocator* allocator)
+static Mat from_gray2rgb(const unsigned char* gray, int w, int h, const Option& opt)
 {
-    Mat m(w, h, 3, 4u, allocator);
+    Mat m(w, h, 3, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
@@ -733,16 +1027,11 @@ static Mat from_gray2rgb(const unsigned char* gray, int w, int h, Allocator* all
     float* ptr1 = m.channel(1);
     float* ptr2 = m.channel(2);
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 4;
     int remain = size - (nn << 4);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     for (; nn>0; nn--)
     {
@@ -814,7 +1103,6 @@ static Mat from_gray2rgb(const unsigned char* gray, int w, int h, Allocator* all
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr0 = *gray;
@@ -826,13 +1114,20 @@ static Mat from_gray2rgb(const unsigned char* gray, int w, int h, Allocator* all
         ptr1++;
         ptr2++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_c1_to_planar(gray + w * i, ptr0 + w * i, ptr1 + w * i, ptr2 + w * i, w);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static Mat from_rgba2rgb(const unsigned char* rgba, int w, int h, Allocator* allocator)
+static Mat from_rgba2rgb(const unsigned char* rgba, int w, int h, const Option& opt)
 {
-    Mat m(w, h, 3, 4u, allocator);
+    Mat m(w, h, 3, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
@@ -840,16 +1135,11 @@ static Mat from_rgba2rgb(const unsigned char* rgba, int w, int h, Allocator* all
     float* ptr1 = m.channel(1);
     float* ptr2 = m.channel(2);
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 3;
     int remain = size - (nn << 3);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     for (; nn>0; nn--)
     {
@@ -918,7 +1208,6 @@ static Mat from_rgba2rgb(const unsigned char* rgba, int w, int h, Allocator* all
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr0 = rgba[0];
@@ -930,13 +1219,20 @@ static Mat from_rgba2rgb(const unsigned char* rgba, int w, int h, Allocator* all
         ptr1++;
         ptr2++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_c4_to_planar(rgba + w * 4 * i, ptr0 + w * i, ptr1 + w * i, ptr2 + w * i, 0, w);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static Mat from_rgba2bgr(const unsigned char* rgba, int w, int h, Allocator* allocator)
+static Mat from_rgba2bgr(const unsigned char* rgba, int w, int h, const Option& opt)
 {
-    Mat m(w, h, 3, 4u, allocator);
+    Mat m(w, h, 3, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
@@ -944,16 +1240,11 @@ static Mat from_rgba2bgr(const unsigned char* rgba, int w, int h, Allocator* all
     float* ptr1 = m.channel(1);
     float* ptr2 = m.channel(2);
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 3;
     int remain = size - (nn << 3);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     for (; nn>0; nn--)
     {
@@ -1022,7 +1313,6 @@ static Mat from_rgba2bgr(const unsigned char* rgba, int w, int h, Allocator* all
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr0 = rgba[2];
@@ -1034,11 +1324,18 @@ static Mat from_rgba2bgr(const unsigned char* rgba, int w, int h, Allocator* all
         ptr1++;
         ptr2++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_c4_to_planar(rgba + w * 4 * i, ptr2 + w * i, ptr1 + w * i, ptr0 + w * i, 0, w);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
 
-static Mat from_rgba2gray(const unsigned char* rgba, int w, int h, Allocator* allocator)
+static Mat from_rgba2gray(const unsigned char* rgba, int w, int h, const Option& opt)
 {
     // coeffs for r g b = 0.299f, 0.587f, 0.114f
     const unsigned char Y_shift = 8;//14
@@ -1046,22 +1343,17 @@ static Mat from_rgba2gray(const unsigned char* rgba, int w, int h, Allocator* al
     const unsigned char G2Y = 150;
     const unsigned char B2Y = 29;
 
-    Mat m(w, h, 1, 4u, allocator);
+    Mat m(w, h, 1, 4u, opt.blob_allocator);
     if (m.empty())
         return m;
 
     float* ptr = m;
 
-    int size = w * h;
-
 #if __ARM_NEON
+    int size = w * h;
     int nn = size >> 3;
     int remain = size - (nn << 3);
-#else
-    int remain = size;
-#endif // __ARM_NEON
 
-#if __ARM_NEON
 #if __aarch64__
     uint8x8_t _R2Y = vdup_n_u8(R2Y);
     uint8x8_t _G2Y = vdup_n_u8(G2Y);
@@ -1118,7 +1410,6 @@ static Mat from_rgba2gray(const unsigned char* rgba, int w, int h, Allocator* al
     );
     }
 #endif // __aarch64__
-#endif // __ARM_NEON
     for (; remain>0; remain--)
     {
         *ptr = (rgba[0] * R2Y + rgba[1] * G2Y + rgba[2] * B2Y) >> Y_shift;
@@ -1126,6 +1417,13 @@ static Mat from_rgba2gray(const unsigned char* rgba, int w, int h, Allocator* al
         rgba += 4;
         ptr++;
     }
+#else
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= pixel_parallel_size)
+    for (int i=0; i<h; i++)
+    {
+        pixel_cn_to_gray(rgba + w * 4 * i, 4, ptr + w * i, w, R2Y, G2Y, B2Y, Y_shift);
+    }
+#endif // __ARM_NEON
 
     return m;
 }
@@ -1327,49 +1625,70 @@ void yuv420sp2rgb(const unsigned char* yuv420sp, int w, int h, unsigned char* rg
 }
 
 Mat Mat::from_pixels(const unsigned char* pixels, int type, int w, int h, Allocator* allocator)
+{
+    Option opt;
+    opt.blob_allocator = allocator;
+
+    return Mat::from_pixels(pixels, type, w, h, opt);
+}
+
+Mat Mat::from_pixels(const unsigned char* pixels, int type, int w, int h, const Option& opt)
 {
     if (type & PIXEL_CONVERT_MASK)
     {
         if (type == PIXEL_RGB2BGR || type == PIXEL_BGR2RGB)
-            return from_rgb2bgr(pixels, w, h, allocator);
+            return from_rgb2bgr(pixels, w, h, opt);
 
         if (type == PIXEL_RGB2GRAY)
-            return from_rgb2gray(pixels, w, h, allocator);
+            return from_rgb2gray(pixels, w, h, opt);
 
         if (type == PIXEL_BGR2GRAY)
-            return from_bgr2gray(pixels, w, h, allocator);
+            return from_bgr2gray(pixels, w, h, opt);
 
         if (type == PIXEL_GRAY2RGB || type == PIXEL_GRAY2BGR)
-            return from_gray2rgb(pixels, w, h, allocator);
+            return from_gray2rgb(pixels, w, h, opt);
 
         if (type == PIXEL_RGBA2RGB)
-            return from_rgba2rgb(pixels, w, h, allocator);
+            return from_rgba2rgb(pixels, w, h, opt);
 
         if (type == PIXEL_RGBA2BGR)
-            return from_rgba2bgr(pixels, w, h, allocator);
+            return from_rgba2bgr(pixels, w, h, opt);
 
         if (type == PIXEL_RGBA2GRAY)
-            return from_rgba2gray(pixels, w, h, allocator);
+            return from_rgba2gray(pixels, w, h, opt);
+
+        // yuv rows are converted one at a time
+        int type_from = type & PIXEL_FORMAT_MASK;
+        if (type_from == PIXEL_NV21 || type_from == PIXEL_NV12 || type_from == PIXEL_I420)
+            return from_pixels_resize_normalize(pixels, type, w, h, w, h, 0, 0, opt);
     }
     else
     {
         if (type == PIXEL_RGB || type == PIXEL_BGR)
-            return from_rgb(pixels, w, h, allocator);
+            return from_rgb(pixels, w, h, opt);
 
         if (type == PIXEL_GRAY)
-            return from_gray(pixels, w, h, allocator);
+            return from_gray(pixels, w, h, opt);
 
         if (type == PIXEL_RGBA)
-            return from_rgba(pixels, w, h, allocator);
+            return from_rgba(pixels, w, h, opt);
     }
 
     return Mat();
 }
 
 Mat Mat::from_pixels_resize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, Allocator* allocator)
+{
+    Option opt;
+    opt.blob_allocator = allocator;
+
+    return Mat::from_pixels_resize(pixels, type, w, h, target_width, target_height, opt);
+}
+
+Mat Mat::from_pixels_resize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, const Option& opt)
 {
     if (w == target_width && h == target_height)
-        return Mat::from_pixels(pixels, type, w, h);
+        return Mat::from_pixels(pixels, type, w, h, opt);
 
     Mat m;
 
@@ -1379,54 +1698,109 @@ Mat Mat::from_pixels_resize(const unsigned char* pixels, int type, int w, int h,
     {
         Mat dst(target_width, target_height, (size_t)3u, 3);
 
-        resize_bilinear_c3(pixels, w, h, dst, target_width, target_height);
+        resize_bilinear_c3(pixels, w, h, dst, target_width, target_height, opt);
 
-        m = Mat::from_pixels(dst, type, target_width, target_height, allocator);
+        m = Mat::from_pixels(dst, type, target_width, target_height, opt);
     }
     else if (type_from == PIXEL_GRAY)
     {
         Mat dst(target_width, target_height, (size_t)1u, 1);
 
-        resize_bilinear_c1(pixels, w, h, dst, target_width, target_height);
+        resize_bilinear_c1(pixels, w, h, dst, target_width, target_height, opt);
 
-        m = Mat::from_pixels(dst, type, target_width, target_height, allocator);
+        m = Mat::from_pixels(dst, type, target_width, target_height, opt);
     }
     else if (type_from == PIXEL_RGBA)
     {
         Mat dst(target_width, target_height, (size_t)4u, 4);
 
-        resize_bilinear_c4(pixels, w, h, dst, target_width, target_height);
+        resize_bilinear_c4(pixels, w, h, dst, target_width, target_height, opt);
+
+        m = Mat::from_pixels(dst, type, target_width, target_height, opt);
+    }
+    else if (type_from == PIXEL_NV21 || type_from == PIXEL_NV12 || type_from == PIXEL_I420)
+    {
+        // convert and resize row by row, without a full size rgb image
+        m = Mat::from_pixels_resize_normalize(pixels, type, w, h, target_width, target_height, 0, 0, opt);
+    }
+
+    return m;
+}
+
+Mat Mat::from_pixels_resize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, int resize_type, Allocator* allocator)
+{
+    Option opt;
+    opt.blob_allocator = allocator;
+
+    return Mat::from_pixels_resize(pixels, type, w, h, target_width, target_height, resize_type, opt);
+}
+
+Mat Mat::from_pixels_resize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, int resize_type, const Option& opt)
+{
+    if (resize_type != RESIZE_AREA || target_width > w || target_height > h || (w == target_width && h == target_height))
+        return Mat::from_pixels_resize(pixels, type, w, h, target_width, target_height, opt);
+
+    Mat m;
 
-        m = Mat::from_pixels(dst, type, target_width, target_height, allocator);
+    int type_from = type & PIXEL_FORMAT_MASK;
+
+    if (type_from == PIXEL_RGB || type_from == PIXEL_BGR)
+    {
+        Mat dst(target_width, target_height, (size_t)3u, 3);
+
+        resize_area_c3(pixels, w, h, dst, target_width, target_height, opt);
+
+        m = Mat::from_pixels(dst, type, target_width, target_height, opt);
+    }
+    else if (type_from == PIXEL_GRAY)
+    {
+        Mat dst(target_width, target_height, (size_t)1u, 1);
+
+        resize_area_c1(pixels, w, h, dst, target_width, target_height, opt);
+
+        m = Mat::from_pixels(dst, type, target_width, target_height, opt);
+    }
+    else if (type_from == PIXEL_RGBA)
+    {
+        Mat dst(target_width, target_height, (size_t)4u, 4);
+
+        resize_area_c4(pixels, w, h, dst, target_width, target_height, opt);
+
+        m = Mat::from_pixels(dst, type, target_width, target_height, opt);
+    }
+    else if (type_from == PIXEL_NV21 || type_from == PIXEL_NV12 || type_from == PIXEL_I420)
+    {
+        // area average the converted image
+        resize_area(Mat::from_pixels(pixels, type, w, h, opt), m, target_width, target_height, opt);
     }
 
     return m;
 }
 
-void Mat::to_pixels(unsigned char* pixels, int type) const
+void Mat::to_pixels(unsigned char* pixels, int type, const Option& opt) const
 {
     if (type & PIXEL_CONVERT_MASK)
     {
         if (type == PIXEL_RGB2BGR || type == PIXEL_BGR2RGB)
-            return to_bgr2rgb(*this, pixels);
+            return to_bgr2rgb(*this, pixels, opt);
     }
     else
     {
         if (type == PIXEL_RGB || type == PIXEL_BGR)
-            return to_rgb(*this, pixels);
+            return to_rgb(*this, pixels, opt);
 
         if (type == PIXEL_GRAY)
-            return to_gray(*this, pixels);
+            return to_gray(*this, pixels, opt);
 
         if (type == PIXEL_RGBA)
-            return to_rgba(*this, pixels);
+            return to_rgba(*this, pixels, opt);
     }
 }
 
-void Mat::to_pixels_resize(unsigned char* pixels, int type, int target_width, int target_height) const
+void Mat::to_pixels_resize(unsigned char* pixels, int type, int target_width, int target_height, const Option& opt) const
 {
     if (w == target_width && h == target_height)
-        return to_pixels(pixels, type);
+        return to_pixels(pixels, type, opt);
 
     int type_to = (type & PIXEL_CONVERT_MASK) ? (type >> PIXEL_CONVERT_SHIFT) : (type & PIXEL_FORMAT_MASK);
 
@@ -1434,25 +1808,25 @@ void Mat::to_pixels_resize(unsigned char* pixels, int type, int target_width, in
     {
         Mat src(w, h, (size_t)3u, 3);
 
-        to_pixels(src, type);
+        to_pixels(src, type, opt);
 
-        resize_bilinear_c3(src, w, h, pixels, target_width, target_height);
+        resize_bilinear_c3(src, w, h, pixels, target_width, target_height, opt);
     }
     else if (type_to == PIXEL_GRAY)
     {
         Mat src(w, h, (size_t)1u, 1);
 
-        to_pixels(src, type);
+        to_pixels(src, type, opt);
 
-        resize_bilinear_c1(src, w, h, pixels, target_width, target_height);
+        resize_bilinear_c1(src, w, h, pixels, target_width, target_height, opt);
     }
     else if (type_to == PIXEL_RGBA)
     {
         Mat src(w, h, (size_t)4u, 4);
 
-        to_pixels(src, type);
+        to_pixels(src, type, opt);
 
-        resize_bilinear_c4(src, w, h, pixels, target_width, target_height);
+        resize_bilinear_c4(src, w, h, pixels, target_width, target_height, opt);
     }
 }
 #endif // NCNN_PIXEL
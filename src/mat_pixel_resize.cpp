@@ -15,16 +15,1111 @@
 #include "mat.h"
 #include <limits.h>
 #include <math.h>
+#include <string.h>
 #include <algorithm>
+#include <vector>
 #if __ARM_NEON
 #include <arm_neon.h>
 #endif // __ARM_NEON
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
 #include "platform.h"
 
 namespace ncnn {
 
 #if NCNN_PIXEL
-void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h)
+#if __SSE2__
+#include "mat_pixel_sse.h"
+#endif // __SSE2__
+#include "mat_resize_area.h"
+
+// one row of yuv420 to interleaved rgb with the same fixed point arithmetic as yuv420sp2rgb
+// uptr and vptr point to the chroma of the first pixel pair, uvstep is 2 for interleaved and 1 for planar chroma
+static void yuv420_to_rgb_row(const unsigned char* yptr, const unsigned char* uptr, const unsigned char* vptr, int uvstep, unsigned char* rgb, int w)
+{
+    int x = 0;
+#if __SSE2__
+    __m128i _zero = _mm_setzero_si128();
+    __m128i _v128 = _mm_set1_epi16(128);
+    __m128i _v90 = _mm_set1_epi16(90);
+    __m128i _v46 = _mm_set1_epi16(46);
+    __m128i _v22 = _mm_set1_epi16(22);
+    __m128i _v113 = _mm_set1_epi16(113);
+    const unsigned char* uvptr = std::min(uptr, vptr);
+    for (; x+7<w; x+=8)
+    {
+        __m128i _yy = _mm_slli_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(yptr + x)), _zero), 6);
+
+        // chroma of 4 pixel pairs, duplicated for both pixels of a pair
+        __m128i _uu;
+        __m128i _vv;
+        if (uvstep == 2)
+        {
+            __m128i _c = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(uvptr + x)), _zero), _v128);
+            __m128i _c0 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_c, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+            __m128i _c1 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_c, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+            _uu = uptr < vptr ? _c0 : _c1;
+            _vv = uptr < vptr ? _c1 : _c0;
+        }
+        else
+        {
+            int u4;
+            int v4;
+            memcpy(&u4, uptr + x / 2, 4);
+            memcpy(&v4, vptr + x / 2, 4);
+            __m128i _u = _mm_unpacklo_epi8(_mm_cvtsi32_si128(u4), _zero);
+            __m128i _v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v4), _zero);
+            _uu = _mm_sub_epi16(_mm_unpacklo_epi16(_u, _u), _v128);
+            _vv = _mm_sub_epi16(_mm_unpacklo_epi16(_v, _v), _v128);
+        }
+
+        // every term stays within int16
+        __m128i _r = _mm_srai_epi16(_mm_add_epi16(_yy, _mm_mullo_epi16(_vv, _v90)), 6);
+        __m128i _g = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(_yy, _mm_mullo_epi16(_vv, _v46)), _mm_mullo_epi16(_uu, _v22)), 6);
+        __m128i _b = _mm_srai_epi16(_mm_add_epi16(_yy, _mm_mullo_epi16(_uu, _v113)), 6);
+
+        unsigned char tmp[32];
+        _mm_storeu_si128((__m128i*)tmp, _mm_packus_epi16(_r, _g));
+        _mm_storel_epi64((__m128i*)(tmp + 16), _mm_packus_epi16(_b, _b));
+
+        for (int k=0; k<8; k++)
+        {
+            rgb[0] = tmp[k];
+            rgb[1] = tmp[8 + k];
+            rgb[2] = tmp[16 + k];
+            rgb += 3;
+        }
+    }
+#endif // __SSE2__
+
+#define SATURATE_CAST_UCHAR(X) (unsigned char)::std::min(::std::max((int)(X), 0), 255);
+    for (; x<w; x++)
+    {
+        int u = uptr[x / 2 * uvstep] - 128;
+        int v = vptr[x / 2 * uvstep] - 128;
+
+        int yy = yptr[x] << 6;
+        rgb[0] = SATURATE_CAST_UCHAR((yy + 90 * v) >> 6);
+        rgb[1] = SATURATE_CAST_UCHAR((yy - 46 * v - 22 * u) >> 6);
+        rgb[2] = SATURATE_CAST_UCHAR((yy + 113 * u) >> 6);
+        rgb += 3;
+    }
+#undef SATURATE_CAST_UCHAR
+}
+
+// affine sampling coordinates carry 10 fractional bits
+static const int warpaffine_bits = 10;
+
+// images with at least this many output pixels are warped with one thread per row block
+static const int warpaffine_parallel_size = 256 * 256;
+
+static inline int warpaffine_fixed(float v)
+{
+    // clamp far outside coordinates, the sum of two terms must not overflow
+    v = std::min(std::max(v * (1 << warpaffine_bits), -(float)(1 << 29)), (float)(1 << 29));
+    return (int)floorf(v + 0.5f);
+}
+
+// bilinear blend with weights of 10 bits, the horizontal sums are scaled down by 4 bits to fit int16 for the vertical step
+#define WARPAFFINE_BLEND(a0, a1, b0, b1) (unsigned char)(((((a0) * alpha0 + (a1) * alpha1) >> 4) * beta0 + (((b0) * alpha0 + (b1) * alpha1) >> 4) * beta1 + (1 << 15)) >> 16)
+
+// one destination row, the source coordinate of pixel x is (X0 + adelta[x], Y0 + bdelta[x]) in fixed point
+static void warpaffine_bilinear_row(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int cn,
+                                    const int* adelta, const int* bdelta, int X0, int Y0, int border_type, const unsigned char* border_color)
+{
+    const int fmask = (1 << warpaffine_bits) - 1;
+
+    int x = 0;
+    while (x < w)
+    {
+        // the coordinates are monotonic along the row, a span is inside when both of its ends are
+        const int X = X0 + adelta[x];
+        const int Y = Y0 + bdelta[x];
+        const int sx = X >> warpaffine_bits;
+        const int sy = Y >> warpaffine_bits;
+
+        if (sx < 0 || sy < 0 || sx >= srcw - 1 || sy >= srch - 1)
+        {
+            // neighbours outside the image take the border value
+            const int fx = X & fmask;
+            const int fy = Y & fmask;
+            const int alpha0 = (1 << warpaffine_bits) - fx;
+            const int alpha1 = fx;
+            const int beta0 = (1 << warpaffine_bits) - fy;
+            const int beta1 = fy;
+
+            int x0 = sx;
+            int x1 = sx + 1;
+            int y0 = sy;
+            int y1 = sy + 1;
+            if (border_type == BORDER_REPLICATE)
+            {
+                x0 = std::min(std::max(x0, 0), srcw - 1);
+                x1 = std::min(std::max(x1, 0), srcw - 1);
+                y0 = std::min(std::max(y0, 0), srch - 1);
+                y1 = std::min(std::max(y1, 0), srch - 1);
+            }
+
+            const bool x0_inside = x0 >= 0 && x0 < srcw;
+            const bool x1_inside = x1 >= 0 && x1 < srcw;
+            const bool y0_inside = y0 >= 0 && y0 < srch;
+            const bool y1_inside = y1 >= 0 && y1 < srch;
+
+            const unsigned char* p00 = x0_inside && y0_inside ? src + y0 * srcstride + x0 * cn : border_color;
+            const unsigned char* p01 = x1_inside && y0_inside ? src + y0 * srcstride + x1 * cn : border_color;
+            const unsigned char* p10 = x0_inside && y1_inside ? src + y1 * srcstride + x0 * cn : border_color;
+            const unsigned char* p11 = x1_inside && y1_inside ? src + y1 * srcstride + x1 * cn : border_color;
+
+            for (int c = 0; c < cn; c++)
+            {
+                dst[x * cn + c] = WARPAFFINE_BLEND(p00[c], p01[c], p10[c], p11[c]);
+            }
+
+            x++;
+            continue;
+        }
+
+        // the longest inside span starting at x, found by bisection on the end point
+        int end = w;
+        {
+            int lo = x + 1;
+            int hi = w;
+            while (lo < hi)
+            {
+                const int mid = (lo + hi) / 2;
+                const int ex = (X0 + adelta[mid]) >> warpaffine_bits;
+                const int ey = (Y0 + bdelta[mid]) >> warpaffine_bits;
+                if (ex < 0 || ey < 0 || ex >= srcw - 1 || ey >= srch - 1)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            end = lo;
+        }
+
+#if __SSE2__
+        const __m128i _fmask = _mm_set1_epi32(fmask);
+        const __m128i _one = _mm_set1_epi32(1 << warpaffine_bits);
+        const __m128i _round = _mm_set1_epi32(1 << 15);
+        const __m128i _zero = _mm_setzero_si128();
+        if (cn == 1)
+        {
+            for (; x+7<end; x+=8)
+            {
+                // the two horizontal neighbours of 8 pixels as u16, two rows
+                __m128i _a = _zero;
+                __m128i _b = _zero;
+#define WARPAFFINE_GATHER_C1(k)                                                                                     \
+                {                                                                                                   \
+                    const unsigned char* p0 = src + ((Y0 + bdelta[x + k]) >> warpaffine_bits) * srcstride + ((X0 + adelta[x + k]) >> warpaffine_bits); \
+                    _a = _mm_insert_epi16(_a, p0[0] | (p0[1] << 8), k);                                             \
+                    _b = _mm_insert_epi16(_b, p0[srcstride] | (p0[srcstride + 1] << 8), k);                         \
+                }
+                WARPAFFINE_GATHER_C1(0)
+                WARPAFFINE_GATHER_C1(1)
+                WARPAFFINE_GATHER_C1(2)
+                WARPAFFINE_GATHER_C1(3)
+                WARPAFFINE_GATHER_C1(4)
+                WARPAFFINE_GATHER_C1(5)
+                WARPAFFINE_GATHER_C1(6)
+                WARPAFFINE_GATHER_C1(7)
+#undef WARPAFFINE_GATHER_C1
+
+                __m128i _v[2];
+                for (int k=0; k<2; k++)
+                {
+                    __m128i _fx = _mm_and_si128(_mm_loadu_si128((const __m128i*)(adelta + x + k * 4)), _fmask);
+                    __m128i _fy = _mm_and_si128(_mm_loadu_si128((const __m128i*)(bdelta + x + k * 4)), _fmask);
+                    // X0 and Y0 only shift the fraction when they are not multiples of one pixel
+                    _fx = _mm_and_si128(_mm_add_epi32(_fx, _mm_set1_epi32(X0 & fmask)), _fmask);
+                    _fy = _mm_and_si128(_mm_add_epi32(_fy, _mm_set1_epi32(Y0 & fmask)), _fmask);
+
+                    __m128i _alpha = _mm_or_si128(_mm_sub_epi32(_one, _fx), _mm_slli_epi32(_fx, 16));
+                    __m128i _beta = _mm_or_si128(_mm_sub_epi32(_one, _fy), _mm_slli_epi32(_fy, 16));
+
+                    // u8 pairs widened to int16 pairs
+                    __m128i _ak = k == 0 ? _mm_unpacklo_epi8(_a, _zero) : _mm_unpackhi_epi8(_a, _zero);
+                    __m128i _bk = k == 0 ? _mm_unpacklo_epi8(_b, _zero) : _mm_unpackhi_epi8(_b, _zero);
+
+                    __m128i _top = _mm_srai_epi32(_mm_madd_epi16(_ak, _alpha), 4);
+                    __m128i _bot = _mm_srai_epi32(_mm_madd_epi16(_bk, _alpha), 4);
+                    _v[k] = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_or_si128(_top, _mm_slli_epi32(_bot, 16)), _beta), _round), 16);
+                }
+
+                __m128i _v16 = _mm_packs_epi32(_v[0], _v[1]);
+                _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(_v16, _v16));
+            }
+        }
+        if (cn == 3 || cn == 4)
+        {
+            // the 8 byte load of the last pixels of the image would read past the end
+            const int ofs_max = (srch - 1) * srcstride + srcw * cn - 8 - srcstride;
+
+            for (; x+3<end; x+=4)
+            {
+                int ofs[4];
+                for (int k=0; k<4; k++)
+                {
+                    ofs[k] = ((Y0 + bdelta[x + k]) >> warpaffine_bits) * srcstride + ((X0 + adelta[x + k]) >> warpaffine_bits) * cn;
+                }
+                if (std::max(std::max(ofs[0], ofs[1]), std::max(ofs[2], ofs[3])) > ofs_max)
+                    break;
+
+                __m128i _fx = _mm_and_si128(_mm_add_epi32(_mm_loadu_si128((const __m128i*)(adelta + x)), _mm_set1_epi32(X0)), _fmask);
+                __m128i _fy = _mm_and_si128(_mm_add_epi32(_mm_loadu_si128((const __m128i*)(bdelta + x)), _mm_set1_epi32(Y0)), _fmask);
+                __m128i _alpha = _mm_or_si128(_mm_sub_epi32(_one, _fx), _mm_slli_epi32(_fx, 16));
+                __m128i _beta = _mm_or_si128(_mm_sub_epi32(_one, _fy), _mm_slli_epi32(_fy, 16));
+
+                // the channels of both horizontal neighbours as int16 pairs, one pixel per lane group
+                __m128i _v[4];
+#define WARPAFFINE_BLEND_CN(k)                                                                                      \
+                {                                                                                                   \
+                    __m128i _a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + ofs[k])), _zero);        \
+                    __m128i _b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + ofs[k] + srcstride)), _zero); \
+                    _a = _mm_unpacklo_epi16(_a, cn == 3 ? _mm_srli_si128(_a, 6) : _mm_srli_si128(_a, 8));          \
+                    _b = _mm_unpacklo_epi16(_b, cn == 3 ? _mm_srli_si128(_b, 6) : _mm_srli_si128(_b, 8));          \
+                    __m128i _alphak = _mm_shuffle_epi32(_alpha, _MM_SHUFFLE(k, k, k, k));                          \
+                    __m128i _betak = _mm_shuffle_epi32(_beta, _MM_SHUFFLE(k, k, k, k));                            \
+                    __m128i _top = _mm_srai_epi32(_mm_madd_epi16(_a, _alphak), 4);                                 \
+                    __m128i _bot = _mm_srai_epi32(_mm_madd_epi16(_b, _alphak), 4);                                 \
+                    _v[k] = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_or_si128(_top, _mm_slli_epi32(_bot, 16)), _betak), _round), 16); \
+                }
+                WARPAFFINE_BLEND_CN(0)
+                WARPAFFINE_BLEND_CN(1)
+                WARPAFFINE_BLEND_CN(2)
+                WARPAFFINE_BLEND_CN(3)
+#undef WARPAFFINE_BLEND_CN
+
+                // 4 pixels of 4 channels
+                __m128i _v8 = _mm_packus_epi16(_mm_packs_epi32(_v[0], _v[1]), _mm_packs_epi32(_v[2], _v[3]));
+                if (cn == 4)
+                {
+                    _mm_storeu_si128((__m128i*)(dst + x * 4), _v8);
+                }
+                else
+                {
+                    // every 4 byte store spills into the next pixel, which is written afterwards
+                    unsigned char* outptr = dst + x * 3;
+                    int v4[4];
+                    v4[0] = _mm_cvtsi128_si32(_v8);
+                    v4[1] = _mm_cvtsi128_si32(_mm_srli_si128(_v8, 4));
+                    v4[2] = _mm_cvtsi128_si32(_mm_srli_si128(_v8, 8));
+                    v4[3] = _mm_cvtsi128_si32(_mm_srli_si128(_v8, 12));
+                    memcpy(outptr, &v4[0], 4);
+                    memcpy(outptr + 3, &v4[1], 4);
+                    memcpy(outptr + 6, &v4[2], 4);
+                    memcpy(outptr + 9, &v4[3], 3);
+                }
+            }
+        }
+#endif // __SSE2__
+        for (; x<end; x++)
+        {
+            const int X = X0 + adelta[x];
+            const int Y = Y0 + bdelta[x];
+            const int fx = X & fmask;
+            const int fy = Y & fmask;
+            const int alpha0 = (1 << warpaffine_bits) - fx;
+            const int alpha1 = fx;
+            const int beta0 = (1 << warpaffine_bits) - fy;
+            const int beta1 = fy;
+
+            const unsigned char* p0 = src + (Y >> warpaffine_bits) * srcstride + (X >> warpaffine_bits) * cn;
+            const unsigned char* p1 = p0 + srcstride;
+
+            for (int c = 0; c < cn; c++)
+            {
+                dst[x * cn + c] = WARPAFFINE_BLEND(p0[c], p0[cn + c], p1[c], p1[cn + c]);
+            }
+        }
+    }
+}
+
+#undef WARPAFFINE_BLEND
+
+// per pixel coordinate steps of the inverse transform, adelta and bdelta hold w values
+static void warpaffine_coeffs(const float* tm, int w, float* tm_inv, int* adelta, int* bdelta)
+{
+    invert_affine_transform(tm, tm_inv);
+
+    for (int x = 0; x < w; x++)
+    {
+        adelta[x] = warpaffine_fixed(tm_inv[0] * x);
+        bdelta[x] = warpaffine_fixed(tm_inv[3] * x);
+    }
+}
+
+static void warpaffine_bilinear(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int cn, const float* tm, int border_type, unsigned int v, const Option& opt)
+{
+    const unsigned char border_color[4] = { (unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24) };
+
+    float tm_inv[6];
+    std::vector<int> delta(w * 2);
+    int* adelta = &delta[0];
+    int* bdelta = &delta[w];
+    warpaffine_coeffs(tm, w, tm_inv, adelta, bdelta);
+
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= warpaffine_parallel_size)
+    for (int y = 0; y < h; y++)
+    {
+        const int X0 = warpaffine_fixed(tm_inv[1] * y + tm_inv[2]);
+        const int Y0 = warpaffine_fixed(tm_inv[4] * y + tm_inv[5]);
+
+        warpaffine_bilinear_row(src, srcw, srch, srcw * cn, dst + w * cn * y, w, cn, adelta, bdelta, X0, Y0, border_type, border_color);
+    }
+}
+
+// images with at least this many source pixels are area resized with one thread per row block
+static const int resize_area_parallel_size = 512 * 512;
+
+// acc = S * b for the first source row of a dst row, acc += S * b for the others
+static void resize_area_vresize(const unsigned char* S, float* acc, float b, int n, bool first)
+{
+    int x = 0;
+#if __AVX2__
+    {
+        __m256 _b = _mm256_set1_ps(b);
+        for (; x+7<n; x+=8)
+        {
+            __m256 _S = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(S + x))));
+            __m256 _acc = first ? _mm256_setzero_ps() : _mm256_loadu_ps(acc + x);
+            _mm256_storeu_ps(acc + x, _mm256_add_ps(_acc, _mm256_mul_ps(_S, _b)));
+        }
+    }
+#elif __SSE2__
+    {
+        __m128 _b = _mm_set1_ps(b);
+        __m128i _zero = _mm_setzero_si128();
+        for (; x+7<n; x+=8)
+        {
+            __m128i _S16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(S + x)), _zero);
+            __m128 _S0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_S16, _zero));
+            __m128 _S1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(_S16, _zero));
+            __m128 _acc0 = first ? _mm_setzero_ps() : _mm_loadu_ps(acc + x);
+            __m128 _acc1 = first ? _mm_setzero_ps() : _mm_loadu_ps(acc + x + 4);
+            _mm_storeu_ps(acc + x, _mm_add_ps(_acc0, _mm_mul_ps(_S0, _b)));
+            _mm_storeu_ps(acc + x + 4, _mm_add_ps(_acc1, _mm_mul_ps(_S1, _b)));
+        }
+    }
+#endif // __AVX2__
+    for (; x<n; x++)
+    {
+        acc[x] = (first ? 0.f : acc[x]) + S[x] * b;
+    }
+}
+
+// sum = S for the first equally weighted source row of a dst row, sum += S for the others
+static void resize_area_vsum(const unsigned char* S, unsigned short* sum, int n, bool first)
+{
+    int x = 0;
+#if __AVX2__
+    for (; x+15<n; x+=16)
+    {
+        __m256i _S = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(S + x)));
+        __m256i _sum = first ? _S : _mm256_add_epi16(_mm256_loadu_si256((const __m256i*)(sum + x)), _S);
+        _mm256_storeu_si256((__m256i*)(sum + x), _sum);
+    }
+#elif __SSE2__
+    __m128i _zero = _mm_setzero_si128();
+    for (; x+15<n; x+=16)
+    {
+        __m128i _S = _mm_loadu_si128((const __m128i*)(S + x));
+        __m128i _S0 = _mm_unpacklo_epi8(_S, _zero);
+        __m128i _S1 = _mm_unpackhi_epi8(_S, _zero);
+        if (!first)
+        {
+            _S0 = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(sum + x)), _S0);
+            _S1 = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(sum + x + 8)), _S1);
+        }
+        _mm_storeu_si128((__m128i*)(sum + x), _S0);
+        _mm_storeu_si128((__m128i*)(sum + x + 8), _S1);
+    }
+#endif // __AVX2__
+    for (; x<n; x++)
+    {
+        sum[x] = (first ? 0 : sum[x]) + S[x];
+    }
+}
+
+// acc = sum * b or acc += sum * b
+static void resize_area_vsum_flush(const unsigned short* sum, float* acc, float b, int n, bool first)
+{
+    int x = 0;
+#if __SSE2__
+    __m128 _b = _mm_set1_ps(b);
+    __m128i _zero = _mm_setzero_si128();
+    for (; x+7<n; x+=8)
+    {
+        __m128i _sum = _mm_loadu_si128((const __m128i*)(sum + x));
+        __m128 _S0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_sum, _zero));
+        __m128 _S1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(_sum, _zero));
+        __m128 _acc0 = first ? _mm_setzero_ps() : _mm_loadu_ps(acc + x);
+        __m128 _acc1 = first ? _mm_setzero_ps() : _mm_loadu_ps(acc + x + 4);
+        _mm_storeu_ps(acc + x, _mm_add_ps(_acc0, _mm_mul_ps(_S0, _b)));
+        _mm_storeu_ps(acc + x + 4, _mm_add_ps(_acc1, _mm_mul_ps(_S1, _b)));
+    }
+#endif // __SSE2__
+    for (; x<n; x++)
+    {
+        acc[x] = (first ? 0.f : acc[x]) + sum[x] * b;
+    }
+}
+
+// area resize output rows [dy0, dy1), a source row is read once for every output row it overlaps
+// the fully covered source rows share one weight and are summed as integers
+static void resize_area_rows(const unsigned char* src, int srcw, unsigned char* dst, int w, int cn, const int* xtab, const int* xidx, const float* xalpha, const int* ytab, const int* yidx, const float* ybeta, int dy0, int dy1)
+{
+    Mat accbuf(srcw*cn+1);
+    Mat sumbuf(srcw*cn, (size_t)2u);
+    Mat rowsbuf(w*cn+1);
+    float* acc = accbuf;
+    unsigned short* sum = (unsigned short*)sumbuf.data;
+    float* rows = rowsbuf;
+    acc[srcw*cn] = 0.f;
+
+    const int n = srcw * cn;
+
+    for (int dy = dy0; dy < dy1; dy++)
+    {
+        float bmax = 0.f;
+        for (int k = ytab[dy]; k < ytab[dy + 1]; k++)
+        {
+            bmax = std::max(bmax, ybeta[k]);
+        }
+
+        bool acc_first = true;
+        int nsum = 0;
+        for (int k = ytab[dy]; k < ytab[dy + 1]; k++)
+        {
+            const unsigned char* S = src + srcw * cn * yidx[k];
+
+            if (ybeta[k] != bmax)
+            {
+                resize_area_vresize(S, acc, ybeta[k], n, acc_first);
+                acc_first = false;
+                continue;
+            }
+
+            resize_area_vsum(S, sum, n, nsum == 0);
+            nsum++;
+
+            // 257 rows of 255 fit in 16 bits
+            if (nsum == 257)
+            {
+                resize_area_vsum_flush(sum, acc, bmax, n, acc_first);
+                acc_first = false;
+                nsum = 0;
+            }
+        }
+        if (nsum > 0)
+        {
+            resize_area_vsum_flush(sum, acc, bmax, n, acc_first);
+        }
+
+        resize_area_hresize(acc, rows, w, cn, xtab, xidx, xalpha);
+
+        // round to nearest
+        unsigned char* Dp = dst + w * cn * dy;
+        int x = 0;
+#if __SSE2__
+        __m128 _half = _mm_set1_ps(0.5f);
+        for (; x+7<w*cn; x+=8)
+        {
+            __m128i _D0 = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(rows + x), _half));
+            __m128i _D1 = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(rows + x + 4), _half));
+            __m128i _D = _mm_packs_epi32(_D0, _D1);
+            _mm_storel_epi64((__m128i*)(Dp + x), _mm_packus_epi16(_D, _D));
+        }
+#endif // __SSE2__
+        for (; x<w*cn; x++)
+        {
+            Dp[x] = (unsigned char)std::min((int)(rows[x] + 0.5f), 255);
+        }
+    }
+}
+
+static void resize_area_pixels(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int cn, const Option& opt)
+{
+    std::vector<int> tab(w + 1 + h + 1);
+    std::vector<int> idx(srcw + w * 2 + srch + h * 2);
+    std::vector<float> alpha(srcw + w * 2 + srch + h * 2);
+    int* xtab = &tab[0];
+    int* ytab = &tab[w + 1];
+    int* xidx = &idx[0];
+    int* yidx = &idx[srcw + w * 2];
+    float* xalpha = &alpha[0];
+    float* ybeta = &alpha[srcw + w * 2];
+
+    resize_area_coeffs(srcw, w, xtab, xidx, xalpha);
+    resize_area_coeffs(srch, h, ytab, yidx, ybeta);
+
+    // one block of output rows per thread
+    const int nblocks = srcw * srch >= resize_area_parallel_size ? std::min(opt.num_threads, h) : 1;
+
+    #pragma omp parallel for num_threads(nblocks)
+    for (int t=0; t<nblocks; t++)
+    {
+        resize_area_rows(src, srcw, dst, w, cn, xtab, xidx, xalpha, ytab, yidx, ybeta, h * t / nblocks, h * (t + 1) / nblocks);
+    }
+}
+
+#if !__ARM_NEON
+// images with at least this many output pixels are resized with one thread per row block
+static const int resize_parallel_size = 256 * 256;
+
+// rows[dx] = (S[sx] * a0 + S[sx + cn] * a1) >> 4 for every channel, xofs is in bytes
+static void resize_hresize(const unsigned char* S, short* rows, const int* xofs, const short* ialpha, int w, int cn)
+{
+    int dx = 0;
+#if __SSE2__
+    __m128i _zero = _mm_setzero_si128();
+    if (cn == 1)
+    {
+        for (; dx+7<w; dx+=8)
+        {
+            // gather the two taps of 8 pixels as u8 pairs
+            const unsigned char* Sp0 = S + xofs[dx];
+            const unsigned char* Sp1 = S + xofs[dx + 1];
+            const unsigned char* Sp2 = S + xofs[dx + 2];
+            const unsigned char* Sp3 = S + xofs[dx + 3];
+            const unsigned char* Sp4 = S + xofs[dx + 4];
+            const unsigned char* Sp5 = S + xofs[dx + 5];
+            const unsigned char* Sp6 = S + xofs[dx + 6];
+            const unsigned char* Sp7 = S + xofs[dx + 7];
+
+            __m128i _S = _mm_cvtsi32_si128(Sp0[0] | (Sp0[1] << 8));
+            _S = _mm_insert_epi16(_S, Sp1[0] | (Sp1[1] << 8), 1);
+            _S = _mm_insert_epi16(_S, Sp2[0] | (Sp2[1] << 8), 2);
+            _S = _mm_insert_epi16(_S, Sp3[0] | (Sp3[1] << 8), 3);
+            _S = _mm_insert_epi16(_S, Sp4[0] | (Sp4[1] << 8), 4);
+            _S = _mm_insert_epi16(_S, Sp5[0] | (Sp5[1] << 8), 5);
+            _S = _mm_insert_epi16(_S, Sp6[0] | (Sp6[1] << 8), 6);
+            _S = _mm_insert_epi16(_S, Sp7[0] | (Sp7[1] << 8), 7);
+
+            __m128i _S0 = _mm_unpacklo_epi8(_S, _zero);
+            __m128i _S1 = _mm_unpackhi_epi8(_S, _zero);
+            __m128i _a0 = _mm_loadu_si128((const __m128i*)(ialpha + dx * 2));
+            __m128i _a1 = _mm_loadu_si128((const __m128i*)(ialpha + dx * 2 + 8));
+
+            __m128i _rows0 = _mm_srai_epi32(_mm_madd_epi16(_S0, _a0), 4);
+            __m128i _rows1 = _mm_srai_epi32(_mm_madd_epi16(_S1, _a1), 4);
+
+            _mm_storeu_si128((__m128i*)(rows + dx), _mm_packs_epi32(_rows0, _rows1));
+        }
+    }
+    if (cn == 2)
+    {
+        for (; dx+3<w; dx+=4)
+        {
+            int v[4];
+            for (int k=0; k<4; k++)
+            {
+                memcpy(&v[k], S + xofs[dx + k], 4);
+            }
+
+            // c0t0 c1t0 c0t1 c1t1 -> c0t0 c0t1 c1t0 c1t1
+            __m128i _S = _mm_setr_epi32(v[0], v[1], v[2], v[3]);
+            __m128i _S0 = _mm_unpacklo_epi8(_S, _zero);
+            __m128i _S1 = _mm_unpackhi_epi8(_S, _zero);
+            _S0 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_S0, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+            _S1 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_S1, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+
+            // a0 a1 of each pixel repeated for both channels
+            __m128i _a = _mm_loadu_si128((const __m128i*)(ialpha + dx * 2));
+            __m128i _a0 = _mm_unpacklo_epi32(_a, _a);
+            __m128i _a1 = _mm_unpackhi_epi32(_a, _a);
+
+            __m128i _rows0 = _mm_srai_epi32(_mm_madd_epi16(_S0, _a0), 4);
+            __m128i _rows1 = _mm_srai_epi32(_mm_madd_epi16(_S1, _a1), 4);
+
+            _mm_storeu_si128((__m128i*)(rows + dx * 2), _mm_packs_epi32(_rows0, _rows1));
+        }
+    }
+    if (cn == 3)
+    {
+        // one pixel per step, the 4th lane spills into the next pixel which overwrites it, rows has one spare element
+        for (; dx<w; dx++)
+        {
+            const unsigned char* Sp = S + xofs[dx];
+
+            int v0;
+            int v1;
+            memcpy(&v0, Sp, 4);
+            memcpy(&v1, Sp + 2, 4);
+
+            __m128i _St0 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v0), _zero);
+            __m128i _St1 = _mm_unpacklo_epi8(_mm_srli_epi32(_mm_cvtsi32_si128(v1), 8), _zero);
+            __m128i _S = _mm_unpacklo_epi16(_St0, _St1);
+
+            int a;
+            memcpy(&a, ialpha + dx * 2, 4);
+
+            __m128i _rows = _mm_srai_epi32(_mm_madd_epi16(_S, _mm_set1_epi32(a)), 4);
+
+            _mm_storel_epi64((__m128i*)(rows + dx * 3), _mm_packs_epi32(_rows, _rows));
+        }
+    }
+    if (cn == 4)
+    {
+        for (; dx+1<w; dx+=2)
+        {
+            __m128i _S0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(S + xofs[dx])), _zero);
+            __m128i _S1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(S + xofs[dx + 1])), _zero);
+
+            // t0 c0..c3 t1 c0..c3 -> c0t0 c0t1 c1t0 c1t1 ...
+            _S0 = _mm_unpacklo_epi16(_S0, _mm_srli_si128(_S0, 8));
+            _S1 = _mm_unpacklo_epi16(_S1, _mm_srli_si128(_S1, 8));
+
+            int a0;
+            int a1;
+            memcpy(&a0, ialpha + dx * 2, 4);
+            memcpy(&a1, ialpha + dx * 2 + 2, 4);
+
+            __m128i _rows0 = _mm_srai_epi32(_mm_madd_epi16(_S0, _mm_set1_epi32(a0)), 4);
+            __m128i _rows1 = _mm_srai_epi32(_mm_madd_epi16(_S1, _mm_set1_epi32(a1)), 4);
+
+            _mm_storeu_si128((__m128i*)(rows + dx * 4), _mm_packs_epi32(_rows0, _rows1));
+        }
+    }
+#endif // __SSE2__
+    for (; dx<w; dx++)
+    {
+        const unsigned char* Sp = S + xofs[dx];
+        short a0 = ialpha[dx * 2];
+        short a1 = ialpha[dx * 2 + 1];
+
+        for (int k=0; k<cn; k++)
+        {
+            rows[dx * cn + k] = (Sp[k]*a0 + Sp[k + cn]*a1) >> 4;
+        }
+    }
+}
+
+// D[x] = (rows0[x]*b0 + rows1[x]*b1) >> INTER_RESIZE_COEF_BITS, with the same intermediate rounding as the scalar code
+static void resize_vresize(const short* rows0p, const short* rows1p, short b0, short b1, unsigned char* Dp, int n)
+{
+    int x = 0;
+#if __AVX2__
+    {
+        __m256i _b0 = _mm256_set1_epi16(b0);
+        __m256i _b1 = _mm256_set1_epi16(b1);
+        __m256i _v2 = _mm256_set1_epi16(2);
+        for (; x+15<n; x+=16)
+        {
+            __m256i _rows0 = _mm256_loadu_si256((const __m256i*)(rows0p + x));
+            __m256i _rows1 = _mm256_loadu_si256((const __m256i*)(rows1p + x));
+
+            __m256i _acc = _mm256_add_epi16(_mm256_add_epi16(_mm256_mulhi_epi16(_rows0, _b0), _mm256_mulhi_epi16(_rows1, _b1)), _v2);
+            _acc = _mm256_srai_epi16(_acc, 2);
+
+            __m128i _D = _mm_packus_epi16(_mm256_castsi256_si128(_acc), _mm256_extracti128_si256(_acc, 1));
+            _mm_storeu_si128((__m128i*)(Dp + x), _D);
+        }
+    }
+#endif // __AVX2__
+#if __SSE2__
+    {
+        __m128i _b0 = _mm_set1_epi16(b0);
+        __m128i _b1 = _mm_set1_epi16(b1);
+        __m128i _v2 = _mm_set1_epi16(2);
+        for (; x+7<n; x+=8)
+        {
+            __m128i _rows0 = _mm_loadu_si128((const __m128i*)(rows0p + x));
+            __m128i _rows1 = _mm_loadu_si128((const __m128i*)(rows1p + x));
+
+            __m128i _acc = _mm_add_epi16(_mm_add_epi16(_mm_mulhi_epi16(_rows0, _b0), _mm_mulhi_epi16(_rows1, _b1)), _v2);
+            _acc = _mm_srai_epi16(_acc, 2);
+
+            _mm_storel_epi64((__m128i*)(Dp + x), _mm_packus_epi16(_acc, _acc));
+        }
+    }
+#endif // __SSE2__
+    for (; x<n; x++)
+    {
+        Dp[x] = (unsigned char)(( (short)((b0 * (short)rows0p[x]) >> 16) + (short)((b1 * (short)rows1p[x]) >> 16) + 2)>>2);
+    }
+}
+
+// resize output rows [dy0, dy1), xofs and yofs are premultiplied by cn like in the callers
+static void resize_bilinear_rows(const unsigned char* src, int srcw, unsigned char* dst, int w, int cn, const int* xofs, const short* ialpha, const int* yofs, const short* ibeta, int dy0, int dy1)
+{
+    Mat rowsbuf0(w*cn+1, (size_t)2u);
+    Mat rowsbuf1(w*cn+1, (size_t)2u);
+    short* rows0 = (short*)rowsbuf0.data;
+    short* rows1 = (short*)rowsbuf1.data;
+
+    int prev_sy1 = -2 * cn;
+
+    for (int dy = dy0; dy < dy1; dy++)
+    {
+        int sy = yofs[dy];
+
+        if (sy == prev_sy1)
+        {
+            // reuse all rows
+        }
+        else if (sy == prev_sy1 + cn)
+        {
+            // hresize one row
+            std::swap(rows0, rows1);
+            resize_hresize(src + srcw * (sy+cn), rows1, xofs, ialpha, w, cn);
+        }
+        else
+        {
+            // hresize two rows
+            resize_hresize(src + srcw * (sy), rows0, xofs, ialpha, w, cn);
+            resize_hresize(src + srcw * (sy+cn), rows1, xofs, ialpha, w, cn);
+        }
+
+        prev_sy1 = sy;
+
+        // vresize
+        resize_vresize(rows0, rows1, ibeta[dy*2], ibeta[dy*2 + 1], dst + w * cn * dy, w * cn);
+    }
+}
+
+static void resize_bilinear_rows_parallel(const unsigned char* src, int srcw, unsigned char* dst, int w, int h, int cn, const int* xofs, const short* ialpha, const int* yofs, const short* ibeta, const Option& opt)
+{
+    // one block of output rows per thread, each block hresizes its own first source rows
+    const int nblocks = w * h >= resize_parallel_size ? std::min(opt.num_threads, h) : 1;
+
+    #pragma omp parallel for num_threads(nblocks)
+    for (int t=0; t<nblocks; t++)
+    {
+        resize_bilinear_rows(src, srcw, dst, w, cn, xofs, ialpha, yofs, ibeta, h * t / nblocks, h * (t + 1) / nblocks);
+    }
+}
+
+// fixed point bilinear coefficients along one axis, the same as the resize_bilinear_c* setup, ofs is premultiplied by cn
+static void resize_bilinear_coeffs(int srcw, int w, int cn, int* ofs, short* alpha)
+{
+    const int INTER_RESIZE_COEF_BITS=11;
+    const int INTER_RESIZE_COEF_SCALE=1 << INTER_RESIZE_COEF_BITS;
+
+    double scale = (double)srcw / w;
+
+#define SATURATE_CAST_SHORT(X) (short)::std::min(::std::max((int)(X + (X >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), SHRT_MAX);
+
+    for (int dx = 0; dx < w; dx++)
+    {
+        float fx = (float)((dx + 0.5) * scale - 0.5);
+        int sx = floor(fx);
+        fx -= sx;
+
+        if (sx < 0)
+        {
+            sx = 0;
+            fx = 0.f;
+        }
+        if (sx >= srcw - 1)
+        {
+            sx = srcw - 2;
+            fx = 1.f;
+        }
+
+        ofs[dx] = sx*cn;
+
+        float a0 = (1.f - fx) * INTER_RESIZE_COEF_SCALE;
+        float a1 =        fx  * INTER_RESIZE_COEF_SCALE;
+
+        alpha[dx*2    ] = SATURATE_CAST_SHORT(a0);
+        alpha[dx*2 + 1] = SATURATE_CAST_SHORT(a1);
+    }
+
+#undef SATURATE_CAST_SHORT
+}
+
+// outptr[x] = ptr[x * cn] * scale + bias
+static void resize_u8_to_float_scale_bias(const unsigned char* ptr, int cn, float* outptr, int w, float scale, float bias)
+{
+    int x = 0;
+    if (cn == 1)
+    {
+#if __AVX2__
+        __m256 _scale8 = _mm256_set1_ps(scale);
+        __m256 _bias8 = _mm256_set1_ps(bias);
+        for (; x+7<w; x+=8)
+        {
+            __m256 _p = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(ptr + x))));
+            _mm256_storeu_ps(outptr + x, _mm256_fmadd_ps(_p, _scale8, _bias8));
+        }
+#endif // __AVX2__
+#if __SSE2__
+        __m128i _zero = _mm_setzero_si128();
+        __m128 _scale = _mm_set1_ps(scale);
+        __m128 _bias = _mm_set1_ps(bias);
+        for (; x+7<w; x+=8)
+        {
+            __m128i _p16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(ptr + x)), _zero);
+            __m128 _p0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_p16, _zero));
+            __m128 _p1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(_p16, _zero));
+            _mm_storeu_ps(outptr + x, _mm_add_ps(_mm_mul_ps(_p0, _scale), _bias));
+            _mm_storeu_ps(outptr + x + 4, _mm_add_ps(_mm_mul_ps(_p1, _scale), _bias));
+        }
+#endif // __SSE2__
+    }
+    for (; x<w; x++)
+    {
+        outptr[x] = ptr[x * cn] * scale + bias;
+    }
+}
+
+// interleaved 3 or 4 channels to planes in one pass, channels with a null outptr are dropped
+static void resize_u8_to_float_scale_bias_planar(const unsigned char* ptr, int cn, float* const* outptr, int w, const float* scale, const float* bias)
+{
+    float* ptr0 = outptr[0];
+    float* ptr1 = outptr[1];
+    float* ptr2 = outptr[2];
+    float* ptr3 = outptr[3];
+
+    int x = 0;
+#if __SSE2__
+    __m128 _scale0 = _mm_set1_ps(scale[0]);
+    __m128 _scale1 = _mm_set1_ps(scale[1]);
+    __m128 _scale2 = _mm_set1_ps(scale[2]);
+    __m128 _bias0 = _mm_set1_ps(bias[0]);
+    __m128 _bias1 = _mm_set1_ps(bias[1]);
+    __m128 _bias2 = _mm_set1_ps(bias[2]);
+    if (cn == 3)
+    {
+        for (; x+15<w; x+=16)
+        {
+            __m128 _v[12];
+            pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)ptr), _v[0], _v[1], _v[2], _v[3]);
+            pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)(ptr + 16)), _v[4], _v[5], _v[6], _v[7]);
+            pixel_u8_to_ps(_mm_loadu_si128((const __m128i*)(ptr + 32)), _v[8], _v[9], _v[10], _v[11]);
+
+            for (int k=0; k<4; k++)
+            {
+                __m128 _p0, _p1, _p2;
+                pixel_deinterleave3_ps(_v[k * 3], _v[k * 3 + 1], _v[k * 3 + 2], _p0, _p1, _p2);
+
+                _mm_storeu_ps(ptr0 + x + k * 4, _mm_add_ps(_mm_mul_ps(_p0, _scale0), _bias0));
+                _mm_storeu_ps(ptr1 + x + k * 4, _mm_add_ps(_mm_mul_ps(_p1, _scale1), _bias1));
+                _mm_storeu_ps(ptr2 + x + k * 4, _mm_add_ps(_mm_mul_ps(_p2, _scale2), _bias2));
+            }
+
+            ptr += 3*16;
+        }
+    }
+    if (cn == 4)
+    {
+        // every pixel is one 32bit lane
+        __m128i _mask = _mm_set1_epi32(0xff);
+        __m128 _scale3 = _mm_set1_ps(scale[3]);
+        __m128 _bias3 = _mm_set1_ps(bias[3]);
+        for (; x+3<w; x+=4)
+        {
+            __m128i _v = _mm_loadu_si128((const __m128i*)ptr);
+
+            __m128 _p0 = _mm_cvtepi32_ps(_mm_and_si128(_v, _mask));
+            __m128 _p1 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(_v, 8), _mask));
+            __m128 _p2 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(_v, 16), _mask));
+
+            _mm_storeu_ps(ptr0 + x, _mm_add_ps(_mm_mul_ps(_p0, _scale0), _bias0));
+            _mm_storeu_ps(ptr1 + x, _mm_add_ps(_mm_mul_ps(_p1, _scale1), _bias1));
+            _mm_storeu_ps(ptr2 + x, _mm_add_ps(_mm_mul_ps(_p2, _scale2), _bias2));
+            if (ptr3)
+            {
+                __m128 _p3 = _mm_cvtepi32_ps(_mm_srli_epi32(_v, 24));
+                _mm_storeu_ps(ptr3 + x, _mm_add_ps(_mm_mul_ps(_p3, _scale3), _bias3));
+            }
+
+            ptr += 4*4;
+        }
+    }
+#endif // __SSE2__
+    for (; x<w; x++)
+    {
+        ptr0[x] = ptr[0] * scale[0] + bias[0];
+        ptr1[x] = ptr[1] * scale[1] + bias[1];
+        ptr2[x] = ptr[2] * scale[2] + bias[2];
+        if (ptr3)
+        {
+            ptr3[x] = ptr[3] * scale[3] + bias[3];
+        }
+
+        ptr += cn;
+    }
+}
+
+// pixel layout of the fused preprocessing
+struct resize_normalize_param
+{
+    int cn;             // source channels
+    int outc;           // output channels
+    int cidx[4];        // source channel of every output channel
+    int gray_coeffs[3]; // nonzero for gray conversion
+    float scale[4];
+    float bias[4];
+
+    // yuv420 source, every row is converted to rgb before resizing
+    int yuv;
+    const unsigned char* uptr;
+    const unsigned char* vptr;
+    int uvstride;
+    int uvstep;
+};
+
+// source row y of the roi, converted into rgb for yuv sources
+static const unsigned char* resize_normalize_source_row(const unsigned char* src, int srcstride, int srcw, const resize_normalize_param& p, int y, unsigned char* rgb)
+{
+    if (!p.yuv)
+        return src + srcstride * y;
+
+    yuv420_to_rgb_row(src + srcstride * y, p.uptr + p.uvstride * (y / 2), p.vptr + p.uvstride * (y / 2), p.uvstep, rgb, srcw);
+    return rgb;
+}
+
+// convert and normalize one u8 row into output row dy, gray is a scratch row for gray conversion
+static void resize_normalize_row(const unsigned char* row, Mat& m, int dy, const resize_normalize_param& p, unsigned char* gray)
+{
+    const int w = m.w;
+    const int cn = p.cn;
+
+    if (p.gray_coeffs[0])
+    {
+        for (int x = 0; x < w; x++)
+        {
+            const unsigned char* rgb = row + x * cn;
+            gray[x] = (rgb[0] * p.gray_coeffs[0] + rgb[1] * p.gray_coeffs[1] + rgb[2] * p.gray_coeffs[2]) >> 8;
+        }
+
+        resize_u8_to_float_scale_bias(gray, 1, m.channel(0).row(dy), w, p.scale[0], p.bias[0]);
+        return;
+    }
+
+    if (cn == 1)
+    {
+        for (int q = 0; q < p.outc; q++)
+        {
+            resize_u8_to_float_scale_bias(row, 1, m.channel(q).row(dy), w, p.scale[q], p.bias[q]);
+        }
+        return;
+    }
+
+    // output row and normalization of every source channel
+    float* outptr[4] = { 0, 0, 0, 0 };
+    float scale[4] = { 0.f, 0.f, 0.f, 0.f };
+    float bias[4] = { 0.f, 0.f, 0.f, 0.f };
+    for (int q = 0; q < p.outc; q++)
+    {
+        outptr[p.cidx[q]] = m.channel(q).row(dy);
+        scale[p.cidx[q]] = p.scale[q];
+        bias[p.cidx[q]] = p.bias[q];
+    }
+
+    resize_u8_to_float_scale_bias_planar(row, cn, outptr, w, scale, bias);
+}
+
+// resize, convert and normalize output rows [dy0, dy1), one u8 row stays in cache between the three steps
+static void resize_normalize_rows(const unsigned char* src, int srcstride, int srcw, int srch, Mat& m, const resize_normalize_param& p,
+                                  const int* xofs, const short* ialpha, const int* yofs, const short* ibeta, int dy0, int dy1)
+{
+    const int w = m.w;
+    const int cn = p.cn;
+    const bool resize = srcw != w || srch != m.h;
+
+    Mat rowsbuf0;
+    Mat rowsbuf1;
+    Mat rowbuf;
+    if (resize)
+    {
+        rowsbuf0.create(w*cn+1, (size_t)2u);
+        rowsbuf1.create(w*cn+1, (size_t)2u);
+        rowbuf.create(w*cn, (size_t)1u);
+    }
+    short* rows0 = rowsbuf0;
+    short* rows1 = rowsbuf1;
+
+    Mat graybuf;
+    if (p.gray_coeffs[0])
+    {
+        graybuf.create(w, (size_t)1u);
+    }
+    unsigned char* gray = graybuf;
+
+    Mat srcrowbuf;
+    if (p.yuv)
+    {
+        srcrowbuf.create(srcw*cn, (size_t)1u);
+    }
+    unsigned char* srcrow = srcrowbuf;
+
+    int prev_sy1 = -2;
+
+    for (int dy = dy0; dy < dy1; dy++)
+    {
+        const unsigned char* row;
+
+        if (!resize)
+        {
+            row = resize_normalize_source_row(src, srcstride, srcw, p, dy, srcrow);
+        }
+        else
+        {
+            int sy = yofs[dy];
+
+            if (sy == prev_sy1)
+            {
+                // reuse all rows
+            }
+            else if (sy == prev_sy1 + 1)
+            {
+                std::swap(rows0, rows1);
+                resize_hresize(resize_normalize_source_row(src, srcstride, srcw, p, sy+1, srcrow), rows1, xofs, ialpha, w, cn);
+            }
+            else
+            {
+                resize_hresize(resize_normalize_source_row(src, srcstride, srcw, p, sy, srcrow), rows0, xofs, ialpha, w, cn);
+                resize_hresize(resize_normalize_source_row(src, srcstride, srcw, p, sy+1, srcrow), rows1, xofs, ialpha, w, cn);
+            }
+
+            prev_sy1 = sy;
+
+            resize_vresize(rows0, rows1, ibeta[dy*2], ibeta[dy*2 + 1], rowbuf, w * cn);
+
+            row = rowbuf;
+        }
+
+        resize_normalize_row(row, m, dy, p, gray);
+    }
+}
+
+// warp, convert and normalize output rows [dy0, dy1)
+static void warpaffine_normalize_rows(const unsigned char* src, int srcw, int srch, Mat& m, const resize_normalize_param& p,
+                                      const float* tm_inv, const int* adelta, const int* bdelta, int border_type, const unsigned char* border_color, int dy0, int dy1)
+{
+    const int w = m.w;
+    const int cn = p.cn;
+
+    Mat rowbuf(w*cn, (size_t)1u);
+    unsigned char* row = rowbuf;
+
+    Mat graybuf;
+    if (p.gray_coeffs[0])
+    {
+        graybuf.create(w, (size_t)1u);
+    }
+    unsigned char* gray = graybuf;
+
+    for (int dy = dy0; dy < dy1; dy++)
+    {
+        const int X0 = warpaffine_fixed(tm_inv[1] * dy + tm_inv[2]);
+        const int Y0 = warpaffine_fixed(tm_inv[4] * dy + tm_inv[5]);
+
+        warpaffine_bilinear_row(src, srcw, srch, srcw * cn, row, w, cn, adelta, bdelta, X0, Y0, border_type, border_color);
+
+        resize_normalize_row(row, m, dy, p, gray);
+    }
+}
+#endif // !__ARM_NEON
+
+void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
 {
     const int INTER_RESIZE_COEF_BITS=11;
     const int INTER_RESIZE_COEF_SCALE=1 << INTER_RESIZE_COEF_BITS;
@@ -102,6 +1197,7 @@ void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned c
 
 #undef SATURATE_CAST_SHORT
 
+#if __ARM_NEON
     // loop body
     Mat rowsbuf0(w, (size_t)2u);
     Mat rowsbuf1(w, (size_t)2u);
@@ -174,14 +1270,9 @@ void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned c
         short* rows1p = rows1;
         unsigned char* Dp = dst + w * (dy);
 
-#if __ARM_NEON
         int nn = w >> 3;
-#else
-        int nn = 0;
-#endif
         int remain = w - (nn << 3);
 
-#if __ARM_NEON
 #if __aarch64__
         int16x4_t _b0 = vdup_n_s16(b0);
         int16x4_t _b1 = vdup_n_s16(b1);
@@ -266,7 +1357,6 @@ void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned c
         );
         }
 #endif // __aarch64__
-#endif // __ARM_NEON
         for ( ; remain; --remain )
         {
 //             D[x] = (rows0[x]*b0 + rows1[x]*b1) >> INTER_RESIZE_COEF_BITS;
@@ -275,11 +1365,14 @@ void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned c
 
         ibeta += 2;
     }
+#else
+    resize_bilinear_rows_parallel(src, srcw, dst, w, h, 1, xofs, ialpha, yofs, ibeta, opt);
+#endif // __ARM_NEON
 
     delete[] buf;
 }
 
-void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h)
+void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
 {
     const int INTER_RESIZE_COEF_BITS=11;
     const int INTER_RESIZE_COEF_SCALE=1 << INTER_RESIZE_COEF_BITS;
@@ -357,6 +1450,7 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned c
 
 #undef SATURATE_CAST_SHORT
 
+#if __ARM_NEON
     // loop body
     Mat rowsbuf0(w*2+2, (size_t)2u);
     Mat rowsbuf1(w*2+2, (size_t)2u);
@@ -388,7 +1482,6 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned c
                 int sx = xofs[dx];
 
                 const unsigned char* S1p = S1 + sx;
-#if __ARM_NEON
                 int16x4_t _a0a1XX = vld1_s16(ialphap);
                 int16x4_t _a0a0a1a1 = vzip_s16(_a0a1XX, _a0a1XX).val[0];
                 uint8x8_t _S1 = uint8x8_t();
@@ -405,13 +1498,6 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned c
                 int32x4_t _rows1 = vcombine_s32(_rows1low, vget_high_s32(_S1ma0a1));
                 int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
                 vst1_s16(rows1p, _rows1_sr4);
-#else
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
-
-                rows1p[0] = (S1p[0]*a0 + S1p[2]*a1) >> 4;
-                rows1p[1] = (S1p[1]*a0 + S1p[3]*a1) >> 4;
-#endif // __ARM_NEON
 
                 ialphap += 2;
                 rows1p += 2;
@@ -434,7 +1520,6 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned c
 
                 const unsigned char* S0p = S0 + sx;
                 const unsigned char* S1p = S1 + sx;
-#if __ARM_NEON
                 int16x4_t _a0 = vdup_n_s16(a0);
                 int16x4_t _a1 = vdup_n_s16(a1);
                 uint8x8_t _S0 = uint8x8_t();
@@ -461,12 +1546,6 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned c
                 int16x4_t _rows1_sr4 = vext_s16(_rows01_sr4, _rows01_sr4, 2);
                 vst1_s16(rows0p, _rows01_sr4);
                 vst1_s16(rows1p, _rows1_sr4);
-#else
-                rows0p[0] = (S0p[0]*a0 + S0p[2]*a1) >> 4;
-                rows0p[1] = (S0p[1]*a0 + S0p[3]*a1) >> 4;
-                rows1p[0] = (S1p[0]*a0 + S1p[2]*a1) >> 4;
-                rows1p[1] = (S1p[1]*a0 + S1p[3]*a1) >> 4;
-#endif // __ARM_NEON
 
                 ialphap += 2;
                 rows0p += 2;
@@ -484,14 +1563,9 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned c
         short* rows1p = rows1;
         unsigned char* Dp = dst + w * 2 * (dy);
 
-#if __ARM_NEON
         int nn = (w * 2) >> 3;
-#else
-        int nn = 0;
-#endif
         int remain = (w * 2) - (nn << 3);
 
-#if __ARM_NEON
 #if __aarch64__
         int16x4_t _b0 = vdup_n_s16(b0);
         int16x4_t _b1 = vdup_n_s16(b1);
@@ -576,7 +1650,6 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned c
         );
         }
 #endif // __aarch64__
-#endif // __ARM_NEON
         for ( ; remain; --remain )
         {
 //             D[x] = (rows0[x]*b0 + rows1[x]*b1) >> INTER_RESIZE_COEF_BITS;
@@ -585,11 +1658,14 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, unsigned c
 
         ibeta += 2;
     }
+#else
+    resize_bilinear_rows_parallel(src, srcw, dst, w, h, 2, xofs, ialpha, yofs, ibeta, opt);
+#endif // __ARM_NEON
 
     delete[] buf;
 }
 
-void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h)
+void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
 {
     const int INTER_RESIZE_COEF_BITS=11;
     const int INTER_RESIZE_COEF_SCALE=1 << INTER_RESIZE_COEF_BITS;
@@ -667,6 +1743,7 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned c
 
 #undef SATURATE_CAST_SHORT
 
+#if __ARM_NEON
     // loop body
     Mat rowsbuf0(w*3+1, (size_t)2u);
     Mat rowsbuf1(w*3+1, (size_t)2u);
@@ -700,7 +1777,6 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned c
                 short a1 = ialphap[1];
 
                 const unsigned char* S1p = S1 + sx;
-#if __ARM_NEON
                 int16x4_t _a0 = vdup_n_s16(a0);
                 int16x4_t _a1 = vdup_n_s16(a1);
                 uint8x8_t _S1 = uint8x8_t();
@@ -719,11 +1795,6 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned c
                 _rows1 = vmlal_s16(_rows1, _S1high, _a1);
                 int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
                 vst1_s16(rows1p, _rows1_sr4);
-#else
-                rows1p[0] = (S1p[0]*a0 + S1p[3]*a1) >> 4;
-                rows1p[1] = (S1p[1]*a0 + S1p[4]*a1) >> 4;
-                rows1p[2] = (S1p[2]*a0 + S1p[5]*a1) >> 4;
-#endif // __ARM_NEON
 
                 ialphap += 2;
                 rows1p += 3;
@@ -746,7 +1817,6 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned c
 
                 const unsigned char* S0p = S0 + sx;
                 const unsigned char* S1p = S1 + sx;
-#if __ARM_NEON
                 int16x4_t _a0 = vdup_n_s16(a0);
                 int16x4_t _a1 = vdup_n_s16(a1);
                 uint8x8_t _S0 = uint8x8_t();
@@ -780,14 +1850,6 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned c
                 int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
                 vst1_s16(rows0p, _rows0_sr4);
                 vst1_s16(rows1p, _rows1_sr4);
-#else
-                rows0p[0] = (S0p[0]*a0 + S0p[3]*a1) >> 4;
-                rows0p[1] = (S0p[1]*a0 + S0p[4]*a1) >> 4;
-                rows0p[2] = (S0p[2]*a0 + S0p[5]*a1) >> 4;
-                rows1p[0] = (S1p[0]*a0 + S1p[3]*a1) >> 4;
-                rows1p[1] = (S1p[1]*a0 + S1p[4]*a1) >> 4;
-                rows1p[2] = (S1p[2]*a0 + S1p[5]*a1) >> 4;
-#endif // __ARM_NEON
 
                 ialphap += 2;
                 rows0p += 3;
@@ -805,14 +1867,9 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned c
         short* rows1p = rows1;
         unsigned char* Dp = dst + w * 3 * (dy);
 
-#if __ARM_NEON
         int nn = (w * 3) >> 3;
-#else
-        int nn = 0;
-#endif
         int remain = (w * 3) - (nn << 3);
 
-#if __ARM_NEON
 #if __aarch64__
         int16x4_t _b0 = vdup_n_s16(b0);
         int16x4_t _b1 = vdup_n_s16(b1);
@@ -897,7 +1954,6 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned c
         );
         }
 #endif // __aarch64__
-#endif // __ARM_NEON
         for ( ; remain; --remain )
         {
 //             D[x] = (rows0[x]*b0 + rows1[x]*b1) >> INTER_RESIZE_COEF_BITS;
@@ -906,11 +1962,14 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned c
 
         ibeta += 2;
     }
+#else
+    resize_bilinear_rows_parallel(src, srcw, dst, w, h, 3, xofs, ialpha, yofs, ibeta, opt);
+#endif // __ARM_NEON
 
     delete[] buf;
 }
 
-void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h)
+void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
 {
     const int INTER_RESIZE_COEF_BITS=11;
     const int INTER_RESIZE_COEF_SCALE=1 << INTER_RESIZE_COEF_BITS;
@@ -988,6 +2047,7 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
 
 #undef SATURATE_CAST_SHORT
 
+#if __ARM_NEON
     // loop body
     Mat rowsbuf0(w*4, (size_t)2u);
     Mat rowsbuf1(w*4, (size_t)2u);
@@ -1021,7 +2081,6 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
                 short a1 = ialphap[1];
 
                 const unsigned char* S1p = S1 + sx;
-#if __ARM_NEON
                 int16x4_t _a0 = vdup_n_s16(a0);
                 int16x4_t _a1 = vdup_n_s16(a1);
                 uint8x8_t _S1 = vld1_u8(S1p);
@@ -1032,12 +2091,6 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
                 _rows1 = vmlal_s16(_rows1, _S1high, _a1);
                 int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
                 vst1_s16(rows1p, _rows1_sr4);
-#else
-                rows1p[0] = (S1p[0]*a0 + S1p[4]*a1) >> 4;
-                rows1p[1] = (S1p[1]*a0 + S1p[5]*a1) >> 4;
-                rows1p[2] = (S1p[2]*a0 + S1p[6]*a1) >> 4;
-                rows1p[3] = (S1p[3]*a0 + S1p[7]*a1) >> 4;
-#endif // __ARM_NEON
 
                 ialphap += 2;
                 rows1p += 4;
@@ -1060,7 +2113,6 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
 
                 const unsigned char* S0p = S0 + sx;
                 const unsigned char* S1p = S1 + sx;
-#if __ARM_NEON
                 int16x4_t _a0 = vdup_n_s16(a0);
                 int16x4_t _a1 = vdup_n_s16(a1);
                 uint8x8_t _S0 = vld1_u8(S0p);
@@ -1079,16 +2131,6 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
                 int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
                 vst1_s16(rows0p, _rows0_sr4);
                 vst1_s16(rows1p, _rows1_sr4);
-#else
-                rows0p[0] = (S0p[0]*a0 + S0p[4]*a1) >> 4;
-                rows0p[1] = (S0p[1]*a0 + S0p[5]*a1) >> 4;
-                rows0p[2] = (S0p[2]*a0 + S0p[6]*a1) >> 4;
-                rows0p[3] = (S0p[3]*a0 + S0p[7]*a1) >> 4;
-                rows1p[0] = (S1p[0]*a0 + S1p[4]*a1) >> 4;
-                rows1p[1] = (S1p[1]*a0 + S1p[5]*a1) >> 4;
-                rows1p[2] = (S1p[2]*a0 + S1p[6]*a1) >> 4;
-                rows1p[3] = (S1p[3]*a0 + S1p[7]*a1) >> 4;
-#endif // __ARM_NEON
 
                 ialphap += 2;
                 rows0p += 4;
@@ -1106,14 +2148,9 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
         short* rows1p = rows1;
         unsigned char* Dp = dst + w * 4 * (dy);
 
-#if __ARM_NEON
         int nn = (w * 4) >> 3;
-#else
-        int nn = 0;
-#endif
         int remain = (w * 4) - (nn << 3);
 
-#if __ARM_NEON
 #if __aarch64__
         int16x4_t _b0 = vdup_n_s16(b0);
         int16x4_t _b1 = vdup_n_s16(b1);
@@ -1198,7 +2235,6 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
         );
         }
 #endif // __aarch64__
-#endif // __ARM_NEON
         for ( ; remain; --remain )
         {
 //             D[x] = (rows0[x]*b0 + rows1[x]*b1) >> INTER_RESIZE_COEF_BITS;
@@ -1207,11 +2243,14 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
 
         ibeta += 2;
     }
+#else
+    resize_bilinear_rows_parallel(src, srcw, dst, w, h, 4, xofs, ialpha, yofs, ibeta, opt);
+#endif // __ARM_NEON
 
     delete[] buf;
 }
 
-void resize_bilinear_yuv420sp(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h)
+void resize_bilinear_yuv420sp(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
 {
     // assert srcw % 2 == 0
     // assert srch % 2 == 0
@@ -1220,12 +2259,473 @@ void resize_bilinear_yuv420sp(const unsigned char* src, int srcw, int srch, unsi
 
     const unsigned char* srcY = src;
     unsigned char* dstY = dst;
-    resize_bilinear_c1(srcY, srcw, srch, dstY, w, h);
+    resize_bilinear_c1(srcY, srcw, srch, dstY, w, h, opt);
 
     const unsigned char* srcUV = src + srcw * srch;
     unsigned char* dstUV = dst + w * h;
-    resize_bilinear_c2(srcUV, srcw / 2, srch / 2, dstUV, w / 2, h / 2);
+    resize_bilinear_c2(srcUV, srcw / 2, srch / 2, dstUV, w / 2, h / 2, opt);
+}
+
+void resize_area_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
+{
+    return resize_area_pixels(src, srcw, srch, dst, w, h, 1, opt);
+}
+
+void resize_area_c2(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
+{
+    return resize_area_pixels(src, srcw, srch, dst, w, h, 2, opt);
+}
+
+void resize_area_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
+{
+    return resize_area_pixels(src, srcw, srch, dst, w, h, 3, opt);
+}
+
+void resize_area_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const Option& opt)
+{
+    return resize_area_pixels(src, srcw, srch, dst, w, h, 4, opt);
+}
+
+void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int border_type, unsigned int v, const Option& opt)
+{
+    return warpaffine_bilinear(src, srcw, srch, dst, w, h, 1, tm, border_type, v, opt);
+}
+
+void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int border_type, unsigned int v, const Option& opt)
+{
+    return warpaffine_bilinear(src, srcw, srch, dst, w, h, 3, tm, border_type, v, opt);
+}
+
+void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int border_type, unsigned int v, const Option& opt)
+{
+    return warpaffine_bilinear(src, srcw, srch, dst, w, h, 4, tm, border_type, v, opt);
+}
+
+void invert_affine_transform(const float* tm, float* tm_inv)
+{
+    float D = tm[0] * tm[4] - tm[1] * tm[3];
+    D = D != 0.f ? 1.f / D : 0.f;
+
+    float A11 = tm[4] * D;
+    float A22 = tm[0] * D;
+    float A12 = -tm[1] * D;
+    float A21 = -tm[3] * D;
+    float b1 = -A11 * tm[2] - A12 * tm[5];
+    float b2 = -A21 * tm[2] - A22 * tm[5];
+
+    tm_inv[0] = A11;
+    tm_inv[1] = A12;
+    tm_inv[2] = b1;
+    tm_inv[3] = A21;
+    tm_inv[4] = A22;
+    tm_inv[5] = b2;
+}
+
+void get_similarity_transform(const float* points_from, const float* points_to, int num_point, float* tm)
+{
+    // [ a -b tx ]
+    // [ b  a ty ]
+    double mx = 0, my = 0, mu = 0, mv = 0;
+    for (int i = 0; i < num_point; i++)
+    {
+        mx += points_from[i * 2];
+        my += points_from[i * 2 + 1];
+        mu += points_to[i * 2];
+        mv += points_to[i * 2 + 1];
+    }
+    mx /= num_point;
+    my /= num_point;
+    mu /= num_point;
+    mv /= num_point;
+
+    double sa = 0, sb = 0, sxx = 0;
+    for (int i = 0; i < num_point; i++)
+    {
+        double x = points_from[i * 2] - mx;
+        double y = points_from[i * 2 + 1] - my;
+        double u = points_to[i * 2] - mu;
+        double v = points_to[i * 2 + 1] - mv;
+
+        sa += x * u + y * v;
+        sb += x * v - y * u;
+        sxx += x * x + y * y;
+    }
+
+    double a = sxx != 0 ? sa / sxx : 1;
+    double b = sxx != 0 ? sb / sxx : 0;
+
+    tm[0] = (float)a;
+    tm[1] = (float)-b;
+    tm[2] = (float)(mu - (a * mx - b * my));
+    tm[3] = (float)b;
+    tm[4] = (float)a;
+    tm[5] = (float)(mv - (b * mx + a * my));
+}
+
+Mat Mat::from_pixels_resize_normalize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, const float* mean_vals, const float* norm_vals, Allocator* allocator)
+{
+    Option opt;
+    opt.blob_allocator = allocator;
+
+    return Mat::from_pixels_roi_resize_normalize(pixels, type, w, h, 0, 0, w, h, target_width, target_height, mean_vals, norm_vals, opt);
+}
+
+Mat Mat::from_pixels_resize_normalize(const unsigned char* pixels, int type, int w, int h, int target_width, int target_height, const float* mean_vals, const float* norm_vals, const Option& opt)
+{
+    return Mat::from_pixels_roi_resize_normalize(pixels, type, w, h, 0, 0, w, h, target_width, target_height, mean_vals, norm_vals, opt);
+}
+
+static int pixel_type_channels(int type)
+{
+    if (type == Mat::PIXEL_RGB || type == Mat::PIXEL_BGR)
+        return 3;
+    if (type == Mat::PIXEL_GRAY)
+        return 1;
+    if (type == Mat::PIXEL_RGBA)
+        return 4;
+    return 0;
+}
+
+#if !__ARM_NEON
+// channel order, gray conversion and normalization of the fused preprocessing
+static void resize_normalize_param_init(resize_normalize_param& p, int type_from, int type_to, const float* mean_vals, const float* norm_vals)
+{
+    p.cn = pixel_type_channels(type_from);
+    p.outc = pixel_type_channels(type_to);
+    for (int q = 0; q < 4; q++)
+    {
+        p.cidx[q] = q;
+    }
+    p.gray_coeffs[0] = 0;
+    p.gray_coeffs[1] = 0;
+    p.gray_coeffs[2] = 0;
+
+    if ((type_from == Mat::PIXEL_RGB && type_to == Mat::PIXEL_BGR) || (type_from == Mat::PIXEL_BGR && type_to == Mat::PIXEL_RGB) || (type_from == Mat::PIXEL_RGBA && type_to == Mat::PIXEL_BGR))
+    {
+        p.cidx[0] = 2;
+        p.cidx[2] = 0;
+    }
+    if (type_from == Mat::PIXEL_GRAY)
+    {
+        p.cidx[1] = 0;
+        p.cidx[2] = 0;
+    }
+    if (type_to == Mat::PIXEL_GRAY && p.cn > 1)
+    {
+        // coeffs for r g b = 0.299f, 0.587f, 0.114f
+        const int R2Y = 77;
+        const int G2Y = 150;
+        const int B2Y = 29;
+
+        p.gray_coeffs[0] = type_from == Mat::PIXEL_BGR ? B2Y : R2Y;
+        p.gray_coeffs[1] = G2Y;
+        p.gray_coeffs[2] = type_from == Mat::PIXEL_BGR ? R2Y : B2Y;
+    }
+
+    // the same arithmetic as substract_mean_normalize
+    for (int q = 0; q < p.outc; q++)
+    {
+        p.scale[q] = norm_vals ? norm_vals[q] : 1.f;
+        p.bias[q] = mean_vals ? (norm_vals ? -mean_vals[q] * norm_vals[q] : -mean_vals[q]) : 0.f;
+    }
+
+    p.yuv = 0;
+}
+#endif // !__ARM_NEON
+
+Mat Mat::from_pixels_roi_resize_normalize(const unsigned char* pixels, int type, int w, int h, int roix, int roiy, int roiw, int roih, int target_width, int target_height, const float* mean_vals, const float* norm_vals, Allocator* allocator)
+{
+    Option opt;
+    opt.blob_allocator = allocator;
+
+    return Mat::from_pixels_roi_resize_normalize(pixels, type, w, h, roix, roiy, roiw, roih, target_width, target_height, mean_vals, norm_vals, opt);
+}
+
+Mat Mat::from_pixels_roi_resize_normalize(const unsigned char* pixels, int type, int w, int h, int roix, int roiy, int roiw, int roih, int target_width, int target_height, const float* mean_vals, const float* norm_vals, const Option& opt)
+{
+    int type_from = type & PIXEL_FORMAT_MASK;
+    const int type_to = (type & PIXEL_CONVERT_MASK) ? (type >> PIXEL_CONVERT_SHIFT) : type_from;
+
+    // yuv sources are resized as rgb rows
+    const int yuv = type_from == PIXEL_NV21 || type_from == PIXEL_NV12 || type_from == PIXEL_I420 ? type_from : 0;
+    if (yuv)
+    {
+        if (w % 2 != 0 || h % 2 != 0 || roix % 2 != 0 || roiy % 2 != 0)
+            return Mat();
+
+        type_from = PIXEL_RGB;
+    }
+
+    const int cn = pixel_type_channels(type_from);
+    const int outc = pixel_type_channels(type_to);
+    if (cn == 0 || outc == 0)
+        return Mat();
+
+    if (roix < 0 || roiy < 0 || roiw <= 0 || roih <= 0 || roix + roiw > w || roiy + roih > h)
+        return Mat();
+
+    const int stride = yuv ? w : w * cn;
+    const unsigned char* roi = pixels + roiy * stride + roix * (yuv ? 1 : cn);
+
+    // chroma of the first roi pixel
+    const unsigned char* uptr = 0;
+    const unsigned char* vptr = 0;
+    int uvstride = 0;
+    int uvstep = 0;
+    if (yuv == PIXEL_NV21 || yuv == PIXEL_NV12)
+    {
+        const unsigned char* uv = pixels + w * h + roiy / 2 * w + roix;
+        uptr = yuv == PIXEL_NV21 ? uv + 1 : uv;
+        vptr = yuv == PIXEL_NV21 ? uv : uv + 1;
+        uvstride = w;
+        uvstep = 2;
+    }
+    if (yuv == PIXEL_I420)
+    {
+        uptr = pixels + w * h + roiy / 2 * (w / 2) + roix / 2;
+        vptr = uptr + w * h / 4;
+        uvstride = w / 2;
+        uvstep = 1;
+    }
+
+#if __ARM_NEON
+    // the neon resize kernels are faster than a fused scalar pass, resize first and normalize afterwards
+    const int type_rgb = !yuv ? type : type_to == type_from ? type_from : type_from | (type_to << PIXEL_CONVERT_SHIFT);
+
+    Mat m;
+    if (roiw == w && !yuv)
+    {
+        m = Mat::from_pixels_resize(roi, type_rgb, roiw, roih, target_width, target_height, opt);
+    }
+    else
+    {
+        Mat roi_pixels(roiw * cn, roih, (size_t)1u);
+        for (int i = 0; i < roih; i++)
+        {
+            if (yuv)
+            {
+                yuv420_to_rgb_row(roi + stride * i, uptr + uvstride * (i / 2), vptr + uvstride * (i / 2), uvstep, roi_pixels.row<unsigned char>(i), roiw);
+            }
+            else
+            {
+                memcpy(roi_pixels.row<unsigned char>(i), roi + stride * i, roiw * cn);
+            }
+        }
+
+        m = Mat::from_pixels_resize(roi_pixels, type_rgb, roiw, roih, target_width, target_height, opt);
+    }
+
+    if (!m.empty())
+        m.substract_mean_normalize(mean_vals, norm_vals);
+
+    return m;
+#else
+    resize_normalize_param p;
+    resize_normalize_param_init(p, type_from, type_to, mean_vals, norm_vals);
+
+    p.yuv = yuv;
+    p.uptr = uptr;
+    p.vptr = vptr;
+    p.uvstride = uvstride;
+    p.uvstep = uvstep;
+
+    Mat m(target_width, target_height, outc, 4u, opt.blob_allocator);
+    if (m.empty())
+        return m;
+
+    std::vector<int> ofs(target_width + target_height);
+    std::vector<short> alpha((target_width + target_height) * 2);
+    int* xofs = &ofs[0];
+    int* yofs = &ofs[target_width];
+    short* ialpha = &alpha[0];
+    short* ibeta = &alpha[target_width * 2];
+
+    if (roiw != target_width || roih != target_height)
+    {
+        resize_bilinear_coeffs(roiw, target_width, cn, xofs, ialpha);
+        resize_bilinear_coeffs(roih, target_height, 1, yofs, ibeta);
+    }
+
+    // one block of output rows per thread
+    const int nblocks = target_width * target_height >= resize_parallel_size ? std::min(opt.num_threads, target_height) : 1;
+
+    #pragma omp parallel for num_threads(nblocks)
+    for (int t=0; t<nblocks; t++)
+    {
+        resize_normalize_rows(roi, stride, roiw, roih, m, p, xofs, ialpha, yofs, ibeta, target_height * t / nblocks, target_height * (t + 1) / nblocks);
+    }
+
+    return m;
+#endif // __ARM_NEON
+}
+
+Mat Mat::from_pixels_warpaffine_normalize(const unsigned char* pixels, int type, int w, int h, const float* tm, int target_width, int target_height, const float* mean_vals, const float* norm_vals, int border_type, unsigned int v, Allocator* allocator)
+{
+    Option opt;
+    opt.blob_allocator = allocator;
+
+    return Mat::from_pixels_warpaffine_normalize(pixels, type, w, h, tm, target_width, target_height, mean_vals, norm_vals, border_type, v, opt);
+}
+
+Mat Mat::from_pixels_warpaffine_normalize(const unsigned char* pixels, int type, int w, int h, const float* tm, int target_width, int target_height, const float* mean_vals, const float* norm_vals, int border_type, unsigned int v, const Option& opt)
+{
+    const int type_from = type & PIXEL_FORMAT_MASK;
+    const int type_to = (type & PIXEL_CONVERT_MASK) ? (type >> PIXEL_CONVERT_SHIFT) : type_from;
+
+    const int cn = pixel_type_channels(type_from);
+    const int outc = pixel_type_channels(type_to);
+    if (cn == 0 || outc == 0)
+        return Mat();
+
+#if __ARM_NEON
+    Mat dst(target_width, target_height, (size_t)cn, cn);
+    warpaffine_bilinear(pixels, w, h, dst, target_width, target_height, cn, tm, border_type, v, opt);
+
+    Mat m = Mat::from_pixels(dst, type, target_width, target_height, opt);
+    if (!m.empty())
+        m.substract_mean_normalize(mean_vals, norm_vals);
+
+    return m;
+#else
+    resize_normalize_param p;
+    resize_normalize_param_init(p, type_from, type_to, mean_vals, norm_vals);
+
+    Mat m(target_width, target_height, outc, 4u, opt.blob_allocator);
+    if (m.empty())
+        return m;
+
+    const unsigned char border_color[4] = { (unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24) };
+
+    float tm_inv[6];
+    std::vector<int> delta(target_width * 2);
+    int* adelta = &delta[0];
+    int* bdelta = &delta[target_width];
+    warpaffine_coeffs(tm, target_width, tm_inv, adelta, bdelta);
+
+    // one block of output rows per thread
+    const int nblocks = target_width * target_height >= warpaffine_parallel_size ? std::min(opt.num_threads, target_height) : 1;
+
+    #pragma omp parallel for num_threads(nblocks)
+    for (int t=0; t<nblocks; t++)
+    {
+        warpaffine_normalize_rows(pixels, w, h, m, p, tm_inv, adelta, bdelta, border_type, border_color, target_height * t / nblocks, target_height * (t + 1) / nblocks);
+    }
+
+    return m;
+#endif // __ARM_NEON
+}
+
+#if NCNN_PIXEL_ROTATE
+// rotated rows are converted in bands of this many rows
+static const int rotate_normalize_band = 16;
+
+// output rows [y0, y1) of the pixel data rotated by type, into rows of outw pixels
+static void rotate_pixels_rows(const unsigned char* pixels, int w, int h, int cn, int type, unsigned char* dst, int outw, int y0, int y1, const Option& opt)
+{
+    const int stride = w * cn;
+
+    // the source rows or columns of the band
+    const unsigned char* src = pixels;
+    int srcw = w;
+    int srch = h;
+    if (type <= 4)
+    {
+        src += (type <= 2 ? y0 : h - y1) * stride;
+        srch = y1 - y0;
+    }
+    else
+    {
+        src += (type <= 6 ? y0 : w - y1) * cn;
+        srcw = y1 - y0;
+    }
+
+    if (cn == 1)
+        kanna_rotate_c1(src, srcw, srch, stride, dst, outw, y1 - y0, outw * cn, type, opt);
+    if (cn == 3)
+        kanna_rotate_c3(src, srcw, srch, stride, dst, outw, y1 - y0, outw * cn, type, opt);
+    if (cn == 4)
+        kanna_rotate_c4(src, srcw, srch, stride, dst, outw, y1 - y0, outw * cn, type, opt);
+}
+
+Mat Mat::from_pixels_rotate(const unsigned char* pixels, int type, int w, int h, int rotate_type, Allocator* allocator)
+{
+    return Mat::from_pixels_rotate_normalize(pixels, type, w, h, rotate_type, 0, 0, allocator);
+}
+
+Mat Mat::from_pixels_rotate(const unsigned char* pixels, int type, int w, int h, int rotate_type, const Option& opt)
+{
+    return Mat::from_pixels_rotate_normalize(pixels, type, w, h, rotate_type, 0, 0, opt);
+}
+
+Mat Mat::from_pixels_rotate_normalize(const unsigned char* pixels, int type, int w, int h, int rotate_type, const float* mean_vals, const float* norm_vals, Allocator* allocator)
+{
+    Option opt;
+    opt.blob_allocator = allocator;
+
+    return Mat::from_pixels_rotate_normalize(pixels, type, w, h, rotate_type, mean_vals, norm_vals, opt);
+}
+
+Mat Mat::from_pixels_rotate_normalize(const unsigned char* pixels, int type, int w, int h, int rotate_type, const float* mean_vals, const float* norm_vals, const Option& opt)
+{
+    const int type_from = type & PIXEL_FORMAT_MASK;
+    const int type_to = (type & PIXEL_CONVERT_MASK) ? (type >> PIXEL_CONVERT_SHIFT) : type_from;
+
+    const int cn = pixel_type_channels(type_from);
+    const int outc = pixel_type_channels(type_to);
+    if (cn == 0 || outc == 0 || rotate_type < 1 || rotate_type > 8)
+        return Mat();
+
+    const int outw = rotate_type <= 4 ? w : h;
+    const int outh = rotate_type <= 4 ? h : w;
+
+#if __ARM_NEON
+    Mat dst(outw, outh, (size_t)cn, cn);
+    rotate_pixels_rows(pixels, w, h, cn, rotate_type, dst, outw, 0, outh, opt);
+
+    Mat m = Mat::from_pixels(dst, type, outw, outh, opt);
+    if (!m.empty())
+        m.substract_mean_normalize(mean_vals, norm_vals);
+
+    return m;
+#else
+    resize_normalize_param p;
+    resize_normalize_param_init(p, type_from, type_to, mean_vals, norm_vals);
+
+    Mat m(outw, outh, outc, 4u, opt.blob_allocator);
+    if (m.empty())
+        return m;
+
+    // one block of output rows per thread, rotated band by band into a small buffer
+    const int nblocks = outw * outh >= resize_parallel_size ? std::min(opt.num_threads, outh) : 1;
+
+    #pragma omp parallel for num_threads(nblocks)
+    for (int t=0; t<nblocks; t++)
+    {
+        const int dy0 = outh * t / nblocks;
+        const int dy1 = outh * (t + 1) / nblocks;
+
+        Mat bandbuf(outw * cn, rotate_normalize_band, (size_t)1u);
+        Mat graybuf(outw, (size_t)1u);
+        unsigned char* band = bandbuf;
+        unsigned char* gray = graybuf;
+
+        for (int y0 = dy0; y0 < dy1; y0 += rotate_normalize_band)
+        {
+            const int y1 = std::min(y0 + rotate_normalize_band, dy1);
+
+            rotate_pixels_rows(pixels, w, h, cn, rotate_type, band, outw, y0, y1, opt);
+
+            for (int y = y0; y < y1; y++)
+            {
+                resize_normalize_row(band + (y - y0) * outw * cn, m, y, p, gray);
+            }
+        }
+    }
+
+    return m;
+#endif // __ARM_NEON
 }
+#endif // NCNN_PIXEL_ROTATE
 #endif // NCNN_PIXEL
 
 } // namespace ncnn
@@ -0,0 +1,408 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "mat.h"
+#include <string.h>
+#include <algorithm>
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#include "platform.h"
+
+namespace ncnn {
+
+#if NCNN_PIXEL_ROTATE
+// images with at least this many pixels are rotated with one thread per band of output rows
+static const int rotate_parallel_size = 256 * 256;
+
+// output rows are produced in bands, the source columns read by a band stay in cache
+static const int rotate_band = 32;
+
+#if __SSE2__
+// reverse the order of the 16 / cn pixels in 16 bytes
+static inline __m128i rotate_reverse(__m128i _v, int cn)
+{
+    _v = _mm_shuffle_epi32(_v, _MM_SHUFFLE(0, 1, 2, 3));
+    if (cn == 4)
+        return _v;
+
+    _v = _mm_shufflelo_epi16(_v, _MM_SHUFFLE(2, 3, 0, 1));
+    _v = _mm_shufflehi_epi16(_v, _MM_SHUFFLE(2, 3, 0, 1));
+    if (cn == 2)
+        return _v;
+
+    return _mm_or_si128(_mm_slli_epi16(_v, 8), _mm_srli_epi16(_v, 8));
+}
+#endif // __SSE2__
+
+// dst[x] = src[w - 1 - x] for every pixel of the row
+static void rotate_flip_row(const unsigned char* src, unsigned char* dst, int w, int cn)
+{
+    int x = 0;
+#if __SSE2__
+    if (cn != 3)
+    {
+        const unsigned char* end = src + w * cn;
+        for (; x+16/cn-1<w; x+=16/cn)
+        {
+            __m128i _v = _mm_loadu_si128((const __m128i*)(end - (x * cn) - 16));
+            _mm_storeu_si128((__m128i*)(dst + x * cn), rotate_reverse(_v, cn));
+        }
+    }
+#endif // __SSE2__
+    if (cn == 3)
+    {
+        for (; x<w; x++)
+        {
+            const unsigned char* p = src + (w - 1 - x) * 3;
+            dst[x * 3] = p[0];
+            dst[x * 3 + 1] = p[1];
+            dst[x * 3 + 2] = p[2];
+        }
+        return;
+    }
+    for (; x<w; x++)
+    {
+        const unsigned char* p = src + (w - 1 - x) * cn;
+        for (int k=0; k<cn; k++)
+        {
+            dst[x * cn + k] = p[k];
+        }
+    }
+}
+
+// dst(x, y) = base[x * xstep + y * ystep] for the pixels [x0, x1) x [y0, y1)
+static void rotate_transpose_tile(const unsigned char* base, int xstep, int ystep, unsigned char* dst, int stride, int cn, int x0, int x1, int y0, int y1)
+{
+    if (cn == 3)
+    {
+        for (int y = y0; y < y1; y++)
+        {
+            unsigned char* outptr = dst + y * stride + x0 * 3;
+
+            for (int x = x0; x < x1; x++)
+            {
+                const unsigned char* p = base + x * xstep + y * ystep;
+                outptr[0] = p[0];
+                outptr[1] = p[1];
+                outptr[2] = p[2];
+                outptr += 3;
+            }
+        }
+        return;
+    }
+
+    for (int y = y0; y < y1; y++)
+    {
+        unsigned char* outptr = dst + y * stride + x0 * cn;
+
+        for (int x = x0; x < x1; x++)
+        {
+            const unsigned char* p = base + x * xstep + y * ystep;
+            for (int k=0; k<cn; k++)
+            {
+                outptr[k] = p[k];
+            }
+            outptr += cn;
+        }
+    }
+}
+
+#if __SSE2__
+// the pixels of one dst column are contiguous in the source, ystep is cn or -cn
+// lane j of a loaded column is dst row y0 + j, or y0 + tile - 1 - j when ystep is negative
+static inline const unsigned char* rotate_column(const unsigned char* base, int xstep, int ystep, int x, int y0, int tile)
+{
+    return base + x * xstep + (ystep > 0 ? y0 : y0 + tile - 1) * ystep;
+}
+
+static void rotate_transpose_8x8_c1(const unsigned char* base, int xstep, int ystep, unsigned char* dst, int stride, int x0, int y0)
+{
+    __m128i _t0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)rotate_column(base, xstep, ystep, x0, y0, 8)), _mm_loadl_epi64((const __m128i*)rotate_column(base, xstep, ystep, x0 + 1, y0, 8)));
+    __m128i _t1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)rotate_column(base, xstep, ystep, x0 + 2, y0, 8)), _mm_loadl_epi64((const __m128i*)rotate_column(base, xstep, ystep, x0 + 3, y0, 8)));
+    __m128i _t2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)rotate_column(base, xstep, ystep, x0 + 4, y0, 8)), _mm_loadl_epi64((const __m128i*)rotate_column(base, xstep, ystep, x0 + 5, y0, 8)));
+    __m128i _t3 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)rotate_column(base, xstep, ystep, x0 + 6, y0, 8)), _mm_loadl_epi64((const __m128i*)rotate_column(base, xstep, ystep, x0 + 7, y0, 8)));
+
+    __m128i _u0 = _mm_unpacklo_epi16(_t0, _t1);
+    __m128i _u1 = _mm_unpackhi_epi16(_t0, _t1);
+    __m128i _u2 = _mm_unpacklo_epi16(_t2, _t3);
+    __m128i _u3 = _mm_unpackhi_epi16(_t2, _t3);
+
+    __m128i _r[4];
+    _r[0] = _mm_unpacklo_epi32(_u0, _u2);
+    _r[1] = _mm_unpackhi_epi32(_u0, _u2);
+    _r[2] = _mm_unpacklo_epi32(_u1, _u3);
+    _r[3] = _mm_unpackhi_epi32(_u1, _u3);
+
+    for (int j=0; j<4; j++)
+    {
+        const int ya = ystep > 0 ? y0 + j * 2 : y0 + 7 - j * 2;
+        const int yb = ystep > 0 ? ya + 1 : ya - 1;
+        _mm_storel_epi64((__m128i*)(dst + ya * stride + x0), _r[j]);
+        _mm_storel_epi64((__m128i*)(dst + yb * stride + x0), _mm_unpackhi_epi64(_r[j], _r[j]));
+    }
+}
+
+static void rotate_transpose_8x8_c2(const unsigned char* base, int xstep, int ystep, unsigned char* dst, int stride, int x0, int y0)
+{
+    __m128i _a[8];
+    for (int i=0; i<8; i++)
+    {
+        _a[i] = _mm_loadu_si128((const __m128i*)rotate_column(base, xstep, ystep, x0 + i, y0, 8));
+    }
+
+    __m128i _t0 = _mm_unpacklo_epi16(_a[0], _a[1]);
+    __m128i _t1 = _mm_unpackhi_epi16(_a[0], _a[1]);
+    __m128i _t2 = _mm_unpacklo_epi16(_a[2], _a[3]);
+    __m128i _t3 = _mm_unpackhi_epi16(_a[2], _a[3]);
+    __m128i _t4 = _mm_unpacklo_epi16(_a[4], _a[5]);
+    __m128i _t5 = _mm_unpackhi_epi16(_a[4], _a[5]);
+    __m128i _t6 = _mm_unpacklo_epi16(_a[6], _a[7]);
+    __m128i _t7 = _mm_unpackhi_epi16(_a[6], _a[7]);
+
+    __m128i _u0 = _mm_unpacklo_epi32(_t0, _t2);
+    __m128i _u1 = _mm_unpackhi_epi32(_t0, _t2);
+    __m128i _u2 = _mm_unpacklo_epi32(_t1, _t3);
+    __m128i _u3 = _mm_unpackhi_epi32(_t1, _t3);
+    __m128i _u4 = _mm_unpacklo_epi32(_t4, _t6);
+    __m128i _u5 = _mm_unpackhi_epi32(_t4, _t6);
+    __m128i _u6 = _mm_unpacklo_epi32(_t5, _t7);
+    __m128i _u7 = _mm_unpackhi_epi32(_t5, _t7);
+
+    __m128i _r[8];
+    _r[0] = _mm_unpacklo_epi64(_u0, _u4);
+    _r[1] = _mm_unpackhi_epi64(_u0, _u4);
+    _r[2] = _mm_unpacklo_epi64(_u1, _u5);
+    _r[3] = _mm_unpackhi_epi64(_u1, _u5);
+    _r[4] = _mm_unpacklo_epi64(_u2, _u6);
+    _r[5] = _mm_unpackhi_epi64(_u2, _u6);
+    _r[6] = _mm_unpacklo_epi64(_u3, _u7);
+    _r[7] = _mm_unpackhi_epi64(_u3, _u7);
+
+    for (int j=0; j<8; j++)
+    {
+        const int y = ystep > 0 ? y0 + j : y0 + 7 - j;
+        _mm_storeu_si128((__m128i*)(dst + y * stride + x0 * 2), _r[j]);
+    }
+}
+
+#if __AVX__
+static void rotate_transpose_8x8_c4(const unsigned char* base, int xstep, int ystep, unsigned char* dst, int stride, int x0, int y0)
+{
+    __m256 _a[8];
+    for (int i=0; i<8; i++)
+    {
+        _a[i] = _mm256_loadu_ps((const float*)rotate_column(base, xstep, ystep, x0 + i, y0, 8));
+    }
+
+    __m256 _t0 = _mm256_unpacklo_ps(_a[0], _a[1]);
+    __m256 _t1 = _mm256_unpackhi_ps(_a[0], _a[1]);
+    __m256 _t2 = _mm256_unpacklo_ps(_a[2], _a[3]);
+    __m256 _t3 = _mm256_unpackhi_ps(_a[2], _a[3]);
+    __m256 _t4 = _mm256_unpacklo_ps(_a[4], _a[5]);
+    __m256 _t5 = _mm256_unpackhi_ps(_a[4], _a[5]);
+    __m256 _t6 = _mm256_unpacklo_ps(_a[6], _a[7]);
+    __m256 _t7 = _mm256_unpackhi_ps(_a[6], _a[7]);
+
+    __m256 _u0 = _mm256_shuffle_ps(_t0, _t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _u1 = _mm256_shuffle_ps(_t0, _t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _u2 = _mm256_shuffle_ps(_t1, _t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _u3 = _mm256_shuffle_ps(_t1, _t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _u4 = _mm256_shuffle_ps(_t4, _t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _u5 = _mm256_shuffle_ps(_t4, _t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 _u6 = _mm256_shuffle_ps(_t5, _t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 _u7 = _mm256_shuffle_ps(_t5, _t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    __m256 _r[8];
+    _r[0] = _mm256_permute2f128_ps(_u0, _u4, 0x20);
+    _r[1] = _mm256_permute2f128_ps(_u1, _u5, 0x20);
+    _r[2] = _mm256_permute2f128_ps(_u2, _u6, 0x20);
+    _r[3] = _mm256_permute2f128_ps(_u3, _u7, 0x20);
+    _r[4] = _mm256_permute2f128_ps(_u0, _u4, 0x31);
+    _r[5] = _mm256_permute2f128_ps(_u1, _u5, 0x31);
+    _r[6] = _mm256_permute2f128_ps(_u2, _u6, 0x31);
+    _r[7] = _mm256_permute2f128_ps(_u3, _u7, 0x31);
+
+    for (int j=0; j<8; j++)
+    {
+        const int y = ystep > 0 ? y0 + j : y0 + 7 - j;
+        _mm256_storeu_ps((float*)(dst + y * stride + x0 * 4), _r[j]);
+    }
+}
+#else
+static void rotate_transpose_4x4_c4(const unsigned char* base, int xstep, int ystep, unsigned char* dst, int stride, int x0, int y0)
+{
+    __m128i _a0 = _mm_loadu_si128((const __m128i*)rotate_column(base, xstep, ystep, x0, y0, 4));
+    __m128i _a1 = _mm_loadu_si128((const __m128i*)rotate_column(base, xstep, ystep, x0 + 1, y0, 4));
+    __m128i _a2 = _mm_loadu_si128((const __m128i*)rotate_column(base, xstep, ystep, x0 + 2, y0, 4));
+    __m128i _a3 = _mm_loadu_si128((const __m128i*)rotate_column(base, xstep, ystep, x0 + 3, y0, 4));
+
+    __m128i _t0 = _mm_unpacklo_epi32(_a0, _a1);
+    __m128i _t1 = _mm_unpackhi_epi32(_a0, _a1);
+    __m128i _t2 = _mm_unpacklo_epi32(_a2, _a3);
+    __m128i _t3 = _mm_unpackhi_epi32(_a2, _a3);
+
+    __m128i _r[4];
+    _r[0] = _mm_unpacklo_epi64(_t0, _t2);
+    _r[1] = _mm_unpackhi_epi64(_t0, _t2);
+    _r[2] = _mm_unpacklo_epi64(_t1, _t3);
+    _r[3] = _mm_unpackhi_epi64(_t1, _t3);
+
+    for (int j=0; j<4; j++)
+    {
+        const int y = ystep > 0 ? y0 + j : y0 + 3 - j;
+        _mm_storeu_si128((__m128i*)(dst + y * stride + x0 * 4), _r[j]);
+    }
+}
+#endif // __AVX__
+#endif // __SSE2__
+
+// dst(x, y) = base[x * xstep + y * ystep] for w x h pixels, ystep is cn or -cn
+// square tiles are transposed in registers, columns first so that a tile reads contiguous source bytes
+static void rotate_transpose(const unsigned char* base, int xstep, int ystep, unsigned char* dst, int w, int h, int stride, int cn)
+{
+    int tile = 8;
+#if __SSE2__ && !__AVX__
+    if (cn == 4)
+        tile = 4;
+#endif
+
+    int x0 = 0;
+    for (; x0+tile-1<w; x0+=tile)
+    {
+        int y0 = 0;
+#if __SSE2__
+        for (; y0+tile-1<h && cn != 3; y0+=tile)
+        {
+            if (cn == 1)
+                rotate_transpose_8x8_c1(base, xstep, ystep, dst, stride, x0, y0);
+            if (cn == 2)
+                rotate_transpose_8x8_c2(base, xstep, ystep, dst, stride, x0, y0);
+#if __AVX__
+            if (cn == 4)
+                rotate_transpose_8x8_c4(base, xstep, ystep, dst, stride, x0, y0);
+#else
+            if (cn == 4)
+                rotate_transpose_4x4_c4(base, xstep, ystep, dst, stride, x0, y0);
+#endif // __AVX__
+        }
+#endif // __SSE2__
+        for (; y0<h; y0+=tile)
+        {
+            rotate_transpose_tile(base, xstep, ystep, dst, stride, cn, x0, x0 + tile, y0, std::min(y0 + tile, h));
+        }
+    }
+
+    rotate_transpose_tile(base, xstep, ystep, dst, stride, cn, x0, w, 0, h);
+}
+
+// output rows [y0, y1) of the rotated image
+static void kanna_rotate_rows(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int stride, int cn, int type, int y0, int y1)
+{
+    if (type <= 4)
+    {
+        for (int y = y0; y < y1; y++)
+        {
+            const unsigned char* p = src + (type <= 2 ? y : srch - 1 - y) * srcstride;
+            unsigned char* outptr = dst + y * stride;
+
+            if (type == 1 || type == 4)
+                memcpy(outptr, p, w * cn);
+            else
+                rotate_flip_row(p, outptr, w, cn);
+        }
+        return;
+    }
+
+    // source pixel of dst(x, y) is base + x * xstep + y * ystep
+    //   5 src(y, x)  6 src(y, srch - 1 - x)  7 src(srcw - 1 - y, srch - 1 - x)  8 src(srcw - 1 - y, x)
+    const unsigned char* base = src;
+    int xstep = srcstride;
+    int ystep = cn;
+    if (type == 6 || type == 7)
+    {
+        base += (srch - 1) * srcstride;
+        xstep = -srcstride;
+    }
+    if (type == 7 || type == 8)
+    {
+        base += (srcw - 1) * cn;
+        ystep = -cn;
+    }
+
+    rotate_transpose(base + y0 * ystep, xstep, ystep, dst + y0 * stride, w, y1 - y0, stride, cn);
+}
+
+static void kanna_rotate(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int cn, int type, const Option& opt)
+{
+    if (type < 1 || type > 8)
+        return;
+
+    if (type <= 4 ? (w != srcw || h != srch) : (w != srch || h != srcw))
+        return;
+
+    const int nbands = (h + rotate_band - 1) / rotate_band;
+
+    #pragma omp parallel for num_threads(opt.num_threads) if (w * h >= rotate_parallel_size && nbands > 1)
+    for (int b=0; b<nbands; b++)
+    {
+        kanna_rotate_rows(src, srcw, srch, srcstride, dst, w, stride, cn, type, b * rotate_band, std::min((b + 1) * rotate_band, h));
+    }
+}
+
+void kanna_rotate_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, const Option& opt)
+{
+    return kanna_rotate(src, srcw, srch, srcw, dst, w, h, w, 1, type, opt);
+}
+
+void kanna_rotate_c2(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, const Option& opt)
+{
+    return kanna_rotate(src, srcw, srch, srcw * 2, dst, w, h, w * 2, 2, type, opt);
+}
+
+void kanna_rotate_c3(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, const Option& opt)
+{
+    return kanna_rotate(src, srcw, srch, srcw * 3, dst, w, h, w * 3, 3, type, opt);
+}
+
+void kanna_rotate_c4(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, const Option& opt)
+{
+    return kanna_rotate(src, srcw, srch, srcw * 4, dst, w, h, w * 4, 4, type, opt);
+}
+
+void kanna_rotate_c1(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int type, const Option& opt)
+{
+    return kanna_rotate(src, srcw, srch, srcstride, dst, w, h, stride, 1, type, opt);
+}
+
+void kanna_rotate_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int type, const Option& opt)
+{
+    return kanna_rotate(src, srcw, srch, srcstride, dst, w, h, stride, 2, type, opt);
+}
+
+void kanna_rotate_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int type, const Option& opt)
+{
+    return kanna_rotate(src, srcw, srch, srcstride, dst, w, h, stride, 3, type, opt);
+}
+
+void kanna_rotate_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int type, const Option& opt)
+{
+    return kanna_rotate(src, srcw, srch, srcstride, dst, w, h, stride, 4, type, opt);
+}
+#endif // NCNN_PIXEL_ROTATE
+
+} // namespace ncnn
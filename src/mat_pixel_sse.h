@@ -0,0 +1,62 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// 16 u8 values to 4 x 4 floats
+static inline void pixel_u8_to_ps(__m128i _v, __m128& _f0, __m128& _f1, __m128& _f2, __m128& _f3)
+{
+    __m128i _zero = _mm_setzero_si128();
+    __m128i _lo = _mm_unpacklo_epi8(_v, _zero);
+    __m128i _hi = _mm_unpackhi_epi8(_v, _zero);
+    _f0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_lo, _zero));
+    _f1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(_lo, _zero));
+    _f2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_hi, _zero));
+    _f3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(_hi, _zero));
+}
+
+// 4 x 4 floats to 16 u8 values, truncated and saturated like SATURATE_CAST_UCHAR
+static inline __m128i pixel_ps_to_u8(__m128 _f0, __m128 _f1, __m128 _f2, __m128 _f3)
+{
+    __m128i _lo = _mm_packs_epi32(_mm_cvttps_epi32(_f0), _mm_cvttps_epi32(_f1));
+    __m128i _hi = _mm_packs_epi32(_mm_cvttps_epi32(_f2), _mm_cvttps_epi32(_f3));
+    return _mm_packus_epi16(_lo, _hi);
+}
+
+// r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3  ->  r0 r1 r2 r3 | g0 g1 g2 g3 | b0 b1 b2 b3
+static inline void pixel_deinterleave3_ps(__m128 _a, __m128 _b, __m128 _c, __m128& _p0, __m128& _p1, __m128& _p2)
+{
+    __m128 _b2c1 = _mm_shuffle_ps(_b, _c, _MM_SHUFFLE(1, 1, 2, 2));
+    __m128 _a1b0 = _mm_shuffle_ps(_a, _b, _MM_SHUFFLE(0, 0, 1, 1));
+    __m128 _b3c2 = _mm_shuffle_ps(_b, _c, _MM_SHUFFLE(2, 2, 3, 3));
+    __m128 _a2b1 = _mm_shuffle_ps(_a, _b, _MM_SHUFFLE(1, 1, 2, 2));
+    __m128 _c0c3 = _mm_shuffle_ps(_c, _c, _MM_SHUFFLE(3, 3, 0, 0));
+
+    _p0 = _mm_shuffle_ps(_a, _b2c1, _MM_SHUFFLE(2, 0, 3, 0));
+    _p1 = _mm_shuffle_ps(_a1b0, _b3c2, _MM_SHUFFLE(2, 0, 2, 0));
+    _p2 = _mm_shuffle_ps(_a2b1, _c0c3, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// r0 r1 r2 r3 | g0 g1 g2 g3 | b0 b1 b2 b3  ->  r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3
+static inline void pixel_interleave3_ps(__m128 _p0, __m128 _p1, __m128 _p2, __m128& _a, __m128& _b, __m128& _c)
+{
+    __m128 _r0g0 = _mm_shuffle_ps(_p0, _p1, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 _b0r1 = _mm_shuffle_ps(_p2, _p0, _MM_SHUFFLE(1, 1, 0, 0));
+    __m128 _g1b1 = _mm_shuffle_ps(_p1, _p2, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 _r2g2 = _mm_shuffle_ps(_p0, _p1, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 _b2r3 = _mm_shuffle_ps(_p2, _p0, _MM_SHUFFLE(3, 3, 2, 2));
+    __m128 _g3b3 = _mm_shuffle_ps(_p1, _p2, _MM_SHUFFLE(3, 3, 3, 3));
+
+    _a = _mm_shuffle_ps(_r0g0, _b0r1, _MM_SHUFFLE(2, 0, 2, 0));
+    _b = _mm_shuffle_ps(_g1b1, _r2g2, _MM_SHUFFLE(2, 0, 2, 0));
+    _c = _mm_shuffle_ps(_b2r3, _g3b3, _MM_SHUFFLE(2, 0, 2, 0));
+}
@@ -0,0 +1,96 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// dst pixel i covers the source span [i * scale, (i + 1) * scale), every source pixel is weighted by its overlap
+// the taps of dst pixel i are [tab[i], tab[i + 1]) in idx and alpha, at most srcw + w * 2 taps
+static void resize_area_coeffs(int srcw, int w, int* tab, int* idx, float* alpha)
+{
+    const double scale = (double)srcw / w;
+
+    int n = 0;
+    for (int dx = 0; dx < w; dx++)
+    {
+        tab[dx] = n;
+
+        const double fsx1 = dx * scale;
+        const double fsx2 = std::min(fsx1 + scale, (double)srcw);
+        const int sx1 = (int)ceil(fsx1);
+        const int sx2 = (int)floor(fsx2);
+
+        if (sx1 - fsx1 > 1e-3)
+        {
+            idx[n] = sx1 - 1;
+            alpha[n] = (float)(sx1 - fsx1);
+            n++;
+        }
+        for (int sx = sx1; sx < sx2; sx++)
+        {
+            idx[n] = sx;
+            alpha[n] = 1.f;
+            n++;
+        }
+        if (fsx2 - sx2 > 1e-3)
+        {
+            idx[n] = sx2;
+            alpha[n] = (float)(fsx2 - sx2);
+            n++;
+        }
+
+        // weights of every dst pixel sum to 1
+        float sum = 0.f;
+        for (int k = tab[dx]; k < n; k++)
+        {
+            sum += alpha[k];
+        }
+        for (int k = tab[dx]; k < n; k++)
+        {
+            alpha[k] /= sum;
+        }
+    }
+
+    tab[w] = n;
+}
+
+// D[dx * cn + k] = sum of acc[idx * cn + k] * alpha over the taps of dx
+// acc and D have one float of padding past w * cn for cn == 3
+static void resize_area_hresize(const float* acc, float* D, int w, int cn, const int* tab, const int* idx, const float* alpha)
+{
+#if __SSE2__
+    if (cn == 3 || cn == 4)
+    {
+        for (int dx = 0; dx < w; dx++)
+        {
+            __m128 _sum = _mm_setzero_ps();
+            for (int k = tab[dx]; k < tab[dx + 1]; k++)
+            {
+                _sum = _mm_add_ps(_sum, _mm_mul_ps(_mm_loadu_ps(acc + idx[k] * cn), _mm_set1_ps(alpha[k])));
+            }
+            _mm_storeu_ps(D + dx * cn, _sum);
+        }
+        return;
+    }
+#endif // __SSE2__
+    for (int dx = 0; dx < w; dx++)
+    {
+        for (int c = 0; c < cn; c++)
+        {
+            float sum = 0.f;
+            for (int k = tab[dx]; k < tab[dx + 1]; k++)
+            {
+                sum += acc[idx[k] * cn + c] * alpha[k];
+            }
+            D[dx * cn + c] = sum;
+        }
+    }
+}
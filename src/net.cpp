@@ -13,11 +13,13 @@
 // specific language governing permissions and limitations under the License.
 
 #include "net.h"
+#include "autotune.h"
 #include "layer_type.h"
 #include "modelbin.h"
 #include "paramdict.h"
 #include "convolution.h"
 #include "convolutiondepthwise.h"
+#include "innerproduct.h"
 #include "relu.h"
 
 #include <stdarg.h>
@@ -39,8 +41,17 @@
 
 namespace ncnn {
 
+// elempack of blobs fed to layers with support_packing, one avx register on x86 and one neon register on arm
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+static const int packing_elempack = 8;
+#else
+static const int packing_elempack = 4;
+#endif
+
 Net::Net()
 {
+    autotune_cache = 0;
+
 #if NCNN_VULKAN
     vkdev = 0;
     weight_vkallocator = 0;
@@ -57,6 +68,8 @@ Net::~Net()
 {
     clear();
 
+    delete autotune_cache;
+
 #if NCNN_VULKAN
     delete cast_float32_to_float16;
     delete cast_float16_to_float32;
@@ -65,6 +78,23 @@ Net::~Net()
 #endif // NCNN_VULKAN
 }
 
+int Net::enable_autotune(const char* cachepath)
+{
+    if (!autotune_cache)
+        autotune_cache = new AutotuneCache;
+
+    opt.autotune_cache = autotune_cache;
+
+#if NCNN_STDIO
+    if (cachepath)
+        return autotune_cache->load(cachepath);
+#else
+    (void)cachepath;
+#endif // NCNN_STDIO
+
+    return 0;
+}
+
 #if NCNN_STRING
 int Net::register_custom_layer(const char* type, layer_creator_func creator)
 {
@@ -887,6 +917,10 @@ int Net::fuse_network()
                 continue;    
             net_quantized = true;
         }
+        if (layer->type == "InnerProduct" && ((InnerProduct*)layer)->use_int8_inference)
+        {
+            net_quantized = true;
+        }
     }
 
     if (net_quantized == false)
@@ -1027,6 +1061,22 @@ int Net::fuse_network()
                 }                  
             }
         }
+
+        // stacked int8 fully connected layers, requantize straight into the next one
+        if (layer->type == "InnerProduct" && ((InnerProduct*)layer)->use_int8_inference)
+        {
+            if (blobs[layer->tops[0]].consumers.size() != 1)
+                continue;
+
+            int layer_next_index = blobs[layer->tops[0]].consumers[0];
+            Layer* layer_next = layers[layer_next_index];
+
+            if (layer_next->type != "InnerProduct" || ((InnerProduct*)layer_next)->use_int8_inference == false)
+                continue;
+
+            ((InnerProduct*)layer)->use_int8_requantize = true;
+            ((InnerProduct*)layer)->top_blob_int8_scale = ((InnerProduct*)layer_next)->bottom_blob_int8_scale;
+        }
     }
 #endif
     return 0;
@@ -1299,7 +1349,7 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, Option& opt
 
         if (opt.use_packing_layout)
         {
-            int elempack = layer->support_packing ? 4 : 1;
+            int elempack = layer->support_packing ? packing_elempack : 1;
 
             Mat bottom_blob_packed;
             convert_packing(bottom_blob, bottom_blob_packed, elempack, opt);
@@ -1373,7 +1423,7 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, Option& opt
 
             if (opt.use_packing_layout)
             {
-                int elempack = layer->support_packing ? 4 : 1;
+                int elempack = layer->support_packing ? packing_elempack : 1;
 
                 Mat bottom_blob_packed;
                 convert_packing(bottom_blobs[i], bottom_blob_packed, elempack, opt);
@@ -1800,7 +1850,7 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector
 
             if (opt.use_packing_layout)
             {
-                int elempack = layer->support_packing ? 4 : 1;
+                int elempack = layer->support_packing ? packing_elempack : 1;
 
                 Mat bottom_blob_packed;
                 convert_packing(bottom_blob, bottom_blob_packed, elempack, opt);
@@ -1976,7 +2026,7 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector
 
                 if (opt.use_packing_layout)
                 {
-                    int elempack = layer->support_packing ? 4 : 1;
+                    int elempack = layer->support_packing ? packing_elempack : 1;
 
                     Mat bottom_blob_packed;
                     convert_packing(bottom_blobs[i], bottom_blob_packed, elempack, opt);
@@ -51,6 +51,13 @@ public:
     const VulkanDevice* vulkan_device() const;
 #endif // NCNN_VULKAN
 
+    // runtime autotuning of layer implementations
+    // a layer times its candidate implementations on the first sight of each input shape
+    // and keeps the fastest, decisions are loaded from and appended to cachepath when not null
+    // changes should be applied before loading network structure and weight
+    // return 0 if success
+    int enable_autotune(const char* cachepath = 0);
+
 #if NCNN_STRING
     // register custom layer by layer type name
     // return 0 if success
@@ -132,6 +139,8 @@ protected:
 
     std::vector<layer_registry_entry> custom_layer_registry;
 
+    AutotuneCache* autotune_cache;
+
 #if NCNN_VULKAN
     const VulkanDevice* vkdev;
 
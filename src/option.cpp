@@ -43,6 +43,8 @@ Option::Option()
 
     use_packing_layout = false;
 
+    autotune_cache = 0;
+
     // sanitize
     if (num_threads <= 0)
         num_threads = 1;
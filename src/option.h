@@ -24,6 +24,7 @@ class VkAllocator;
 #endif // NCNN_VULKAN
 
 class Allocator;
+class AutotuneCache;
 class Option
 {
 public:
@@ -33,6 +34,7 @@ public:
 public:
     // light mode
     // intermediate blob will be recycled when enabled
+    // layers may also drop original weights once repacked
     // enabled by default
     bool lightmode;
 
@@ -85,8 +87,12 @@ public:
     bool use_int8_storage;
     bool use_int8_arithmetic;
 
-    //
+    // channels interleaved in blobs, elempack 4 on arm and 8 on x86 with avx
     bool use_packing_layout;
+
+    // runtime implementation decisions, see Net::enable_autotune
+    // layers use their built-in heuristics when null
+    AutotuneCache* autotune_cache;
 };
 
 } // namespace ncnn
@@ -12,6 +12,12 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
+#ifdef NCNN_CONFIGURED_PLATFORM_H
+// cmake builds use the platform.h configured from platform.h.in,
+// this copy holds the settings of the visual studio project
+#include NCNN_CONFIGURED_PLATFORM_H
+#else // NCNN_CONFIGURED_PLATFORM_H
+
 #ifndef NCNN_PLATFORM_H
 #define NCNN_PLATFORM_H
 
@@ -132,3 +138,5 @@ private:
 } // namespace ncnn
 
 #endif // NCNN_PLATFORM_H
+
+#endif // NCNN_CONFIGURED_PLATFORM_H
@@ -0,0 +1,102 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+#include "layer/exp.h"
+
+static int test_exp(const ncnn::Mat& a, float base, float scale, float shift)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, base);
+    pd.set(1, scale);
+    pd.set(2, shift);
+
+    std::vector<ncnn::Mat> weights(0);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+    int ret = test_layer<ncnn::Exp>(ncnn::LayerType::Exp, pd, weights, opt, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_exp failed a.dims=%d a=(%d %d %d) base=%f scale=%f shift=%f\n", a.dims, a.w, a.h, a.c, base, scale, shift);
+    }
+
+    return ret;
+}
+
+static int test_exp_0()
+{
+    return 0
+        || test_exp(RandomMat(5, 7, 3), -1.f, 1.f, 0.f)
+        || test_exp(RandomMat(6, 7, 16), -1.f, 1.f, 0.f)
+        || test_exp(RandomMat(3, 5, 24), -1.f, 1.f, 0.f)
+        || test_exp(RandomMat(19, 5), -1.f, 1.f, 0.f)
+        || test_exp(RandomMat(13, 16), -1.f, 1.f, 0.f)
+        || test_exp(RandomMat(13), -1.f, 1.f, 0.f)
+        || test_exp(RandomMat(40), -1.f, 1.f, 0.f)
+        ;
+}
+
+static int test_exp_1()
+{
+    return 0
+        || test_exp(RandomMat(5, 7, 3), -1.f, 0.5f, 0.2f)
+        || test_exp(RandomMat(6, 7, 16), -1.f, 0.5f, 0.2f)
+        || test_exp(RandomMat(3, 5, 24), -1.f, 0.5f, 0.2f)
+        || test_exp(RandomMat(19, 5), -1.f, 0.5f, 0.2f)
+        || test_exp(RandomMat(13, 16), -1.f, 0.5f, 0.2f)
+        || test_exp(RandomMat(13), -1.f, 0.5f, 0.2f)
+        || test_exp(RandomMat(40), -1.f, 0.5f, 0.2f)
+        ;
+}
+
+static int test_exp_2()
+{
+    return 0
+        || test_exp(RandomMat(5, 7, 3), 2.f, 1.f, 0.f)
+        || test_exp(RandomMat(6, 7, 16), 2.f, 1.f, 0.f)
+        || test_exp(RandomMat(3, 5, 24), 2.f, 1.f, 0.f)
+        || test_exp(RandomMat(19, 5), 2.f, 1.f, 0.f)
+        || test_exp(RandomMat(13, 16), 2.f, 1.f, 0.f)
+        || test_exp(RandomMat(13), 2.f, 1.f, 0.f)
+        || test_exp(RandomMat(40), 2.f, 1.f, 0.f)
+        ;
+}
+
+static int test_exp_3()
+{
+    return 0
+        || test_exp(RandomMat(5, 7, 3), 0.f, 1.f, 0.f)
+        || test_exp(RandomMat(6, 7, 16), 0.f, 1.f, 0.f)
+        || test_exp(RandomMat(3, 5, 24), 0.f, 1.f, 0.f)
+        || test_exp(RandomMat(19, 5), 0.f, 1.f, 0.f)
+        || test_exp(RandomMat(13, 16), 0.f, 1.f, 0.f)
+        || test_exp(RandomMat(13), 0.f, 1.f, 0.f)
+        || test_exp(RandomMat(40), 0.f, 1.f, 0.f)
+        ;
+}
+
+int main()
+{
+    srand(7767517);
+
+    return 0
+        || test_exp_0()
+        || test_exp_1()
+        || test_exp_2()
+        || test_exp_3()
+        ;
+}
@@ -0,0 +1,258 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+#include <limits.h>
+
+// the plain c bilinear resize, fixed point with 11 bit coefficients
+static void resize_bilinear_ref(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int cn)
+{
+    const int INTER_RESIZE_COEF_BITS = 11;
+    const int INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS;
+
+    double scale_x = (double)srcw / w;
+    double scale_y = (double)srch / h;
+
+    std::vector<int> xofs(w);
+    std::vector<int> yofs(h);
+    std::vector<short> ialpha(w * 2);
+    std::vector<short> ibeta(h * 2);
+
+#define SATURATE_CAST_SHORT(X) (short)std::min(std::max((int)(X + (X >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), SHRT_MAX)
+
+    for (int dx = 0; dx < w; dx++)
+    {
+        float fx = (float)((dx + 0.5) * scale_x - 0.5);
+        int sx = (int)floor(fx);
+        fx -= sx;
+
+        if (sx < 0)
+        {
+            sx = 0;
+            fx = 0.f;
+        }
+        if (sx >= srcw - 1)
+        {
+            sx = srcw - 2;
+            fx = 1.f;
+        }
+
+        xofs[dx] = sx;
+
+        float a0 = (1.f - fx) * INTER_RESIZE_COEF_SCALE;
+        float a1 = fx * INTER_RESIZE_COEF_SCALE;
+
+        ialpha[dx * 2] = SATURATE_CAST_SHORT(a0);
+        ialpha[dx * 2 + 1] = SATURATE_CAST_SHORT(a1);
+    }
+
+    for (int dy = 0; dy < h; dy++)
+    {
+        float fy = (float)((dy + 0.5) * scale_y - 0.5);
+        int sy = (int)floor(fy);
+        fy -= sy;
+
+        if (sy < 0)
+        {
+            sy = 0;
+            fy = 0.f;
+        }
+        if (sy >= srch - 1)
+        {
+            sy = srch - 2;
+            fy = 1.f;
+        }
+
+        yofs[dy] = sy;
+
+        float b0 = (1.f - fy) * INTER_RESIZE_COEF_SCALE;
+        float b1 = fy * INTER_RESIZE_COEF_SCALE;
+
+        ibeta[dy * 2] = SATURATE_CAST_SHORT(b0);
+        ibeta[dy * 2 + 1] = SATURATE_CAST_SHORT(b1);
+    }
+
+#undef SATURATE_CAST_SHORT
+
+    std::vector<short> rows0(w * cn);
+    std::vector<short> rows1(w * cn);
+
+    for (int dy = 0; dy < h; dy++)
+    {
+        const unsigned char* S0 = src + srcw * cn * yofs[dy];
+        const unsigned char* S1 = src + srcw * cn * (yofs[dy] + 1);
+
+        for (int dx = 0; dx < w; dx++)
+        {
+            short a0 = ialpha[dx * 2];
+            short a1 = ialpha[dx * 2 + 1];
+
+            for (int k = 0; k < cn; k++)
+            {
+                int sx = xofs[dx] * cn + k;
+                rows0[dx * cn + k] = (S0[sx] * a0 + S0[sx + cn] * a1) >> 4;
+                rows1[dx * cn + k] = (S1[sx] * a0 + S1[sx + cn] * a1) >> 4;
+            }
+        }
+
+        short b0 = ibeta[dy * 2];
+        short b1 = ibeta[dy * 2 + 1];
+
+        unsigned char* D = dst + w * cn * dy;
+        for (int x = 0; x < w * cn; x++)
+        {
+            D[x] = (unsigned char)(((short)((b0 * rows0[x]) >> 16) + (short)((b1 * rows1[x]) >> 16) + 2) >> 2);
+        }
+    }
+}
+
+static int test_mat_pixel_resize(int srcw, int srch, int w, int h, int cn, int num_threads)
+{
+    ncnn::Mat a = RandomPixels(srcw, srch, cn);
+
+    ncnn::Mat b(w * cn, h, (size_t)1u);
+    ncnn::Mat c(w * cn, h, (size_t)1u);
+
+    ncnn::Option opt;
+    opt.num_threads = num_threads;
+
+    if (cn == 1) ncnn::resize_bilinear_c1(a, srcw, srch, b, w, h, opt);
+    if (cn == 2) ncnn::resize_bilinear_c2(a, srcw, srch, b, w, h, opt);
+    if (cn == 3) ncnn::resize_bilinear_c3(a, srcw, srch, b, w, h, opt);
+    if (cn == 4) ncnn::resize_bilinear_c4(a, srcw, srch, b, w, h, opt);
+
+    resize_bilinear_ref(a, srcw, srch, c, w, h, cn);
+
+    if (memcmp(b.data, c.data, w * cn * h) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_resize failed srcw=%d srch=%d w=%d h=%d cn=%d num_threads=%d\n", srcw, srch, w, h, cn, num_threads);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_resize_0()
+{
+    for (int cn = 1; cn <= 4; cn++)
+    {
+        int ret = 0
+            || test_mat_pixel_resize(24, 48, 24, 48, cn, 1)
+            || test_mat_pixel_resize(13, 7, 5, 11, cn, 1)
+            || test_mat_pixel_resize(5, 11, 13, 7, cn, 1)
+            || test_mat_pixel_resize(64, 63, 31, 33, cn, 1)
+            || test_mat_pixel_resize(31, 33, 64, 63, cn, 1)
+            || test_mat_pixel_resize(2, 2, 17, 3, cn, 1)
+            || test_mat_pixel_resize(129, 97, 2, 2, cn, 1)
+            ;
+
+        if (ret != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_resize_1()
+{
+    // output large enough to be resized in row blocks
+    for (int cn = 1; cn <= 4; cn++)
+    {
+        int ret = 0
+            || test_mat_pixel_resize(300, 200, 259, 257, cn, 1)
+            || test_mat_pixel_resize(300, 200, 259, 257, cn, 4)
+            || test_mat_pixel_resize(161, 257, 301, 311, cn, 3)
+            || test_mat_pixel_resize(611, 401, 257, 263, cn, 7)
+            ;
+
+        if (ret != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_resize_area(int srcw, int srch, int w, int h, int cn, int num_threads)
+{
+    ncnn::Mat a = RandomPixels(srcw, srch, cn);
+
+    ncnn::Mat b(w * cn, h, (size_t)1u);
+    ncnn::Mat c(w * cn, h, (size_t)1u);
+
+    ncnn::Option opt;
+    opt.num_threads = num_threads;
+
+    ncnn::Option opt1;
+    opt1.num_threads = 1;
+
+    // the row blocks must not change the result
+    if (cn == 1)
+    {
+        ncnn::resize_area_c1(a, srcw, srch, b, w, h, opt);
+        ncnn::resize_area_c1(a, srcw, srch, c, w, h, opt1);
+    }
+    if (cn == 2)
+    {
+        ncnn::resize_area_c2(a, srcw, srch, b, w, h, opt);
+        ncnn::resize_area_c2(a, srcw, srch, c, w, h, opt1);
+    }
+    if (cn == 3)
+    {
+        ncnn::resize_area_c3(a, srcw, srch, b, w, h, opt);
+        ncnn::resize_area_c3(a, srcw, srch, c, w, h, opt1);
+    }
+    if (cn == 4)
+    {
+        ncnn::resize_area_c4(a, srcw, srch, b, w, h, opt);
+        ncnn::resize_area_c4(a, srcw, srch, c, w, h, opt1);
+    }
+
+    if (memcmp(b.data, c.data, w * cn * h) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_resize_area failed srcw=%d srch=%d w=%d h=%d cn=%d num_threads=%d\n", srcw, srch, w, h, cn, num_threads);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_resize_2()
+{
+    // source large enough to be area resized in row blocks
+    for (int cn = 1; cn <= 4; cn++)
+    {
+        int ret = 0
+            || test_mat_pixel_resize_area(640, 480, 213, 160, cn, 4)
+            || test_mat_pixel_resize_area(641, 483, 97, 61, cn, 3)
+            || test_mat_pixel_resize_area(1023, 517, 511, 258, cn, 7)
+            ;
+
+        if (ret != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    srand(7767517);
+
+    return 0
+        || test_mat_pixel_resize_0()
+        || test_mat_pixel_resize_1()
+        || test_mat_pixel_resize_2()
+        ;
+}
@@ -0,0 +1,216 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+#include <string.h>
+
+// the plain c rotation, dst pixel x y is the source pixel sx sy of the exif orientation type
+static void kanna_rotate_ref(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int cn, int type)
+{
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            int sx = x;
+            int sy = y;
+            if (type == 2) { sx = srcw - 1 - x; sy = y; }
+            if (type == 3) { sx = srcw - 1 - x; sy = srch - 1 - y; }
+            if (type == 4) { sx = x; sy = srch - 1 - y; }
+            if (type == 5) { sx = y; sy = x; }
+            if (type == 6) { sx = y; sy = srch - 1 - x; }
+            if (type == 7) { sx = srcw - 1 - y; sy = srch - 1 - x; }
+            if (type == 8) { sx = srcw - 1 - y; sy = x; }
+
+            memcpy(dst + y * stride + x * cn, src + sy * srcstride + sx * cn, cn);
+        }
+    }
+}
+
+static int test_mat_pixel_rotate(int srcw, int srch, int cn, int type, int num_threads)
+{
+    const int w = type <= 4 ? srcw : srch;
+    const int h = type <= 4 ? srch : srcw;
+
+    ncnn::Mat a = RandomPixels(srcw, srch, cn);
+
+    ncnn::Mat b(w * cn, h, (size_t)1u);
+    ncnn::Mat c(w * cn, h, (size_t)1u);
+
+    ncnn::Option opt;
+    opt.num_threads = num_threads;
+
+    if (cn == 1) ncnn::kanna_rotate_c1(a, srcw, srch, b, w, h, type, opt);
+    if (cn == 2) ncnn::kanna_rotate_c2(a, srcw, srch, b, w, h, type, opt);
+    if (cn == 3) ncnn::kanna_rotate_c3(a, srcw, srch, b, w, h, type, opt);
+    if (cn == 4) ncnn::kanna_rotate_c4(a, srcw, srch, b, w, h, type, opt);
+
+    kanna_rotate_ref(a, srcw, srch, srcw * cn, c, w, h, w * cn, cn, type);
+
+    if (memcmp(b.data, c.data, w * cn * h) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_rotate failed srcw=%d srch=%d cn=%d type=%d num_threads=%d\n", srcw, srch, cn, type, num_threads);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_rotate_stride(int srcw, int srch, int cn, int type)
+{
+    const int w = type <= 4 ? srcw : srch;
+    const int h = type <= 4 ? srch : srcw;
+
+    // rows padded with a few bytes that must be left untouched
+    const int srcstride = srcw * cn + 3;
+    const int stride = w * cn + 5;
+
+    ncnn::Mat a = RandomPixels(srcstride, srch, 1);
+
+    ncnn::Mat b(stride, h, (size_t)1u);
+    ncnn::Mat c(stride, h, (size_t)1u);
+    memset(b.data, 233, stride * h);
+    memset(c.data, 233, stride * h);
+
+    if (cn == 1) ncnn::kanna_rotate_c1(a, srcw, srch, srcstride, b, w, h, stride, type);
+    if (cn == 2) ncnn::kanna_rotate_c2(a, srcw, srch, srcstride, b, w, h, stride, type);
+    if (cn == 3) ncnn::kanna_rotate_c3(a, srcw, srch, srcstride, b, w, h, stride, type);
+    if (cn == 4) ncnn::kanna_rotate_c4(a, srcw, srch, srcstride, b, w, h, stride, type);
+
+    kanna_rotate_ref(a, srcw, srch, srcstride, c, w, h, stride, cn, type);
+
+    if (memcmp(b.data, c.data, stride * h) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_rotate_stride failed srcw=%d srch=%d cn=%d type=%d\n", srcw, srch, cn, type);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int pixel_type_channels(int type)
+{
+    int type_from = type & ncnn::Mat::PIXEL_FORMAT_MASK;
+    if (type_from == ncnn::Mat::PIXEL_GRAY)
+        return 1;
+    if (type_from == ncnn::Mat::PIXEL_RGBA)
+        return 4;
+    return 3;
+}
+
+static int test_mat_pixel_from_pixels_rotate(int srcw, int srch, int pixel_type, int type, int num_threads)
+{
+    const int cn = pixel_type_channels(pixel_type);
+    const int w = type <= 4 ? srcw : srch;
+    const int h = type <= 4 ? srch : srcw;
+
+    ncnn::Mat a = RandomPixels(srcw, srch, cn);
+
+    ncnn::Mat rotated(w * cn, h, (size_t)1u);
+    kanna_rotate_ref(a, srcw, srch, srcw * cn, rotated, w, h, w * cn, cn, type);
+
+    ncnn::Option opt;
+    opt.num_threads = num_threads;
+
+    ncnn::Mat b = ncnn::Mat::from_pixels_rotate(a, pixel_type, srcw, srch, type, opt);
+    ncnn::Mat c = ncnn::Mat::from_pixels(rotated, pixel_type, w, h);
+
+    if (Compare(b, c, 0.f) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_from_pixels_rotate failed srcw=%d srch=%d pixel_type=%d type=%d num_threads=%d\n", srcw, srch, pixel_type, type, num_threads);
+        return -1;
+    }
+
+    const float mean_vals[4] = { 127.5f, 100.f, 50.f, 0.f };
+    const float norm_vals[4] = { 1 / 127.5f, 0.01f, 0.02f, 1.f };
+
+    ncnn::Mat d = ncnn::Mat::from_pixels_rotate_normalize(a, pixel_type, srcw, srch, type, mean_vals, norm_vals, opt);
+    c.substract_mean_normalize(mean_vals, norm_vals);
+
+    if (Compare(d, c) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_from_pixels_rotate_normalize failed srcw=%d srch=%d pixel_type=%d type=%d num_threads=%d\n", srcw, srch, pixel_type, type, num_threads);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_rotate_0()
+{
+    for (int cn = 1; cn <= 4; cn++)
+    {
+        for (int type = 1; type <= 8; type++)
+        {
+            int ret = 0
+                || test_mat_pixel_rotate(1, 1, cn, type, 1)
+                || test_mat_pixel_rotate(3, 5, cn, type, 1)
+                || test_mat_pixel_rotate(7, 13, cn, type, 1)
+                || test_mat_pixel_rotate(17, 9, cn, type, 1)
+                || test_mat_pixel_rotate(33, 31, cn, type, 1)
+                || test_mat_pixel_rotate(65, 67, cn, type, 1)
+                || test_mat_pixel_rotate(301, 259, cn, type, 1)
+                || test_mat_pixel_rotate(301, 259, cn, type, 4)
+                || test_mat_pixel_rotate_stride(15, 11, cn, type)
+                || test_mat_pixel_rotate_stride(37, 41, cn, type)
+                ;
+
+            if (ret != 0)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_rotate_1()
+{
+    const int pixel_types[] = {
+        ncnn::Mat::PIXEL_RGB,
+        ncnn::Mat::PIXEL_BGR,
+        ncnn::Mat::PIXEL_GRAY,
+        ncnn::Mat::PIXEL_RGBA,
+        ncnn::Mat::PIXEL_RGB2BGR,
+        ncnn::Mat::PIXEL_BGR2RGB,
+        ncnn::Mat::PIXEL_RGBA2RGB,
+        ncnn::Mat::PIXEL_RGBA2BGR,
+    };
+
+    for (int i = 0; i < (int)(sizeof(pixel_types) / sizeof(int)); i++)
+    {
+        for (int type = 1; type <= 8; type++)
+        {
+            int ret = 0
+                || test_mat_pixel_from_pixels_rotate(5, 3, pixel_types[i], type, 1)
+                || test_mat_pixel_from_pixels_rotate(23, 37, pixel_types[i], type, 1)
+                || test_mat_pixel_from_pixels_rotate(263, 257, pixel_types[i], type, 4)
+                ;
+
+            if (ret != 0)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    srand(7767517);
+
+    return 0
+        || test_mat_pixel_rotate_0()
+        || test_mat_pixel_rotate_1()
+        ;
+}
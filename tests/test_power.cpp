@@ -0,0 +1,116 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+#include "layer/power.h"
+
+static int test_power(const ncnn::Mat& a, float power, float scale, float shift)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, power);
+    pd.set(1, scale);
+    pd.set(2, shift);
+
+    std::vector<ncnn::Mat> weights(0);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+    int ret = test_layer<ncnn::Power>(ncnn::LayerType::Power, pd, weights, opt, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_power failed a.dims=%d a=(%d %d %d) power=%f scale=%f shift=%f\n", a.dims, a.w, a.h, a.c, power, scale, shift);
+    }
+
+    return ret;
+}
+
+static int test_power_0()
+{
+    return 0
+        || test_power(RandomMat(5, 7, 3), 1.f, 1.5f, 0.2f)
+        || test_power(RandomMat(6, 7, 16), 1.f, 1.5f, 0.2f)
+        || test_power(RandomMat(3, 5, 24), 1.f, 1.5f, 0.2f)
+        || test_power(RandomMat(19, 5), 1.f, 1.5f, 0.2f)
+        || test_power(RandomMat(13, 16), 1.f, 1.5f, 0.2f)
+        || test_power(RandomMat(13), 1.f, 1.5f, 0.2f)
+        || test_power(RandomMat(40), 1.f, 1.5f, 0.2f)
+        ;
+}
+
+static int test_power_1()
+{
+    return 0
+        || test_power(RandomMat(5, 7, 3), 2.f, 1.f, 0.f)
+        || test_power(RandomMat(6, 7, 16), 2.f, 1.f, 0.f)
+        || test_power(RandomMat(3, 5, 24), 2.f, 1.f, 0.f)
+        || test_power(RandomMat(19, 5), 2.f, 1.f, 0.f)
+        || test_power(RandomMat(13, 16), 2.f, 1.f, 0.f)
+        || test_power(RandomMat(13), 2.f, 1.f, 0.f)
+        || test_power(RandomMat(40), 2.f, 1.f, 0.f)
+        ;
+}
+
+static int test_power_2()
+{
+    return 0
+        || test_power(RandomMat(5, 7, 3), 0.5f, 0.5f, 2.f)
+        || test_power(RandomMat(6, 7, 16), 0.5f, 0.5f, 2.f)
+        || test_power(RandomMat(3, 5, 24), 0.5f, 0.5f, 2.f)
+        || test_power(RandomMat(19, 5), 0.5f, 0.5f, 2.f)
+        || test_power(RandomMat(13, 16), 0.5f, 0.5f, 2.f)
+        || test_power(RandomMat(13), 0.5f, 0.5f, 2.f)
+        || test_power(RandomMat(40), 0.5f, 0.5f, 2.f)
+        ;
+}
+
+static int test_power_3()
+{
+    return 0
+        || test_power(RandomMat(5, 7, 3), -1.f, 0.5f, 2.f)
+        || test_power(RandomMat(6, 7, 16), -1.f, 0.5f, 2.f)
+        || test_power(RandomMat(3, 5, 24), -1.f, 0.5f, 2.f)
+        || test_power(RandomMat(19, 5), -1.f, 0.5f, 2.f)
+        || test_power(RandomMat(13, 16), -1.f, 0.5f, 2.f)
+        || test_power(RandomMat(13), -1.f, 0.5f, 2.f)
+        || test_power(RandomMat(40), -1.f, 0.5f, 2.f)
+        ;
+}
+
+static int test_power_4()
+{
+    return 0
+        || test_power(RandomMat(5, 7, 3), 3.f, 1.f, 0.3f)
+        || test_power(RandomMat(6, 7, 16), 3.f, 1.f, 0.3f)
+        || test_power(RandomMat(3, 5, 24), 3.f, 1.f, 0.3f)
+        || test_power(RandomMat(19, 5), 3.f, 1.f, 0.3f)
+        || test_power(RandomMat(13, 16), 3.f, 1.f, 0.3f)
+        || test_power(RandomMat(13), 3.f, 1.f, 0.3f)
+        || test_power(RandomMat(40), 3.f, 1.f, 0.3f)
+        ;
+}
+
+int main()
+{
+    srand(7767517);
+
+    return 0
+        || test_power_0()
+        || test_power_1()
+        || test_power_2()
+        || test_power_3()
+        || test_power_4()
+        ;
+}
@@ -0,0 +1,73 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+#include "layer/selu.h"
+
+static int test_selu(const ncnn::Mat& a, float alpha, float lambda)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, alpha);
+    pd.set(1, lambda);
+
+    std::vector<ncnn::Mat> weights(0);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+    int ret = test_layer<ncnn::SELU>(ncnn::LayerType::SELU, pd, weights, opt, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_selu failed a.dims=%d a=(%d %d %d) alpha=%f lambda=%f\n", a.dims, a.w, a.h, a.c, alpha, lambda);
+    }
+
+    return ret;
+}
+
+static int test_selu_0()
+{
+    return 0
+        || test_selu(RandomMat(5, 7, 3), 1.67326324f, 1.050700987f)
+        || test_selu(RandomMat(6, 7, 16), 1.67326324f, 1.050700987f)
+        || test_selu(RandomMat(3, 5, 24), 1.67326324f, 1.050700987f)
+        || test_selu(RandomMat(19, 5), 1.67326324f, 1.050700987f)
+        || test_selu(RandomMat(13, 16), 1.67326324f, 1.050700987f)
+        || test_selu(RandomMat(13), 1.67326324f, 1.050700987f)
+        || test_selu(RandomMat(40), 1.67326324f, 1.050700987f)
+        ;
+}
+
+static int test_selu_1()
+{
+    return 0
+        || test_selu(RandomMat(5, 7, 3), 0.5f, 2.f)
+        || test_selu(RandomMat(6, 7, 16), 0.5f, 2.f)
+        || test_selu(RandomMat(3, 5, 24), 0.5f, 2.f)
+        || test_selu(RandomMat(19, 5), 0.5f, 2.f)
+        || test_selu(RandomMat(13, 16), 0.5f, 2.f)
+        || test_selu(RandomMat(13), 0.5f, 2.f)
+        || test_selu(RandomMat(40), 0.5f, 2.f)
+        ;
+}
+
+int main()
+{
+    srand(7767517);
+
+    return 0
+        || test_selu_0()
+        || test_selu_1()
+        ;
+}
@@ -0,0 +1,213 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TESTUTIL_H
+#define TESTUTIL_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#include "layer.h"
+#include "layer_type.h"
+#include "mat.h"
+#include "modelbin.h"
+#include "paramdict.h"
+
+static float RandomFloat(float a = -1.2f, float b = 1.2f)
+{
+    float random = ((float)rand()) / (float)RAND_MAX;
+    return a + random * (b - a);
+}
+
+static void Randomize(ncnn::Mat& m, float a = -1.2f, float b = 1.2f)
+{
+    for (size_t i=0; i<m.total(); i++)
+    {
+        m[i] = RandomFloat(a, b);
+    }
+}
+
+static ncnn::Mat RandomMat(int w)
+{
+    ncnn::Mat m(w);
+    Randomize(m);
+    return m;
+}
+
+static ncnn::Mat RandomMat(int w, int h)
+{
+    ncnn::Mat m(w, h);
+    Randomize(m);
+    return m;
+}
+
+static ncnn::Mat RandomMat(int w, int h, int c)
+{
+    ncnn::Mat m(w, h, c);
+    Randomize(m);
+    return m;
+}
+
+// h rows of w pixels with cn interleaved u8 channels
+static ncnn::Mat RandomPixels(int w, int h, int cn)
+{
+    ncnn::Mat m(w * cn, h, (size_t)1u);
+
+    unsigned char* p = m;
+    for (int i=0; i<w * cn * h; i++)
+    {
+        p[i] = (unsigned char)(rand() % 256);
+    }
+
+    return m;
+}
+
+static bool FloatNearlyEqual(float a, float b, float epsilon)
+{
+    if (a == b)
+        return true;
+
+    float diff = fabs(a - b);
+    if (diff <= epsilon)
+        return true;
+
+    // relative error
+    return diff < epsilon * std::max(fabs(a), fabs(b));
+}
+
+// element-wise comparison of two pack1 float or int8 blobs
+static int Compare(const ncnn::Mat& a, const ncnn::Mat& b, float epsilon = 0.001f)
+{
+#define CHECK_MEMBER(m) \
+    if (a.m != b.m) \
+    { \
+        fprintf(stderr, #m" not match    expect %d but got %d\n", (int)b.m, (int)a.m); \
+        return -1; \
+    }
+
+    CHECK_MEMBER(dims)
+    CHECK_MEMBER(w)
+    CHECK_MEMBER(h)
+    CHECK_MEMBER(c)
+    CHECK_MEMBER(elemsize)
+    CHECK_MEMBER(elempack)
+
+#undef CHECK_MEMBER
+
+    for (int q=0; q<a.c; q++)
+    {
+        const ncnn::Mat ma = a.channel(q);
+        const ncnn::Mat mb = b.channel(q);
+        for (int i=0; i<a.h; i++)
+        {
+            for (int j=0; j<a.w; j++)
+            {
+                float va = a.elemsize == 1 ? (float)ma.row<signed char>(i)[j] : ma.row(i)[j];
+                float vb = b.elemsize == 1 ? (float)mb.row<signed char>(i)[j] : mb.row(i)[j];
+                if (!FloatNearlyEqual(va, vb, epsilon))
+                {
+                    fprintf(stderr, "value not match  at c:%d h:%d w:%d    expect %f but got %f\n", q, i, j, vb, va);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int layer_forward(const ncnn::Layer* op, const ncnn::Mat& a, ncnn::Mat& b, const ncnn::Option& opt)
+{
+    if (op->support_inplace)
+    {
+        b = a.clone();
+        return op->forward_inplace(b, opt);
+    }
+
+    return op->forward(a, b, opt);
+}
+
+// run the optimized layer from create_layer and the generic layer T on the same input
+// the optimized one runs once on pack1 input and once on the packed layout the net would feed it
+template<typename T>
+int test_layer(int typeindex, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Option& _opt, const ncnn::Mat& a, float epsilon = 0.001f)
+{
+    T* op_ref = new T;
+    op_ref->load_param(pd);
+    op_ref->load_model(ncnn::ModelBinFromMatArray(weights.data()));
+
+    ncnn::Option opt_ref = _opt;
+    opt_ref.use_packing_layout = false;
+    op_ref->create_pipeline(opt_ref);
+
+    ncnn::Mat b;
+    int ret = layer_forward(op_ref, a, b, opt_ref);
+
+    op_ref->destroy_pipeline(opt_ref);
+    delete op_ref;
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "reference forward failed %d\n", ret);
+        return -1;
+    }
+
+    for (int packing = 0; packing < 2; packing++)
+    {
+        ncnn::Option opt = _opt;
+        opt.use_packing_layout = packing == 1;
+
+        ncnn::Layer* op = ncnn::create_layer(typeindex);
+        op->load_param(pd);
+        op->load_model(ncnn::ModelBinFromMatArray(weights.data()));
+        op->create_pipeline(opt);
+
+        ncnn::Mat a_packed = a;
+        if (opt.use_packing_layout && op->support_packing)
+        {
+            ncnn::convert_packing(a, a_packed, 8, opt);
+        }
+
+        ncnn::Mat c_packed;
+        ret = layer_forward(op, a_packed, c_packed, opt);
+
+        ncnn::Mat c = c_packed;
+        if (ret == 0 && c_packed.elempack != 1)
+        {
+            ncnn::convert_packing(c_packed, c, 1, opt);
+        }
+
+        op->destroy_pipeline(opt);
+        delete op;
+
+        if (ret != 0)
+        {
+            fprintf(stderr, "forward failed %d  packing=%d\n", ret, packing);
+            return -1;
+        }
+
+        if (Compare(c, b, epsilon) != 0)
+        {
+            fprintf(stderr, "output not match  packing=%d elempack=%d\n", packing, a_packed.elempack);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+#endif // TESTUTIL_H